@@ -353,7 +353,9 @@ aom_codec_err_t aom_codec_register_put_slice_cb(aom_codec_ctx_t *ctx,
  * \note
  * When decoding AV1, the application may be required to pass in at least
  * #AOM_MAXIMUM_WORK_BUFFERS external frame
- * buffers.
+ * buffers. Frame parallel decoding with n threads may use up to
+ * #AOM_MAXIMUM_REF_BUFFERS + n + max(n, 6) of them: 136 with the maximum
+ * of 64 threads.
  */
 aom_codec_err_t aom_codec_set_frame_buffer_functions(
     aom_codec_ctx_t *ctx, aom_get_frame_buffer_cb_fn_t cb_get,
@@ -23,9 +23,10 @@ extern "C" {
 #include "./aom_integer.h"
 
 /*!\brief The maximum number of work buffers used by libaom.
- *  Support maximum 4 threads to decode video in parallel.
- *  Each thread will use one work buffer.
- * TODO(hkuang): Add support to set number of worker threads dynamically.
+ *  This covers decoding on a single thread. Frame parallel decoding, with up
+ *  to 64 threads, gives each thread a work buffer of its own and uses up to
+ *  #AOM_MAXIMUM_REF_BUFFERS + n + max(n, 6) frame buffers in all with n
+ *  threads.
  */
 #define AOM_MAXIMUM_WORK_BUFFERS 8
 
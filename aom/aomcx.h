@@ -553,6 +553,51 @@ enum aome_enc_control_id {
    * 0 : off, 1 : MAX_EXTREME_MV, 2 : MIN_EXTREME_MV
    */
   AV1E_ENABLE_MOTION_VECTOR_UNIT_TEST,
+
+  /*!\brief Codec control function to enable row based multi-threading.
+   *
+   * When enabled, the superblock rows of each tile are encoded by different
+   * worker threads in wavefront order, so that the number of usable threads
+   * is no longer limited by the number of tile columns. The output does not
+   * depend on the number of threads, but it is not identical to the output
+   * produced with row based multi-threading disabled.
+   *
+   *            0 = disable row based multi-threading (default)
+   *            1 = enable row based multi-threading
+   */
+  AV1E_SET_ROW_MT,
+
+  /*!\brief Codec control function to code the first pass of one chunk of
+   * the sequence, so that the chunks can be coded in parallel.
+   *
+   * The value is the index in the sequence of the first frame of the chunk.
+   * A chunk other than the first must also be given the warm-up frames just
+   * before it, see #AV1E_SET_FIRST_PASS_CHUNK_WARMUP: they are coded only
+   * to build up the reference frames of the chunk, and produce no
+   * statistics. The frames of the statistics packets are numbered from the
+   * start of the sequence.
+   *
+   * The statistics of the whole sequence are the frame packets of each
+   * chunk, in order, followed by the field-by-field sum of the last packets
+   * of the chunks, which hold the totals of the chunks.
+   *
+   *            0 = the whole sequence (default)
+   */
+  AV1E_SET_FIRST_PASS_CHUNK_START,
+
+  /*!\brief Codec control function to set the number of warm-up frames
+   * coded before a first pass chunk, see #AV1E_SET_FIRST_PASS_CHUNK_START.
+   *
+   * The first warm-up frame is intra coded, so the reference frames of the
+   * chunk only approach those of a first pass of the whole sequence, and the
+   * statistics of the first frames of the chunk differ from it the most.
+   * More warm-up frames make the statistics closer but the chunk slower. A
+   * chunk that would start its warm-up before the start of the sequence
+   * starts at the first frame, and its statistics are exact.
+   *
+   * Valid range: 1..MAX_LAG_BUFFERS, default is 1.
+   */
+  AV1E_SET_FIRST_PASS_CHUNK_WARMUP,
 };
 
 /*!\brief aom 1-D scaling mode
@@ -772,6 +817,15 @@ AOM_CTRL_USE_TYPE(AV1E_SET_TILE_ENCODING_MODE, unsigned int)
 AOM_CTRL_USE_TYPE(AV1E_ENABLE_MOTION_VECTOR_UNIT_TEST, unsigned int)
 #define AOM_CTRL_AV1E_ENABLE_MOTION_VECTOR_UNIT_TEST
 
+AOM_CTRL_USE_TYPE(AV1E_SET_ROW_MT, unsigned int)
+#define AOM_CTRL_AV1E_SET_ROW_MT
+
+AOM_CTRL_USE_TYPE(AV1E_SET_FIRST_PASS_CHUNK_START, unsigned int)
+#define AOM_CTRL_AV1E_SET_FIRST_PASS_CHUNK_START
+
+AOM_CTRL_USE_TYPE(AV1E_SET_FIRST_PASS_CHUNK_WARMUP, unsigned int)
+#define AOM_CTRL_AV1E_SET_FIRST_PASS_CHUNK_WARMUP
+
 /*!\endcond */
 /*! @} - end defgroup aom_encoder */
 #ifdef __cplusplus
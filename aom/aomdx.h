@@ -156,6 +156,15 @@ enum aom_dec_control_id {
    */
   AV1_SET_INSPECTION_CALLBACK,
 
+  /** control function to set the row based multi-threading flag. With a
+   * nonzero value, the decoder parses each superblock row of a tile into a
+   * buffer before reconstructing it. With more than one thread, the worker
+   * threads reconstruct the parsed rows while the main thread parses the
+   * following ones. The output is the same either way. The default value is
+   * 1 when decoding with more than one thread, 0 otherwise.
+   */
+  AV1D_SET_ROW_MT,
+
   AOM_DECODER_CTRL_ID_MAX,
 };
 
@@ -213,6 +222,8 @@ AOM_CTRL_USE_TYPE(AV1_SET_DECODE_TILE_COL, int)
 #define AOM_CTRL_AV1_SET_DECODE_TILE_COL
 AOM_CTRL_USE_TYPE(AV1_SET_INSPECTION_CALLBACK, aom_inspect_init *)
 #define AOM_CTRL_AV1_SET_INSPECTION_CALLBACK
+AOM_CTRL_USE_TYPE(AV1D_SET_ROW_MT, int)
+#define AOM_CTRL_AV1D_SET_ROW_MT
 /*!\endcond */
 /*! @} - end defgroup aom_decoder */
 
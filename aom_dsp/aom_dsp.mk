@@ -64,6 +64,7 @@ endif
 
 # intra predictions
 DSP_SRCS-yes += intrapred.c
+DSP_SRCS-yes += intrapred_common.h
 
 ifneq ($(CONFIG_ANS),yes)
 DSP_SRCS-yes += entcode.c
@@ -73,6 +74,8 @@ endif
 DSP_SRCS-$(HAVE_SSE) += x86/intrapred_sse2.asm
 DSP_SRCS-$(HAVE_SSE2) += x86/intrapred_sse2.asm
 DSP_SRCS-$(HAVE_SSSE3) += x86/intrapred_ssse3.asm
+DSP_SRCS-$(HAVE_SSE4_1) += x86/intrapred_sse4.c
+DSP_SRCS-$(HAVE_AVX2) += x86/intrapred_avx2.c
 DSP_SRCS-$(HAVE_SSSE3) += x86/aom_subpixel_8t_ssse3.asm
 
 ifeq ($(CONFIG_HIGHBITDEPTH),yes)
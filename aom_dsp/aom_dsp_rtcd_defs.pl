@@ -80,6 +80,25 @@ foreach (@tx_sizes) {
   }
 }
 
+if (aom_config("CONFIG_ALT_INTRA") eq "yes") {
+  @alt_pred_names = qw/paeth smooth/;
+  if (aom_config("CONFIG_SMOOTH_HV") eq "yes") {
+    push @alt_pred_names, qw/smooth_v smooth_h/;
+  }
+  foreach (@tx_sizes) {
+    ($w, $h) = @$_;
+    next if ($w < 4 || $h < 4 || $w > 32 || $h > 32);
+    # The AVX2 versions only cover blocks at least 16 pixels wide.
+    @archs = ($w >= 16) ? qw/sse4_1 avx2/ : qw/sse4_1/;
+    foreach $pred_name (@alt_pred_names) {
+      specialize "aom_${pred_name}_predictor_${w}x${h}", @archs;
+      if (aom_config("CONFIG_HIGHBITDEPTH") eq "yes") {
+        specialize "aom_highbd_${pred_name}_predictor_${w}x${h}", @archs;
+      }
+    }
+  }
+}  # CONFIG_ALT_INTRA
+
 specialize qw/aom_d63e_predictor_4x4 ssse3/;
 specialize qw/aom_h_predictor_4x4 neon dspr2 msa sse2/;
 specialize qw/aom_d135_predictor_4x4 neon/;
@@ -16,6 +16,7 @@
 #include "./aom_dsp_rtcd.h"
 
 #include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/intrapred_common.h"
 #include "aom_mem/aom_mem.h"
 #include "aom_ports/bitops.h"
 
@@ -208,18 +209,7 @@ static INLINE void paeth_predictor(uint8_t *dst, ptrdiff_t stride, int bw,
   }
 }
 
-// Weights are quadratic from '1' to '1 / block_size', scaled by
-// 2^sm_weight_log2_scale.
-static const int sm_weight_log2_scale = 8;
-
-#if CONFIG_TX64X64
-// max(block_size_wide[BLOCK_LARGEST], block_size_high[BLOCK_LARGEST])
-#define MAX_BLOCK_DIM 64
-#else
-#define MAX_BLOCK_DIM 32
-#endif  // CONFIG_TX64X64
-
-static const uint8_t sm_weight_arrays[2 * MAX_BLOCK_DIM] = {
+const uint8_t aom_sm_weight_arrays[2 * MAX_BLOCK_DIM] = {
   // Unused, because we always offset by bs, which is at least 2.
   0, 0,
   // bs = 2
@@ -258,8 +248,8 @@ static INLINE void smooth_predictor(uint8_t *dst, ptrdiff_t stride, int bw,
                                     const uint8_t *left) {
   const uint8_t below_pred = left[bh - 1];   // estimated by bottom-left pixel
   const uint8_t right_pred = above[bw - 1];  // estimated by top-right pixel
-  const uint8_t *const sm_weights_w = sm_weight_arrays + bw;
-  const uint8_t *const sm_weights_h = sm_weight_arrays + bh;
+  const uint8_t *const sm_weights_w = aom_sm_weight_arrays + bw;
+  const uint8_t *const sm_weights_h = aom_sm_weight_arrays + bh;
   // scale = 2 * 2^sm_weight_log2_scale
   const int log2_scale = 1 + sm_weight_log2_scale;
   const uint16_t scale = (1 << sm_weight_log2_scale);
@@ -289,7 +279,7 @@ static INLINE void smooth_v_predictor(uint8_t *dst, ptrdiff_t stride, int bw,
                                       int bh, const uint8_t *above,
                                       const uint8_t *left) {
   const uint8_t below_pred = left[bh - 1];  // estimated by bottom-left pixel
-  const uint8_t *const sm_weights = sm_weight_arrays + bh;
+  const uint8_t *const sm_weights = aom_sm_weight_arrays + bh;
   // scale = 2^sm_weight_log2_scale
   const int log2_scale = sm_weight_log2_scale;
   const uint16_t scale = (1 << sm_weight_log2_scale);
@@ -318,7 +308,7 @@ static INLINE void smooth_h_predictor(uint8_t *dst, ptrdiff_t stride, int bw,
                                       int bh, const uint8_t *above,
                                       const uint8_t *left) {
   const uint8_t right_pred = above[bw - 1];  // estimated by top-right pixel
-  const uint8_t *const sm_weights = sm_weight_arrays + bw;
+  const uint8_t *const sm_weights = aom_sm_weight_arrays + bw;
   // scale = 2^sm_weight_log2_scale
   const int log2_scale = sm_weight_log2_scale;
   const uint16_t scale = (1 << sm_weight_log2_scale);
@@ -815,8 +805,8 @@ static INLINE void highbd_smooth_predictor(uint16_t *dst, ptrdiff_t stride,
                                            const uint16_t *left, int bd) {
   const uint16_t below_pred = left[bh - 1];   // estimated by bottom-left pixel
   const uint16_t right_pred = above[bw - 1];  // estimated by top-right pixel
-  const uint8_t *const sm_weights_w = sm_weight_arrays + bw;
-  const uint8_t *const sm_weights_h = sm_weight_arrays + bh;
+  const uint8_t *const sm_weights_w = aom_sm_weight_arrays + bw;
+  const uint8_t *const sm_weights_h = aom_sm_weight_arrays + bh;
   // scale = 2 * 2^sm_weight_log2_scale
   const int log2_scale = 1 + sm_weight_log2_scale;
   const uint16_t scale = (1 << sm_weight_log2_scale);
@@ -847,7 +837,7 @@ static INLINE void highbd_smooth_v_predictor(uint16_t *dst, ptrdiff_t stride,
                                              const uint16_t *above,
                                              const uint16_t *left, int bd) {
   const uint16_t below_pred = left[bh - 1];  // estimated by bottom-left pixel
-  const uint8_t *const sm_weights = sm_weight_arrays + bh;
+  const uint8_t *const sm_weights = aom_sm_weight_arrays + bh;
   // scale = 2^sm_weight_log2_scale
   const int log2_scale = sm_weight_log2_scale;
   const uint16_t scale = (1 << sm_weight_log2_scale);
@@ -877,7 +867,7 @@ static INLINE void highbd_smooth_h_predictor(uint16_t *dst, ptrdiff_t stride,
                                              const uint16_t *above,
                                              const uint16_t *left, int bd) {
   const uint16_t right_pred = above[bw - 1];  // estimated by top-right pixel
-  const uint8_t *const sm_weights = sm_weight_arrays + bw;
+  const uint8_t *const sm_weights = aom_sm_weight_arrays + bw;
   // scale = 2^sm_weight_log2_scale
   const int log2_scale = sm_weight_log2_scale;
   const uint16_t scale = (1 << sm_weight_log2_scale);
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_DSP_INTRAPRED_COMMON_H_
+#define AOM_DSP_INTRAPRED_COMMON_H_
+
+#include "./aom_config.h"
+#include "aom/aom_integer.h"
+
+#if CONFIG_ALT_INTRA
+// Weights are quadratic from '1' to '1 / block_size', scaled by
+// 2^sm_weight_log2_scale.
+static const int sm_weight_log2_scale = 8;
+
+#if CONFIG_TX64X64
+// max(block_size_wide[BLOCK_LARGEST], block_size_high[BLOCK_LARGEST])
+#define MAX_BLOCK_DIM 64
+#else
+#define MAX_BLOCK_DIM 32
+#endif  // CONFIG_TX64X64
+
+extern const uint8_t aom_sm_weight_arrays[2 * MAX_BLOCK_DIM];
+#endif  // CONFIG_ALT_INTRA
+
+#endif  // AOM_DSP_INTRAPRED_COMMON_H_
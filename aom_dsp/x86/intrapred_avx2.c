@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "./aom_config.h"
+#include "./aom_dsp_rtcd.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/intrapred_common.h"
+
+#if CONFIG_ALT_INTRA
+// Only the blocks that are at least 16 pixels wide are implemented here, one
+// row of 16 pixels per 256-bit register. The narrower blocks use the SSE4.1
+// versions. As in intrapred_sse4.c all arithmetic is done on 16-bit lanes.
+
+// Packs the 16-bit predictors of columns 0-15 in |lo| and of columns 16-31 in
+// |hi| into 32 bytes in column order.
+static INLINE __m256i pack_16x2(__m256i lo, __m256i hi) {
+  return _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8);
+}
+
+// -----------------------------------------------------------------------------
+// PAETH_PRED
+
+static INLINE __m256i paeth_16(__m256i left, __m256i top, __m256i top_left) {
+  const __m256i base = _mm256_sub_epi16(_mm256_add_epi16(top, left), top_left);
+  const __m256i p_left = _mm256_abs_epi16(_mm256_sub_epi16(base, left));
+  const __m256i p_top = _mm256_abs_epi16(_mm256_sub_epi16(base, top));
+  const __m256i p_top_left = _mm256_abs_epi16(_mm256_sub_epi16(base, top_left));
+  const __m256i not_left =
+      _mm256_or_si256(_mm256_cmpgt_epi16(p_left, p_top),
+                      _mm256_cmpgt_epi16(p_left, p_top_left));
+  const __m256i not_top = _mm256_cmpgt_epi16(p_top, p_top_left);
+  const __m256i top_or_top_left = _mm256_blendv_epi8(top, top_left, not_top);
+  return _mm256_blendv_epi8(left, top_or_top_left, not_left);
+}
+
+static INLINE void paeth_predictor(uint8_t *dst, ptrdiff_t stride, int bw,
+                                   int bh, const uint8_t *above,
+                                   const uint8_t *left) {
+  const __m256i top_left = _mm256_set1_epi16(above[-1]);
+  const __m256i top0 =
+      _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)above));
+  int r;
+
+  if (bw == 16) {
+    for (r = 0; r < bh; ++r) {
+      const __m256i pred = paeth_16(_mm256_set1_epi16(left[r]), top0, top_left);
+      _mm_storeu_si128((__m128i *)dst,
+                       _mm256_castsi256_si128(pack_16x2(pred, pred)));
+      dst += stride;
+    }
+  } else {
+    const __m256i top1 =
+        _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(above + 16)));
+    for (r = 0; r < bh; ++r) {
+      const __m256i l = _mm256_set1_epi16(left[r]);
+      const __m256i pred_lo = paeth_16(l, top0, top_left);
+      const __m256i pred_hi = paeth_16(l, top1, top_left);
+      _mm256_storeu_si256((__m256i *)dst, pack_16x2(pred_lo, pred_hi));
+      dst += stride;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// SMOOTH_PRED
+//
+// See intrapred_sse4.c for the pairing of pixels and weights. The unpack and
+// pack instructions both work within 128-bit lanes, so interleaving the
+// pixels with _mm256_unpack{lo,hi}_epi16() and packing the results with
+// _mm256_packus_epi32() puts the predictors back in column order.
+
+// Interleaves the 16 16-bit values of |p| with |q|, into |pairs[0]| for
+// columns 0-3 and 8-11 and into |pairs[1]| for columns 4-7 and 12-15.
+static INLINE void interleave_16(__m256i p, __m256i q, __m256i *pairs) {
+  pairs[0] = _mm256_unpacklo_epi16(p, q);
+  pairs[1] = _mm256_unpackhi_epi16(p, q);
+}
+
+static INLINE void weight_pairs_16(const uint8_t *weights, __m256i *pairs) {
+  const __m256i w =
+      _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)weights));
+  const __m256i scale = _mm256_set1_epi16(1 << sm_weight_log2_scale);
+  interleave_16(w, _mm256_sub_epi16(scale, w), pairs);
+}
+
+// Computes 16 16-bit predictors of one row from the interleaved pairs of
+// 16 columns, with the vertical and horizontal terms selected as in
+// intrapred_sse4.c.
+static INLINE __m256i smooth_16(const __m256i *above_pairs,
+                                __m256i row_weights, __m256i left_pair,
+                                const __m256i *col_weights, int use_v,
+                                int use_h) {
+  const int log2_scale = sm_weight_log2_scale + (use_v && use_h);
+  const __m256i round = _mm256_set1_epi32(1 << (log2_scale - 1));
+  __m256i sum[2];
+  int i;
+  for (i = 0; i < 2; ++i) {
+    sum[i] = round;
+    if (use_v)
+      sum[i] = _mm256_add_epi32(
+          sum[i], _mm256_madd_epi16(above_pairs[i], row_weights));
+    if (use_h)
+      sum[i] = _mm256_add_epi32(
+          sum[i], _mm256_madd_epi16(left_pair, col_weights[i]));
+    sum[i] = _mm256_srli_epi32(sum[i], log2_scale);
+  }
+  return _mm256_packus_epi32(sum[0], sum[1]);
+}
+
+static INLINE __m256i dup_weight_pair(int w) {
+  return _mm256_set1_epi32(((1 << sm_weight_log2_scale) - w) << 16 | w);
+}
+
+static INLINE __m256i dup_pixel_pair(int p, int q) {
+  return _mm256_set1_epi32(q << 16 | p);
+}
+
+static INLINE void smooth_predictor(uint8_t *dst, ptrdiff_t stride, int bw,
+                                    int bh, const uint8_t *above,
+                                    const uint8_t *left, int use_v,
+                                    int use_h) {
+  const uint8_t below_pred = left[bh - 1];   // estimated by bottom-left pixel
+  const uint8_t right_pred = above[bw - 1];  // estimated by top-right pixel
+  const uint8_t *const sm_weights_w = aom_sm_weight_arrays + bw;
+  const uint8_t *const sm_weights_h = aom_sm_weight_arrays + bh;
+  const __m256i below = _mm256_set1_epi16(below_pred);
+  __m256i above_pairs[4], col_weights[4];
+  int r, c;
+
+  for (c = 0; c < bw; c += 16) {
+    const __m256i a =
+        _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(above + c)));
+    interleave_16(a, below, above_pairs + (c >> 3));
+    weight_pairs_16(sm_weights_w + c, col_weights + (c >> 3));
+  }
+
+  for (r = 0; r < bh; ++r) {
+    const __m256i row_weights = dup_weight_pair(sm_weights_h[r]);
+    const __m256i left_pair = dup_pixel_pair(left[r], right_pred);
+    const __m256i pred_lo = smooth_16(above_pairs, row_weights, left_pair,
+                                      col_weights, use_v, use_h);
+    if (bw == 16) {
+      _mm_storeu_si128((__m128i *)dst,
+                       _mm256_castsi256_si128(pack_16x2(pred_lo, pred_lo)));
+    } else {
+      const __m256i pred_hi = smooth_16(above_pairs + 2, row_weights,
+                                        left_pair, col_weights + 2, use_v,
+                                        use_h);
+      _mm256_storeu_si256((__m256i *)dst, pack_16x2(pred_lo, pred_hi));
+    }
+    dst += stride;
+  }
+}
+
+#define intra_pred_sized(type, width, height)                  \
+  void aom_##type##_predictor_##width##x##height##_avx2(       \
+      uint8_t *dst, ptrdiff_t stride, const uint8_t *above,    \
+      const uint8_t *left) {                                   \
+    type##_predictor(dst, stride, width, height, above, left); \
+  }
+
+#define smooth_pred_sized(type, use_v, use_h, width, height)                 \
+  void aom_##type##_predictor_##width##x##height##_avx2(                     \
+      uint8_t *dst, ptrdiff_t stride, const uint8_t *above,                  \
+      const uint8_t *left) {                                                 \
+    smooth_predictor(dst, stride, width, height, above, left, use_v, use_h); \
+  }
+
+#if CONFIG_HIGHBITDEPTH
+static INLINE void highbd_paeth_predictor(uint16_t *dst, ptrdiff_t stride,
+                                          int bw, int bh, const uint16_t *above,
+                                          const uint16_t *left, int bd) {
+  const __m256i top_left = _mm256_set1_epi16(above[-1]);
+  __m256i top[2];
+  int r, c;
+  (void)bd;
+
+  for (c = 0; c < bw; c += 16)
+    top[c >> 4] = _mm256_loadu_si256((const __m256i *)(above + c));
+
+  for (r = 0; r < bh; ++r) {
+    const __m256i l = _mm256_set1_epi16(left[r]);
+    for (c = 0; c < bw; c += 16)
+      _mm256_storeu_si256((__m256i *)(dst + c),
+                          paeth_16(l, top[c >> 4], top_left));
+    dst += stride;
+  }
+}
+
+static INLINE void highbd_smooth_predictor(uint16_t *dst, ptrdiff_t stride,
+                                           int bw, int bh,
+                                           const uint16_t *above,
+                                           const uint16_t *left, int use_v,
+                                           int use_h) {
+  const uint16_t below_pred = left[bh - 1];   // estimated by bottom-left pixel
+  const uint16_t right_pred = above[bw - 1];  // estimated by top-right pixel
+  const uint8_t *const sm_weights_w = aom_sm_weight_arrays + bw;
+  const uint8_t *const sm_weights_h = aom_sm_weight_arrays + bh;
+  const __m256i below = _mm256_set1_epi16(below_pred);
+  __m256i above_pairs[4], col_weights[4];
+  int r, c;
+
+  for (c = 0; c < bw; c += 16) {
+    const __m256i a = _mm256_loadu_si256((const __m256i *)(above + c));
+    interleave_16(a, below, above_pairs + (c >> 3));
+    weight_pairs_16(sm_weights_w + c, col_weights + (c >> 3));
+  }
+
+  for (r = 0; r < bh; ++r) {
+    const __m256i row_weights = dup_weight_pair(sm_weights_h[r]);
+    const __m256i left_pair = dup_pixel_pair(left[r], right_pred);
+    for (c = 0; c < bw; c += 16)
+      _mm256_storeu_si256(
+          (__m256i *)(dst + c),
+          smooth_16(above_pairs + (c >> 3), row_weights, left_pair,
+                    col_weights + (c >> 3), use_v, use_h));
+    dst += stride;
+  }
+}
+
+#define intra_pred_highbd_sized(type, width, height)                        \
+  void aom_highbd_##type##_predictor_##width##x##height##_avx2(             \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,               \
+      const uint16_t *left, int bd) {                                       \
+    highbd_##type##_predictor(dst, stride, width, height, above, left, bd); \
+  }
+
+#define smooth_pred_highbd_sized(type, use_v, use_h, width, height) \
+  void aom_highbd_##type##_predictor_##width##x##height##_avx2(     \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,       \
+      const uint16_t *left, int bd) {                               \
+    (void)bd;                                                       \
+    highbd_smooth_predictor(dst, stride, width, height, above, left, \
+                            use_v, use_h);                          \
+  }
+#else
+#define intra_pred_highbd_sized(type, width, height)
+#define smooth_pred_highbd_sized(type, use_v, use_h, width, height)
+#endif  // CONFIG_HIGHBITDEPTH
+
+#define intra_pred_wide_sizes(type)     \
+  intra_pred_sized(type, 16, 8)         \
+  intra_pred_sized(type, 16, 16)        \
+  intra_pred_sized(type, 16, 32)        \
+  intra_pred_sized(type, 32, 16)        \
+  intra_pred_sized(type, 32, 32)        \
+  intra_pred_highbd_sized(type, 16, 8)  \
+  intra_pred_highbd_sized(type, 16, 16) \
+  intra_pred_highbd_sized(type, 16, 32) \
+  intra_pred_highbd_sized(type, 32, 16) \
+  intra_pred_highbd_sized(type, 32, 32)
+
+#define smooth_pred_wide_sizes(type, use_v, use_h)       \
+  smooth_pred_sized(type, use_v, use_h, 16, 8)           \
+  smooth_pred_sized(type, use_v, use_h, 16, 16)          \
+  smooth_pred_sized(type, use_v, use_h, 16, 32)          \
+  smooth_pred_sized(type, use_v, use_h, 32, 16)          \
+  smooth_pred_sized(type, use_v, use_h, 32, 32)          \
+  smooth_pred_highbd_sized(type, use_v, use_h, 16, 8)    \
+  smooth_pred_highbd_sized(type, use_v, use_h, 16, 16)   \
+  smooth_pred_highbd_sized(type, use_v, use_h, 16, 32)   \
+  smooth_pred_highbd_sized(type, use_v, use_h, 32, 16)   \
+  smooth_pred_highbd_sized(type, use_v, use_h, 32, 32)
+
+/* clang-format off */
+intra_pred_wide_sizes(paeth)
+smooth_pred_wide_sizes(smooth, 1, 1)
+#if CONFIG_SMOOTH_HV
+smooth_pred_wide_sizes(smooth_v, 1, 0)
+smooth_pred_wide_sizes(smooth_h, 0, 1)
+#endif  // CONFIG_SMOOTH_HV
+/* clang-format on */
+#endif  // CONFIG_ALT_INTRA
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <smmintrin.h>  // SSE4.1
+
+#include "./aom_config.h"
+#include "./aom_dsp_rtcd.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/intrapred_common.h"
+#include "aom_dsp/x86/synonyms.h"
+
+#if CONFIG_ALT_INTRA
+// All predictors work on 16-bit lanes, so the low and high bitdepth versions
+// share the same kernels and only differ in how pixels are loaded and stored.
+
+// -----------------------------------------------------------------------------
+// PAETH_PRED
+
+// Returns the Paeth predictor of eight pixels of one row. |left| holds the
+// left pixel of the row in every lane.
+static INLINE __m128i paeth_8(__m128i left, __m128i top, __m128i top_left) {
+  const __m128i base = _mm_sub_epi16(_mm_add_epi16(top, left), top_left);
+  const __m128i p_left = _mm_abs_epi16(_mm_sub_epi16(base, left));
+  const __m128i p_top = _mm_abs_epi16(_mm_sub_epi16(base, top));
+  const __m128i p_top_left = _mm_abs_epi16(_mm_sub_epi16(base, top_left));
+  const __m128i not_left = _mm_or_si128(_mm_cmpgt_epi16(p_left, p_top),
+                                        _mm_cmpgt_epi16(p_left, p_top_left));
+  const __m128i not_top = _mm_cmpgt_epi16(p_top, p_top_left);
+  const __m128i top_or_top_left = _mm_blendv_epi8(top, top_left, not_top);
+  return _mm_blendv_epi8(left, top_or_top_left, not_left);
+}
+
+static INLINE void paeth_predictor(uint8_t *dst, ptrdiff_t stride, int bw,
+                                   int bh, const uint8_t *above,
+                                   const uint8_t *left) {
+  const __m128i top_left = _mm_set1_epi16(above[-1]);
+  __m128i top[4];
+  int r, c;
+
+  if (bw == 4) {
+    top[0] = _mm_cvtepu8_epi16(xx_loadl_32(above));
+    for (r = 0; r < bh; ++r) {
+      const __m128i pred = paeth_8(_mm_set1_epi16(left[r]), top[0], top_left);
+      xx_storel_32(dst, _mm_packus_epi16(pred, pred));
+      dst += stride;
+    }
+    return;
+  }
+
+  for (c = 0; c < bw; c += 8)
+    top[c >> 3] = _mm_cvtepu8_epi16(xx_loadl_64(above + c));
+
+  for (r = 0; r < bh; ++r) {
+    const __m128i l = _mm_set1_epi16(left[r]);
+    if (bw == 8) {
+      const __m128i pred = paeth_8(l, top[0], top_left);
+      xx_storel_64(dst, _mm_packus_epi16(pred, pred));
+    } else {
+      for (c = 0; c < bw; c += 16) {
+        const __m128i pred_lo = paeth_8(l, top[c >> 3], top_left);
+        const __m128i pred_hi = paeth_8(l, top[(c >> 3) + 1], top_left);
+        xx_storeu_128(dst + c, _mm_packus_epi16(pred_lo, pred_hi));
+      }
+    }
+    dst += stride;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// SMOOTH_PRED, SMOOTH_V_PRED and SMOOTH_H_PRED
+//
+// Each term of the predictor is a pair of a weight w and its complement
+// (scale - w) applied to two pixels, which maps onto _mm_madd_epi16() once the
+// pixels and the weights are interleaved. The weights are at most 256 and the
+// pixels at most 12 bits, so the products fit into the signed 16x16 multiply.
+
+// Interleaves the four 16-bit pixels |p| with the pixel |q| repeated.
+static INLINE __m128i pixel_pairs(__m128i p, int q) {
+  return _mm_unpacklo_epi16(p, _mm_set1_epi16(q));
+}
+
+// Interleaves four weights from |weights| with their complements.
+static INLINE __m128i weight_pairs(const uint8_t *weights) {
+  const __m128i w = _mm_cvtepu8_epi16(xx_loadl_32(weights));
+  const __m128i scale = _mm_set1_epi16(1 << sm_weight_log2_scale);
+  return _mm_unpacklo_epi16(w, _mm_sub_epi16(scale, w));
+}
+
+// Returns the pair (w, scale - w) in every 32-bit lane.
+static INLINE __m128i dup_weight_pair(int w) {
+  return _mm_set1_epi32(((1 << sm_weight_log2_scale) - w) << 16 | w);
+}
+
+// Returns the pair (p, q) in every 32-bit lane.
+static INLINE __m128i dup_pixel_pair(int p, int q) {
+  return _mm_set1_epi32(q << 16 | p);
+}
+
+// Computes the 32-bit predictors of four pixels of one row. Either the
+// vertical (|above_pairs| x |row_weights|) or the horizontal
+// (|left_pair| x |col_weights|) term may be disabled by the caller through
+// |use_v| and |use_h|, which are compile-time constants in every caller.
+static INLINE __m128i smooth_4(__m128i above_pairs, __m128i row_weights,
+                               __m128i left_pair, __m128i col_weights,
+                               int use_v, int use_h) {
+  const int log2_scale = sm_weight_log2_scale + (use_v && use_h);
+  const __m128i round = _mm_set1_epi32(1 << (log2_scale - 1));
+  __m128i sum = round;
+  if (use_v) sum = _mm_add_epi32(sum, _mm_madd_epi16(above_pairs, row_weights));
+  if (use_h) sum = _mm_add_epi32(sum, _mm_madd_epi16(left_pair, col_weights));
+  return _mm_srli_epi32(sum, log2_scale);
+}
+
+// Computes eight 16-bit predictors of one row from the pairs of columns
+// |c| .. |c| + 7.
+static INLINE __m128i smooth_8(const __m128i *above_pairs, __m128i row_weights,
+                               __m128i left_pair, const __m128i *col_weights,
+                               int c, int use_v, int use_h) {
+  const __m128i lo = smooth_4(above_pairs[c >> 2], row_weights, left_pair,
+                              col_weights[c >> 2], use_v, use_h);
+  const __m128i hi =
+      smooth_4(above_pairs[(c >> 2) + 1], row_weights, left_pair,
+               col_weights[(c >> 2) + 1], use_v, use_h);
+  return _mm_packus_epi32(lo, hi);
+}
+
+static INLINE void smooth_predictor(uint8_t *dst, ptrdiff_t stride, int bw,
+                                    int bh, const uint8_t *above,
+                                    const uint8_t *left, int use_v,
+                                    int use_h) {
+  const uint8_t below_pred = left[bh - 1];   // estimated by bottom-left pixel
+  const uint8_t right_pred = above[bw - 1];  // estimated by top-right pixel
+  const uint8_t *const sm_weights_w = aom_sm_weight_arrays + bw;
+  const uint8_t *const sm_weights_h = aom_sm_weight_arrays + bh;
+  __m128i above_pairs[8], col_weights[8];
+  int r, c;
+
+  for (c = 0; c < bw; c += 4) {
+    above_pairs[c >> 2] =
+        pixel_pairs(_mm_cvtepu8_epi16(xx_loadl_32(above + c)), below_pred);
+    col_weights[c >> 2] = weight_pairs(sm_weights_w + c);
+  }
+
+  for (r = 0; r < bh; ++r) {
+    const __m128i row_weights = dup_weight_pair(sm_weights_h[r]);
+    const __m128i left_pair = dup_pixel_pair(left[r], right_pred);
+    if (bw == 4) {
+      const __m128i pred = smooth_4(above_pairs[0], row_weights, left_pair,
+                                    col_weights[0], use_v, use_h);
+      const __m128i pred16 = _mm_packus_epi32(pred, pred);
+      xx_storel_32(dst, _mm_packus_epi16(pred16, pred16));
+    } else if (bw == 8) {
+      const __m128i pred = smooth_8(above_pairs, row_weights, left_pair,
+                                    col_weights, 0, use_v, use_h);
+      xx_storel_64(dst, _mm_packus_epi16(pred, pred));
+    } else {
+      for (c = 0; c < bw; c += 16) {
+        const __m128i pred_lo = smooth_8(above_pairs, row_weights, left_pair,
+                                         col_weights, c, use_v, use_h);
+        const __m128i pred_hi = smooth_8(above_pairs, row_weights, left_pair,
+                                         col_weights, c + 8, use_v, use_h);
+        xx_storeu_128(dst + c, _mm_packus_epi16(pred_lo, pred_hi));
+      }
+    }
+    dst += stride;
+  }
+}
+
+#define intra_pred_sized(type, width, height)                  \
+  void aom_##type##_predictor_##width##x##height##_sse4_1(     \
+      uint8_t *dst, ptrdiff_t stride, const uint8_t *above,    \
+      const uint8_t *left) {                                   \
+    type##_predictor(dst, stride, width, height, above, left); \
+  }
+
+#define smooth_pred_sized(type, use_v, use_h, width, height)                 \
+  void aom_##type##_predictor_##width##x##height##_sse4_1(                   \
+      uint8_t *dst, ptrdiff_t stride, const uint8_t *above,                  \
+      const uint8_t *left) {                                                 \
+    smooth_predictor(dst, stride, width, height, above, left, use_v, use_h); \
+  }
+
+#if CONFIG_HIGHBITDEPTH
+static INLINE void highbd_paeth_predictor(uint16_t *dst, ptrdiff_t stride,
+                                          int bw, int bh, const uint16_t *above,
+                                          const uint16_t *left, int bd) {
+  const __m128i top_left = _mm_set1_epi16(above[-1]);
+  __m128i top[4];
+  int r, c;
+  (void)bd;
+
+  if (bw == 4) {
+    top[0] = xx_loadl_64(above);
+    for (r = 0; r < bh; ++r) {
+      xx_storel_64(dst, paeth_8(_mm_set1_epi16(left[r]), top[0], top_left));
+      dst += stride;
+    }
+    return;
+  }
+
+  for (c = 0; c < bw; c += 8) top[c >> 3] = xx_loadu_128(above + c);
+
+  for (r = 0; r < bh; ++r) {
+    const __m128i l = _mm_set1_epi16(left[r]);
+    for (c = 0; c < bw; c += 8)
+      xx_storeu_128(dst + c, paeth_8(l, top[c >> 3], top_left));
+    dst += stride;
+  }
+}
+
+static INLINE void highbd_smooth_predictor(uint16_t *dst, ptrdiff_t stride,
+                                           int bw, int bh,
+                                           const uint16_t *above,
+                                           const uint16_t *left, int use_v,
+                                           int use_h) {
+  const uint16_t below_pred = left[bh - 1];   // estimated by bottom-left pixel
+  const uint16_t right_pred = above[bw - 1];  // estimated by top-right pixel
+  const uint8_t *const sm_weights_w = aom_sm_weight_arrays + bw;
+  const uint8_t *const sm_weights_h = aom_sm_weight_arrays + bh;
+  __m128i above_pairs[8], col_weights[8];
+  int r, c;
+
+  // The predictor is a weighted average of pixels which are all in range, so
+  // unlike the C version there is no need to clip to the bit depth.
+  for (c = 0; c < bw; c += 4) {
+    above_pairs[c >> 2] = pixel_pairs(xx_loadl_64(above + c), below_pred);
+    col_weights[c >> 2] = weight_pairs(sm_weights_w + c);
+  }
+
+  for (r = 0; r < bh; ++r) {
+    const __m128i row_weights = dup_weight_pair(sm_weights_h[r]);
+    const __m128i left_pair = dup_pixel_pair(left[r], right_pred);
+    if (bw == 4) {
+      const __m128i pred = smooth_4(above_pairs[0], row_weights, left_pair,
+                                    col_weights[0], use_v, use_h);
+      xx_storel_64(dst, _mm_packus_epi32(pred, pred));
+    } else {
+      for (c = 0; c < bw; c += 8)
+        xx_storeu_128(dst + c, smooth_8(above_pairs, row_weights, left_pair,
+                                        col_weights, c, use_v, use_h));
+    }
+    dst += stride;
+  }
+}
+
+#define intra_pred_highbd_sized(type, width, height)                        \
+  void aom_highbd_##type##_predictor_##width##x##height##_sse4_1(           \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,               \
+      const uint16_t *left, int bd) {                                       \
+    highbd_##type##_predictor(dst, stride, width, height, above, left, bd); \
+  }
+
+#define smooth_pred_highbd_sized(type, use_v, use_h, width, height) \
+  void aom_highbd_##type##_predictor_##width##x##height##_sse4_1(   \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,       \
+      const uint16_t *left, int bd) {                               \
+    (void)bd;                                                       \
+    highbd_smooth_predictor(dst, stride, width, height, above, left, \
+                            use_v, use_h);                          \
+  }
+#else
+#define intra_pred_highbd_sized(type, width, height)
+#define smooth_pred_highbd_sized(type, use_v, use_h, width, height)
+#endif  // CONFIG_HIGHBITDEPTH
+
+#define intra_pred_allsizes(type)               \
+  intra_pred_sized(type, 4, 4)                  \
+  intra_pred_sized(type, 4, 8)                  \
+  intra_pred_sized(type, 8, 4)                  \
+  intra_pred_sized(type, 8, 8)                  \
+  intra_pred_sized(type, 8, 16)                 \
+  intra_pred_sized(type, 16, 8)                 \
+  intra_pred_sized(type, 16, 16)                \
+  intra_pred_sized(type, 16, 32)                \
+  intra_pred_sized(type, 32, 16)                \
+  intra_pred_sized(type, 32, 32)                \
+  intra_pred_highbd_sized(type, 4, 4)           \
+  intra_pred_highbd_sized(type, 4, 8)           \
+  intra_pred_highbd_sized(type, 8, 4)           \
+  intra_pred_highbd_sized(type, 8, 8)           \
+  intra_pred_highbd_sized(type, 8, 16)          \
+  intra_pred_highbd_sized(type, 16, 8)          \
+  intra_pred_highbd_sized(type, 16, 16)         \
+  intra_pred_highbd_sized(type, 16, 32)         \
+  intra_pred_highbd_sized(type, 32, 16)         \
+  intra_pred_highbd_sized(type, 32, 32)
+
+#define smooth_pred_allsizes(type, use_v, use_h)          \
+  smooth_pred_sized(type, use_v, use_h, 4, 4)             \
+  smooth_pred_sized(type, use_v, use_h, 4, 8)             \
+  smooth_pred_sized(type, use_v, use_h, 8, 4)             \
+  smooth_pred_sized(type, use_v, use_h, 8, 8)             \
+  smooth_pred_sized(type, use_v, use_h, 8, 16)            \
+  smooth_pred_sized(type, use_v, use_h, 16, 8)            \
+  smooth_pred_sized(type, use_v, use_h, 16, 16)           \
+  smooth_pred_sized(type, use_v, use_h, 16, 32)           \
+  smooth_pred_sized(type, use_v, use_h, 32, 16)           \
+  smooth_pred_sized(type, use_v, use_h, 32, 32)           \
+  smooth_pred_highbd_sized(type, use_v, use_h, 4, 4)      \
+  smooth_pred_highbd_sized(type, use_v, use_h, 4, 8)      \
+  smooth_pred_highbd_sized(type, use_v, use_h, 8, 4)      \
+  smooth_pred_highbd_sized(type, use_v, use_h, 8, 8)      \
+  smooth_pred_highbd_sized(type, use_v, use_h, 8, 16)     \
+  smooth_pred_highbd_sized(type, use_v, use_h, 16, 8)     \
+  smooth_pred_highbd_sized(type, use_v, use_h, 16, 16)    \
+  smooth_pred_highbd_sized(type, use_v, use_h, 16, 32)    \
+  smooth_pred_highbd_sized(type, use_v, use_h, 32, 16)    \
+  smooth_pred_highbd_sized(type, use_v, use_h, 32, 32)
+
+/* clang-format off */
+intra_pred_allsizes(paeth)
+smooth_pred_allsizes(smooth, 1, 1)
+#if CONFIG_SMOOTH_HV
+smooth_pred_allsizes(smooth_v, 1, 0)
+smooth_pred_allsizes(smooth_h, 0, 1)
+#endif  // CONFIG_SMOOTH_HV
+/* clang-format on */
+#endif  // CONFIG_ALT_INTRA
@@ -181,3 +181,167 @@ const AVxWorkerInterface *aom_get_worker_interface(void) {
 }
 
 //------------------------------------------------------------------------------
+
+struct AVxJobDeque {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex_;
+#endif
+  // Slots [head, tail) are pending. Slot k of the deque of worker w holds the
+  // job w + k * num_workers.
+  int head;
+  int tail;
+};
+
+static INLINE void deque_lock(AVxJobDeque *const deque) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&deque->mutex_);
+#else
+  (void)deque;
+#endif
+}
+
+static INLINE void deque_unlock(AVxJobDeque *const deque) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&deque->mutex_);
+#else
+  (void)deque;
+#endif
+}
+
+static int64_t job_queue_elapsed(const AVxJobQueue *const queue) {
+  struct aom_usec_timer timer = queue->timer_;
+  aom_usec_timer_mark(&timer);
+  return aom_usec_timer_elapsed(&timer);
+}
+
+int aom_job_queue_alloc(AVxJobQueue *const queue, int max_workers) {
+  memset(queue, 0, sizeof(*queue));
+  if (max_workers <= 0) return 0;
+  queue->deques_ =
+      (AVxJobDeque *)aom_calloc(max_workers, sizeof(*queue->deques_));
+  queue->stats = (AVxJobStats *)aom_calloc(max_workers, sizeof(*queue->stats));
+  queue->finish_us_ =
+      (int64_t *)aom_calloc(max_workers, sizeof(*queue->finish_us_));
+  if (queue->deques_ == NULL || queue->stats == NULL ||
+      queue->finish_us_ == NULL) {
+    aom_job_queue_free(queue);
+    return 0;
+  }
+#if CONFIG_MULTITHREAD
+  for (; queue->max_workers < max_workers; ++queue->max_workers) {
+    if (pthread_mutex_init(&queue->deques_[queue->max_workers].mutex_, NULL)) {
+      aom_job_queue_free(queue);
+      return 0;
+    }
+  }
+#else
+  queue->max_workers = max_workers;
+#endif
+  return 1;
+}
+
+void aom_job_queue_free(AVxJobQueue *const queue) {
+  if (queue == NULL) return;
+#if CONFIG_MULTITHREAD
+  if (queue->deques_ != NULL) {
+    int i;
+    for (i = 0; i < queue->max_workers; ++i) {
+      pthread_mutex_destroy(&queue->deques_[i].mutex_);
+    }
+  }
+#endif
+  aom_free(queue->deques_);
+  aom_free(queue->stats);
+  aom_free(queue->finish_us_);
+  memset(queue, 0, sizeof(*queue));
+}
+
+void aom_job_queue_reset(AVxJobQueue *const queue, int num_workers,
+                         int num_jobs) {
+  int i;
+  assert(num_workers > 0 && num_workers <= queue->max_workers);
+  queue->num_workers = num_workers;
+  for (i = 0; i < num_workers; ++i) {
+    AVxJobDeque *const deque = &queue->deques_[i];
+    deque->head = 0;
+    deque->tail = i < num_jobs ? (num_jobs - 1 - i) / num_workers + 1 : 0;
+    queue->finish_us_[i] = -1;
+  }
+  aom_usec_timer_start(&queue->timer_);
+}
+
+int aom_job_queue_pop(AVxJobQueue *const queue, int worker, int *const job) {
+  const int num_workers = queue->num_workers;
+  AVxJobDeque *const own = &queue->deques_[worker];
+  AVxJobStats *const stats = &queue->stats[worker];
+  assert(worker >= 0 && worker < num_workers);
+
+  deque_lock(own);
+  if (own->head < own->tail) {
+    *job = worker + own->head++ * num_workers;
+    deque_unlock(own);
+    ++stats->jobs;
+    return 1;
+  }
+  deque_unlock(own);
+
+  // Out of own jobs: steal from the back of the most loaded deque. Deques
+  // only ever shrink, so a lost race just means looking again.
+  for (;;) {
+    int victim = -1;
+    int most = 0;
+    int i;
+    for (i = 1; i < num_workers; ++i) {
+      const int w = (worker + i) % num_workers;
+      AVxJobDeque *const deque = &queue->deques_[w];
+      int left;
+      deque_lock(deque);
+      left = deque->tail - deque->head;
+      deque_unlock(deque);
+      if (left > most) {
+        most = left;
+        victim = w;
+      }
+    }
+    if (victim < 0) break;
+    {
+      AVxJobDeque *const deque = &queue->deques_[victim];
+      deque_lock(deque);
+      if (deque->head < deque->tail) {
+        *job = victim + --deque->tail * num_workers;
+        deque_unlock(deque);
+        ++stats->jobs;
+        ++stats->steals;
+        return 1;
+      }
+      deque_unlock(deque);
+    }
+  }
+
+  if (queue->finish_us_[worker] < 0)
+    queue->finish_us_[worker] = job_queue_elapsed(queue);
+  return 0;
+}
+
+void aom_job_queue_finish(AVxJobQueue *const queue) {
+  const int64_t now = job_queue_elapsed(queue);
+  int64_t span = 0;
+  int i;
+
+  for (i = 0; i < queue->num_workers; ++i) {
+    // A worker that bailed out early never asked for more work.
+    if (queue->finish_us_[i] < 0) queue->finish_us_[i] = now;
+    if (queue->finish_us_[i] > span) span = queue->finish_us_[i];
+  }
+  for (i = 0; i < queue->num_workers; ++i) {
+    queue->stats[i].busy_us += queue->finish_us_[i];
+    queue->stats[i].idle_us += span - queue->finish_us_[i];
+  }
+}
+
+void aom_job_queue_clear_stats(AVxJobQueue *const queue) {
+  if (queue->stats != NULL)
+    memset(queue->stats, 0, queue->max_workers * sizeof(*queue->stats));
+}
+
+//------------------------------------------------------------------------------
@@ -18,14 +18,17 @@
 #define AOM_THREAD_H_
 
 #include "./aom_config.h"
+#include "aom/aom_integer.h"
+#include "aom_ports/aom_timer.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// Set maximum decode threads to be 8 due to the limit of frame buffers
-// and not enough semaphores in the emulation layer on windows.
-#define MAX_DECODE_THREADS 8
+// Maximum number of frame parallel decoding threads. The frame buffer pool
+// grows with the number of threads, and the semaphores of the condition
+// variable emulation on windows are created with this maximum count.
+#define MAX_DECODE_THREADS 64
 
 #if CONFIG_MULTITHREAD
 
@@ -403,6 +406,61 @@ int aom_set_worker_interface(const AVxWorkerInterface *const winterface);
 // Retrieve the currently set thread worker interface.
 const AVxWorkerInterface *aom_get_worker_interface(void);
 
+//------------------------------------------------------------------------------
+// Job queue with work stealing
+
+// Per-worker load counters of an AVxJobQueue. They accumulate over all the
+// runs of the queue until cleared with aom_job_queue_clear_stats(). Builds
+// with CONFIG_INTERNAL_STATS write those of the encoder and decoder queues to
+// jobs.stt and dec_jobs.stt when the codec is destroyed.
+typedef struct {
+  int64_t busy_us;  // time from the start of a run until out of jobs
+  int64_t idle_us;  // time spent waiting for the slowest worker of a run
+  int jobs;         // number of jobs executed
+  int steals;       // number of jobs taken from another worker's deque
+} AVxJobStats;
+
+// Platform-dependent per-worker deque of the job queue.
+typedef struct AVxJobDeque AVxJobDeque;
+
+// Distributes the jobs 0 .. num_jobs - 1 of a run over per-worker deques.
+// Job j goes to the deque of worker j % num_workers, so each deque holds its
+// jobs in ascending order. A worker takes jobs from the front of its own
+// deque and, once it runs dry, steals from the back of the most loaded deque
+// of another worker. As long as a job only waits on lower numbered jobs (as
+// in the row based wavefronts) this order can not deadlock.
+typedef struct {
+  AVxJobDeque *deques_;
+  AVxJobStats *stats;
+  int max_workers;
+  int num_workers;
+  int64_t *finish_us_;
+  struct aom_usec_timer timer_;
+} AVxJobQueue;
+
+// Allocates a queue usable by up to max_workers workers. Returns false in
+// case of error.
+int aom_job_queue_alloc(AVxJobQueue *const queue, int max_workers);
+
+// Frees the queue. Safe to call on a zeroed or already freed queue.
+void aom_job_queue_free(AVxJobQueue *const queue);
+
+// Starts a new run of num_jobs jobs shared by the first num_workers workers.
+// Must be called before the workers are launched.
+void aom_job_queue_reset(AVxJobQueue *const queue, int num_workers,
+                         int num_jobs);
+
+// Fetches the next job for 'worker' into *job. Returns false once there are no
+// jobs left in any deque. Thread-safe.
+int aom_job_queue_pop(AVxJobQueue *const queue, int worker, int *const job);
+
+// Ends the current run and updates the idle counters. Must be called after
+// all the workers of the run have been synced.
+void aom_job_queue_finish(AVxJobQueue *const queue);
+
+// Clears the per-worker load counters.
+void aom_job_queue_clear_stats(AVxJobQueue *const queue);
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus
@@ -85,6 +85,8 @@ static const arg_def_t threadsarg =
     ARG_DEF("t", "threads", 1, "Max threads to use");
 static const arg_def_t frameparallelarg =
     ARG_DEF(NULL, "frame-parallel", 0, "Frame parallel decode");
+static const arg_def_t rowmtarg =
+    ARG_DEF(NULL, "row-mt", 1, "Row based multi-threading (0: off, 1: on)");
 static const arg_def_t verbosearg =
     ARG_DEF("v", "verbose", 0, "Show version string");
 static const arg_def_t error_concealment =
@@ -126,6 +128,7 @@ static const arg_def_t *all_args[] = { &codecarg,
                                        &outputfile,
                                        &threadsarg,
                                        &frameparallelarg,
+                                       &rowmtarg,
                                        &verbosearg,
                                        &scalearg,
                                        &fb_arg,
@@ -504,7 +507,7 @@ static int main_loop(int argc, const char **argv_) {
   size_t bytes_in_buffer = 0, buffer_size = 0;
   FILE *infile;
   int frame_in = 0, frame_out = 0, flipuv = 0, noblit = 0;
-  int do_md5 = 0, progress = 0, frame_parallel = 0;
+  int do_md5 = 0, progress = 0, frame_parallel = 0, row_mt = -1;
   int stop_after = 0, postproc = 0, summary = 0, quiet = 1;
   int arg_skip = 0;
   int ec_enabled = 0;
@@ -610,6 +613,8 @@ static int main_loop(int argc, const char **argv_) {
 #if CONFIG_AV1_DECODER
     else if (arg_match(&arg, &frameparallelarg, argi))
       frame_parallel = 1;
+    else if (arg_match(&arg, &rowmtarg, argi))
+      row_mt = arg_parse_uint(&arg);
 #endif
     else if (arg_match(&arg, &verbosearg, argi))
       quiet = 0;
@@ -730,6 +735,14 @@ static int main_loop(int argc, const char **argv_) {
 
   if (!quiet) fprintf(stderr, "%s\n", decoder.name);
 
+#if CONFIG_AV1_DECODER
+  if (row_mt >= 0 &&
+      aom_codec_control(&decoder, AV1D_SET_ROW_MT, row_mt)) {
+    fprintf(stderr, "Failed to set row_mt: %s\n", aom_codec_error(&decoder));
+    goto fail;
+  }
+#endif
+
 #if CONFIG_AV1_DECODER && CONFIG_EXT_TILE
   if (aom_codec_control(&decoder, AV1_SET_DECODE_TILE_ROW, tile_row)) {
     fprintf(stderr, "Failed to set decode_tile_row: %s\n",
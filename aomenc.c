@@ -48,6 +48,7 @@
 #include "aom_dsp/aom_dsp_common.h"
 #include "aom_ports/aom_timer.h"
 #include "aom_ports/mem_ops.h"
+#include "aom_util/aom_thread.h"
 #if CONFIG_WEBM_IO
 #include "./webmenc.h"
 #endif
@@ -155,6 +156,12 @@ static const arg_def_t limit =
     ARG_DEF(NULL, "limit", 1, "Stop encoding after n input frames");
 static const arg_def_t skip =
     ARG_DEF(NULL, "skip", 1, "Skip the first n input frames");
+static const arg_def_t fp_chunks =
+    ARG_DEF(NULL, "fp-chunks", 1,
+            "Code the first pass as n chunks of the input in parallel");
+static const arg_def_t fp_chunk_warmup =
+    ARG_DEF(NULL, "fp-chunk-warmup", 1,
+            "Frames coded before each first pass chunk (default 8)");
 static const arg_def_t deadline =
     ARG_DEF("d", "deadline", 1, "Deadline per frame (usec)");
 static const arg_def_t good_dl =
@@ -214,6 +221,8 @@ static const arg_def_t *main_args[] = { &debugmode,
                                         &fpf_name,
                                         &limit,
                                         &skip,
+                                        &fp_chunks,
+                                        &fp_chunk_warmup,
                                         &deadline,
                                         &good_dl,
                                         &quietarg,
@@ -387,6 +396,9 @@ static const arg_def_t tile_encoding_mode =
 static const arg_def_t tile_dependent_rows =
     ARG_DEF(NULL, "tile-dependent-rows", 1, "Enable dependent Tile rows");
 #endif
+static const arg_def_t row_mt =
+    ARG_DEF(NULL, "row-mt", 1,
+            "Enable row based multi-threading (0: off (default), 1: on)");
 #if CONFIG_LOOPFILTERING_ACROSS_TILES
 static const arg_def_t tile_loopfilter = ARG_DEF(
     NULL, "tile-loopfilter", 1, "Enable loop filter across tile boundary");
@@ -525,6 +537,7 @@ static const arg_def_t *av1_args[] = { &cpu_used_av1,
                                        &static_thresh,
                                        &tile_cols,
                                        &tile_rows,
+                                       &row_mt,
 #if CONFIG_EXT_TILE
                                        &tile_encoding_mode,
 #endif
@@ -583,6 +596,7 @@ static const int av1_arg_ctrl_map[] = { AOME_SET_CPUUSED,
                                         AOME_SET_STATIC_THRESHOLD,
                                         AV1E_SET_TILE_COLUMNS,
                                         AV1E_SET_TILE_ROWS,
+                                        AV1E_SET_ROW_MT,
 #if CONFIG_EXT_TILE
                                         AV1E_SET_TILE_ENCODING_MODE,
 #endif
@@ -750,6 +764,7 @@ static void parse_global_config(struct AvxEncoderConfig *global, char **argv) {
   global->codec = get_aom_encoder_by_index(num_encoder - 1);
   global->passes = 0;
   global->color_type = I420;
+  global->fp_chunk_warmup = 8;
   /* Assign default deadline to good quality */
   global->deadline = AOM_DL_GOOD_QUALITY;
 
@@ -794,6 +809,10 @@ static void parse_global_config(struct AvxEncoderConfig *global, char **argv) {
       global->limit = arg_parse_uint(&arg);
     else if (arg_match(&arg, &skip, argi))
       global->skip_frames = arg_parse_uint(&arg);
+    else if (arg_match(&arg, &fp_chunks, argi))
+      global->fp_chunks = arg_parse_uint(&arg);
+    else if (arg_match(&arg, &fp_chunk_warmup, argi))
+      global->fp_chunk_warmup = arg_parse_uint(&arg);
     else if (arg_match(&arg, &psnrarg, argi))
       global->show_psnr = 1;
     else if (arg_match(&arg, &recontest, argi))
@@ -1685,6 +1704,232 @@ static void test_decode(struct stream_state *stream,
   aom_img_free(&dec_img);
 }
 
+/* One chunk of a first pass coded in parallel, see --fp-chunks. */
+struct fp_chunk {
+  struct stream_state stream;
+  struct AvxInputContext input;
+  struct AvxEncoderConfig *global;
+  AVxWorker worker;
+  /* Coded frames of the chunk, counted from the first frame after --skip */
+  int start;
+  int end;
+  int use_16bit_internal;
+  int input_shift;
+  /* Statistics packets written to stream.stats, and their size */
+  int packets;
+  size_t pkt_sz;
+};
+
+/* Number of frames the first pass codes: the input frames up to --limit,
+ * minus the --skip ones.
+ */
+static int count_input_frames(const struct AvxInputContext *input,
+                              const struct AvxEncoderConfig *global) {
+  struct AvxInputContext ctx = *input;
+  aom_image_t img;
+  int frames = 0;
+
+  open_input_file(&ctx);
+  if (ctx.file_type == FILE_TYPE_Y4M)
+    memset(&img, 0, sizeof(img));
+  else
+    aom_img_alloc(&img, ctx.fmt, ctx.width, ctx.height, 32);
+
+  while ((!global->limit || frames < global->limit) && read_frame(&ctx, &img))
+    frames++;
+
+  aom_img_free(&img);
+  close_input_file(&ctx);
+  return AOMMAX(frames - global->skip_frames, 0);
+}
+
+static void get_chunk_stats(struct fp_chunk *chunk) {
+  struct stream_state *const stream = &chunk->stream;
+  aom_codec_iter_t iter = NULL;
+  const aom_codec_cx_pkt_t *pkt;
+
+  while ((pkt = aom_codec_get_cx_data(&stream->encoder, &iter))) {
+    switch (pkt->kind) {
+      case AOM_CODEC_STATS_PKT:
+        stats_write(&stream->stats, pkt->data.twopass_stats.buf,
+                    pkt->data.twopass_stats.sz);
+        chunk->pkt_sz = pkt->data.twopass_stats.sz;
+        chunk->packets++;
+        break;
+#if CONFIG_FP_MB_STATS
+      case AOM_CODEC_FPMB_STATS_PKT:
+        stats_write(&stream->fpmb_stats, pkt->data.firstpass_mb_stats.buf,
+                    pkt->data.firstpass_mb_stats.sz);
+        break;
+#endif
+      default: break;
+    }
+  }
+}
+
+static int fp_chunk_worker_hook(void *arg1, void *unused) {
+  struct fp_chunk *const chunk = (struct fp_chunk *)arg1;
+  struct stream_state *const stream = &chunk->stream;
+  struct AvxInputContext *const input = &chunk->input;
+  const int skip_frames = chunk->global->skip_frames;
+  /* A chunk after the first one also codes the warm-up frames before it. */
+  const int first = AOMMAX(chunk->start - chunk->global->fp_chunk_warmup, 0);
+  aom_image_t raw;
+#if CONFIG_HIGHBITDEPTH
+  aom_image_t raw_shift;
+  int allocated_raw_shift = 0;
+#endif
+  int i;
+  (void)unused;
+
+  open_input_file(input);
+  if (input->file_type == FILE_TYPE_Y4M)
+    memset(&raw, 0, sizeof(raw));
+  else
+    aom_img_alloc(&raw, input->fmt, input->width, input->height, 32);
+
+  for (i = 0; i < skip_frames + first; i++)
+    if (!read_frame(input, &raw)) break;
+
+  for (i = first; i < chunk->end && read_frame(input, &raw); i++) {
+    aom_image_t *frame_to_encode = &raw;
+#if CONFIG_HIGHBITDEPTH
+    if (chunk->input_shift ||
+        (chunk->use_16bit_internal && input->bit_depth == 8)) {
+      if (!allocated_raw_shift) {
+        aom_img_alloc(&raw_shift, raw.fmt | AOM_IMG_FMT_HIGHBITDEPTH,
+                      input->width, input->height, 32);
+        allocated_raw_shift = 1;
+      }
+      aom_img_upshift(&raw_shift, &raw, chunk->input_shift);
+      frame_to_encode = &raw_shift;
+    }
+#endif
+    encode_frame(stream, chunk->global, frame_to_encode, skip_frames + i + 1);
+    get_chunk_stats(chunk);
+  }
+
+  /* Flush, which also gives the packet with the total of the chunk. */
+  encode_frame(stream, chunk->global, NULL, skip_frames + i);
+  get_chunk_stats(chunk);
+
+#if CONFIG_HIGHBITDEPTH
+  if (allocated_raw_shift) aom_img_free(&raw_shift);
+#endif
+  aom_img_free(&raw);
+  close_input_file(input);
+  return 1;
+}
+
+/* Codes the first pass of 'stream' as up to --fp-chunks chunks of the input,
+ * each with its own encoder and thread, and stitches their statistics
+ * together as described at AV1E_SET_FIRST_PASS_CHUNK_START. Returns the
+ * number of frames coded.
+ */
+static int chunked_first_pass(struct stream_state *stream,
+                              struct AvxEncoderConfig *global,
+                              const struct AvxInputContext *input,
+                              int use_16bit_internal, int input_shift) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const int frames = count_input_frames(input, global);
+  const int num_chunks = AOMMAX(AOMMIN(global->fp_chunks, frames), 1);
+  struct fp_chunk *const chunks = calloc(num_chunks, sizeof(*chunks));
+  double *total = NULL;
+  size_t pkt_sz = 0;
+  int i;
+
+  if (!chunks) fatal("Failed to allocate first pass chunks");
+
+  for (i = 0; i < num_chunks; i++) {
+    struct fp_chunk *const chunk = &chunks[i];
+
+    chunk->stream = *stream;
+    chunk->stream.img = NULL;
+    chunk->input = *input;
+    chunk->global = global;
+    chunk->start = (int)((int64_t)i * frames / num_chunks);
+    chunk->end = (int)((int64_t)(i + 1) * frames / num_chunks);
+    chunk->use_16bit_internal = use_16bit_internal;
+    chunk->input_shift = input_shift;
+
+    memset(&chunk->stream.stats, 0, sizeof(chunk->stream.stats));
+    if (!stats_open_mem(&chunk->stream.stats, 0))
+      fatal("Failed to open statistics store");
+#if CONFIG_FP_MB_STATS
+    memset(&chunk->stream.fpmb_stats, 0, sizeof(chunk->stream.fpmb_stats));
+    if (!stats_open_mem(&chunk->stream.fpmb_stats, 0))
+      fatal("Failed to open mb statistics store");
+#endif
+    initialize_encoder(&chunk->stream, global);
+    if (chunk->start > 0) {
+      aom_codec_control(&chunk->stream.encoder,
+                        AV1E_SET_FIRST_PASS_CHUNK_START, chunk->start);
+      aom_codec_control(&chunk->stream.encoder,
+                        AV1E_SET_FIRST_PASS_CHUNK_WARMUP,
+                        global->fp_chunk_warmup);
+      ctx_exit_on_error(&chunk->stream.encoder,
+                        "Failed to set the first pass chunk");
+    }
+
+    winterface->init(&chunk->worker);
+    chunk->worker.hook = fp_chunk_worker_hook;
+    chunk->worker.data1 = chunk;
+    chunk->worker.data2 = NULL;
+  }
+
+  /* The last chunk is coded on this thread. */
+  for (i = 0; i < num_chunks - 1; i++) {
+    if (!winterface->reset(&chunks[i].worker))
+      fatal("Failed to create first pass thread");
+    winterface->launch(&chunks[i].worker);
+  }
+  winterface->execute(&chunks[num_chunks - 1].worker);
+
+  for (i = 0; i < num_chunks; i++) {
+    struct fp_chunk *const chunk = &chunks[i];
+    const char *const buf = (const char *)chunk->stream.stats.buf.buf;
+    const double *last;
+    size_t k;
+
+    if (!winterface->sync(&chunk->worker) || chunk->packets < 1)
+      fatal("Failed to code first pass chunk %d", i);
+    winterface->end(&chunk->worker);
+
+    if (!total) {
+      pkt_sz = chunk->pkt_sz;
+      total = calloc(pkt_sz / sizeof(*total), sizeof(*total));
+      if (!total) fatal("Failed to allocate first pass statistics");
+    }
+
+    /* The last packet of the chunk holds its total. */
+    stats_write(&stream->stats, buf, (chunk->packets - 1) * pkt_sz);
+    last = (const double *)(buf + (chunk->packets - 1) * pkt_sz);
+    for (k = 0; k < pkt_sz / sizeof(*total); k++) total[k] += last[k];
+    stream->frames_out += chunk->packets - 1;
+    stream->nbytes += (chunk->packets - 1) * pkt_sz;
+
+#if CONFIG_FP_MB_STATS
+    stats_write(&stream->fpmb_stats, chunk->stream.fpmb_stats.buf.buf,
+                chunk->stream.fpmb_stats.buf.sz);
+    stream->nbytes += chunk->stream.fpmb_stats.buf.sz;
+    stats_close(&chunk->stream.fpmb_stats, 0);
+#endif
+    stats_close(&chunk->stream.stats, 0);
+    aom_codec_destroy(&chunk->stream.encoder);
+    if (global->test_decode != TEST_DECODE_OFF)
+      aom_codec_destroy(&chunk->stream.decoder);
+    if (chunk->stream.img) aom_img_free(chunk->stream.img);
+  }
+
+  stats_write(&stream->stats, total, pkt_sz);
+  stream->frames_out++;
+  stream->nbytes += pkt_sz;
+
+  free(total);
+  free(chunks);
+  return frames;
+}
+
 static void print_time(const char *label, int64_t etl) {
   int64_t hours;
   int64_t mins;
@@ -1967,6 +2212,27 @@ int main(int argc, const char **argv_) {
     frame_avail = 1;
     got_data = 0;
 
+    if (pass == 0 && global.passes == 2 && global.fp_chunks > 1) {
+      struct aom_usec_timer timer;
+
+      if (stream_cnt > 1) die("Error: --fp-chunks needs a single stream\n");
+      if (!strcmp(input.filename, "-"))
+        die("Error: --fp-chunks cannot read the input from stdin\n");
+
+      aom_usec_timer_start(&timer);
+#if CONFIG_HIGHBITDEPTH
+      seen_frames = chunked_first_pass(streams, &global, &input,
+                                       use_16bit_internal, input_shift);
+#else
+      seen_frames = chunked_first_pass(streams, &global, &input, 0, 0);
+#endif
+      aom_usec_timer_mark(&timer);
+      cx_time += aom_usec_timer_elapsed(&timer);
+      streams->cx_time += aom_usec_timer_elapsed(&timer);
+      frames_in = global.skip_frames + seen_frames;
+      frame_avail = 0;
+    }
+
     while (frame_avail || got_data) {
       struct aom_usec_timer timer;
 
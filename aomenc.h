@@ -56,6 +56,8 @@ struct AvxEncoderConfig {
   int disable_warnings;
   int disable_warning_prompt;
   int experimental_bitstream;
+  int fp_chunks;
+  int fp_chunk_warmup;
 };
 
 #ifdef __cplusplus
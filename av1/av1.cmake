@@ -175,8 +175,7 @@ set(AOM_AV1_COMMON_INTRIN_MSA
 
 set(AOM_AV1_ENCODER_ASM_SSE2
     "${AOM_ROOT}/av1/encoder/x86/dct_sse2.asm"
-    "${AOM_ROOT}/av1/encoder/x86/error_sse2.asm"
-    "${AOM_ROOT}/av1/encoder/x86/temporal_filter_apply_sse2.asm")
+    "${AOM_ROOT}/av1/encoder/x86/error_sse2.asm")
 
 set(AOM_AV1_ENCODER_INTRIN_SSE2
     "${AOM_ROOT}/av1/encoder/x86/dct_intrin_sse2.c"
@@ -189,10 +188,16 @@ set(AOM_AV1_ENCODER_ASM_SSSE3_X86_64
 set(AOM_AV1_ENCODER_INTRIN_SSSE3
     "${AOM_ROOT}/av1/encoder/x86/dct_ssse3.c")
 
+set(AOM_AV1_ENCODER_INTRIN_SSE4_1
+    "${AOM_ROOT}/av1/encoder/x86/temporal_filter_simd.h"
+    "${AOM_ROOT}/av1/encoder/x86/temporal_filter_sse4.c")
+
 set(AOM_AV1_ENCODER_INTRIN_AVX2
     "${AOM_ROOT}/av1/encoder/x86/av1_quantize_avx2.c"
     "${AOM_ROOT}/av1/encoder/x86/error_intrin_avx2.c"
-    "${AOM_ROOT}/av1/encoder/x86/hybrid_fwd_txfm_avx2.c")
+    "${AOM_ROOT}/av1/encoder/x86/hybrid_fwd_txfm_avx2.c"
+    "${AOM_ROOT}/av1/encoder/x86/temporal_filter_avx2.c"
+    "${AOM_ROOT}/av1/encoder/x86/temporal_filter_simd.h")
 set(AOM_AV1_ENCODER_INTRIN_NEON
     "${AOM_ROOT}/av1/encoder/arm/neon/quantize_neon.c")
 
@@ -201,8 +206,7 @@ set(AOM_AV1_ENCODER_INTRIN_MSA
     "${AOM_ROOT}/av1/encoder/mips/msa/fdct16x16_msa.c"
     "${AOM_ROOT}/av1/encoder/mips/msa/fdct4x4_msa.c"
     "${AOM_ROOT}/av1/encoder/mips/msa/fdct8x8_msa.c"
-    "${AOM_ROOT}/av1/encoder/mips/msa/fdct_msa.h"
-    "${AOM_ROOT}/av1/encoder/mips/msa/temporal_filter_msa.c")
+    "${AOM_ROOT}/av1/encoder/mips/msa/fdct_msa.h")
 
 if (CONFIG_HIGHBITDEPTH)
   set(AOM_AV1_COMMON_INTRIN_SSE4_1
@@ -266,6 +270,10 @@ if (CONFIG_CDEF)
       "${AOM_ROOT}/av1/common/clpf_sse4.c"
       "${AOM_ROOT}/av1/common/od_dering_sse4.c")
 
+  set(AOM_AV1_COMMON_INTRIN_AVX2
+      ${AOM_AV1_COMMON_INTRIN_AVX2}
+      "${AOM_ROOT}/av1/common/od_dering_avx2.c")
+
   set(AOM_AV1_COMMON_INTRIN_NEON
       ${AOM_AV1_COMMON_INTRIN_NEON}
       "${AOM_ROOT}/av1/common/clpf_neon.c"
@@ -311,9 +319,17 @@ if (CONFIG_GLOBAL_MOTION)
       "${AOM_ROOT}/third_party/fastfeat/fast.h"
       "${AOM_ROOT}/third_party/fastfeat/nonmax.c")
 
+  set(AOM_AV1_ENCODER_INTRIN_SSE2
+      ${AOM_AV1_ENCODER_INTRIN_SSE2}
+      "${AOM_ROOT}/av1/encoder/x86/ransac_sse2.c")
+
   set(AOM_AV1_ENCODER_INTRIN_SSE4_1
       ${AOM_AV1_ENCODER_INTRIN_SSE4_1}
       "${AOM_ROOT}/av1/encoder/x86/corner_match_sse4.c")
+
+  set(AOM_AV1_ENCODER_INTRIN_AVX2
+      ${AOM_AV1_ENCODER_INTRIN_AVX2}
+      "${AOM_ROOT}/av1/encoder/x86/ransac_avx2.c")
 endif ()
 
 if (CONFIG_INSPECTION)
@@ -353,10 +369,18 @@ if (CONFIG_LOOP_RESTORATION)
       ${AOM_AV1_COMMON_INTRIN_SSE4_1}
       "${AOM_ROOT}/av1/common/x86/selfguided_sse4.c")
 
+  set(AOM_AV1_COMMON_INTRIN_AVX2
+      ${AOM_AV1_COMMON_INTRIN_AVX2}
+      "${AOM_ROOT}/av1/common/x86/selfguided_avx2.c")
+
   set(AOM_AV1_ENCODER_SOURCES
       ${AOM_AV1_ENCODER_SOURCES}
       "${AOM_ROOT}/av1/encoder/pickrst.c"
       "${AOM_ROOT}/av1/encoder/pickrst.h")
+
+  set(AOM_AV1_ENCODER_INTRIN_AVX2
+      ${AOM_AV1_ENCODER_INTRIN_AVX2}
+      "${AOM_ROOT}/av1/encoder/x86/pickrst_avx2.c")
 endif ()
 
 if (CONFIG_PVQ)
@@ -435,6 +459,10 @@ if (CONFIG_WARPED_MOTION OR CONFIG_GLOBAL_MOTION)
       ${AOM_AV1_COMMON_INTRIN_SSSE3}
       "${AOM_ROOT}/av1/common/x86/warp_plane_ssse3.c")
 
+  set(AOM_AV1_COMMON_INTRIN_AVX2
+      ${AOM_AV1_COMMON_INTRIN_AVX2}
+      "${AOM_ROOT}/av1/common/x86/warp_plane_avx2.c")
+
   if (CONFIG_HIGHBITDEPTH)
     set(AOM_AV1_COMMON_INTRIN_SSSE3
         ${AOM_AV1_COMMON_INTRIN_SSSE3}
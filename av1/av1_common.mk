@@ -81,6 +81,7 @@ ifeq ($(CONFIG_LOOP_RESTORATION),yes)
 AV1_COMMON_SRCS-yes += common/restoration.h
 AV1_COMMON_SRCS-yes += common/restoration.c
 AV1_COMMON_SRCS-$(HAVE_SSE4_1) += common/x86/selfguided_sse4.c
+AV1_COMMON_SRCS-$(HAVE_AVX2) += common/x86/selfguided_avx2.c
 endif
 ifeq (yes,$(filter $(CONFIG_GLOBAL_MOTION) $(CONFIG_WARPED_MOTION),yes))
 AV1_COMMON_SRCS-yes += common/warped_motion.h
@@ -98,6 +99,7 @@ AV1_COMMON_SRCS-$(HAVE_NEON) += common/clpf_neon.c
 AV1_COMMON_SRCS-$(HAVE_SSE2) += common/od_dering_sse2.c
 AV1_COMMON_SRCS-$(HAVE_SSSE3) += common/od_dering_ssse3.c
 AV1_COMMON_SRCS-$(HAVE_SSE4_1) += common/od_dering_sse4.c
+AV1_COMMON_SRCS-$(HAVE_AVX2) += common/od_dering_avx2.c
 AV1_COMMON_SRCS-$(HAVE_NEON) += common/od_dering_neon.c
 AV1_COMMON_SRCS-yes += common/od_dering.c
 AV1_COMMON_SRCS-yes += common/od_dering.h
@@ -171,6 +173,7 @@ endif
 ifneq ($(findstring yes,$(CONFIG_GLOBAL_MOTION) $(CONFIG_WARPED_MOTION)),)
 AV1_COMMON_SRCS-$(HAVE_SSE2) += common/x86/warp_plane_sse2.c
 AV1_COMMON_SRCS-$(HAVE_SSSE3) += common/x86/warp_plane_ssse3.c
+AV1_COMMON_SRCS-$(HAVE_AVX2) += common/x86/warp_plane_avx2.c
 ifeq ($(CONFIG_HIGHBITDEPTH),yes)
 AV1_COMMON_SRCS-$(HAVE_SSSE3) += common/x86/highbd_warp_plane_ssse3.c
 endif
@@ -18,6 +18,7 @@
 #include "aom_ports/system_state.h"
 #include "aom/internal/aom_codec_internal.h"
 #include "./aom_version.h"
+#include "av1/common/alloccommon.h"
 #include "av1/encoder/encoder.h"
 #include "aom/aomcx.h"
 #include "av1/encoder/firstpass.h"
@@ -34,6 +35,9 @@ struct av1_extracfg {
   unsigned int static_thresh;
   unsigned int tile_columns;
   unsigned int tile_rows;
+  unsigned int row_mt;
+  unsigned int first_pass_chunk_start;
+  unsigned int first_pass_chunk_warmup;
 #if CONFIG_DEPENDENT_HORZTILES
   unsigned int dependent_horz_tiles;
 #endif
@@ -105,6 +109,9 @@ static struct av1_extracfg default_extra_cfg = {
   0,  // tile_columns
   0,  // tile_rows
 #endif  // CONFIG_EXT_TILE
+  0,  // row_mt
+  0,  // first_pass_chunk_start
+  1,  // first_pass_chunk_warmup
 #if CONFIG_DEPENDENT_HORZTILES
   0,  // Dependent Horizontal tiles
 #endif
@@ -236,6 +243,8 @@ static aom_codec_err_t validate_config(aom_codec_alg_priv_t *ctx,
   RANGE_CHECK(extra_cfg, deltaq_mode, 0, DELTAQ_MODE_COUNT - 1);
 #endif
   RANGE_CHECK_HI(extra_cfg, frame_periodic_boost, 1);
+  RANGE_CHECK_BOOL(extra_cfg, row_mt);
+  RANGE_CHECK(extra_cfg, first_pass_chunk_warmup, 1, MAX_LAG_BUFFERS);
   RANGE_CHECK_HI(cfg, g_threads, 64);
   RANGE_CHECK_HI(cfg, g_lag_in_frames, MAX_LAG_BUFFERS);
   RANGE_CHECK(cfg, rc_end_usage, AOM_VBR, AOM_Q);
@@ -578,6 +587,9 @@ static aom_codec_err_t set_encoder_config(
   oxcf->tile_columns = extra_cfg->tile_columns;
   oxcf->tile_rows = extra_cfg->tile_rows;
 #endif  // CONFIG_EXT_TILE
+  oxcf->row_mt = extra_cfg->row_mt;
+  oxcf->first_pass_chunk_start = extra_cfg->first_pass_chunk_start;
+  oxcf->first_pass_chunk_warmup = extra_cfg->first_pass_chunk_warmup;
 #if CONFIG_DEPENDENT_HORZTILES
   oxcf->dependent_horz_tiles = extra_cfg->dependent_horz_tiles;
 #endif
@@ -750,6 +762,29 @@ static aom_codec_err_t ctrl_set_tile_rows(aom_codec_alg_priv_t *ctx,
   extra_cfg.tile_rows = CAST(AV1E_SET_TILE_ROWS, args);
   return update_extra_cfg(ctx, &extra_cfg);
 }
+
+static aom_codec_err_t ctrl_set_row_mt(aom_codec_alg_priv_t *ctx,
+                                       va_list args) {
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.row_mt = CAST(AV1E_SET_ROW_MT, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static aom_codec_err_t ctrl_set_first_pass_chunk_start(
+    aom_codec_alg_priv_t *ctx, va_list args) {
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.first_pass_chunk_start =
+      CAST(AV1E_SET_FIRST_PASS_CHUNK_START, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static aom_codec_err_t ctrl_set_first_pass_chunk_warmup(
+    aom_codec_alg_priv_t *ctx, va_list args) {
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.first_pass_chunk_warmup =
+      CAST(AV1E_SET_FIRST_PASS_CHUNK_WARMUP, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
 #if CONFIG_DEPENDENT_HORZTILES
 static aom_codec_err_t ctrl_set_tile_dependent_rows(aom_codec_alg_priv_t *ctx,
                                                     va_list args) {
@@ -946,6 +981,11 @@ static aom_codec_err_t encoder_init(aom_codec_ctx_t *ctx,
     ctx->priv->enc.total_encoders = 1;
     priv->buffer_pool = (BufferPool *)aom_calloc(1, sizeof(BufferPool));
     if (priv->buffer_pool == NULL) return AOM_CODEC_MEM_ERROR;
+    if (av1_alloc_pool_frame_bufs(priv->buffer_pool, FRAME_BUFFERS)) {
+      aom_free(priv->buffer_pool);
+      priv->buffer_pool = NULL;
+      return AOM_CODEC_MEM_ERROR;
+    }
 
 #if CONFIG_MULTITHREAD
     if (pthread_mutex_init(&priv->buffer_pool->pool_mutex, NULL)) {
@@ -984,10 +1024,13 @@ static aom_codec_err_t encoder_init(aom_codec_ctx_t *ctx,
 static aom_codec_err_t encoder_destroy(aom_codec_alg_priv_t *ctx) {
   free(ctx->cx_data);
   av1_remove_compressor(ctx->cpi);
+  if (ctx->buffer_pool) {
 #if CONFIG_MULTITHREAD
-  pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
+    pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
 #endif
-  aom_free(ctx->buffer_pool);
+    av1_free_pool_frame_bufs(ctx->buffer_pool);
+    aom_free(ctx->buffer_pool);
+  }
   aom_free(ctx);
   return AOM_CODEC_OK;
 }
@@ -1502,6 +1545,9 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AOME_SET_STATIC_THRESHOLD, ctrl_set_static_thresh },
   { AV1E_SET_TILE_COLUMNS, ctrl_set_tile_columns },
   { AV1E_SET_TILE_ROWS, ctrl_set_tile_rows },
+  { AV1E_SET_ROW_MT, ctrl_set_row_mt },
+  { AV1E_SET_FIRST_PASS_CHUNK_START, ctrl_set_first_pass_chunk_start },
+  { AV1E_SET_FIRST_PASS_CHUNK_WARMUP, ctrl_set_first_pass_chunk_warmup },
 #if CONFIG_DEPENDENT_HORZTILES
   { AV1E_SET_TILE_DEPENDENT_ROWS, ctrl_set_tile_dependent_rows },
 #endif
@@ -31,9 +31,8 @@
 
 #include "av1/av1_iface_common.h"
 
-// This limit is due to framebuffer numbers.
-// TODO(hkuang): Remove this limit after implementing ondemand framebuffers.
-#define FRAME_CACHE_SIZE 6  // Cache maximum 6 decoded frames.
+// Cache at least 6 decoded frames, and one per frame worker beyond that.
+#define FRAME_CACHE_SIZE 6
 
 typedef struct cache_frame {
   int fb_idx;
@@ -57,6 +56,7 @@ struct aom_codec_alg_priv {
   int skip_loop_filter;
   int decode_tile_row;
   int decode_tile_col;
+  int row_mt;  // -1 until set: on with more than one thread.
 
   // Frame parallel related.
   int frame_parallel_decode;  // frame-based threading.
@@ -66,7 +66,8 @@ struct aom_codec_alg_priv {
   int last_submit_worker_id;
   int next_output_worker_id;
   int available_threads;
-  cache_frame frame_cache[FRAME_CACHE_SIZE];
+  cache_frame *frame_cache;
+  int frame_cache_size;
   int frame_cache_write;
   int frame_cache_read;
   int num_cache_frames;
@@ -100,6 +101,7 @@ static aom_codec_err_t decoder_init(aom_codec_ctx_t *ctx,
     ctx->priv = (aom_codec_priv_t *)priv;
     ctx->priv->init_flags = ctx->init_flags;
     priv->flushed = 0;
+    priv->row_mt = -1;
     // Only do frame parallel decode when threads > 1.
     priv->frame_parallel_decode =
         (ctx->config.dec && (ctx->config.dec->threads > 1) &&
@@ -143,9 +145,11 @@ static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
   if (ctx->buffer_pool) {
     av1_free_ref_frame_buffers(ctx->buffer_pool);
     av1_free_internal_frame_buffers(&ctx->buffer_pool->int_frame_buffers);
+    av1_free_pool_frame_bufs(ctx->buffer_pool);
   }
 
   aom_free(ctx->frame_workers);
+  aom_free(ctx->frame_cache);
   aom_free(ctx->buffer_pool);
   aom_free(ctx);
   return AOM_CODEC_OK;
@@ -325,7 +329,8 @@ static void init_buffer_callbacks(aom_codec_alg_priv_t *ctx) {
       pool->get_fb_cb = av1_get_frame_buffer;
       pool->release_fb_cb = av1_release_frame_buffer;
 
-      if (av1_alloc_internal_frame_buffers(&pool->int_frame_buffers))
+      if (av1_alloc_internal_frame_buffers(&pool->int_frame_buffers,
+                                           pool->num_frame_bufs))
         aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
                            "Failed to initialize internal frame buffers");
 
@@ -394,9 +399,28 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
   ctx->available_threads = ctx->num_frame_workers;
   ctx->flushed = 0;
 
+  // The decoded frames wait in the cache while all the frame workers are busy.
+  ctx->frame_cache_size = AOMMAX(FRAME_CACHE_SIZE, ctx->num_frame_workers);
+  ctx->frame_cache = (cache_frame *)aom_calloc(ctx->frame_cache_size,
+                                               sizeof(*ctx->frame_cache));
+  if (ctx->frame_cache == NULL) {
+    set_error_detail(ctx, "Failed to allocate frame_cache");
+    return AOM_CODEC_MEM_ERROR;
+  }
+
   ctx->buffer_pool = (BufferPool *)aom_calloc(1, sizeof(BufferPool));
   if (ctx->buffer_pool == NULL) return AOM_CODEC_MEM_ERROR;
 
+  // Room for the references, the frame of each frame worker and the cached
+  // frames.
+  if (av1_alloc_pool_frame_bufs(
+          ctx->buffer_pool,
+          AOMMAX(FRAME_BUFFERS, REF_FRAMES + ctx->num_frame_workers +
+                                    ctx->frame_cache_size))) {
+    set_error_detail(ctx, "Failed to allocate frame buffers");
+    return AOM_CODEC_MEM_ERROR;
+  }
+
 #if CONFIG_MULTITHREAD
   if (pthread_mutex_init(&ctx->buffer_pool->pool_mutex, NULL)) {
     set_error_detail(ctx, "Failed to allocate buffer pool mutex");
@@ -449,6 +473,8 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
     // thread or loopfilter thread.
     frame_worker_data->pbi->max_threads =
         (ctx->frame_parallel_decode == 0) ? ctx->cfg.threads : 0;
+    frame_worker_data->pbi->row_mt =
+        ctx->row_mt >= 0 ? ctx->row_mt : ctx->cfg.threads > 1;
 
     frame_worker_data->pbi->inv_tile_order = ctx->invert_tile_order;
     frame_worker_data->pbi->common.frame_parallel_decode =
@@ -597,7 +623,8 @@ static void wait_worker_and_cache_frame(aom_codec_alg_priv_t *ctx) {
                     frame_worker_data->user_priv);
     ctx->frame_cache[ctx->frame_cache_write].img.fb_priv =
         frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv;
-    ctx->frame_cache_write = (ctx->frame_cache_write + 1) % FRAME_CACHE_SIZE;
+    ctx->frame_cache_write =
+        (ctx->frame_cache_write + 1) % ctx->frame_cache_size;
     ++ctx->num_cache_frames;
   }
 }
@@ -649,7 +676,7 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
         if (ctx->available_threads == 0) {
           // No more threads for decoding. Wait until the next output worker
           // finishes decoding. Then copy the decoded frame into cache.
-          if (ctx->num_cache_frames < FRAME_CACHE_SIZE) {
+          if (ctx->num_cache_frames < ctx->frame_cache_size) {
             wait_worker_and_cache_frame(ctx);
           } else {
             // TODO(hkuang): Add unit test to test this path.
@@ -667,7 +694,7 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
       if (ctx->available_threads == 0) {
         // No more threads for decoding. Wait until the next output worker
         // finishes decoding. Then copy the decoded frame into cache.
-        if (ctx->num_cache_frames < FRAME_CACHE_SIZE) {
+        if (ctx->num_cache_frames < ctx->frame_cache_size) {
           wait_worker_and_cache_frame(ctx);
         } else {
           // TODO(hkuang): Add unit test to test this path.
@@ -747,7 +774,7 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
     ctx->last_show_frame = ctx->frame_cache[ctx->frame_cache_read].fb_idx;
     if (ctx->need_resync) return NULL;
     img = &ctx->frame_cache[ctx->frame_cache_read].img;
-    ctx->frame_cache_read = (ctx->frame_cache_read + 1) % FRAME_CACHE_SIZE;
+    ctx->frame_cache_read = (ctx->frame_cache_read + 1) % ctx->frame_cache_size;
     --ctx->num_cache_frames;
     return img;
   }
@@ -1135,6 +1162,19 @@ static aom_codec_err_t ctrl_set_skip_loop_filter(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_row_mt(aom_codec_alg_priv_t *ctx,
+                                       va_list args) {
+  ctx->row_mt = va_arg(args, int);
+
+  if (ctx->frame_workers) {
+    AVxWorker *const worker = ctx->frame_workers;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    frame_worker_data->pbi->row_mt = ctx->row_mt;
+  }
+
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_get_accounting(aom_codec_alg_priv_t *ctx,
                                            va_list args) {
 #if !CONFIG_ACCOUNTING
@@ -1196,6 +1236,7 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1_SET_DECODE_TILE_ROW, ctrl_set_decode_tile_row },
   { AV1_SET_DECODE_TILE_COL, ctrl_set_decode_tile_col },
   { AV1_SET_INSPECTION_CALLBACK, ctrl_set_inspection_callback },
+  { AV1D_SET_ROW_MT, ctrl_set_row_mt },
 
   // Getters
   { AOMD_GET_FRAME_CORRUPTED, ctrl_get_frame_corrupted },
@@ -74,10 +74,25 @@ static void free_seg_map(AV1_COMMON *cm) {
   }
 }
 
+int av1_alloc_pool_frame_bufs(BufferPool *pool, int num_frame_bufs) {
+  av1_free_pool_frame_bufs(pool);
+  pool->frame_bufs = (RefCntBuffer *)aom_calloc(num_frame_bufs,
+                                                sizeof(*pool->frame_bufs));
+  if (pool->frame_bufs == NULL) return 1;
+  pool->num_frame_bufs = num_frame_bufs;
+  return 0;
+}
+
+void av1_free_pool_frame_bufs(BufferPool *pool) {
+  aom_free(pool->frame_bufs);
+  pool->frame_bufs = NULL;
+  pool->num_frame_bufs = 0;
+}
+
 void av1_free_ref_frame_buffers(BufferPool *pool) {
   int i;
 
-  for (i = 0; i < FRAME_BUFFERS; ++i) {
+  for (i = 0; i < pool->num_frame_bufs; ++i) {
     if (pool->frame_bufs[i].ref_count > 0 &&
         pool->frame_bufs[i].raw_frame_buffer.data != NULL) {
       pool->release_fb_cb(pool->cb_priv, &pool->frame_bufs[i].raw_frame_buffer);
@@ -85,6 +100,11 @@ void av1_free_ref_frame_buffers(BufferPool *pool) {
     }
     aom_free(pool->frame_bufs[i].mvs);
     pool->frame_bufs[i].mvs = NULL;
+#if CONFIG_GLOBAL_MOTION
+    aom_free(pool->frame_bufs[i].corners);
+    pool->frame_bufs[i].corners = NULL;
+    pool->frame_bufs[i].num_corners = -1;
+#endif  // CONFIG_GLOBAL_MOTION
     aom_free_frame_buffer(&pool->frame_bufs[i].buf);
   }
 }
@@ -107,7 +127,9 @@ void av1_alloc_restoration_buffers(AV1_COMMON *cm) {
                                  ROUND_POWER_OF_TWO(height, cm->subsampling_y));
   aom_free(cm->rst_internal.tmpbuf);
   CHECK_MEM_ERROR(cm, cm->rst_internal.tmpbuf,
-                  (int32_t *)aom_memalign(16, RESTORATION_TMPBUF_SIZE));
+                  (int32_t *)aom_memalign(
+                      16, RESTORATION_TMPBUF_SIZE *
+                              sizeof(*cm->rst_internal.tmpbuf)));
 }
 
 void av1_free_restoration_buffers(AV1_COMMON *cm) {
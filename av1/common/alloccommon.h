@@ -27,6 +27,10 @@ int av1_alloc_context_buffers(struct AV1Common *cm, int width, int height);
 void av1_init_context_buffers(struct AV1Common *cm);
 void av1_free_context_buffers(struct AV1Common *cm);
 
+// Allocates the 'num_frame_bufs' frame buffers of 'pool'. Returns 0 on
+// success.
+int av1_alloc_pool_frame_bufs(struct BufferPool *pool, int num_frame_bufs);
+void av1_free_pool_frame_bufs(struct BufferPool *pool);
 void av1_free_ref_frame_buffers(struct BufferPool *pool);
 #if CONFIG_LOOP_RESTORATION
 void av1_alloc_restoration_buffers(struct AV1Common *cm);
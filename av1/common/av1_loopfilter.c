@@ -2381,9 +2381,18 @@ static void av1_filter_block_plane_horz(const AV1_COMMON *const cm,
 }
 #endif  // CONFIG_PARALLEL_DEBLOCKING
 
-void av1_loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
-                          struct macroblockd_plane planes[MAX_MB_PLANE],
-                          int start, int stop, int y_only) {
+void av1_loop_filter_init_rows(AV1_COMMON *cm) {
+#if CONFIG_VAR_TX && !CONFIG_PARALLEL_DEBLOCKING
+  for (int i = 0; i < MAX_MB_PLANE; ++i)
+    memset(cm->top_txfm_context[i], TX_32X32, cm->mi_cols << TX_UNIT_WIDE_LOG2);
+#else
+  (void)cm;
+#endif  // CONFIG_VAR_TX && !CONFIG_PARALLEL_DEBLOCKING
+}
+
+void av1_loop_filter_sb_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
+                             struct macroblockd_plane planes[MAX_MB_PLANE],
+                             int start, int stop, int y_only) {
   const int num_planes = y_only ? 1 : MAX_MB_PLANE;
   int mi_row, mi_col;
 
@@ -2391,10 +2400,6 @@ void av1_loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
     CONFIG_CB4X4
 
 #if !CONFIG_PARALLEL_DEBLOCKING
-#if CONFIG_VAR_TX
-  for (int i = 0; i < MAX_MB_PLANE; ++i)
-    memset(cm->top_txfm_context[i], TX_32X32, cm->mi_cols << TX_UNIT_WIDE_LOG2);
-#endif  // CONFIG_VAR_TX
   for (mi_row = start; mi_row < stop; mi_row += cm->mib_size) {
     MODE_INFO **mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
 #if CONFIG_VAR_TX
@@ -2533,6 +2538,13 @@ void av1_loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
 #endif  // CONFIG_VAR_TX || CONFIG_EXT_PARTITION || CONFIG_EXT_PARTITION_TYPES
 }
 
+void av1_loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
+                          struct macroblockd_plane planes[MAX_MB_PLANE],
+                          int start, int stop, int y_only) {
+  av1_loop_filter_init_rows(cm);
+  av1_loop_filter_sb_rows(frame_buffer, cm, planes, start, stop, y_only);
+}
+
 void av1_loop_filter_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
                            MACROBLOCKD *xd, int frame_filter_level, int y_only,
                            int partial_frame) {
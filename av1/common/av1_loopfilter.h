@@ -139,6 +139,16 @@ void av1_loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer,
                           struct macroblockd_plane planes[MAX_MB_PLANE],
                           int start, int stop, int y_only);
 
+// av1_loop_filter_rows() split in two for callers filtering the frame a few
+// superblock rows at a time: av1_loop_filter_init_rows() resets the context
+// carried from one superblock row to the next, then av1_loop_filter_sb_rows()
+// filters [start, stop) macro block rows, in order.
+void av1_loop_filter_init_rows(struct AV1Common *cm);
+void av1_loop_filter_sb_rows(YV12_BUFFER_CONFIG *frame_buffer,
+                             struct AV1Common *cm,
+                             struct macroblockd_plane planes[MAX_MB_PLANE],
+                             int start, int stop, int y_only);
+
 typedef struct LoopFilterWorkerData {
   YV12_BUFFER_CONFIG *frame_buffer;
   struct AV1Common *cm;
@@ -448,7 +448,7 @@ add_proto qw/int av1_diamond_search_sad/, "struct macroblock *x, const struct se
 add_proto qw/int av1_full_range_search/, "const struct macroblock *x, const struct search_site_config *cfg, struct mv *ref_mv, struct mv *best_mv, int search_param, int sad_per_bit, int *num00, const struct aom_variance_vtable *fn_ptr, const struct mv *center_mv";
 
 add_proto qw/void av1_temporal_filter_apply/, "uint8_t *frame1, unsigned int stride, uint8_t *frame2, unsigned int block_width, unsigned int block_height, int strength, int filter_weight, unsigned int *accumulator, uint16_t *count";
-specialize qw/av1_temporal_filter_apply sse2 msa/;
+specialize qw/av1_temporal_filter_apply sse4_1 avx2/;
 
 if (aom_config("CONFIG_AOM_QM") eq "yes") {
   add_proto qw/void av1_quantize_b/, "const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan, const qm_val_t * qm_ptr, const qm_val_t * iqm_ptr, int log_scale";
@@ -484,6 +484,7 @@ if (aom_config("CONFIG_HIGHBITDEPTH") eq "yes") {
   }
 
   add_proto qw/void av1_highbd_temporal_filter_apply/, "uint8_t *frame1, unsigned int stride, uint8_t *frame2, unsigned int block_width, unsigned int block_height, int strength, int filter_weight, unsigned int *accumulator, uint16_t *count";
+  specialize qw/av1_highbd_temporal_filter_apply sse4_1 avx2/;
 
 }
 
@@ -579,15 +580,15 @@ if (aom_config("CONFIG_CDEF") eq "yes") {
     specialize qw/aom_clpf_block sse2 ssse3 sse4_1 neon/;
     specialize qw/aom_clpf_hblock sse2 ssse3 sse4_1 neon/;
     specialize qw/od_dir_find8 sse2 ssse3 sse4_1 neon/;
-    specialize qw/od_filter_dering_direction_4x4 sse2 ssse3 sse4_1 neon/;
-    specialize qw/od_filter_dering_direction_8x8 sse2 ssse3 sse4_1 neon/;
+    specialize qw/od_filter_dering_direction_4x4 sse2 ssse3 sse4_1 avx2 neon/;
+    specialize qw/od_filter_dering_direction_8x8 sse2 ssse3 sse4_1 avx2 neon/;
 
     specialize qw/copy_8x8_16bit_to_8bit sse2 ssse3 sse4_1 neon/;
     specialize qw/copy_4x4_16bit_to_8bit sse2 ssse3 sse4_1 neon/;
     specialize qw/copy_8x8_16bit_to_16bit sse2 ssse3 sse4_1 neon/;
     specialize qw/copy_4x4_16bit_to_16bit sse2 ssse3 sse4_1 neon/;
-    specialize qw/copy_rect8_8bit_to_16bit sse2 ssse3 sse4_1 neon/;
-    specialize qw/copy_rect8_16bit_to_16bit sse2 ssse3 sse4_1 neon/;
+    specialize qw/copy_rect8_8bit_to_16bit sse2 ssse3 sse4_1 avx2 neon/;
+    specialize qw/copy_rect8_16bit_to_16bit sse2 ssse3 sse4_1 avx2 neon/;
   }
 }
 
@@ -603,17 +604,19 @@ if (aom_config("CONFIG_PVQ") eq "yes") {
 if ((aom_config("CONFIG_WARPED_MOTION") eq "yes") ||
     (aom_config("CONFIG_GLOBAL_MOTION") eq "yes")) {
   add_proto qw/void av1_warp_affine/, "const int32_t *mat, const uint8_t *ref, int width, int height, int stride, uint8_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta";
-  specialize qw/av1_warp_affine sse2 ssse3/;
+  specialize qw/av1_warp_affine sse2 ssse3 avx2/;
 
   if (aom_config("CONFIG_CONVOLVE_ROUND") eq "yes") {
     add_proto qw/void av1_warp_affine_post_round/, "const int32_t *mat, const uint8_t *ref, int width, int height, int stride, uint8_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta";
+    specialize qw/av1_warp_affine_post_round avx2/;
   }
 
   if (aom_config("CONFIG_HIGHBITDEPTH") eq "yes") {
     add_proto qw/void av1_highbd_warp_affine/, "const int32_t *mat, const uint16_t *ref, int width, int height, int stride, uint16_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, int bd, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta";
-    specialize qw/av1_highbd_warp_affine ssse3/;
+    specialize qw/av1_highbd_warp_affine ssse3 avx2/;
     if (aom_config("CONFIG_CONVOLVE_ROUND") eq "yes") {
       add_proto qw/void av1_highbd_warp_affine_post_round/, "const int32_t *mat, const uint16_t *ref, int width, int height, int stride, uint16_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, int bd, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta";
+      specialize qw/av1_highbd_warp_affine_post_round avx2/;
     }
   }
 }
@@ -622,29 +625,54 @@ if (aom_config("CONFIG_GLOBAL_MOTION") eq "yes" &&
     aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   add_proto qw/double compute_cross_correlation/, "unsigned char *im1, int stride1, int x1, int y1, unsigned char *im2, int stride2, int x2, int y2";
   specialize qw/compute_cross_correlation sse4_1/;
+
+  add_proto qw/int av1_ransac_affine_inliers/, "const double *mat, const double *points1, const double *points2, int npoints, int min_inliers, int *inlier_indices, double *distances";
+  specialize qw/av1_ransac_affine_inliers sse2 avx2/;
 }
 
 # LOOP_RESTORATION functions
 
 if (aom_config("CONFIG_LOOP_RESTORATION") eq "yes") {
   add_proto qw/void apply_selfguided_restoration/, "uint8_t *dat, int width, int height, int stride, int eps, int *xqd, uint8_t *dst, int dst_stride, int32_t *tmpbuf";
-  specialize qw/apply_selfguided_restoration sse4_1/;
+  specialize qw/apply_selfguided_restoration sse4_1 avx2/;
 
   add_proto qw/void av1_selfguided_restoration/, "uint8_t *dgd, int width, int height, int stride, int32_t *dst, int dst_stride, int r, int eps, int32_t *tmpbuf";
-  specialize qw/av1_selfguided_restoration sse4_1/;
+  specialize qw/av1_selfguided_restoration sse4_1 avx2/;
+
+  add_proto qw/void av1_selfguided_integral_images/, "uint8_t *dgd, int width, int height, int stride, int32_t *ii, int32_t *ii_sq";
+  specialize qw/av1_selfguided_integral_images avx2/;
+
+  add_proto qw/void av1_selfguided_restoration_from_integral/, "uint8_t *dgd, int width, int height, int stride, const int32_t *ii, const int32_t *ii_sq, int32_t *dst, int dst_stride, int r, int eps, int32_t *tmpbuf";
+  specialize qw/av1_selfguided_restoration_from_integral sse4_1 avx2/;
 
   add_proto qw/void av1_highpass_filter/, "uint8_t *dgd, int width, int height, int stride, int32_t *dst, int dst_stride, int r, int eps";
-  specialize qw/av1_highpass_filter sse4_1/;
+  specialize qw/av1_highpass_filter sse4_1 avx2/;
 
   if (aom_config("CONFIG_HIGHBITDEPTH") eq "yes") {
     add_proto qw/void apply_selfguided_restoration_highbd/, "uint16_t *dat, int width, int height, int stride, int bit_depth, int eps, int *xqd, uint16_t *dst, int dst_stride, int32_t *tmpbuf";
-    specialize qw/apply_selfguided_restoration_highbd sse4_1/;
+    specialize qw/apply_selfguided_restoration_highbd sse4_1 avx2/;
 
     add_proto qw/void av1_selfguided_restoration_highbd/, "uint16_t *dgd, int width, int height, int stride, int32_t *dst, int dst_stride, int bit_depth, int r, int eps, int32_t *tmpbuf";
-    specialize qw/av1_selfguided_restoration_highbd sse4_1/;
+    specialize qw/av1_selfguided_restoration_highbd sse4_1 avx2/;
+
+    add_proto qw/void av1_selfguided_integral_images_highbd/, "uint16_t *dgd, int width, int height, int stride, int32_t *ii, int32_t *ii_sq";
+    specialize qw/av1_selfguided_integral_images_highbd avx2/;
+
+    add_proto qw/void av1_selfguided_restoration_from_integral_highbd/, "uint16_t *dgd, int width, int height, int stride, const int32_t *ii, const int32_t *ii_sq, int32_t *dst, int dst_stride, int bit_depth, int r, int eps, int32_t *tmpbuf";
+    specialize qw/av1_selfguided_restoration_from_integral_highbd sse4_1 avx2/;
 
     add_proto qw/void av1_highpass_filter_highbd/, "uint16_t *dgd, int width, int height, int stride, int32_t *dst, int dst_stride, int r, int eps";
-    specialize qw/av1_highpass_filter_highbd sse4_1/;
+    specialize qw/av1_highpass_filter_highbd sse4_1 avx2/;
+  }
+
+  if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
+    add_proto qw/void av1_compute_stats/, "const uint8_t *dgd, const uint8_t *src, int avg, int h_start, int h_end, int v_start, int v_end, int dgd_stride, int src_stride, int64_t *M, int64_t *H";
+    specialize qw/av1_compute_stats avx2/;
+
+    if (aom_config("CONFIG_HIGHBITDEPTH") eq "yes") {
+      add_proto qw/void av1_compute_stats_highbd/, "const uint16_t *dgd, const uint16_t *src, int avg, int h_start, int h_end, int v_start, int v_end, int dgd_stride, int src_stride, int64_t *M, int64_t *H";
+      specialize qw/av1_compute_stats_highbd avx2/;
+    }
   }
 }
 
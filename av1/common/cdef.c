@@ -154,282 +154,302 @@ static INLINE void copy_rect(uint16_t *dst, int dstride, const uint16_t *src,
   }
 }
 
-void av1_cdef_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
-                    MACROBLOCKD *xd) {
-  int sbr, sbc;
-  int nhsb, nvsb;
-  uint16_t src[OD_DERING_INBUF_SIZE];
-  uint16_t *linebuf[3];
-  uint16_t *colbuf[3];
-  dering_list dlist[MAX_MIB_SIZE * MAX_MIB_SIZE];
-  unsigned char *row_dering, *prev_row_dering, *curr_row_dering;
-  int dering_count;
-  int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS] = { { 0 } };
-  int var[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS] = { { 0 } };
-  int stride;
-  int mi_wide_l2[3];
-  int mi_high_l2[3];
-  int xdec[3];
-  int ydec[3];
+void av1_cdef_init_rows(AV1CdefState *const cdef, YV12_BUFFER_CONFIG *frame,
+                        const AV1_COMMON *const cm,
+                        const MACROBLOCKD *const xd) {
+  const int nplanes = 3;
   int pli;
-  int dering_left;
-  int coeff_shift = AOMMAX(cm->bit_depth - 8, 0);
-  int nplanes = 3;
-  int chroma_dering =
+  cdef->coeff_shift = AOMMAX(cm->bit_depth - 8, 0);
+  cdef->chroma_dering =
       xd->plane[1].subsampling_x == xd->plane[1].subsampling_y &&
       xd->plane[2].subsampling_x == xd->plane[2].subsampling_y;
-  nvsb = (cm->mi_rows + MAX_MIB_SIZE - 1) / MAX_MIB_SIZE;
-  nhsb = (cm->mi_cols + MAX_MIB_SIZE - 1) / MAX_MIB_SIZE;
-  av1_setup_dst_planes(xd->plane, cm->sb_size, frame, 0, 0);
-  row_dering = aom_malloc(sizeof(*row_dering) * (nhsb + 2) * 2);
-  memset(row_dering, 1, sizeof(*row_dering) * (nhsb + 2) * 2);
-  prev_row_dering = row_dering + 1;
-  curr_row_dering = prev_row_dering + nhsb + 2;
+  cdef->nvsb = (cm->mi_rows + MAX_MIB_SIZE - 1) / MAX_MIB_SIZE;
+  cdef->nhsb = (cm->mi_cols + MAX_MIB_SIZE - 1) / MAX_MIB_SIZE;
+  memcpy(cdef->planes, xd->plane, sizeof(cdef->planes));
+  av1_setup_dst_planes(cdef->planes, cm->sb_size, frame, 0, 0);
   for (pli = 0; pli < nplanes; pli++) {
-    xdec[pli] = xd->plane[pli].subsampling_x;
-    ydec[pli] = xd->plane[pli].subsampling_y;
-    mi_wide_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_x;
-    mi_high_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_y;
+    cdef->xdec[pli] = xd->plane[pli].subsampling_x;
+    cdef->ydec[pli] = xd->plane[pli].subsampling_y;
+    cdef->mi_wide_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_x;
+    cdef->mi_high_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_y;
   }
-  stride = (cm->mi_cols << MI_SIZE_LOG2) + 2 * OD_FILT_HBORDER;
+  cdef->stride = (cm->mi_cols << MI_SIZE_LOG2) + 2 * OD_FILT_HBORDER;
   for (pli = 0; pli < nplanes; pli++) {
-    linebuf[pli] = aom_malloc(sizeof(*linebuf) * OD_FILT_VBORDER * stride);
-    colbuf[pli] =
-        aom_malloc(sizeof(*colbuf) *
-                   ((MAX_SB_SIZE << mi_high_l2[pli]) + 2 * OD_FILT_VBORDER) *
-                   OD_FILT_HBORDER);
+    cdef->linebuf[pli] =
+        aom_malloc(sizeof(*cdef->linebuf[pli]) * 2 * OD_FILT_VBORDER *
+                   cdef->stride * AOMMAX(cdef->nvsb - 1, 1));
   }
-  for (sbr = 0; sbr < nvsb; sbr++) {
-    for (pli = 0; pli < nplanes; pli++) {
-      const int block_height =
-          (MAX_MIB_SIZE << mi_high_l2[pli]) + 2 * OD_FILT_VBORDER;
-      fill_rect(colbuf[pli], OD_FILT_HBORDER, block_height, OD_FILT_HBORDER,
-                OD_DERING_VERY_LARGE);
+}
+
+void av1_cdef_save_lines(const AV1CdefState *const cdef, AV1_COMMON *cm,
+                         int sbr) {
+  const int nplanes = 3;
+  int pli;
+  if (sbr == cdef->nvsb - 1) return;
+  for (pli = 0; pli < nplanes; pli++) {
+    copy_sb8_16(cm, &cdef->linebuf[pli][sbr * 2 * OD_FILT_VBORDER *
+                                        cdef->stride],
+                cdef->stride, cdef->planes[pli].dst.buf,
+                (MAX_MIB_SIZE << cdef->mi_high_l2[pli]) * (sbr + 1) -
+                    OD_FILT_VBORDER,
+                0, cdef->planes[pli].dst.stride, 2 * OD_FILT_VBORDER,
+                cm->mi_cols << cdef->mi_wide_l2[pli]);
+  }
+}
+
+void av1_cdef_sb_row(const AV1CdefState *const cdef, AV1_COMMON *cm,
+                     int sbr) {
+  const int nplanes = 3;
+  const int nhsb = cdef->nhsb;
+  const int nvsb = cdef->nvsb;
+  const int stride = cdef->stride;
+  const int chroma_dering = cdef->chroma_dering;
+  const int coeff_shift = cdef->coeff_shift;
+  const int *const mi_wide_l2 = cdef->mi_wide_l2;
+  const int *const mi_high_l2 = cdef->mi_high_l2;
+  const int *const xdec = cdef->xdec;
+  const int *const ydec = cdef->ydec;
+  const struct macroblockd_plane *const planes = cdef->planes;
+  // The unfiltered lines above and below the row.
+  const uint16_t *above[3];
+  const uint16_t *below[3];
+  // The unfiltered right columns of the superblock on the left.
+  uint16_t colbuf[3][(MAX_SB_SIZE + 2 * OD_FILT_VBORDER) * OD_FILT_HBORDER];
+  int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS] = { { 0 } };
+  int var[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS] = { { 0 } };
+  uint16_t src[OD_DERING_INBUF_SIZE];
+  dering_list dlist[MAX_MIB_SIZE * MAX_MIB_SIZE];
+  int dering_count;
+  int sbc;
+  int pli;
+  int dering_left;
+  for (pli = 0; pli < nplanes; pli++) {
+    const int block_height =
+        (MAX_MIB_SIZE << mi_high_l2[pli]) + 2 * OD_FILT_VBORDER;
+    fill_rect(colbuf[pli], OD_FILT_HBORDER, block_height, OD_FILT_HBORDER,
+              OD_DERING_VERY_LARGE);
+    above[pli] = sbr > 0 ? &cdef->linebuf[pli][(sbr - 1) * 2 *
+                                               OD_FILT_VBORDER * stride]
+                         : NULL;
+    below[pli] = sbr < nvsb - 1
+                     ? &cdef->linebuf[pli][(sbr * 2 + 1) * OD_FILT_VBORDER *
+                                           stride]
+                     : NULL;
+  }
+  dering_left = 1;
+  for (sbc = 0; sbc < nhsb; sbc++) {
+    int level, clpf_strength;
+    int uv_level, uv_clpf_strength;
+    int nhb, nvb;
+    int cstart = 0;
+    if (cm->mi_grid_visible[MAX_MIB_SIZE * sbr * cm->mi_stride +
+                            MAX_MIB_SIZE * sbc] == NULL ||
+        cm->mi_grid_visible[MAX_MIB_SIZE * sbr * cm->mi_stride +
+                            MAX_MIB_SIZE * sbc]
+                ->mbmi.cdef_strength == -1) {
+      dering_left = 0;
+      continue;
     }
-    dering_left = 1;
-    for (sbc = 0; sbc < nhsb; sbc++) {
-      int level, clpf_strength;
-      int uv_level, uv_clpf_strength;
-      int nhb, nvb;
-      int cstart = 0;
-      curr_row_dering[sbc] = 0;
-      if (cm->mi_grid_visible[MAX_MIB_SIZE * sbr * cm->mi_stride +
-                              MAX_MIB_SIZE * sbc] == NULL ||
-          cm->mi_grid_visible[MAX_MIB_SIZE * sbr * cm->mi_stride +
-                              MAX_MIB_SIZE * sbc]
-                  ->mbmi.cdef_strength == -1) {
-        dering_left = 0;
-        continue;
-      }
-      if (!dering_left) cstart = -OD_FILT_HBORDER;
-      nhb = AOMMIN(MAX_MIB_SIZE, cm->mi_cols - MAX_MIB_SIZE * sbc);
-      nvb = AOMMIN(MAX_MIB_SIZE, cm->mi_rows - MAX_MIB_SIZE * sbr);
-      int tile_top, tile_left, tile_bottom, tile_right;
-      int mi_idx = MAX_MIB_SIZE * sbr * cm->mi_stride + MAX_MIB_SIZE * sbc;
-      MODE_INFO *const mi_tl = cm->mi + mi_idx;
-      BOUNDARY_TYPE boundary_tl = mi_tl->mbmi.boundary_info;
-      tile_top = boundary_tl & TILE_ABOVE_BOUNDARY;
-      tile_left = boundary_tl & TILE_LEFT_BOUNDARY;
-
-      if (sbr != nvsb - 1 &&
-          (&cm->mi[mi_idx + (MAX_MIB_SIZE - 1) * cm->mi_stride]))
-        tile_bottom = cm->mi[mi_idx + (MAX_MIB_SIZE - 1) * cm->mi_stride]
-                          .mbmi.boundary_info &
-                      TILE_BOTTOM_BOUNDARY;
-      else
-        tile_bottom = 1;
+    if (!dering_left) cstart = -OD_FILT_HBORDER;
+    nhb = AOMMIN(MAX_MIB_SIZE, cm->mi_cols - MAX_MIB_SIZE * sbc);
+    nvb = AOMMIN(MAX_MIB_SIZE, cm->mi_rows - MAX_MIB_SIZE * sbr);
+    int tile_top, tile_left, tile_bottom, tile_right;
+    int mi_idx = MAX_MIB_SIZE * sbr * cm->mi_stride + MAX_MIB_SIZE * sbc;
+    MODE_INFO *const mi_tl = cm->mi + mi_idx;
+    BOUNDARY_TYPE boundary_tl = mi_tl->mbmi.boundary_info;
+    tile_top = boundary_tl & TILE_ABOVE_BOUNDARY;
+    tile_left = boundary_tl & TILE_LEFT_BOUNDARY;
 
-      if (sbc != nhsb - 1 && (&cm->mi[mi_idx + MAX_MIB_SIZE - 1]))
-        tile_right = cm->mi[mi_idx + MAX_MIB_SIZE - 1].mbmi.boundary_info &
-                     TILE_RIGHT_BOUNDARY;
-      else
-        tile_right = 1;
-
-      const int mbmi_cdef_strength =
-          cm->mi_grid_visible[MAX_MIB_SIZE * sbr * cm->mi_stride +
-                              MAX_MIB_SIZE * sbc]
-              ->mbmi.cdef_strength;
-      level = cm->cdef_strengths[mbmi_cdef_strength] / CLPF_STRENGTHS;
-      clpf_strength = cm->cdef_strengths[mbmi_cdef_strength] % CLPF_STRENGTHS;
-      clpf_strength += clpf_strength == 3;
-      uv_level = cm->cdef_uv_strengths[mbmi_cdef_strength] / CLPF_STRENGTHS;
-      uv_clpf_strength =
-          cm->cdef_uv_strengths[mbmi_cdef_strength] % CLPF_STRENGTHS;
-      uv_clpf_strength += uv_clpf_strength == 3;
-      if ((level == 0 && clpf_strength == 0 && uv_level == 0 &&
-           uv_clpf_strength == 0) ||
-          (dering_count = sb_compute_dering_list(
-               cm, sbr * MAX_MIB_SIZE, sbc * MAX_MIB_SIZE, dlist,
-               get_filter_skip(level) || get_filter_skip(uv_level))) == 0) {
-        dering_left = 0;
-        continue;
-      }
+    if (sbr != nvsb - 1 &&
+        (&cm->mi[mi_idx + (MAX_MIB_SIZE - 1) * cm->mi_stride]))
+      tile_bottom = cm->mi[mi_idx + (MAX_MIB_SIZE - 1) * cm->mi_stride]
+                        .mbmi.boundary_info &
+                    TILE_BOTTOM_BOUNDARY;
+    else
+      tile_bottom = 1;
 
-      curr_row_dering[sbc] = 1;
-      for (pli = 0; pli < nplanes; pli++) {
-        uint16_t dst[MAX_SB_SIZE * MAX_SB_SIZE];
-        int coffset;
-        int rend, cend;
-        int clpf_damping = cm->cdef_clpf_damping;
-        int dering_damping = cm->cdef_dering_damping;
-        int hsize = nhb << mi_wide_l2[pli];
-        int vsize = nvb << mi_high_l2[pli];
-
-        if (pli) {
-          if (chroma_dering)
-            level = uv_level;
-          else
-            level = 0;
-          clpf_strength = uv_clpf_strength;
-        }
+    if (sbc != nhsb - 1 && (&cm->mi[mi_idx + MAX_MIB_SIZE - 1]))
+      tile_right = cm->mi[mi_idx + MAX_MIB_SIZE - 1].mbmi.boundary_info &
+                   TILE_RIGHT_BOUNDARY;
+    else
+      tile_right = 1;
 
-        if (sbc == nhsb - 1)
-          cend = hsize;
-        else
-          cend = hsize + OD_FILT_HBORDER;
+    const int mbmi_cdef_strength =
+        cm->mi_grid_visible[MAX_MIB_SIZE * sbr * cm->mi_stride +
+                            MAX_MIB_SIZE * sbc]
+            ->mbmi.cdef_strength;
+    level = cm->cdef_strengths[mbmi_cdef_strength] / CLPF_STRENGTHS;
+    clpf_strength = cm->cdef_strengths[mbmi_cdef_strength] % CLPF_STRENGTHS;
+    clpf_strength += clpf_strength == 3;
+    uv_level = cm->cdef_uv_strengths[mbmi_cdef_strength] / CLPF_STRENGTHS;
+    uv_clpf_strength =
+        cm->cdef_uv_strengths[mbmi_cdef_strength] % CLPF_STRENGTHS;
+    uv_clpf_strength += uv_clpf_strength == 3;
+    if ((level == 0 && clpf_strength == 0 && uv_level == 0 &&
+         uv_clpf_strength == 0) ||
+        (dering_count = sb_compute_dering_list(
+             cm, sbr * MAX_MIB_SIZE, sbc * MAX_MIB_SIZE, dlist,
+             get_filter_skip(level) || get_filter_skip(uv_level))) == 0) {
+      dering_left = 0;
+      continue;
+    }
+
+    for (pli = 0; pli < nplanes; pli++) {
+      uint16_t dst[MAX_SB_SIZE * MAX_SB_SIZE];
+      int coffset;
+      int rend, cend;
+      int clpf_damping = cm->cdef_clpf_damping;
+      int dering_damping = cm->cdef_dering_damping;
+      int hsize = nhb << mi_wide_l2[pli];
+      int vsize = nvb << mi_high_l2[pli];
 
-        if (sbr == nvsb - 1)
-          rend = vsize;
+      if (pli) {
+        if (chroma_dering)
+          level = uv_level;
         else
-          rend = vsize + OD_FILT_VBORDER;
-
-        coffset = sbc * MAX_MIB_SIZE << mi_wide_l2[pli];
-        if (sbc == nhsb - 1) {
-          /* On the last superblock column, fill in the right border with
-             OD_DERING_VERY_LARGE to avoid filtering with the outside. */
-          fill_rect(&src[cend + OD_FILT_HBORDER], OD_FILT_BSTRIDE,
-                    rend + OD_FILT_VBORDER, hsize + OD_FILT_HBORDER - cend,
-                    OD_DERING_VERY_LARGE);
-        }
-        if (sbr == nvsb - 1) {
-          /* On the last superblock row, fill in the bottom border with
-             OD_DERING_VERY_LARGE to avoid filtering with the outside. */
-          fill_rect(&src[(rend + OD_FILT_VBORDER) * OD_FILT_BSTRIDE],
-                    OD_FILT_BSTRIDE, OD_FILT_VBORDER,
-                    hsize + 2 * OD_FILT_HBORDER, OD_DERING_VERY_LARGE);
-        }
-        /* Copy in the pixels we need from the current superblock for
-           deringing.*/
-        copy_sb8_16(
-            cm,
-            &src[OD_FILT_VBORDER * OD_FILT_BSTRIDE + OD_FILT_HBORDER + cstart],
-            OD_FILT_BSTRIDE, xd->plane[pli].dst.buf,
-            (MAX_MIB_SIZE << mi_high_l2[pli]) * sbr, coffset + cstart,
-            xd->plane[pli].dst.stride, rend, cend - cstart);
-        if (!prev_row_dering[sbc]) {
-          copy_sb8_16(cm, &src[OD_FILT_HBORDER], OD_FILT_BSTRIDE,
-                      xd->plane[pli].dst.buf,
-                      (MAX_MIB_SIZE << mi_high_l2[pli]) * sbr - OD_FILT_VBORDER,
-                      coffset, xd->plane[pli].dst.stride, OD_FILT_VBORDER,
-                      hsize);
-        } else if (sbr > 0) {
-          copy_rect(&src[OD_FILT_HBORDER], OD_FILT_BSTRIDE,
-                    &linebuf[pli][coffset], stride, OD_FILT_VBORDER, hsize);
-        } else {
-          fill_rect(&src[OD_FILT_HBORDER], OD_FILT_BSTRIDE, OD_FILT_VBORDER,
-                    hsize, OD_DERING_VERY_LARGE);
-        }
-        if (!prev_row_dering[sbc - 1]) {
-          copy_sb8_16(cm, src, OD_FILT_BSTRIDE, xd->plane[pli].dst.buf,
-                      (MAX_MIB_SIZE << mi_high_l2[pli]) * sbr - OD_FILT_VBORDER,
-                      coffset - OD_FILT_HBORDER, xd->plane[pli].dst.stride,
-                      OD_FILT_VBORDER, OD_FILT_HBORDER);
-        } else if (sbr > 0 && sbc > 0) {
-          copy_rect(src, OD_FILT_BSTRIDE,
-                    &linebuf[pli][coffset - OD_FILT_HBORDER], stride,
-                    OD_FILT_VBORDER, OD_FILT_HBORDER);
-        } else {
-          fill_rect(src, OD_FILT_BSTRIDE, OD_FILT_VBORDER, OD_FILT_HBORDER,
-                    OD_DERING_VERY_LARGE);
-        }
-        if (!prev_row_dering[sbc + 1]) {
-          copy_sb8_16(cm, &src[OD_FILT_HBORDER + (nhb << mi_wide_l2[pli])],
-                      OD_FILT_BSTRIDE, xd->plane[pli].dst.buf,
-                      (MAX_MIB_SIZE << mi_high_l2[pli]) * sbr - OD_FILT_VBORDER,
-                      coffset + hsize, xd->plane[pli].dst.stride,
-                      OD_FILT_VBORDER, OD_FILT_HBORDER);
-        } else if (sbr > 0 && sbc < nhsb - 1) {
-          copy_rect(&src[hsize + OD_FILT_HBORDER], OD_FILT_BSTRIDE,
-                    &linebuf[pli][coffset + hsize], stride, OD_FILT_VBORDER,
-                    OD_FILT_HBORDER);
-        } else {
-          fill_rect(&src[hsize + OD_FILT_HBORDER], OD_FILT_BSTRIDE,
-                    OD_FILT_VBORDER, OD_FILT_HBORDER, OD_DERING_VERY_LARGE);
-        }
-        if (dering_left) {
-          /* If we deringed the superblock on the left then we need to copy in
-             saved pixels. */
-          copy_rect(src, OD_FILT_BSTRIDE, colbuf[pli], OD_FILT_HBORDER,
-                    rend + OD_FILT_VBORDER, OD_FILT_HBORDER);
-        }
-        /* Saving pixels in case we need to dering the superblock on the
-            right. */
-        copy_rect(colbuf[pli], OD_FILT_HBORDER, src + hsize, OD_FILT_BSTRIDE,
+          level = 0;
+        clpf_strength = uv_clpf_strength;
+      }
+
+      if (sbc == nhsb - 1)
+        cend = hsize;
+      else
+        cend = hsize + OD_FILT_HBORDER;
+
+      if (sbr == nvsb - 1)
+        rend = vsize;
+      else
+        rend = vsize + OD_FILT_VBORDER;
+
+      coffset = sbc * MAX_MIB_SIZE << mi_wide_l2[pli];
+      if (sbc == nhsb - 1) {
+        /* On the last superblock column, fill in the right border with
+           OD_DERING_VERY_LARGE to avoid filtering with the outside. */
+        fill_rect(&src[cend + OD_FILT_HBORDER], OD_FILT_BSTRIDE,
+                  rend + OD_FILT_VBORDER, hsize + OD_FILT_HBORDER - cend,
+                  OD_DERING_VERY_LARGE);
+      }
+      if (sbr == nvsb - 1) {
+        /* On the last superblock row, fill in the bottom border with
+           OD_DERING_VERY_LARGE to avoid filtering with the outside. */
+        fill_rect(&src[(rend + OD_FILT_VBORDER) * OD_FILT_BSTRIDE],
+                  OD_FILT_BSTRIDE, OD_FILT_VBORDER,
+                  hsize + 2 * OD_FILT_HBORDER, OD_DERING_VERY_LARGE);
+      }
+      /* Copy in the pixels we need from the current superblock for
+         deringing, and the saved lines below it.*/
+      copy_sb8_16(
+          cm,
+          &src[OD_FILT_VBORDER * OD_FILT_BSTRIDE + OD_FILT_HBORDER + cstart],
+          OD_FILT_BSTRIDE, planes[pli].dst.buf,
+          (MAX_MIB_SIZE << mi_high_l2[pli]) * sbr, coffset + cstart,
+          planes[pli].dst.stride, vsize, cend - cstart);
+      if (sbr != nvsb - 1) {
+        copy_rect(&src[(vsize + OD_FILT_VBORDER) * OD_FILT_BSTRIDE +
+                       OD_FILT_HBORDER + cstart],
+                  OD_FILT_BSTRIDE, &below[pli][coffset + cstart], stride,
+                  OD_FILT_VBORDER, cend - cstart);
+      }
+      if (sbr > 0) {
+        copy_rect(&src[OD_FILT_HBORDER], OD_FILT_BSTRIDE,
+                  &above[pli][coffset], stride, OD_FILT_VBORDER, hsize);
+      } else {
+        fill_rect(&src[OD_FILT_HBORDER], OD_FILT_BSTRIDE, OD_FILT_VBORDER,
+                  hsize, OD_DERING_VERY_LARGE);
+      }
+      if (sbr > 0 && sbc > 0) {
+        copy_rect(src, OD_FILT_BSTRIDE, &above[pli][coffset - OD_FILT_HBORDER],
+                  stride, OD_FILT_VBORDER, OD_FILT_HBORDER);
+      } else {
+        fill_rect(src, OD_FILT_BSTRIDE, OD_FILT_VBORDER, OD_FILT_HBORDER,
+                  OD_DERING_VERY_LARGE);
+      }
+      if (sbr > 0 && sbc < nhsb - 1) {
+        copy_rect(&src[hsize + OD_FILT_HBORDER], OD_FILT_BSTRIDE,
+                  &above[pli][coffset + hsize], stride, OD_FILT_VBORDER,
+                  OD_FILT_HBORDER);
+      } else {
+        fill_rect(&src[hsize + OD_FILT_HBORDER], OD_FILT_BSTRIDE,
+                  OD_FILT_VBORDER, OD_FILT_HBORDER, OD_DERING_VERY_LARGE);
+      }
+      if (dering_left) {
+        /* If we deringed the superblock on the left then we need to copy in
+           saved pixels. */
+        copy_rect(src, OD_FILT_BSTRIDE, colbuf[pli], OD_FILT_HBORDER,
                   rend + OD_FILT_VBORDER, OD_FILT_HBORDER);
-        copy_sb8_16(
-            cm, &linebuf[pli][coffset], stride, xd->plane[pli].dst.buf,
-            (MAX_MIB_SIZE << mi_high_l2[pli]) * (sbr + 1) - OD_FILT_VBORDER,
-            coffset, xd->plane[pli].dst.stride, OD_FILT_VBORDER, hsize);
-
-        if (tile_top) {
-          fill_rect(src, OD_FILT_BSTRIDE, OD_FILT_VBORDER,
-                    hsize + 2 * OD_FILT_HBORDER, OD_DERING_VERY_LARGE);
-        }
-        if (tile_left) {
-          fill_rect(src, OD_FILT_BSTRIDE, vsize + 2 * OD_FILT_VBORDER,
-                    OD_FILT_HBORDER, OD_DERING_VERY_LARGE);
-        }
-        if (tile_bottom) {
-          fill_rect(&src[(vsize + OD_FILT_VBORDER) * OD_FILT_BSTRIDE],
-                    OD_FILT_BSTRIDE, OD_FILT_VBORDER,
-                    hsize + 2 * OD_FILT_HBORDER, OD_DERING_VERY_LARGE);
-        }
-        if (tile_right) {
-          fill_rect(&src[hsize + OD_FILT_HBORDER], OD_FILT_BSTRIDE,
-                    vsize + 2 * OD_FILT_VBORDER, OD_FILT_HBORDER,
-                    OD_DERING_VERY_LARGE);
-        }
+      }
+      /* Saving pixels in case we need to dering the superblock on the
+          right. */
+      copy_rect(colbuf[pli], OD_FILT_HBORDER, src + hsize, OD_FILT_BSTRIDE,
+                rend + OD_FILT_VBORDER, OD_FILT_HBORDER);
+
+      if (tile_top) {
+        fill_rect(src, OD_FILT_BSTRIDE, OD_FILT_VBORDER,
+                  hsize + 2 * OD_FILT_HBORDER, OD_DERING_VERY_LARGE);
+      }
+      if (tile_left) {
+        fill_rect(src, OD_FILT_BSTRIDE, vsize + 2 * OD_FILT_VBORDER,
+                  OD_FILT_HBORDER, OD_DERING_VERY_LARGE);
+      }
+      if (tile_bottom) {
+        fill_rect(&src[(vsize + OD_FILT_VBORDER) * OD_FILT_BSTRIDE],
+                  OD_FILT_BSTRIDE, OD_FILT_VBORDER,
+                  hsize + 2 * OD_FILT_HBORDER, OD_DERING_VERY_LARGE);
+      }
+      if (tile_right) {
+        fill_rect(&src[hsize + OD_FILT_HBORDER], OD_FILT_BSTRIDE,
+                  vsize + 2 * OD_FILT_VBORDER, OD_FILT_HBORDER,
+                  OD_DERING_VERY_LARGE);
+      }
 #if CONFIG_HIGHBITDEPTH
-        if (cm->use_highbitdepth) {
-          od_dering(
-              (uint8_t *)&CONVERT_TO_SHORTPTR(
-                  xd->plane[pli]
-                      .dst.buf)[xd->plane[pli].dst.stride *
+      if (cm->use_highbitdepth) {
+        od_dering(
+            (uint8_t *)&CONVERT_TO_SHORTPTR(
+                planes[pli]
+                    .dst.buf)[planes[pli].dst.stride *
+                                  (MAX_MIB_SIZE * sbr << mi_high_l2[pli]) +
+                              (sbc * MAX_MIB_SIZE << mi_wide_l2[pli])],
+            planes[pli].dst.stride, dst,
+            &src[OD_FILT_VBORDER * OD_FILT_BSTRIDE + OD_FILT_HBORDER],
+            xdec[pli], ydec[pli], dir, NULL, var, pli, dlist,
+            dering_count, level, clpf_strength, clpf_damping, dering_damping,
+            coeff_shift, 0, 1);
+      } else {
+#endif
+        od_dering(&planes[pli]
+                       .dst.buf[planes[pli].dst.stride *
                                     (MAX_MIB_SIZE * sbr << mi_high_l2[pli]) +
                                 (sbc * MAX_MIB_SIZE << mi_wide_l2[pli])],
-              xd->plane[pli].dst.stride, dst,
-              &src[OD_FILT_VBORDER * OD_FILT_BSTRIDE + OD_FILT_HBORDER],
-              xdec[pli], ydec[pli], dir, NULL, var, pli, dlist, dering_count,
-              level, clpf_strength, clpf_damping, dering_damping, coeff_shift,
-              0, 1);
-        } else {
-#endif
-          od_dering(&xd->plane[pli]
-                         .dst.buf[xd->plane[pli].dst.stride *
-                                      (MAX_MIB_SIZE * sbr << mi_high_l2[pli]) +
-                                  (sbc * MAX_MIB_SIZE << mi_wide_l2[pli])],
-                    xd->plane[pli].dst.stride, dst,
-                    &src[OD_FILT_VBORDER * OD_FILT_BSTRIDE + OD_FILT_HBORDER],
-                    xdec[pli], ydec[pli], dir, NULL, var, pli, dlist,
-                    dering_count, level, clpf_strength, clpf_damping,
-                    dering_damping, coeff_shift, 0, 0);
+                  planes[pli].dst.stride, dst,
+                  &src[OD_FILT_VBORDER * OD_FILT_BSTRIDE + OD_FILT_HBORDER],
+                  xdec[pli], ydec[pli], dir, NULL, var, pli, dlist,
+                  dering_count, level, clpf_strength, clpf_damping,
+                  dering_damping, coeff_shift, 0, 0);
 
 #if CONFIG_HIGHBITDEPTH
-        }
-#endif
       }
-      dering_left = 1;
-    }
-    {
-      unsigned char *tmp;
-      tmp = prev_row_dering;
-      prev_row_dering = curr_row_dering;
-      curr_row_dering = tmp;
+#endif
     }
+    dering_left = 1;
   }
-  aom_free(row_dering);
-  for (pli = 0; pli < nplanes; pli++) {
-    aom_free(linebuf[pli]);
-    aom_free(colbuf[pli]);
+}
+
+void av1_cdef_free_rows(AV1CdefState *const cdef) {
+  int pli;
+  for (pli = 0; pli < 3; pli++) {
+    aom_free(cdef->linebuf[pli]);
+    cdef->linebuf[pli] = NULL;
+  }
+}
+
+void av1_cdef_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                    MACROBLOCKD *xd) {
+  AV1CdefState cdef;
+  int sbr;
+  av1_cdef_init_rows(&cdef, frame, cm, xd);
+  for (sbr = 0; sbr < cdef.nvsb; sbr++) {
+    av1_cdef_save_lines(&cdef, cm, sbr);
+    av1_cdef_sb_row(&cdef, cm, sbr);
   }
+  av1_cdef_free_rows(&cdef);
 }
@@ -19,6 +19,7 @@
 #include "./aom_config.h"
 #include "aom/aom_integer.h"
 #include "aom_ports/mem.h"
+#include "aom_util/aom_thread.h"
 #include "av1/common/od_dering.h"
 #include "av1/common/onyxc_int.h"
 #include "./od_dering.h"
@@ -39,13 +40,51 @@ static INLINE int constrain(int diff, int threshold, unsigned int damping) {
 extern "C" {
 #endif
 
+// State shared by the superblock rows while the frame is filtered a
+// superblock row at a time.
+typedef struct AV1CdefState {
+  struct macroblockd_plane planes[MAX_MB_PLANE];
+  // The unfiltered lines around the bottom edge of every superblock row but
+  // the last: OD_FILT_VBORDER lines above the edge followed by OD_FILT_VBORDER
+  // lines below it.
+  uint16_t *linebuf[3];
+  int mi_wide_l2[3];
+  int mi_high_l2[3];
+  int xdec[3];
+  int ydec[3];
+  int stride;
+  int nhsb;
+  int nvsb;
+  int chroma_dering;
+  int coeff_shift;
+} AV1CdefState;
+
 int sb_all_skip(const AV1_COMMON *const cm, int mi_row, int mi_col);
 int sb_compute_dering_list(const AV1_COMMON *const cm, int mi_row, int mi_col,
                            dering_list *dlist, int filter_skip);
 void av1_cdef_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm, MACROBLOCKD *xd);
 
+// Filters the frame one superblock row at a time. The lines around the bottom
+// edge of row sbr are saved by av1_cdef_save_lines() once the loop filter has
+// finished row sbr + 1 and before row sbr or row sbr + 1 is filtered. Row sbr
+// may be filtered once the lines of rows sbr - 1 and sbr are saved, so with
+// all the lines saved up front the rows can be filtered in any order or in
+// parallel.
+void av1_cdef_init_rows(AV1CdefState *const cdef, YV12_BUFFER_CONFIG *frame,
+                        const AV1_COMMON *const cm,
+                        const MACROBLOCKD *const xd);
+void av1_cdef_save_lines(const AV1CdefState *const cdef, AV1_COMMON *cm,
+                         int sbr);
+void av1_cdef_sb_row(const AV1CdefState *const cdef, AV1_COMMON *cm, int sbr);
+void av1_cdef_free_rows(AV1CdefState *const cdef);
+
+// Picks the strengths of the frame and of each superblock. The filtering of
+// the superblocks with every strength is shared by the workers. With
+// early_exit, a strength may be given up on for a superblock once it is
+// known not to be the best one for it.
 void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
-                     AV1_COMMON *cm, MACROBLOCKD *xd, int fast);
+                     AV1_COMMON *cm, MACROBLOCKD *xd, int fast, int early_exit,
+                     AVxWorker *workers, int num_workers);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -12,14 +12,17 @@
 #include <assert.h>
 
 #include "av1/common/frame_buffers.h"
+#include "aom_dsp/aom_dsp_common.h"
 #include "aom_mem/aom_mem.h"
 
-int av1_alloc_internal_frame_buffers(InternalFrameBufferList *list) {
+int av1_alloc_internal_frame_buffers(InternalFrameBufferList *list,
+                                     int num_pool_frame_bufs) {
   assert(list != NULL);
   av1_free_internal_frame_buffers(list);
 
   list->num_internal_frame_buffers =
-      AOM_MAXIMUM_REF_BUFFERS + AOM_MAXIMUM_WORK_BUFFERS;
+      AOMMAX(AOM_MAXIMUM_REF_BUFFERS + AOM_MAXIMUM_WORK_BUFFERS,
+             num_pool_frame_bufs);
   list->int_fb = (InternalFrameBuffer *)aom_calloc(
       list->num_internal_frame_buffers, sizeof(*list->int_fb));
   return (list->int_fb == NULL);
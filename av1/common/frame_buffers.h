@@ -30,8 +30,10 @@ typedef struct InternalFrameBufferList {
   InternalFrameBuffer *int_fb;
 } InternalFrameBufferList;
 
-// Initializes |list|. Returns 0 on success.
-int av1_alloc_internal_frame_buffers(InternalFrameBufferList *list);
+// Initializes |list| with enough frame buffers for a BufferPool of
+// |num_pool_frame_bufs|. Returns 0 on success.
+int av1_alloc_internal_frame_buffers(InternalFrameBufferList *list,
+                                     int num_pool_frame_bufs);
 
 // Free any data allocated to the frame buffers.
 void av1_free_internal_frame_buffers(InternalFrameBufferList *list);
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "./av1_rtcd.h"
+#include "aom_dsp/aom_simd.h"
+#include "./od_dering.h"
+
+/* The kernels of od_dering_simd.h that gain from 256-bit vectors. The rest,
+   od_dir_find8() included, run no faster with AVX2 than with SSE4.1. */
+
+/* constrain16() of cdef_simd.h on 16 values at a time. */
+SIMD_INLINE v256 constrain16_256(v256 a, v256 b, unsigned int threshold,
+                                 unsigned int adjdamp) {
+  v256 diff = v256_sub_16(a, b);
+  const v256 sign = v256_shr_n_s16(diff, 15);
+  diff = v256_abs_s16(diff);
+  const v256 s =
+      v256_ssub_u16(v256_dup_16(threshold), v256_shr_u16(diff, adjdamp));
+  return v256_xor(v256_add_16(sign, v256_min_s16(diff, s)), sign);
+}
+
+/* Loads the four rows of a 4x4 block, the first row in the high lanes. */
+static INLINE v256 load_4x4(const uint16_t *in, int stride) {
+  return v256_from_v64(v64_load_unaligned(&in[0 * stride]),
+                       v64_load_unaligned(&in[1 * stride]),
+                       v64_load_unaligned(&in[2 * stride]),
+                       v64_load_unaligned(&in[3 * stride]));
+}
+
+/* Loads two rows of an 8x8 block, the first row in the high lanes. */
+static INLINE v256 load_8x2(const uint16_t *in, int stride) {
+  return v256_from_v128(v128_load_unaligned(&in[0]),
+                        v128_load_unaligned(&in[stride]));
+}
+
+/* The whole 4x4 block is filtered at once as 16 values. */
+void od_filter_dering_direction_4x4_avx2(uint16_t *y, int ystride,
+                                         const uint16_t *in, int threshold,
+                                         int dir, int damping) {
+  v256 p0, p1, sum, row, res;
+  v128 res_hi, res_lo;
+  int o1 = OD_DIRECTION_OFFSETS_TABLE[dir][0];
+  int o2 = OD_DIRECTION_OFFSETS_TABLE[dir][1];
+
+  if (threshold) damping -= get_msb(threshold);
+  sum = v256_zero();
+  row = load_4x4(in, OD_FILT_BSTRIDE);
+
+  // p0 = constrain16(in[i*OD_FILT_BSTRIDE + offset], row, threshold, damping)
+  p0 = load_4x4(in + o1, OD_FILT_BSTRIDE);
+  p0 = constrain16_256(p0, row, threshold, damping);
+
+  // p1 = constrain16(in[i*OD_FILT_BSTRIDE - offset], row, threshold, damping)
+  p1 = load_4x4(in - o1, OD_FILT_BSTRIDE);
+  p1 = constrain16_256(p1, row, threshold, damping);
+
+  // sum += 4 * (p0 + p1)
+  sum = v256_add_16(sum, v256_shl_n_16(v256_add_16(p0, p1), 2));
+
+  // p0 = constrain16(in[i*OD_FILT_BSTRIDE + offset], row, threshold, damping)
+  p0 = load_4x4(in + o2, OD_FILT_BSTRIDE);
+  p0 = constrain16_256(p0, row, threshold, damping);
+
+  // p1 = constrain16(in[i*OD_FILT_BSTRIDE - offset], row, threshold, damping)
+  p1 = load_4x4(in - o2, OD_FILT_BSTRIDE);
+  p1 = constrain16_256(p1, row, threshold, damping);
+
+  // sum += 1 * (p0 + p1)
+  sum = v256_add_16(sum, v256_add_16(p0, p1));
+
+  // res = row + ((sum + 8) >> 4)
+  res = v256_add_16(sum, v256_dup_16(8));
+  res = v256_shr_n_s16(res, 4);
+  res = v256_add_16(row, res);
+  res_hi = v256_high_v128(res);
+  res_lo = v256_low_v128(res);
+  v64_store_aligned(&y[0 * ystride], v128_high_v64(res_hi));
+  v64_store_aligned(&y[1 * ystride], v128_low_v64(res_hi));
+  v64_store_aligned(&y[2 * ystride], v128_high_v64(res_lo));
+  v64_store_aligned(&y[3 * ystride], v128_low_v64(res_lo));
+}
+
+/* Two rows of the 8x8 block are filtered per iteration. */
+void od_filter_dering_direction_8x8_avx2(uint16_t *y, int ystride,
+                                         const uint16_t *in, int threshold,
+                                         int dir, int damping) {
+  int i;
+  v256 sum, p0, p1, row, res;
+  int o1 = OD_DIRECTION_OFFSETS_TABLE[dir][0];
+  int o2 = OD_DIRECTION_OFFSETS_TABLE[dir][1];
+  int o3 = OD_DIRECTION_OFFSETS_TABLE[dir][2];
+
+  if (threshold) damping -= get_msb(threshold);
+  for (i = 0; i < 8; i += 2) {
+    const uint16_t *const in_i = &in[i * OD_FILT_BSTRIDE];
+    sum = v256_zero();
+    row = load_8x2(in_i, OD_FILT_BSTRIDE);
+
+    // p0 = constrain16(in[i*OD_FILT_BSTRIDE + offset], row, threshold, damping)
+    p0 = load_8x2(in_i + o1, OD_FILT_BSTRIDE);
+    p0 = constrain16_256(p0, row, threshold, damping);
+
+    // p1 = constrain16(in[i*OD_FILT_BSTRIDE - offset], row, threshold, damping)
+    p1 = load_8x2(in_i - o1, OD_FILT_BSTRIDE);
+    p1 = constrain16_256(p1, row, threshold, damping);
+
+    // sum += 3 * (p0 + p1)
+    p0 = v256_add_16(p0, p1);
+    p0 = v256_add_16(p0, v256_shl_n_16(p0, 1));
+    sum = v256_add_16(sum, p0);
+
+    // p0 = constrain16(in[i*OD_FILT_BSTRIDE + offset], row, threshold, damping)
+    p0 = load_8x2(in_i + o2, OD_FILT_BSTRIDE);
+    p0 = constrain16_256(p0, row, threshold, damping);
+
+    // p1 = constrain16(in[i*OD_FILT_BSTRIDE - offset], row, threshold, damping)
+    p1 = load_8x2(in_i - o2, OD_FILT_BSTRIDE);
+    p1 = constrain16_256(p1, row, threshold, damping);
+
+    // sum += 2 * (p0 + p1)
+    p0 = v256_shl_n_16(v256_add_16(p0, p1), 1);
+    sum = v256_add_16(sum, p0);
+
+    // p0 = constrain16(in[i*OD_FILT_BSTRIDE + offset], row, threshold, damping)
+    p0 = load_8x2(in_i + o3, OD_FILT_BSTRIDE);
+    p0 = constrain16_256(p0, row, threshold, damping);
+
+    // p1 = constrain16(in[i*OD_FILT_BSTRIDE - offset], row, threshold, damping)
+    p1 = load_8x2(in_i - o3, OD_FILT_BSTRIDE);
+    p1 = constrain16_256(p1, row, threshold, damping);
+
+    // sum += (p0 + p1)
+    p0 = v256_add_16(p0, p1);
+    sum = v256_add_16(sum, p0);
+
+    // res = row + ((sum + 8) >> 4)
+    res = v256_add_16(sum, v256_dup_16(8));
+    res = v256_shr_n_s16(res, 4);
+    res = v256_add_16(row, res);
+    v128_store_unaligned(&y[i * ystride], v256_high_v128(res));
+    v128_store_unaligned(&y[(i + 1) * ystride], v256_low_v128(res));
+  }
+}
+
+/* The rectangle copies move 16 pixels per step, then 8, then 1. */
+void copy_rect8_8bit_to_16bit_avx2(uint16_t *dst, int dstride,
+                                   const uint8_t *src, int sstride, int v,
+                                   int h) {
+  int i, j;
+  for (i = 0; i < v; i++) {
+    for (j = 0; j < (h & ~0xf); j += 16) {
+      v128 row = v128_load_unaligned(&src[i * sstride + j]);
+      v256_store_unaligned(&dst[i * dstride + j], v256_unpack_u8_s16(row));
+    }
+    for (; j < (h & ~0x7); j += 8) {
+      v64 row = v64_load_unaligned(&src[i * sstride + j]);
+      v128_store_unaligned(&dst[i * dstride + j], v128_unpack_u8_s16(row));
+    }
+    for (; j < h; j++) {
+      dst[i * dstride + j] = src[i * sstride + j];
+    }
+  }
+}
+
+void copy_rect8_16bit_to_16bit_avx2(uint16_t *dst, int dstride,
+                                    const uint16_t *src, int sstride, int v,
+                                    int h) {
+  int i, j;
+  for (i = 0; i < v; i++) {
+    for (j = 0; j < (h & ~0xf); j += 16) {
+      v256 row = v256_load_unaligned(&src[i * sstride + j]);
+      v256_store_unaligned(&dst[i * dstride + j], row);
+    }
+    for (; j < (h & ~0x7); j += 8) {
+      v128 row = v128_load_unaligned(&src[i * sstride + j]);
+      v128_store_unaligned(&dst[i * dstride + j], row);
+    }
+    for (; j < h; j++) {
+      dst[i * dstride + j] = src[i * sstride + j];
+    }
+  }
+}
@@ -47,10 +47,10 @@ extern "C" {
 #define REF_FRAMES_LOG2 3
 #define REF_FRAMES (1 << REF_FRAMES_LOG2)
 
-// 4 scratch frames for the new frames to support a maximum of 4 cores decoding
-// in parallel, 3 for scaled references on the encoder.
-// TODO(hkuang): Add ondemand frame buffers instead of hardcoding the number
-// of framebuffers.
+// The smallest BufferPool: 4 scratch frames for the new frames to support a
+// maximum of 4 cores decoding in parallel, 3 for scaled references on the
+// encoder. The decoder adds one per frame worker and per cached output frame
+// beyond those.
 // TODO(jkoleszar): These 3 extra references could probably come from the
 // normal reference pool.
 #define FRAME_BUFFERS (REF_FRAMES + 7)
@@ -111,6 +111,11 @@ typedef struct {
   int mi_cols;
 #if CONFIG_GLOBAL_MOTION
   WarpedMotionParams global_motion[TOTAL_REFS_PER_FRAME];
+  // FAST corners of the frame, found by the encoder's global motion search
+  // the first time it searches against the frame, and kept for as long as the
+  // buffer holds the frame. num_corners is -1 until then.
+  int *corners;
+  int num_corners;
 #endif  // CONFIG_GLOBAL_MOTION
   aom_codec_frame_buffer_t raw_frame_buffer;
   YV12_BUFFER_CONFIG buf;
@@ -144,7 +149,9 @@ typedef struct BufferPool {
   aom_get_frame_buffer_cb_fn_t get_fb_cb;
   aom_release_frame_buffer_cb_fn_t release_fb_cb;
 
-  RefCntBuffer frame_bufs[FRAME_BUFFERS];
+  // Allocated by av1_alloc_pool_frame_bufs().
+  RefCntBuffer *frame_bufs;
+  int num_frame_bufs;
 
   // Frame buffers allocated internally by the codec.
   InternalFrameBufferList int_frame_buffers;
@@ -473,7 +480,7 @@ static void unlock_buffer_pool(BufferPool *const pool) {
 static INLINE YV12_BUFFER_CONFIG *get_ref_frame(AV1_COMMON *cm, int index) {
   if (index < 0 || index >= REF_FRAMES) return NULL;
   if (cm->ref_frame_map[index] < 0) return NULL;
-  assert(cm->ref_frame_map[index] < FRAME_BUFFERS);
+  assert(cm->ref_frame_map[index] < cm->buffer_pool->num_frame_bufs);
   return &cm->buffer_pool->frame_bufs[cm->ref_frame_map[index]].buf;
 }
 
@@ -487,11 +494,15 @@ static INLINE int get_free_fb(AV1_COMMON *cm) {
   int i;
 
   lock_buffer_pool(cm->buffer_pool);
-  for (i = 0; i < FRAME_BUFFERS; ++i)
+  for (i = 0; i < cm->buffer_pool->num_frame_bufs; ++i)
     if (frame_bufs[i].ref_count == 0) break;
 
-  if (i != FRAME_BUFFERS) {
+  if (i != cm->buffer_pool->num_frame_bufs) {
     frame_bufs[i].ref_count = 1;
+#if CONFIG_GLOBAL_MOTION
+    // The buffer is about to hold a new frame.
+    frame_bufs[i].num_corners = -1;
+#endif  // CONFIG_GLOBAL_MOTION
   } else {
     // Reset i to be INVALID_IDX to indicate no free buffer found.
     i = INVALID_IDX;
@@ -102,24 +102,36 @@ static void loop_restoration_init(RestorationInternal *rst, int kf) {
   rst->keyframe = kf;
 }
 
-void extend_frame(uint8_t *data, int width, int height, int stride) {
+// Extends rows [start, end) of the frame to the left and right, along with the
+// rows above the frame once row 0 is extended and the rows below the frame
+// once the last row is.
+static void extend_frame_rows(uint8_t *data, int width, int height, int stride,
+                              int start, int end) {
   uint8_t *data_p;
   int i;
-  for (i = 0; i < height; ++i) {
+  for (i = start; i < end; ++i) {
     data_p = data + i * stride;
     memset(data_p - WIENER_HALFWIN, data_p[0], WIENER_HALFWIN);
     memset(data_p + width, data_p[width - 1], WIENER_HALFWIN);
   }
   data_p = data - WIENER_HALFWIN;
-  for (i = -WIENER_HALFWIN; i < 0; ++i) {
-    memcpy(data_p + i * stride, data_p, width + 2 * WIENER_HALFWIN);
+  if (start == 0 && end > 0) {
+    for (i = -WIENER_HALFWIN; i < 0; ++i) {
+      memcpy(data_p + i * stride, data_p, width + 2 * WIENER_HALFWIN);
+    }
   }
-  for (i = height; i < height + WIENER_HALFWIN; ++i) {
-    memcpy(data_p + i * stride, data_p + (height - 1) * stride,
-           width + 2 * WIENER_HALFWIN);
+  if (start < end && end == height) {
+    for (i = height; i < height + WIENER_HALFWIN; ++i) {
+      memcpy(data_p + i * stride, data_p + (height - 1) * stride,
+             width + 2 * WIENER_HALFWIN);
+    }
   }
 }
 
+void extend_frame(uint8_t *data, int width, int height, int stride) {
+  extend_frame_rows(data, width, height, stride, 0, height);
+}
+
 static void loop_copy_tile(uint8_t *data, int tile_idx, int subtile_idx,
                            int subtile_bits, int width, int height, int stride,
                            RestorationInternal *rst, uint8_t *dst,
@@ -565,27 +577,29 @@ const int32_t one_by_x[MAX_NELEM] = {
   102,  100,  98,   95,   93,  91,  89,  87,  85,  84
 };
 
-static void av1_selfguided_restoration_internal(int32_t *dgd, int width,
-                                                int height, int stride,
-                                                int bit_depth, int r, int eps,
-                                                int32_t *tmpbuf) {
-  int32_t *A = tmpbuf;
-  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
-  int8_t num[RESTORATION_TILEPELS_MAX];
+// As boxnum(), but also correct for tiles which are smaller than the window
+static void boxnum_clipped(int width, int height, int r, int8_t *num,
+                           int num_stride) {
   int i, j;
-  // Adjusting the stride of A and B here appears to avoid bad cache effects,
-  // leading to a significant speed improvement.
-  // We also align the stride to a multiple of 16 bytes, for consistency
-  // with the SIMD version of this function.
-  int buf_stride = ((width + 3) & ~3) + 16;
+  for (i = 0; i < height; ++i) {
+    const int rows = AOMMIN(i + r, height - 1) - AOMMAX(i - r, 0) + 1;
+    for (j = 0; j < width; ++j) {
+      const int cols = AOMMIN(j + r, width - 1) - AOMMAX(j - r, 0) + 1;
+      num[i * num_stride + j] = rows * cols;
+    }
+  }
+}
 
-  // Don't filter tiles with dimensions < 5 on any axis
-  if ((width < 5) || (height < 5)) return;
+// Filter dgd in place, given the box sums of radius r of dgd in B and of its
+// square in A, and the number of pixels in each box in num. A and B are
+// overwritten.
+static void selfguided_filter(int32_t *dgd, int width, int height, int stride,
+                              int bit_depth, int r, int eps, int32_t *A,
+                              int32_t *B, int buf_stride, const int8_t *num) {
+  int i, j;
 
-  boxsum(dgd, width, height, stride, r, 0, B, buf_stride);
-  boxsum(dgd, width, height, stride, r, 1, A, buf_stride);
-  boxnum(width, height, r, num, width);
   assert(r <= 3);
+  (void)r;
   for (i = 0; i < height; ++i) {
     for (j = 0; j < width; ++j) {
       const int k = i * buf_stride + j;
@@ -744,6 +758,132 @@ static void av1_selfguided_restoration_internal(int32_t *dgd, int width,
   }
 }
 
+static void av1_selfguided_restoration_internal(int32_t *dgd, int width,
+                                                int height, int stride,
+                                                int bit_depth, int r, int eps,
+                                                int32_t *tmpbuf) {
+  int32_t *A = tmpbuf;
+  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
+  int8_t num[RESTORATION_TILEPELS_MAX];
+  // Adjusting the stride of A and B here appears to avoid bad cache effects,
+  // leading to a significant speed improvement.
+  // We also align the stride to a multiple of 16 bytes, for consistency
+  // with the SIMD version of this function.
+  int buf_stride = ((width + 3) & ~3) + 16;
+
+  // Don't filter tiles with dimensions < 5 on any axis
+  if ((width < 5) || (height < 5)) return;
+
+  boxsum(dgd, width, height, stride, r, 0, B, buf_stride);
+  boxsum(dgd, width, height, stride, r, 1, A, buf_stride);
+  boxnum(width, height, r, num, width);
+  selfguided_filter(dgd, width, height, stride, bit_depth, r, eps, A, B,
+                    buf_stride, num);
+}
+
+// Box sums of radius r, clipped to the tile, from the integral images of
+// av1_selfguided_integral_images(). These match boxsum() for any tile which
+// is at least (2 * r + 1) pixels wide and high.
+static void box_sums_from_integral(const int32_t *ii, const int32_t *ii_sq,
+                                   int width, int height, int r, int32_t *A,
+                                   int32_t *B, int buf_stride) {
+  const int ii_stride = SGRPROJ_INTEGRAL_STRIDE(width);
+  int i, j;
+  for (i = 0; i < height; ++i) {
+    // Rows (i0 - 1) and i1 of the integral images. The sums may have wrapped
+    // around, but the box sums themselves fit in 32 bits.
+    const int i0 = AOMMAX(i - r, 0);
+    const int i1 = AOMMIN(i + r, height - 1);
+    const int top = (i0 - 1 + SGRPROJ_INTEGRAL_BORDER) * ii_stride +
+                    SGRPROJ_INTEGRAL_BORDER;
+    const int bot =
+        (i1 + SGRPROJ_INTEGRAL_BORDER) * ii_stride + SGRPROJ_INTEGRAL_BORDER;
+    for (j = 0; j < width; ++j) {
+      const int j0 = AOMMAX(j - r, 0) - 1;
+      const int j1 = AOMMIN(j + r, width - 1);
+      B[i * buf_stride + j] =
+          (int32_t)((uint32_t)ii[bot + j1] - (uint32_t)ii[bot + j0] -
+                    (uint32_t)ii[top + j1] + (uint32_t)ii[top + j0]);
+      A[i * buf_stride + j] =
+          (int32_t)((uint32_t)ii_sq[bot + j1] - (uint32_t)ii_sq[bot + j0] -
+                    (uint32_t)ii_sq[top + j1] + (uint32_t)ii_sq[top + j0]);
+    }
+  }
+}
+
+static void clear_integral_images_top(int32_t *ii, int32_t *ii_sq,
+                                      int width) {
+  const int ii_stride = SGRPROJ_INTEGRAL_STRIDE(width);
+  memset(ii, 0, SGRPROJ_INTEGRAL_BORDER * ii_stride * sizeof(*ii));
+  memset(ii_sq, 0, SGRPROJ_INTEGRAL_BORDER * ii_stride * sizeof(*ii_sq));
+}
+
+// Fill in the left and right edges of the integral images of a tile, once the
+// rows of the tile itself have been computed.
+static void extend_integral_images(int32_t *ii, int32_t *ii_sq, int width,
+                                   int height) {
+  const int ii_stride = SGRPROJ_INTEGRAL_STRIDE(width);
+  int i, j;
+  for (i = SGRPROJ_INTEGRAL_BORDER; i < height + SGRPROJ_INTEGRAL_BORDER;
+       ++i) {
+    int32_t *row = ii + i * ii_stride;
+    int32_t *row_sq = ii_sq + i * ii_stride;
+    for (j = 0; j < SGRPROJ_INTEGRAL_BORDER; ++j) row[j] = row_sq[j] = 0;
+    for (j = width + SGRPROJ_INTEGRAL_BORDER; j < ii_stride; ++j) {
+      row[j] = row[width + SGRPROJ_INTEGRAL_BORDER - 1];
+      row_sq[j] = row_sq[width + SGRPROJ_INTEGRAL_BORDER - 1];
+    }
+  }
+}
+
+void av1_selfguided_integral_images_c(uint8_t *dgd, int width, int height,
+                                      int stride, int32_t *ii,
+                                      int32_t *ii_sq) {
+  const int ii_stride = SGRPROJ_INTEGRAL_STRIDE(width);
+  int i, j;
+  clear_integral_images_top(ii, ii_sq, width);
+  for (i = 0; i < height; ++i) {
+    // Use unsigned arithmetic, as the integral image of the squares can wrap
+    uint32_t *row = (uint32_t *)ii +
+                    (i + SGRPROJ_INTEGRAL_BORDER) * ii_stride +
+                    SGRPROJ_INTEGRAL_BORDER;
+    uint32_t *row_sq = (uint32_t *)ii_sq +
+                       (i + SGRPROJ_INTEGRAL_BORDER) * ii_stride +
+                       SGRPROJ_INTEGRAL_BORDER;
+    uint32_t sum = 0, sum_sq = 0;
+    for (j = 0; j < width; ++j) {
+      const uint32_t x = dgd[i * stride + j];
+      sum += x;
+      sum_sq += x * x;
+      row[j] = row[j - ii_stride] + sum;
+      row_sq[j] = row_sq[j - ii_stride] + sum_sq;
+    }
+  }
+  extend_integral_images(ii, ii_sq, width, height);
+}
+
+void av1_selfguided_restoration_from_integral_c(
+    uint8_t *dgd, int width, int height, int stride, const int32_t *ii,
+    const int32_t *ii_sq, int32_t *dst, int dst_stride, int r, int eps,
+    int32_t *tmpbuf) {
+  int32_t *A = tmpbuf;
+  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
+  int8_t num[RESTORATION_TILEPELS_MAX];
+  int buf_stride = ((width + 3) & ~3) + 16;
+  int i, j;
+  for (i = 0; i < height; ++i) {
+    for (j = 0; j < width; ++j) {
+      dst[i * dst_stride + j] = dgd[i * stride + j];
+    }
+  }
+  if ((width < 5) || (height < 5)) return;
+
+  box_sums_from_integral(ii, ii_sq, width, height, r, A, B, buf_stride);
+  boxnum_clipped(width, height, r, num, width);
+  selfguided_filter(dst, width, height, dst_stride, 8, r, eps, A, B,
+                    buf_stride, num);
+}
+
 void av1_selfguided_restoration_c(uint8_t *dgd, int width, int height,
                                   int stride, int32_t *dst, int dst_stride,
                                   int r, int eps, int32_t *tmpbuf) {
@@ -937,26 +1077,35 @@ static void loop_switchable_filter(uint8_t *data, int width, int height,
 }
 
 #if CONFIG_HIGHBITDEPTH
-void extend_frame_highbd(uint16_t *data, int width, int height, int stride) {
+static void extend_frame_rows_highbd(uint16_t *data, int width, int height,
+                                     int stride, int start, int end) {
   uint16_t *data_p;
   int i, j;
-  for (i = 0; i < height; ++i) {
+  for (i = start; i < end; ++i) {
     data_p = data + i * stride;
     for (j = -WIENER_HALFWIN; j < 0; ++j) data_p[j] = data_p[0];
     for (j = width; j < width + WIENER_HALFWIN; ++j)
       data_p[j] = data_p[width - 1];
   }
   data_p = data - WIENER_HALFWIN;
-  for (i = -WIENER_HALFWIN; i < 0; ++i) {
-    memcpy(data_p + i * stride, data_p,
-           (width + 2 * WIENER_HALFWIN) * sizeof(uint16_t));
+  if (start == 0 && end > 0) {
+    for (i = -WIENER_HALFWIN; i < 0; ++i) {
+      memcpy(data_p + i * stride, data_p,
+             (width + 2 * WIENER_HALFWIN) * sizeof(uint16_t));
+    }
   }
-  for (i = height; i < height + WIENER_HALFWIN; ++i) {
-    memcpy(data_p + i * stride, data_p + (height - 1) * stride,
-           (width + 2 * WIENER_HALFWIN) * sizeof(uint16_t));
+  if (start < end && end == height) {
+    for (i = height; i < height + WIENER_HALFWIN; ++i) {
+      memcpy(data_p + i * stride, data_p + (height - 1) * stride,
+             (width + 2 * WIENER_HALFWIN) * sizeof(uint16_t));
+    }
   }
 }
 
+void extend_frame_highbd(uint16_t *data, int width, int height, int stride) {
+  extend_frame_rows_highbd(data, width, height, stride, 0, height);
+}
+
 static void loop_copy_tile_highbd(uint16_t *data, int tile_idx, int subtile_idx,
                                   int subtile_bits, int width, int height,
                                   int stride, RestorationInternal *rst,
@@ -1041,6 +1190,53 @@ void av1_selfguided_restoration_highbd_c(uint16_t *dgd, int width, int height,
                                       r, eps, tmpbuf);
 }
 
+void av1_selfguided_integral_images_highbd_c(uint16_t *dgd, int width,
+                                             int height, int stride,
+                                             int32_t *ii, int32_t *ii_sq) {
+  const int ii_stride = SGRPROJ_INTEGRAL_STRIDE(width);
+  int i, j;
+  clear_integral_images_top(ii, ii_sq, width);
+  for (i = 0; i < height; ++i) {
+    uint32_t *row = (uint32_t *)ii +
+                    (i + SGRPROJ_INTEGRAL_BORDER) * ii_stride +
+                    SGRPROJ_INTEGRAL_BORDER;
+    uint32_t *row_sq = (uint32_t *)ii_sq +
+                       (i + SGRPROJ_INTEGRAL_BORDER) * ii_stride +
+                       SGRPROJ_INTEGRAL_BORDER;
+    uint32_t sum = 0, sum_sq = 0;
+    for (j = 0; j < width; ++j) {
+      const uint32_t x = dgd[i * stride + j];
+      sum += x;
+      sum_sq += x * x;
+      row[j] = row[j - ii_stride] + sum;
+      row_sq[j] = row_sq[j - ii_stride] + sum_sq;
+    }
+  }
+  extend_integral_images(ii, ii_sq, width, height);
+}
+
+void av1_selfguided_restoration_from_integral_highbd_c(
+    uint16_t *dgd, int width, int height, int stride, const int32_t *ii,
+    const int32_t *ii_sq, int32_t *dst, int dst_stride, int bit_depth, int r,
+    int eps, int32_t *tmpbuf) {
+  int32_t *A = tmpbuf;
+  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
+  int8_t num[RESTORATION_TILEPELS_MAX];
+  int buf_stride = ((width + 3) & ~3) + 16;
+  int i, j;
+  for (i = 0; i < height; ++i) {
+    for (j = 0; j < width; ++j) {
+      dst[i * dst_stride + j] = dgd[i * stride + j];
+    }
+  }
+  if ((width < 5) || (height < 5)) return;
+
+  box_sums_from_integral(ii, ii_sq, width, height, r, A, B, buf_stride);
+  boxnum_clipped(width, height, r, num, width);
+  selfguided_filter(dst, width, height, dst_stride, bit_depth, r, eps, A, B,
+                    buf_stride, num);
+}
+
 void av1_highpass_filter_highbd_c(uint16_t *dgd, int width, int height,
                                   int stride, int32_t *dst, int dst_stride,
                                   int corner, int edge) {
@@ -1416,3 +1612,246 @@ void av1_loop_restoration_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   loop_restoration_rows(frame, cm, start_mi_row, end_mi_row, components_pattern,
                         rsi, dst);
 }
+
+// Filters one restoration tile with the filter it signals.
+static void loop_restoration_tile(uint8_t *data8, int tile_idx, int width,
+                                  int height, int stride,
+                                  RestorationInternal *rst, int highbd,
+                                  int bit_depth, uint8_t *dst8,
+                                  int dst_stride) {
+#if CONFIG_HIGHBITDEPTH
+  if (highbd) {
+    uint16_t *data = CONVERT_TO_SHORTPTR(data8);
+    uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
+    switch (rst->rsi->restoration_type[tile_idx]) {
+      case RESTORE_WIENER:
+        loop_wiener_filter_tile_highbd(data, tile_idx, width, height, stride,
+                                       rst, bit_depth, dst, dst_stride);
+        break;
+      case RESTORE_SGRPROJ:
+        loop_sgrproj_filter_tile_highbd(data, tile_idx, width, height, stride,
+                                        rst, bit_depth, dst, dst_stride);
+        break;
+      default:
+        loop_copy_tile_highbd(data, tile_idx, 0, 0, width, height, stride, rst,
+                              dst, dst_stride);
+        break;
+    }
+    return;
+  }
+#else
+  (void)highbd;
+  (void)bit_depth;
+#endif  // CONFIG_HIGHBITDEPTH
+  switch (rst->rsi->restoration_type[tile_idx]) {
+    case RESTORE_WIENER:
+      loop_wiener_filter_tile(data8, tile_idx, width, height, stride, rst, dst8,
+                              dst_stride);
+      break;
+    case RESTORE_SGRPROJ:
+      loop_sgrproj_filter_tile(data8, tile_idx, width, height, stride, rst,
+                               dst8, dst_stride);
+      break;
+    default:
+      loop_copy_tile(data8, tile_idx, 0, 0, width, height, stride, rst, dst8,
+                     dst_stride);
+      break;
+  }
+}
+
+static void copy_plane_rows(const uint8_t *src8, int src_stride, uint8_t *dst8,
+                            int dst_stride, int width, int start, int end,
+                            int highbd) {
+  int i;
+#if CONFIG_HIGHBITDEPTH
+  if (highbd) {
+    const uint16_t *src = CONVERT_TO_SHORTPTR(src8);
+    uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
+    for (i = start; i < end; ++i)
+      memcpy(dst + i * dst_stride, src + i * src_stride, width * sizeof(*dst));
+    return;
+  }
+#else
+  (void)highbd;
+#endif  // CONFIG_HIGHBITDEPTH
+  for (i = start; i < end; ++i)
+    memcpy(dst8 + i * dst_stride, src8 + i * src_stride, width);
+}
+
+static uint8_t *plane_buffer(const YV12_BUFFER_CONFIG *buf, int plane) {
+  return plane == 0 ? buf->y_buffer : plane == 1 ? buf->u_buffer
+                                                 : buf->v_buffer;
+}
+
+void av1_loop_restoration_init_rows(AV1LrState *lr, YV12_BUFFER_CONFIG *frame,
+                                    AV1_COMMON *cm) {
+  int plane;
+  lr->frame = frame;
+  memset(&lr->dst, 0, sizeof(lr->dst));
+  if (aom_realloc_frame_buffer(
+          &lr->dst, frame->y_crop_width, frame->y_crop_height,
+          cm->subsampling_x, cm->subsampling_y,
+#if CONFIG_HIGHBITDEPTH
+          cm->use_highbitdepth,
+#endif
+          AOM_BORDER_IN_PIXELS, cm->byte_alignment, NULL, NULL, NULL) < 0)
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate restoration dst buffer");
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    RestorationInternal *const rst = &lr->rst[plane];
+    const int width = plane ? frame->uv_crop_width : frame->y_crop_width;
+    const int height = plane ? frame->uv_crop_height : frame->y_crop_height;
+    *rst = cm->rst_internal;
+    rst->rsi = &cm->rst_info[plane];
+    rst->ntiles = av1_get_rest_ntiles(
+        width, height, rst->rsi->restoration_tilesize, &rst->tile_width,
+        &rst->tile_height, &rst->nhtiles, &rst->nvtiles);
+    loop_restoration_init(rst, cm->frame_type == KEY_FRAME);
+    lr->tile_rows_done[plane] = 0;
+    lr->rows_extended[plane] = 0;
+    lr->rows_copied[plane] = 0;
+  }
+}
+
+static void loop_restoration_plane_rows(AV1LrState *lr, AV1_COMMON *cm,
+                                        int plane, int ready) {
+  YV12_BUFFER_CONFIG *const frame = lr->frame;
+  RestorationInternal *const rst = &lr->rst[plane];
+  const RestorationType frame_type = rst->rsi->frame_restoration_type;
+  const int width = plane ? frame->uv_crop_width : frame->y_crop_width;
+  const int height = plane ? frame->uv_crop_height : frame->y_crop_height;
+  const int stride = plane ? frame->uv_stride : frame->y_stride;
+  const int dst_stride = plane ? lr->dst.uv_stride : lr->dst.y_stride;
+  // Like aom_yv12_copy_frame(), copy back the aligned size of the plane.
+  const int copy_width = plane ? lr->dst.uv_width : lr->dst.y_width;
+  const int copy_height = plane ? lr->dst.uv_height : lr->dst.y_height;
+  uint8_t *const data = plane_buffer(frame, plane);
+  uint8_t *const dst = plane_buffer(&lr->dst, plane);
+#if CONFIG_HIGHBITDEPTH
+  const int highbd = cm->use_highbitdepth;
+#else
+  const int highbd = 0;
+#endif  // CONFIG_HIGHBITDEPTH
+  int copy_end;
+
+  if (frame_type == RESTORE_NONE) return;
+  ready = AOMMIN(ready, height);
+
+  if (frame_type == RESTORE_WIENER || frame_type == RESTORE_SWITCHABLE) {
+#if CONFIG_HIGHBITDEPTH
+    if (highbd)
+      extend_frame_rows_highbd(CONVERT_TO_SHORTPTR(data), width, height,
+                               stride, lr->rows_extended[plane], ready);
+    else
+#endif  // CONFIG_HIGHBITDEPTH
+      extend_frame_rows(data, width, height, stride, lr->rows_extended[plane],
+                        ready);
+    lr->rows_extended[plane] = ready;
+  }
+
+  // A row of restoration tiles is filtered once every row the filters read,
+  // including the rows written past the tile by the convolution blocks, is
+  // final.
+  while (lr->tile_rows_done[plane] < rst->nvtiles) {
+    const int tile_row = lr->tile_rows_done[plane];
+    const int v_end = tile_row < rst->nvtiles - 1
+                          ? (tile_row + 1) * rst->tile_height
+                          : height;
+    int tile_col;
+    if (ready < height && v_end + RESTORATION_ROW_BORDER > ready) break;
+    for (tile_col = 0; tile_col < rst->nhtiles; ++tile_col) {
+      loop_restoration_tile(data, tile_row * rst->nhtiles + tile_col, width,
+                            height, stride, rst, highbd, cm->bit_depth, dst,
+                            dst_stride);
+    }
+    ++lr->tile_rows_done[plane];
+  }
+
+  // Rows are copied back to the frame once no tile left to filter reads them.
+  if (lr->tile_rows_done[plane] == rst->nvtiles)
+    copy_end = copy_height;
+  else
+    copy_end = lr->tile_rows_done[plane] * rst->tile_height - WIENER_HALFWIN;
+  if (copy_end > lr->rows_copied[plane]) {
+    copy_plane_rows(dst, dst_stride, data, stride, copy_width,
+                    lr->rows_copied[plane], copy_end, highbd);
+    lr->rows_copied[plane] = copy_end;
+  }
+}
+
+void av1_loop_restoration_rows(AV1LrState *lr, AV1_COMMON *cm, int ready) {
+  const YV12_BUFFER_CONFIG *const frame = lr->frame;
+  int plane;
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    int plane_ready = ready;
+    if (plane) {
+      plane_ready = ready >= frame->y_crop_height
+                        ? frame->uv_crop_height
+                        : ready >> cm->subsampling_y;
+    }
+    loop_restoration_plane_rows(lr, cm, plane, plane_ready);
+  }
+}
+
+void av1_loop_restoration_free_rows(AV1LrState *lr) {
+  aom_free_frame_buffer(&lr->dst);
+}
+
+int av1_loop_restoration_init_jobs(AV1LrState *lr, YV12_BUFFER_CONFIG *frame,
+                                   AV1_COMMON *cm) {
+  int num_jobs = 0;
+  int plane;
+  av1_loop_restoration_init_rows(lr, frame, cm);
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    const RestorationType frame_type =
+        lr->rst[plane].rsi->frame_restoration_type;
+    const int width = plane ? frame->uv_crop_width : frame->y_crop_width;
+    const int height = plane ? frame->uv_crop_height : frame->y_crop_height;
+    const int stride = plane ? frame->uv_stride : frame->y_stride;
+    lr->first_job[plane] = num_jobs;
+    if (frame_type == RESTORE_NONE) continue;
+    if (frame_type == RESTORE_WIENER || frame_type == RESTORE_SWITCHABLE) {
+#if CONFIG_HIGHBITDEPTH
+      if (cm->use_highbitdepth)
+        extend_frame_highbd(CONVERT_TO_SHORTPTR(plane_buffer(frame, plane)),
+                            width, height, stride);
+      else
+#endif  // CONFIG_HIGHBITDEPTH
+        extend_frame(plane_buffer(frame, plane), width, height, stride);
+      lr->rows_extended[plane] = height;
+    }
+    num_jobs += lr->rst[plane].ntiles;
+  }
+  lr->first_job[MAX_MB_PLANE] = num_jobs;
+  return num_jobs;
+}
+
+void av1_loop_restoration_job(const AV1LrState *lr, AV1_COMMON *cm, int job,
+                              int32_t *tmpbuf) {
+  const YV12_BUFFER_CONFIG *const frame = lr->frame;
+  RestorationInternal rst;
+  int plane = 0;
+  while (job >= lr->first_job[plane + 1]) ++plane;
+  rst = lr->rst[plane];
+  rst.tmpbuf = tmpbuf;
+  loop_restoration_tile(
+      plane_buffer(frame, plane), job - lr->first_job[plane],
+      plane ? frame->uv_crop_width : frame->y_crop_width,
+      plane ? frame->uv_crop_height : frame->y_crop_height,
+      plane ? frame->uv_stride : frame->y_stride, &rst,
+#if CONFIG_HIGHBITDEPTH
+      cm->use_highbitdepth,
+#else
+      0,
+#endif  // CONFIG_HIGHBITDEPTH
+      cm->bit_depth, plane_buffer(&lr->dst, plane),
+      plane ? lr->dst.uv_stride : lr->dst.y_stride);
+}
+
+void av1_loop_restoration_finish_jobs(AV1LrState *lr, AV1_COMMON *cm) {
+  int plane;
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane)
+    lr->tile_rows_done[plane] = lr->rst[plane].nvtiles;
+  av1_loop_restoration_rows(lr, cm, lr->frame->y_crop_height);
+  av1_loop_restoration_free_rows(lr);
+}
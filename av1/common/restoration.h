@@ -36,7 +36,17 @@ extern "C" {
 #define SGRPROJ_TMPBUF_SIZE                         \
   (RESTORATION_TILEPELS_MAX * 2 * sizeof(int32_t) + \
    SGRPROJ_OUTBUF_SIZE * 2 * sizeof(int32_t))
-#define SGRPROJ_EXTBUF_SIZE (0)
+// The encoder's parameter search computes the integral images of each tile,
+// and of its square, once and reads the box sums for every radius off them.
+// Each image has SGRPROJ_INTEGRAL_BORDER rows of zeros above the tile and as
+// many columns of zeros to its left, and repeats the last column of the tile
+// up to the end of each row.
+#define SGRPROJ_INTEGRAL_BORDER (MAX_RADIUS + 1)
+#define SGRPROJ_INTEGRAL_STRIDE(width) ((((width) + 7) & ~7) + 8)
+#define SGRPROJ_INTEGRAL_SIZE                                  \
+  (SGRPROJ_INTEGRAL_STRIDE(RESTORATION_TILESIZE_MAX * 3 / 2) * \
+   (RESTORATION_TILESIZE_MAX * 3 / 2 + SGRPROJ_INTEGRAL_BORDER))
+#define SGRPROJ_EXTBUF_SIZE (SGRPROJ_INTEGRAL_SIZE * 2 * sizeof(int32_t))
 #define SGRPROJ_PARAMS_BITS 4
 #define SGRPROJ_PARAMS (1 << SGRPROJ_PARAMS_BITS)
 #define USE_HIGHPASS_IN_SGRPROJ 0
@@ -122,7 +132,7 @@ extern "C" {
 #define RESTORATION_TMPBUF_SIZE (SGRPROJ_TMPBUF_SIZE)
 
 // Max of SGRPROJ_EXTBUF_SIZE, WIENER_EXTBUF_SIZE
-#define RESTORATION_EXTBUF_SIZE (WIENER_EXTBUF_SIZE)
+#define RESTORATION_EXTBUF_SIZE (SGRPROJ_EXTBUF_SIZE)
 
 // Check the assumptions of the existing code
 #if SUBPEL_TAPS != WIENER_WIN + 1
@@ -172,6 +182,26 @@ typedef struct {
   int32_t *tmpbuf;
 } RestorationInternal;
 
+// Number of rows below a row of restoration tiles that are read, or written
+// and later overwritten, when the tile row is filtered.
+#define RESTORATION_ROW_BORDER (15 + WIENER_HALFWIN + 1)
+
+// Loop restoration of a frame whose rows become final from the top down.
+typedef struct AV1LrState {
+  YV12_BUFFER_CONFIG *frame;
+  YV12_BUFFER_CONFIG dst;
+  RestorationInternal rst[MAX_MB_PLANE];
+  // Per plane, the number of restoration tile rows filtered, the number of
+  // rows extended for the Wiener filter and the number of rows copied back
+  // to the frame.
+  int tile_rows_done[MAX_MB_PLANE];
+  int rows_extended[MAX_MB_PLANE];
+  int rows_copied[MAX_MB_PLANE];
+  // The first restoration tile job of each plane, and the number of jobs,
+  // when the frame is filtered by av1_loop_restoration_job().
+  int first_job[MAX_MB_PLANE + 1];
+} AV1LrState;
+
 static INLINE void set_default_sgrproj(SgrprojInfo *sgrproj_info) {
   sgrproj_info->xqd[0] = (SGRPROJ_PRJ_MIN0 + SGRPROJ_PRJ_MAX0) / 2;
   sgrproj_info->xqd[1] = (SGRPROJ_PRJ_MIN1 + SGRPROJ_PRJ_MAX1) / 2;
@@ -257,6 +287,28 @@ void av1_loop_restoration_frame(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
                                 RestorationInfo *rsi, int components_pattern,
                                 int partial_frame, YV12_BUFFER_CONFIG *dst);
 void av1_loop_restoration_precal();
+
+// Applies the loop restoration of av1_loop_restoration_frame() to all planes
+// as the frame becomes final: av1_loop_restoration_rows() filters what it can
+// once the first 'ready' luma rows of the frame will no longer change, and
+// finishes the frame once 'ready' reaches the frame height.
+void av1_loop_restoration_init_rows(AV1LrState *lr, YV12_BUFFER_CONFIG *frame,
+                                    struct AV1Common *cm);
+void av1_loop_restoration_rows(AV1LrState *lr, struct AV1Common *cm,
+                               int ready);
+void av1_loop_restoration_free_rows(AV1LrState *lr);
+
+// Applies the loop restoration of av1_loop_restoration_frame() to all planes
+// as independent jobs, one per restoration tile. The jobs may run in any order
+// and in parallel, each given its own scratch buffer of
+// RESTORATION_TMPBUF_SIZE values. av1_loop_restoration_init_jobs() returns the
+// number of jobs, and av1_loop_restoration_finish_jobs() copies the result
+// back to the frame once they are all done.
+int av1_loop_restoration_init_jobs(AV1LrState *lr, YV12_BUFFER_CONFIG *frame,
+                                   struct AV1Common *cm);
+void av1_loop_restoration_job(const AV1LrState *lr, struct AV1Common *cm,
+                              int job, int32_t *tmpbuf);
+void av1_loop_restoration_finish_jobs(AV1LrState *lr, struct AV1Common *cm);
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -6726,22 +6726,63 @@ void av1_update_neighbors(int tx_size, const int16_t *scan,
   neighbors[tx2d_size * MAX_NEIGHBORS + 1] = scan[0];
 }
 
-void av1_update_sort_order(TX_SIZE tx_size, TX_TYPE tx_type,
-                           const uint32_t *non_zero_prob, int16_t *sort_order) {
+// Sorts the augmented probabilities in decreasing order by insertion, which
+// is linear when they are nearly sorted already. Past about the number of
+// comparisons of a quick sort, what is left is quick sorted instead. Returns
+// 0 if the probabilities were already sorted.
+static int sort_prob(uint32_t *prob, int n, int max_shifts) {
+  int shifts = 0;
+  int i, j;
+  for (i = 1; i < n; ++i) {
+    const uint32_t p = prob[i];
+    if (prob[i - 1] > p) continue;
+    for (j = i; j > 0 && prob[j - 1] < p; --j) prob[j] = prob[j - 1];
+    prob[j] = p;
+    shifts += i - j;
+    if (shifts > max_shifts) {
+      qsort(prob, n, sizeof(*prob), cmp_prob);
+      break;
+    }
+  }
+  return shifts;
+}
+
+int av1_update_sort_order_from(TX_SIZE tx_size, TX_TYPE tx_type,
+                               const uint32_t *non_zero_prob,
+                               const int16_t *prev_order,
+                               int16_t *sort_order) {
   const SCAN_ORDER *sc = get_default_scan(tx_size, tx_type, 0);
+  uint32_t augmented[COEFF_IDX_SIZE];
   uint32_t temp[COEFF_IDX_SIZE];
   const int tx2d_size = tx_size_2d[tx_size];
+  const int tx2d_size_log2 =
+      tx_size_wide_log2[tx_size] + tx_size_high_log2[tx_size];
   int sort_idx;
   assert(tx2d_size <= COEFF_IDX_SIZE);
-  memcpy(temp, non_zero_prob, tx2d_size * sizeof(*non_zero_prob));
-  av1_augment_prob(tx_size, tx_type, temp);
-  qsort(temp, tx2d_size, sizeof(*temp), cmp_prob);
+  memcpy(augmented, non_zero_prob, tx2d_size * sizeof(*non_zero_prob));
+  av1_augment_prob(tx_size, tx_type, augmented);
+  for (sort_idx = 0; sort_idx < tx2d_size; ++sort_idx)
+    temp[sort_idx] = augmented[prev_order[sort_idx]];
+  if (sort_prob(temp, tx2d_size, tx2d_size * tx2d_size_log2) == 0) {
+    memcpy(sort_order, prev_order, tx2d_size * sizeof(*sort_order));
+    return 0;
+  }
   for (sort_idx = 0; sort_idx < tx2d_size; ++sort_idx) {
     const int default_scan_idx =
         (temp[sort_idx] & COEFF_IDX_MASK) ^ COEFF_IDX_MASK;
     const int coeff_idx = sc->scan[default_scan_idx];
     sort_order[sort_idx] = coeff_idx;
   }
+  return 1;
+}
+
+void av1_update_sort_order(TX_SIZE tx_size, TX_TYPE tx_type,
+                           const uint32_t *non_zero_prob, int16_t *sort_order) {
+  // Equal probabilities are ordered as in the default scan, so the initial
+  // probabilities, which are all equal, are already sorted from it.
+  const SCAN_ORDER *sc = get_default_scan(tx_size, tx_type, 0);
+  av1_update_sort_order_from(tx_size, tx_type, non_zero_prob, sc->scan,
+                             sort_order);
 }
 
 void av1_update_scan_order(TX_SIZE tx_size, int16_t *sort_order, int16_t *scan,
@@ -6776,6 +6817,26 @@ static void update_scan_order_facade(AV1_COMMON *cm, TX_SIZE tx_size,
   av1_update_neighbors(tx_size, scan, iscan, nb);
 }
 
+// Re-sorts the coefficients starting from the current scan order, which the
+// probabilities of the frame seldom change much. If they are still in scan
+// order, the scan order is its own topological sort and nothing else changes:
+// returns 0 without rebuilding the scan order and the neighbors.
+static int adapt_scan_order_facade(AV1_COMMON *cm, TX_SIZE tx_size,
+                                   TX_TYPE tx_type) {
+  int16_t sort_order[COEFF_IDX_SIZE];
+  uint32_t *non_zero_prob = get_non_zero_prob(cm->fc, tx_size, tx_type);
+  int16_t *scan = get_adapt_scan(cm->fc, tx_size, tx_type);
+  int16_t *iscan = get_adapt_iscan(cm->fc, tx_size, tx_type);
+  int16_t *nb = get_adapt_nb(cm->fc, tx_size, tx_type);
+  assert(tx_size_2d[tx_size] <= COEFF_IDX_SIZE);
+  if (!av1_update_sort_order_from(tx_size, tx_type, non_zero_prob, scan,
+                                  sort_order))
+    return 0;
+  av1_update_scan_order(tx_size, sort_order, scan, iscan);
+  av1_update_neighbors(tx_size, scan, iscan, nb);
+  return 1;
+}
+
 static void update_eob_threshold(AV1_COMMON *cm, TX_SIZE tx_size,
                                  TX_TYPE tx_type) {
   int i, row, col, row_limit, col_limit, cal_idx = 0;
@@ -6841,8 +6902,8 @@ void av1_adapt_scan_order(AV1_COMMON *cm) {
     TX_TYPE tx_type;
     for (tx_type = DCT_DCT; tx_type < TX_TYPES; ++tx_type) {
       update_scan_prob(cm, tx_size, tx_type, ADAPT_SCAN_UPDATE_RATE_16);
-      update_scan_order_facade(cm, tx_size, tx_type);
-      update_eob_threshold(cm, tx_size, tx_type);
+      if (adapt_scan_order_facade(cm, tx_size, tx_type))
+        update_eob_threshold(cm, tx_size, tx_type);
     }
   }
 }
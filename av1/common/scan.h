@@ -39,10 +39,17 @@ void av1_update_scan_count_facade(AV1_COMMON *cm, FRAME_COUNTS *counts,
 // will be scanned first
 void av1_augment_prob(TX_SIZE tx_size, TX_TYPE tx_type, uint32_t *prob);
 
-// apply quick sort on nonzero probabilities to obtain a sort order
+// sort the nonzero probabilities to obtain a sort order
 void av1_update_sort_order(TX_SIZE tx_size, TX_TYPE tx_type,
                            const uint32_t *non_zero_prob, int16_t *sort_order);
 
+// same as av1_update_sort_order(), but starting from prev_order, a previous
+// order of all the coefficients, which is cheap when the probabilities are
+// nearly in that order. Returns 0 if sort_order is the same as prev_order.
+int av1_update_sort_order_from(TX_SIZE tx_size, TX_TYPE tx_type,
+                               const uint32_t *non_zero_prob,
+                               const int16_t *prev_order, int16_t *sort_order);
+
 // apply topological sort on the nonzero probabilities sorting order to
 // guarantee each to-be-scanned coefficient's upper and left coefficient will be
 // scanned before the to-be-scanned coefficient.
@@ -9,9 +9,14 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <assert.h>
+
 #include "./aom_config.h"
 #include "aom_dsp/aom_dsp_common.h"
 #include "aom_mem/aom_mem.h"
+#if CONFIG_CDEF
+#include "av1/common/cdef.h"
+#endif  // CONFIG_CDEF
 #include "av1/common/entropymode.h"
 #include "av1/common/thread_common.h"
 #include "av1/common/reconinter.h"
@@ -33,32 +38,32 @@ static INLINE void mutex_lock(pthread_mutex_t *const mutex) {
 }
 #endif  // CONFIG_MULTITHREAD
 
-static INLINE void sync_read(AV1LfSync *const lf_sync, int r, int c) {
+void av1_row_sync_read(AV1RowSync *const row_sync, int r, int c) {
 #if CONFIG_MULTITHREAD
-  const int nsync = lf_sync->sync_range;
+  const int nsync = row_sync->sync_range;
 
   if (r && !(c & (nsync - 1))) {
-    pthread_mutex_t *const mutex = &lf_sync->mutex_[r - 1];
+    pthread_mutex_t *const mutex = &row_sync->mutex_[r - 1];
     mutex_lock(mutex);
 
-    while (c > lf_sync->cur_sb_col[r - 1] - nsync) {
-      pthread_cond_wait(&lf_sync->cond_[r - 1], mutex);
+    while (c > row_sync->cur_sb_col[r - 1] - nsync) {
+      pthread_cond_wait(&row_sync->cond_[r - 1], mutex);
     }
     pthread_mutex_unlock(mutex);
   }
 #else
-  (void)lf_sync;
+  (void)row_sync;
   (void)r;
   (void)c;
 #endif  // CONFIG_MULTITHREAD
 }
 
-static INLINE void sync_write(AV1LfSync *const lf_sync, int r, int c,
-                              const int sb_cols) {
+void av1_row_sync_write(AV1RowSync *const row_sync, int r, int c,
+                        const int sb_cols) {
 #if CONFIG_MULTITHREAD
-  const int nsync = lf_sync->sync_range;
+  const int nsync = row_sync->sync_range;
   int cur;
-  // Only signal when there are enough filtered SB for next row to run.
+  // Only signal when there are enough finished SB for next row to run.
   int sig = 1;
 
   if (c < sb_cols - 1) {
@@ -69,21 +74,81 @@ static INLINE void sync_write(AV1LfSync *const lf_sync, int r, int c,
   }
 
   if (sig) {
-    mutex_lock(&lf_sync->mutex_[r]);
+    mutex_lock(&row_sync->mutex_[r]);
 
-    lf_sync->cur_sb_col[r] = cur;
+    row_sync->cur_sb_col[r] = cur;
 
-    pthread_cond_signal(&lf_sync->cond_[r]);
-    pthread_mutex_unlock(&lf_sync->mutex_[r]);
+    pthread_cond_signal(&row_sync->cond_[r]);
+    pthread_mutex_unlock(&row_sync->mutex_[r]);
   }
 #else
-  (void)lf_sync;
+  (void)row_sync;
   (void)r;
   (void)c;
   (void)sb_cols;
 #endif  // CONFIG_MULTITHREAD
 }
 
+void av1_row_sync_reset(AV1RowSync *row_sync, int rows) {
+  assert(rows <= row_sync->rows);
+  memset(row_sync->cur_sb_col, -1, sizeof(*row_sync->cur_sb_col) * rows);
+}
+
+void av1_row_sync_alloc(AV1RowSync *row_sync, AV1_COMMON *cm, int rows,
+                        int sync_range) {
+  row_sync->rows = rows;
+#if CONFIG_MULTITHREAD
+  {
+    int i;
+
+    CHECK_MEM_ERROR(cm, row_sync->mutex_,
+                    aom_malloc(sizeof(*row_sync->mutex_) * rows));
+    if (row_sync->mutex_) {
+      for (i = 0; i < rows; ++i) {
+        pthread_mutex_init(&row_sync->mutex_[i], NULL);
+      }
+    }
+
+    CHECK_MEM_ERROR(cm, row_sync->cond_,
+                    aom_malloc(sizeof(*row_sync->cond_) * rows));
+    if (row_sync->cond_) {
+      for (i = 0; i < rows; ++i) {
+        pthread_cond_init(&row_sync->cond_[i], NULL);
+      }
+    }
+  }
+#endif  // CONFIG_MULTITHREAD
+
+  CHECK_MEM_ERROR(cm, row_sync->cur_sb_col,
+                  aom_malloc(sizeof(*row_sync->cur_sb_col) * rows));
+
+  assert(sync_range > 0 && !(sync_range & (sync_range - 1)));
+  row_sync->sync_range = sync_range;
+}
+
+void av1_row_sync_dealloc(AV1RowSync *row_sync) {
+  if (row_sync != NULL) {
+#if CONFIG_MULTITHREAD
+    int i;
+
+    if (row_sync->mutex_ != NULL) {
+      for (i = 0; i < row_sync->rows; ++i) {
+        pthread_mutex_destroy(&row_sync->mutex_[i]);
+      }
+      aom_free(row_sync->mutex_);
+    }
+    if (row_sync->cond_ != NULL) {
+      for (i = 0; i < row_sync->rows; ++i) {
+        pthread_cond_destroy(&row_sync->cond_[i]);
+      }
+      aom_free(row_sync->cond_);
+    }
+#endif  // CONFIG_MULTITHREAD
+    aom_free(row_sync->cur_sb_col);
+    av1_zero(*row_sync);
+  }
+}
+
 #if !CONFIG_EXT_PARTITION_TYPES
 static INLINE enum lf_path get_loop_filter_path(
     int y_only, struct macroblockd_plane planes[MAX_MB_PLANE]) {
@@ -146,12 +211,13 @@ static INLINE void loop_filter_block_plane_hor(
 static int loop_filter_ver_row_worker(AV1LfSync *const lf_sync,
                                       LFWorkerData *const lf_data) {
   const int num_planes = lf_data->y_only ? 1 : MAX_MB_PLANE;
-  int mi_row, mi_col;
+  const int worker = (int)(lf_data - lf_sync->lfdata);
+  int job, mi_col;
 #if !CONFIG_EXT_PARTITION_TYPES
   enum lf_path path = get_loop_filter_path(lf_data->y_only, lf_data->planes);
 #endif
-  for (mi_row = lf_data->start; mi_row < lf_data->stop;
-       mi_row += lf_sync->num_workers * lf_data->cm->mib_size) {
+  while (aom_job_queue_pop(&lf_sync->job_queue, worker, &job)) {
+    const int mi_row = lf_data->start + job * lf_data->cm->mib_size;
     MODE_INFO **const mi =
         lf_data->cm->mi_grid_visible + mi_row * lf_data->cm->mi_stride;
 
@@ -185,13 +251,14 @@ static int loop_filter_hor_row_worker(AV1LfSync *const lf_sync,
   const int num_planes = lf_data->y_only ? 1 : MAX_MB_PLANE;
   const int sb_cols =
       mi_cols_aligned_to_sb(lf_data->cm) >> lf_data->cm->mib_size_log2;
-  int mi_row, mi_col;
+  const int worker = (int)(lf_data - lf_sync->lfdata);
+  int job, mi_col;
 #if !CONFIG_EXT_PARTITION_TYPES
   enum lf_path path = get_loop_filter_path(lf_data->y_only, lf_data->planes);
 #endif
 
-  for (mi_row = lf_data->start; mi_row < lf_data->stop;
-       mi_row += lf_sync->num_workers * lf_data->cm->mib_size) {
+  while (aom_job_queue_pop(&lf_sync->job_queue, worker, &job)) {
+    const int mi_row = lf_data->start + job * lf_data->cm->mib_size;
     MODE_INFO **const mi =
         lf_data->cm->mi_grid_visible + mi_row * lf_data->cm->mi_stride;
 
@@ -204,7 +271,7 @@ static int loop_filter_hor_row_worker(AV1LfSync *const lf_sync,
 
       // TODO(wenhao.zhang@intel.com): For better parallelization, reorder
       // the outer loop to column-based and remove the synchronizations here.
-      sync_read(lf_sync, r, c);
+      av1_row_sync_read(&lf_sync->row_sync, r, c);
 
       av1_setup_dst_planes(lf_data->planes, lf_data->cm->sb_size,
                            lf_data->frame_buffer, mi_row, mi_col);
@@ -219,7 +286,7 @@ static int loop_filter_hor_row_worker(AV1LfSync *const lf_sync,
         loop_filter_block_plane_hor(lf_data->cm, lf_data->planes, plane,
                                     mi + mi_col, mi_row, mi_col, path, &lfm);
 #endif
-      sync_write(lf_sync, r, c, sb_cols);
+      av1_row_sync_write(&lf_sync->row_sync, r, c, sb_cols);
     }
   }
   return 1;
@@ -230,7 +297,8 @@ static int loop_filter_row_worker(AV1LfSync *const lf_sync,
   const int num_planes = lf_data->y_only ? 1 : MAX_MB_PLANE;
   const int sb_cols =
       mi_cols_aligned_to_sb(lf_data->cm) >> lf_data->cm->mib_size_log2;
-  int mi_row, mi_col;
+  const int worker = (int)(lf_data - lf_sync->lfdata);
+  int job, mi_col;
 #if !CONFIG_EXT_PARTITION_TYPES
   enum lf_path path = get_loop_filter_path(lf_data->y_only, lf_data->planes);
 #endif  // !CONFIG_EXT_PARTITION_TYPES
@@ -242,8 +310,8 @@ static int loop_filter_row_worker(AV1LfSync *const lf_sync,
   exit(EXIT_FAILURE);
 #endif  // CONFIG_EXT_PARTITION
 
-  for (mi_row = lf_data->start; mi_row < lf_data->stop;
-       mi_row += lf_sync->num_workers * lf_data->cm->mib_size) {
+  while (aom_job_queue_pop(&lf_sync->job_queue, worker, &job)) {
+    const int mi_row = lf_data->start + job * lf_data->cm->mib_size;
     MODE_INFO **const mi =
         lf_data->cm->mi_grid_visible + mi_row * lf_data->cm->mi_stride;
 
@@ -256,7 +324,7 @@ static int loop_filter_row_worker(AV1LfSync *const lf_sync,
 #endif
       int plane;
 
-      sync_read(lf_sync, r, c);
+      av1_row_sync_read(&lf_sync->row_sync, r, c);
 
       av1_setup_dst_planes(lf_data->planes, lf_data->cm->sb_size,
                            lf_data->frame_buffer, mi_row, mi_col);
@@ -278,7 +346,7 @@ static int loop_filter_row_worker(AV1LfSync *const lf_sync,
                                     mi + mi_col, mi_row, mi_col, path, &lfm);
       }
 #endif  // CONFIG_EXT_PARTITION_TYPES
-      sync_write(lf_sync, r, c, sb_cols);
+      av1_row_sync_write(&lf_sync->row_sync, r, c, sb_cols);
     }
   }
   return 1;
@@ -297,6 +365,9 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   // input.
   const int tile_cols = cm->tile_cols;
   const int num_workers = AOMMIN(nworkers, tile_cols);
+  // Every superblock row is a job. Workers take the rows in ascending order
+  // and steal rows from each other when the load is uneven.
+  const int num_jobs = (stop - start + cm->mib_size - 1) >> cm->mib_size_log2;
   int i;
 
 #if CONFIG_EXT_PARTITION
@@ -306,7 +377,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   exit(EXIT_FAILURE);
 #endif  // CONFIG_EXT_PARTITION
 
-  if (!lf_sync->sync_range || sb_rows != lf_sync->rows ||
+  if (!lf_sync->row_sync.sync_range || sb_rows != lf_sync->row_sync.rows ||
       num_workers > lf_sync->num_workers) {
     av1_loop_filter_dealloc(lf_sync);
     av1_loop_filter_alloc(lf_sync, cm, sb_rows, cm->width, num_workers);
@@ -323,9 +394,10 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
 
 #if CONFIG_PARALLEL_DEBLOCKING
   // Initialize cur_sb_col to -1 for all SB rows.
-  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  av1_row_sync_reset(&lf_sync->row_sync, sb_rows);
 
   // Filter all the vertical edges in the whole frame
+  aom_job_queue_reset(&lf_sync->job_queue, num_workers, num_jobs);
   for (i = 0; i < num_workers; ++i) {
     AVxWorker *const worker = &workers[i];
     LFWorkerData *const lf_data = &lf_sync->lfdata[i];
@@ -336,7 +408,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
 
     // Loopfilter data
     av1_loop_filter_data_reset(lf_data, frame, cm, planes);
-    lf_data->start = start + i * cm->mib_size;
+    lf_data->start = start;
     lf_data->stop = stop;
     lf_data->y_only = y_only;
 
@@ -352,9 +424,11 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   for (i = 0; i < num_workers; ++i) {
     winterface->sync(&workers[i]);
   }
+  aom_job_queue_finish(&lf_sync->job_queue);
 
-  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  av1_row_sync_reset(&lf_sync->row_sync, sb_rows);
   // Filter all the horizontal edges in the whole frame
+  aom_job_queue_reset(&lf_sync->job_queue, num_workers, num_jobs);
   for (i = 0; i < num_workers; ++i) {
     AVxWorker *const worker = &workers[i];
     LFWorkerData *const lf_data = &lf_sync->lfdata[i];
@@ -365,7 +439,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
 
     // Loopfilter data
     av1_loop_filter_data_reset(lf_data, frame, cm, planes);
-    lf_data->start = start + i * cm->mib_size;
+    lf_data->start = start;
     lf_data->stop = stop;
     lf_data->y_only = y_only;
 
@@ -381,10 +455,12 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   for (i = 0; i < num_workers; ++i) {
     winterface->sync(&workers[i]);
   }
+  aom_job_queue_finish(&lf_sync->job_queue);
 #else   // CONFIG_PARALLEL_DEBLOCKING
   // Initialize cur_sb_col to -1 for all SB rows.
-  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  av1_row_sync_reset(&lf_sync->row_sync, sb_rows);
 
+  aom_job_queue_reset(&lf_sync->job_queue, num_workers, num_jobs);
   for (i = 0; i < num_workers; ++i) {
     AVxWorker *const worker = &workers[i];
     LFWorkerData *const lf_data = &lf_sync->lfdata[i];
@@ -395,7 +471,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
 
     // Loopfilter data
     av1_loop_filter_data_reset(lf_data, frame, cm, planes);
-    lf_data->start = start + i * cm->mib_size;
+    lf_data->start = start;
     lf_data->stop = stop;
     lf_data->y_only = y_only;
 
@@ -411,6 +487,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   for (i = 0; i < num_workers; ++i) {
     winterface->sync(&workers[i]);
   }
+  aom_job_queue_finish(&lf_sync->job_queue);
 #endif  // CONFIG_PARALLEL_DEBLOCKING
 }
 
@@ -454,67 +531,421 @@ static INLINE int get_sync_range(int width) {
 // Allocate memory for lf row synchronization
 void av1_loop_filter_alloc(AV1LfSync *lf_sync, AV1_COMMON *cm, int rows,
                            int width, int num_workers) {
-  lf_sync->rows = rows;
+  av1_row_sync_alloc(&lf_sync->row_sync, cm, rows, get_sync_range(width));
+
+  CHECK_MEM_ERROR(cm, lf_sync->lfdata,
+                  aom_malloc(num_workers * sizeof(*lf_sync->lfdata)));
+  lf_sync->num_workers = num_workers;
+
+  if (!aom_job_queue_alloc(&lf_sync->job_queue, num_workers))
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate loop filter job queue");
+}
+
+// Deallocate lf synchronization related mutex and data
+void av1_loop_filter_dealloc(AV1LfSync *lf_sync) {
+  if (lf_sync != NULL) {
+    av1_row_sync_dealloc(&lf_sync->row_sync);
+    aom_free(lf_sync->lfdata);
+    aom_job_queue_free(&lf_sync->job_queue);
+    // clear the structure as the source of this call may be a resize in which
+    // case this call will be followed by an _alloc() which may fail.
+    av1_zero(*lf_sync);
+  }
+}
+
+// Loop restoration of a superblock row leaves alone the bottom lines that
+// CDEF and deblocking of the rows below may still read.
+#define POST_FILTER_RESTORATION_LAG 8
+
 #if CONFIG_MULTITHREAD
-  {
-    int i;
+static void post_filter_alloc(AV1PostFilterSync *pf_sync, AV1_COMMON *cm) {
+  CHECK_MEM_ERROR(cm, pf_sync->mutex_, aom_malloc(sizeof(*pf_sync->mutex_)));
+  if (pf_sync->mutex_) pthread_mutex_init(pf_sync->mutex_, NULL);
+  CHECK_MEM_ERROR(cm, pf_sync->cond_, aom_malloc(sizeof(*pf_sync->cond_)));
+  if (pf_sync->cond_) pthread_cond_init(pf_sync->cond_, NULL);
+}
+#endif  // CONFIG_MULTITHREAD
 
-    CHECK_MEM_ERROR(cm, lf_sync->mutex_,
-                    aom_malloc(sizeof(*lf_sync->mutex_) * rows));
-    if (lf_sync->mutex_) {
-      for (i = 0; i < rows; ++i) {
-        pthread_mutex_init(&lf_sync->mutex_[i], NULL);
-      }
+void av1_post_filter_dealloc(AV1PostFilterSync *pf_sync) {
+  if (pf_sync != NULL) {
+#if CONFIG_MULTITHREAD
+    if (pf_sync->mutex_ != NULL) {
+      pthread_mutex_destroy(pf_sync->mutex_);
+      aom_free(pf_sync->mutex_);
     }
-
-    CHECK_MEM_ERROR(cm, lf_sync->cond_,
-                    aom_malloc(sizeof(*lf_sync->cond_) * rows));
-    if (lf_sync->cond_) {
-      for (i = 0; i < rows; ++i) {
-        pthread_cond_init(&lf_sync->cond_[i], NULL);
-      }
+    if (pf_sync->cond_ != NULL) {
+      pthread_cond_destroy(pf_sync->cond_);
+      aom_free(pf_sync->cond_);
     }
+#endif  // CONFIG_MULTITHREAD
+    aom_free(pf_sync->pfdata);
+    av1_zero(*pf_sync);
   }
+}
+
+static void post_filter_lock(AV1PostFilterSync *const pf_sync) {
+#if CONFIG_MULTITHREAD
+  if (pf_sync->mutex_ != NULL) mutex_lock(pf_sync->mutex_);
+#else
+  (void)pf_sync;
 #endif  // CONFIG_MULTITHREAD
+}
 
-  CHECK_MEM_ERROR(cm, lf_sync->lfdata,
-                  aom_malloc(num_workers * sizeof(*lf_sync->lfdata)));
-  lf_sync->num_workers = num_workers;
+// Releases the lock, first waking up the waiting workers if 'progress' is set.
+static void post_filter_unlock(AV1PostFilterSync *const pf_sync,
+                               int progress) {
+#if CONFIG_MULTITHREAD
+  if (pf_sync->mutex_ != NULL) {
+    if (progress) pthread_cond_broadcast(pf_sync->cond_);
+    pthread_mutex_unlock(pf_sync->mutex_);
+  }
+#else
+  (void)pf_sync;
+  (void)progress;
+#endif  // CONFIG_MULTITHREAD
+}
 
-  CHECK_MEM_ERROR(cm, lf_sync->cur_sb_col,
-                  aom_malloc(sizeof(*lf_sync->cur_sb_col) * rows));
+// Returns the number of superblock rows 'stage' can have filtered given the
+// progress of the stage feeding it.
+static int post_filter_rows_ready(const AV1PostFilterSync *const pf_sync,
+                                  int stage) {
+  int s;
+  for (s = stage - 1; s >= 0; --s) {
+    if (!pf_sync->enabled[s]) continue;
+    // Deblocking a row changes the bottom lines of the row above.
+    if (s == POST_FILTER_DEBLOCK && pf_sync->rows_done[s] < pf_sync->rows)
+      return pf_sync->rows_done[s] - 1;
+    return pf_sync->rows_done[s];
+  }
+  return pf_sync->rows;
+}
 
-  // Set up nsync.
-  lf_sync->sync_range = get_sync_range(width);
+// Returns 1 if the next row of 'stage' can be started. A CDEF row also waits
+// for the row above to save the lines they share.
+static int post_filter_row_ready(const AV1PostFilterSync *const pf_sync,
+                                 int stage) {
+  const int row = pf_sync->rows_started[stage];
+  if (row >= post_filter_rows_ready(pf_sync, stage)) return 0;
+  return stage != POST_FILTER_CDEF || pf_sync->cdef_lines_saved == row;
 }
 
-// Deallocate lf synchronization related mutex and data
-void av1_loop_filter_dealloc(AV1LfSync *lf_sync) {
-  if (lf_sync != NULL) {
+static void post_filter_row(AV1PostFilterSync *const pf_sync, int stage,
+                            int row) {
+  AV1_COMMON *const cm = pf_sync->cm;
+  switch (stage) {
+    case POST_FILTER_DEBLOCK:
+      av1_loop_filter_sb_rows(pf_sync->frame, cm, pf_sync->planes,
+                              row * MAX_MIB_SIZE,
+                              AOMMIN((row + 1) * MAX_MIB_SIZE, cm->mi_rows), 0);
+      break;
+#if CONFIG_CDEF
+    case POST_FILTER_CDEF: av1_cdef_sb_row(pf_sync->cdef, cm, row); break;
+#endif  // CONFIG_CDEF
+#if CONFIG_LOOP_RESTORATION
+    case POST_FILTER_RESTORATION:
+      av1_loop_restoration_rows(
+          pf_sync->lr, cm,
+          row == pf_sync->rows - 1
+              ? pf_sync->frame->y_crop_height
+              : ((row + 1) * MAX_MIB_SIZE << MI_SIZE_LOG2) -
+                    POST_FILTER_RESTORATION_LAG);
+      break;
+#endif  // CONFIG_LOOP_RESTORATION
+    default: assert(0 && "Invalid post filter stage"); break;
+  }
+}
+
+// Records that the worker finished 'row' of 'stage'. CDEF rows may finish
+// out of order, so CDEF is done up to the first row still being filtered.
+static void post_filter_row_done(AV1PostFilterSync *const pf_sync,
+                                 AV1PostFilterWorkerData *const pf_data,
+                                 int stage, int row) {
+  int i;
+  if (stage != POST_FILTER_CDEF) {
+    pf_sync->rows_done[stage] = row + 1;
+    return;
+  }
+  pf_data->cdef_row = -1;
+  pf_sync->rows_done[stage] = pf_sync->rows_started[stage];
+  for (i = 0; i < pf_sync->num_pfdata; ++i) {
+    if (pf_sync->pfdata[i].cdef_row >= 0)
+      pf_sync->rows_done[stage] =
+          AOMMIN(pf_sync->rows_done[stage], pf_sync->pfdata[i].cdef_row);
+  }
+}
+
+// Returns 1 if one of the stages of the worker can start a row, or if they
+// have all started their last row.
+static int post_filter_can_progress(const AV1PostFilterSync *const pf_sync,
+                                    const AV1PostFilterWorkerData *pf_data) {
+  int finished = 1;
+  int s;
+  for (s = pf_data->first_stage; s < pf_data->last_stage; ++s) {
+    if (!pf_sync->enabled[s] || pf_sync->rows_started[s] == pf_sync->rows)
+      continue;
+    if (post_filter_row_ready(pf_sync, s)) return 1;
+    finished = 0;
+  }
+  return finished;
+}
+
+// Interleaves the stages of the worker a superblock row at a time, waiting on
+// the stages run by other workers when none of them can progress.
+static int post_filter_worker(AV1PostFilterSync *const pf_sync,
+                              AV1PostFilterWorkerData *const pf_data) {
+  for (;;) {
+    int pending = 0;
+    int progress = 0;
+    int s;
+    for (s = pf_data->first_stage; s < pf_data->last_stage; ++s) {
+      int row;
+      if (!pf_sync->enabled[s]) continue;
+      post_filter_lock(pf_sync);
+      row = pf_sync->rows_started[s];
+      if (row == pf_sync->rows || !post_filter_row_ready(pf_sync, s)) {
+        pending |= row < pf_sync->rows;
+        post_filter_unlock(pf_sync, 0);
+        continue;
+      }
+      pending = 1;
+      pf_sync->rows_started[s] = row + 1;
+      if (s == POST_FILTER_CDEF) pf_data->cdef_row = row;
+      post_filter_unlock(pf_sync, 0);
+
+#if CONFIG_CDEF
+      if (s == POST_FILTER_CDEF) {
+        av1_cdef_save_lines(pf_sync->cdef, pf_sync->cm, row);
+        post_filter_lock(pf_sync);
+        pf_sync->cdef_lines_saved = row + 1;
+        post_filter_unlock(pf_sync, 1);
+      }
+#endif  // CONFIG_CDEF
+      post_filter_row(pf_sync, s, row);
+      progress = 1;
+      post_filter_lock(pf_sync);
+      post_filter_row_done(pf_sync, pf_data, s, row);
+      post_filter_unlock(pf_sync, 1);
+    }
+    if (!pending) break;
+    if (!progress) {
 #if CONFIG_MULTITHREAD
-    int i;
+      assert(pf_sync->mutex_ != NULL);
+      mutex_lock(pf_sync->mutex_);
+      while (!post_filter_can_progress(pf_sync, pf_data))
+        pthread_cond_wait(pf_sync->cond_, pf_sync->mutex_);
+      pthread_mutex_unlock(pf_sync->mutex_);
+#else
+      // Without threads the workers run one after the other in stage order,
+      // so the stages feeding this worker are already finished.
+      assert(0 && "Post filter stage cannot progress");
+      break;
+#endif  // CONFIG_MULTITHREAD
+    }
+  }
+  return 1;
+}
 
-    if (lf_sync->mutex_ != NULL) {
-      for (i = 0; i < lf_sync->rows; ++i) {
-        pthread_mutex_destroy(&lf_sync->mutex_[i]);
+void av1_post_filter_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                           MACROBLOCKD *xd, int deblock, int cdef,
+                           int restoration, AVxWorker *workers,
+                           int num_workers, AV1PostFilterSync *pf_sync) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+#if CONFIG_CDEF
+  AV1CdefState cdef_state;
+#endif  // CONFIG_CDEF
+#if CONFIG_LOOP_RESTORATION
+  AV1LrState lr_state;
+#endif  // CONFIG_LOOP_RESTORATION
+  int stages[POST_FILTER_STAGES];
+  int num_stages = 0;
+  int num_groups;
+  int num_helpers;
+  int num_used;
+  int i, j;
+
+#if !CONFIG_CDEF
+  assert(!cdef);
+#endif  // !CONFIG_CDEF
+#if !CONFIG_LOOP_RESTORATION
+  assert(!restoration);
+#endif  // !CONFIG_LOOP_RESTORATION
+  pf_sync->frame = frame;
+  pf_sync->cm = cm;
+  pf_sync->rows = (cm->mi_rows + MAX_MIB_SIZE - 1) / MAX_MIB_SIZE;
+  pf_sync->enabled[POST_FILTER_DEBLOCK] = deblock;
+  pf_sync->enabled[POST_FILTER_CDEF] = cdef;
+  pf_sync->enabled[POST_FILTER_RESTORATION] = restoration;
+  for (i = 0; i < POST_FILTER_STAGES; ++i) {
+    pf_sync->rows_started[i] = 0;
+    pf_sync->rows_done[i] = 0;
+    if (pf_sync->enabled[i]) stages[num_stages++] = i;
+  }
+  pf_sync->cdef_lines_saved = 0;
+  if (num_stages == 0) return;
+
+  // Split the stages into contiguous groups, one per worker, and let the
+  // workers left over help with CDEF, the most expensive stage.
+  num_groups = AOMMAX(1, AOMMIN(num_workers, num_stages));
+  num_helpers = cdef ? AOMMAX(0, num_workers - num_groups) : 0;
+  num_used = num_groups + num_helpers;
+  if (pf_sync->num_pfdata < num_used) {
+    aom_free(pf_sync->pfdata);
+    pf_sync->num_pfdata = 0;
+    CHECK_MEM_ERROR(cm, pf_sync->pfdata,
+                    aom_malloc(num_used * sizeof(*pf_sync->pfdata)));
+    pf_sync->num_pfdata = num_used;
+  }
+#if CONFIG_MULTITHREAD
+  if (num_used > 1 && pf_sync->mutex_ == NULL)
+    post_filter_alloc(pf_sync, cm);
+#endif  // CONFIG_MULTITHREAD
+  // Workers are started upstream first so that they also complete when run in
+  // turn, with the CDEF helpers right after the group running CDEF.
+  for (i = 0, j = 0; i < num_groups; ++i) {
+    AV1PostFilterWorkerData *pf_data = &pf_sync->pfdata[j++];
+    pf_data->first_stage = stages[i * num_stages / num_groups];
+    pf_data->last_stage = stages[(i + 1) * num_stages / num_groups - 1] + 1;
+    pf_data->cdef_row = -1;
+    if (cdef && pf_data->first_stage <= POST_FILTER_CDEF &&
+        pf_data->last_stage > POST_FILTER_CDEF) {
+      for (; num_helpers > 0; --num_helpers) {
+        pf_data = &pf_sync->pfdata[j++];
+        pf_data->first_stage = POST_FILTER_CDEF;
+        pf_data->last_stage = POST_FILTER_CDEF + 1;
+        pf_data->cdef_row = -1;
       }
-      aom_free(lf_sync->mutex_);
     }
-    if (lf_sync->cond_ != NULL) {
-      for (i = 0; i < lf_sync->rows; ++i) {
-        pthread_cond_destroy(&lf_sync->cond_[i]);
+  }
+  for (; j < pf_sync->num_pfdata; ++j) pf_sync->pfdata[j].cdef_row = -1;
+
+  if (deblock) {
+    av1_loop_filter_frame_init(cm, cm->lf.filter_level);
+    av1_loop_filter_init_rows(cm);
+    memcpy(pf_sync->planes, xd->plane, sizeof(pf_sync->planes));
+  }
+  pf_sync->cdef = NULL;
+  pf_sync->lr = NULL;
+#if CONFIG_CDEF
+  if (cdef) {
+    pf_sync->cdef = &cdef_state;
+    av1_cdef_init_rows(pf_sync->cdef, frame, cm, xd);
+  }
+#endif  // CONFIG_CDEF
+#if CONFIG_LOOP_RESTORATION
+  if (restoration) {
+    pf_sync->lr = &lr_state;
+    av1_loop_restoration_init_rows(pf_sync->lr, frame, cm);
+  }
+#endif  // CONFIG_LOOP_RESTORATION
+
+  if (num_workers == 0) {
+    post_filter_worker(pf_sync, &pf_sync->pfdata[0]);
+  } else {
+    for (i = 0; i < num_used; ++i) {
+      AVxWorker *const worker = &workers[i];
+      worker->hook = (AVxWorkerHook)post_filter_worker;
+      worker->data1 = pf_sync;
+      worker->data2 = &pf_sync->pfdata[i];
+      if (i == num_used - 1) {
+        winterface->execute(worker);
+      } else {
+        winterface->launch(worker);
       }
-      aom_free(lf_sync->cond_);
     }
-#endif  // CONFIG_MULTITHREAD
-    aom_free(lf_sync->lfdata);
-    aom_free(lf_sync->cur_sb_col);
-    // clear the structure as the source of this call may be a resize in which
-    // case this call will be followed by an _alloc() which may fail.
-    av1_zero(*lf_sync);
+    for (i = 0; i < num_used; ++i) {
+      winterface->sync(&workers[i]);
+    }
+  }
+
+#if CONFIG_CDEF
+  if (cdef) av1_cdef_free_rows(pf_sync->cdef);
+#endif  // CONFIG_CDEF
+#if CONFIG_LOOP_RESTORATION
+  if (restoration) av1_loop_restoration_free_rows(pf_sync->lr);
+#endif  // CONFIG_LOOP_RESTORATION
+  pf_sync->cdef = NULL;
+  pf_sync->lr = NULL;
+}
+
+#if CONFIG_LOOP_RESTORATION
+static void loop_restoration_alloc(AV1LrSync *lr_sync, AV1_COMMON *cm,
+                                   int num_workers) {
+  int i;
+  CHECK_MEM_ERROR(cm, lr_sync->lrdata,
+                  aom_calloc(num_workers, sizeof(*lr_sync->lrdata)));
+  lr_sync->num_workers = num_workers;
+  for (i = 0; i < num_workers; ++i) {
+    CHECK_MEM_ERROR(cm, lr_sync->lrdata[i].tmpbuf,
+                    (int32_t *)aom_memalign(
+                        16, RESTORATION_TMPBUF_SIZE *
+                                sizeof(*lr_sync->lrdata[i].tmpbuf)));
+  }
+  if (!aom_job_queue_alloc(&lr_sync->job_queue, num_workers))
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate loop restoration job queue");
+}
+
+void av1_loop_restoration_dealloc(AV1LrSync *lr_sync) {
+  if (lr_sync != NULL) {
+    int i;
+    if (lr_sync->lrdata != NULL) {
+      for (i = 0; i < lr_sync->num_workers; ++i)
+        aom_free(lr_sync->lrdata[i].tmpbuf);
+      aom_free(lr_sync->lrdata);
+    }
+    aom_job_queue_free(&lr_sync->job_queue);
+    av1_zero(*lr_sync);
   }
 }
 
+static int loop_restoration_worker(AV1LrSync *const lr_sync,
+                                   AV1LrWorkerData *const lr_data) {
+  const int worker = (int)(lr_data - lr_sync->lrdata);
+  int job;
+  while (aom_job_queue_pop(&lr_sync->job_queue, worker, &job))
+    av1_loop_restoration_job(lr_sync->lr, lr_sync->cm, job, lr_data->tmpbuf);
+  return 1;
+}
+
+void av1_loop_restoration_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                                   AVxWorker *workers, int num_workers,
+                                   AV1LrSync *lr_sync) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  AV1LrState lr;
+  int num_jobs;
+  int i;
+
+  if (lr_sync->num_workers < num_workers) {
+    av1_loop_restoration_dealloc(lr_sync);
+    loop_restoration_alloc(lr_sync, cm, num_workers);
+  }
+  num_jobs = av1_loop_restoration_init_jobs(&lr, frame, cm);
+  lr_sync->lr = &lr;
+  lr_sync->cm = cm;
+
+  aom_job_queue_reset(&lr_sync->job_queue, num_workers, num_jobs);
+  for (i = 0; i < num_workers; ++i) {
+    AVxWorker *const worker = &workers[i];
+    worker->hook = (AVxWorkerHook)loop_restoration_worker;
+    worker->data1 = lr_sync;
+    worker->data2 = &lr_sync->lrdata[i];
+    if (i == num_workers - 1) {
+      winterface->execute(worker);
+    } else {
+      winterface->launch(worker);
+    }
+  }
+  for (i = 0; i < num_workers; ++i) {
+    winterface->sync(&workers[i]);
+  }
+  aom_job_queue_finish(&lr_sync->job_queue);
+
+  av1_loop_restoration_finish_jobs(&lr, cm);
+  lr_sync->lr = NULL;
+}
+#endif  // CONFIG_LOOP_RESTORATION
+
 // Accumulate frame counts. FRAME_COUNTS consist solely of 'unsigned int'
 // members, so we treat it as an array, and sum over the whole length.
 void av1_accumulate_frame_counts(FRAME_COUNTS *acc_counts,
@@ -527,3 +958,20 @@ void av1_accumulate_frame_counts(FRAME_COUNTS *acc_counts,
 
   for (i = 0; i < n_counts; i++) acc[i] += cnt[i];
 }
+
+#if CONFIG_INTERNAL_STATS
+void av1_print_job_stats(FILE *f, const char *name,
+                         const AVxJobQueue *queue) {
+  int i;
+
+  if (queue->stats == NULL) return;
+
+  for (i = 0; i < queue->max_workers; ++i) {
+    const AVxJobStats *const stats = &queue->stats[i];
+    if (stats->jobs == 0) continue;
+    fprintf(f, "%-12s\t%6d\t%10.3f\t%10.3f\t%8d\t%8d\n", name, i,
+            stats->busy_us / 1000.0, stats->idle_us / 1000.0, stats->jobs,
+            stats->steals);
+  }
+}
+#endif  // CONFIG_INTERNAL_STATS
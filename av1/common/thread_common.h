@@ -11,6 +11,7 @@
 
 #ifndef AV1_COMMON_LOOPFILTER_THREAD_H_
 #define AV1_COMMON_LOOPFILTER_THREAD_H_
+#include <stdio.h>
 #include "./aom_config.h"
 #include "av1/common/av1_loopfilter.h"
 #include "aom_util/aom_thread.h"
@@ -20,24 +21,51 @@ extern "C" {
 #endif
 
 struct AV1Common;
+struct AV1CdefState;
+struct AV1LrState;
 struct FRAME_COUNTS;
 
-// Loopfilter row synchronization
-typedef struct AV1LfSyncData {
+// Superblock row synchronization: a row may work on a superblock column only
+// once the row above is at least sync_range columns further along.
+typedef struct AV1RowSync {
 #if CONFIG_MULTITHREAD
   pthread_mutex_t *mutex_;
   pthread_cond_t *cond_;
 #endif
-  // Allocate memory to store the loop-filtered superblock index in each row.
+  // The last finished superblock column in each superblock row.
   int *cur_sb_col;
-  // The optimal sync_range for different resolution and platform should be
-  // determined by testing. Currently, it is chosen to be a power-of-2 number.
+  // A power of 2. The optimal value for different resolutions and platforms
+  // should be determined by testing.
   int sync_range;
   int rows;
+} AV1RowSync;
+
+// Allocate memory for the synchronization of 'rows' superblock rows.
+void av1_row_sync_alloc(AV1RowSync *row_sync, struct AV1Common *cm, int rows,
+                        int sync_range);
+
+// Deallocate superblock row synchronization related mutex and data.
+void av1_row_sync_dealloc(AV1RowSync *row_sync);
+
+// Marks the first 'rows' superblock rows as not started.
+void av1_row_sync_reset(AV1RowSync *row_sync, int rows);
+
+// Waits until row r may work on superblock column c.
+void av1_row_sync_read(AV1RowSync *const row_sync, int r, int c);
+
+// Records that row r has finished superblock column c of sb_cols.
+void av1_row_sync_write(AV1RowSync *const row_sync, int r, int c,
+                        const int sb_cols);
+
+// Loopfilter row synchronization
+typedef struct AV1LfSyncData {
+  AV1RowSync row_sync;
 
   // Row-based parallel loopfilter data
   LFWorkerData *lfdata;
   int num_workers;
+  // Superblock rows still to be filtered, with per-worker load counters.
+  AVxJobQueue job_queue;
 } AV1LfSync;
 
 // Allocate memory for loopfilter row synchronization.
@@ -54,9 +82,100 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
                               int partial_frame, AVxWorker *workers,
                               int num_workers, AV1LfSync *lf_sync);
 
+// The in-loop filters run after the frame is decoded, in pipeline order.
+enum {
+  POST_FILTER_DEBLOCK,
+  POST_FILTER_CDEF,
+  POST_FILTER_RESTORATION,
+  POST_FILTER_STAGES
+};
+
+// The post filter stages [first_stage, last_stage) run by one worker.
+typedef struct AV1PostFilterWorkerData {
+  int first_stage;
+  int last_stage;
+  // The CDEF superblock row being filtered by the worker, or -1.
+  int cdef_row;
+} AV1PostFilterWorkerData;
+
+// Superblock row synchronization between the post filter stages.
+typedef struct AV1PostFilterSync {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *mutex_;
+  pthread_cond_t *cond_;
+#endif
+  YV12_BUFFER_CONFIG *frame;
+  struct AV1Common *cm;
+  int enabled[POST_FILTER_STAGES];
+  // The number of superblock rows each stage has started, and finished
+  // without gaps. Only CDEF rows may be filtered by several workers at once.
+  int rows_started[POST_FILTER_STAGES];
+  int rows_done[POST_FILTER_STAGES];
+  // The number of superblock rows whose CDEF border lines are saved.
+  int cdef_lines_saved;
+  int rows;
+
+  AV1PostFilterWorkerData *pfdata;
+  int num_pfdata;
+  // Per stage state, valid during av1_post_filter_frame().
+  struct macroblockd_plane planes[MAX_MB_PLANE];
+  struct AV1CdefState *cdef;
+  struct AV1LrState *lr;
+} AV1PostFilterSync;
+
+// Deallocate the post filter synchronization data.
+void av1_post_filter_dealloc(AV1PostFilterSync *pf_sync);
+
+// Applies the enabled post filters to the frame a superblock row at a time:
+// CDEF of a row starts once deblocking has finished the row below, and loop
+// restoration trails CDEF by the lines the earlier stages may still read. The
+// stages are spread over up to num_workers of the workers, the last of which
+// runs on the calling thread, and the workers left over share the CDEF rows;
+// with no workers everything runs on the calling thread. The output does not
+// depend on the number of workers.
+void av1_post_filter_frame(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
+                           struct macroblockd *xd, int deblock, int cdef,
+                           int restoration, AVxWorker *workers,
+                           int num_workers, AV1PostFilterSync *pf_sync);
+
+#if CONFIG_LOOP_RESTORATION
+// Loop restoration data of one worker.
+typedef struct AV1LrWorkerData {
+  // Scratch buffer of RESTORATION_TMPBUF_SIZE values.
+  int32_t *tmpbuf;
+} AV1LrWorkerData;
+
+// Restoration tile jobs shared by the loop restoration workers.
+typedef struct AV1LrSync {
+  AV1LrWorkerData *lrdata;
+  int num_workers;
+  AVxJobQueue job_queue;
+  // Valid during av1_loop_restoration_frame_mt().
+  struct AV1LrState *lr;
+  struct AV1Common *cm;
+} AV1LrSync;
+
+// Deallocate the loop restoration jobs and scratch buffers.
+void av1_loop_restoration_dealloc(AV1LrSync *lr_sync);
+
+// Multi-threaded av1_loop_restoration_frame() of all planes of the whole
+// frame, in place, that splits the restoration tiles over the workers.
+void av1_loop_restoration_frame_mt(YV12_BUFFER_CONFIG *frame,
+                                   struct AV1Common *cm, AVxWorker *workers,
+                                   int num_workers, AV1LrSync *lr_sync);
+#endif  // CONFIG_LOOP_RESTORATION
+
 void av1_accumulate_frame_counts(struct FRAME_COUNTS *acc_counts,
                                  struct FRAME_COUNTS *counts);
 
+#if CONFIG_INTERNAL_STATS
+// Write the load counters of each worker of 'queue' to 'f', one line per
+// worker that ran a job, headed by 'name'. A queue that was never allocated
+// writes nothing.
+void av1_print_job_stats(FILE *f, const char *name,
+                         const AVxJobQueue *queue);
+#endif  // CONFIG_INTERNAL_STATS
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -35,6 +35,9 @@
 
 extern const int16_t warped_filter[WARPEDPIXEL_PREC_SHIFTS * 3 + 1][8];
 
+DECLARE_ALIGNED(8, extern const int8_t,
+                warped_filter_8bit[WARPEDPIXEL_PREC_SHIFTS * 3 + 1][8]);
+
 typedef void (*ProjectPointsFunc)(const int32_t *mat, int *points, int *proj,
                                   const int n, const int stride_points,
                                   const int stride_proj,
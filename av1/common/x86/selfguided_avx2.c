@@ -0,0 +1,727 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+#include <string.h>
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "aom_ports/mem.h"
+#include "av1/common/restoration.h"
+
+/* Unlike the SSE4.1 version, which has separate sliding-window box sums for
+   each radius, the box sums here are taken from integral images of the source
+   and of its square. That handles every radius with the same code, and the
+   windows which are clipped at the edges of the tile come for free from the
+   padding of the integral images.
+
+   Every intermediate is kept in 32 bits. The integral image of the squares
+   may wrap around, but all of the box sums taken from it are below 2^32, so
+   the modular differences are still exact.
+
+   The high bitdepth functions share all of the code below: the source is
+   passed around as a CONVERT_TO_BYTEPTR() pointer plus a 'highbd' flag.
+*/
+
+// Load 8 pixels, zero-extended to 32 bits.
+static INLINE __m256i load_pixels_32(const uint8_t *src, int highbd) {
+#if CONFIG_HIGHBITDEPTH
+  if (highbd)
+    return _mm256_cvtepu16_epi32(
+        _mm_loadu_si128((const __m128i *)CONVERT_TO_SHORTPTR(src)));
+#else
+  (void)highbd;
+#endif
+  return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)src));
+}
+
+// As load_pixels_32(), but only reads the first n < 8 pixels and sets the
+// rest to zero, so that we never read past the end of the source row.
+static INLINE __m256i load_pixels_32_partial(const uint8_t *src, int highbd,
+                                             int n) {
+  DECLARE_ALIGNED(32, int32_t, buf[8]) = { 0 };
+  int k;
+#if CONFIG_HIGHBITDEPTH
+  if (highbd) {
+    const uint16_t *src16 = CONVERT_TO_SHORTPTR(src);
+    for (k = 0; k < n; ++k) buf[k] = src16[k];
+    return _mm256_load_si256((const __m256i *)buf);
+  }
+#else
+  (void)highbd;
+#endif
+  for (k = 0; k < n; ++k) buf[k] = src[k];
+  return _mm256_load_si256((const __m256i *)buf);
+}
+
+static INLINE int get_pixel(const uint8_t *src, int highbd, int idx) {
+#if CONFIG_HIGHBITDEPTH
+  if (highbd) return CONVERT_TO_SHORTPTR(src)[idx];
+#else
+  (void)highbd;
+#endif
+  return src[idx];
+}
+
+// Inclusive prefix sum over the eight 32-bit lanes of x
+static INLINE __m256i prefix_sum_32(__m256i x) {
+  x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+  x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+  // The byte shifts above stay within each 128-bit lane, so finish off by
+  // adding the total of the low lane to every element of the high lane.
+  const __m256i lo = _mm256_permute2x128_si256(x, x, 0x08);
+  return _mm256_add_epi32(x, _mm256_shuffle_epi32(lo, 0xff));
+}
+
+/* Build the integral images of the source (in ii) and of its square (in
+   ii_sq), in the layout described next to SGRPROJ_INTEGRAL_BORDER. Row i of
+   the integral image, ie. the sums over [0, i] x [0, j], is stored in row
+   (i + SGRPROJ_INTEGRAL_BORDER) of the buffers, starting at column
+   SGRPROJ_INTEGRAL_BORDER.
+
+   The rows above it and the columns to its left are zero, and the columns to
+   its right repeat the value of the last pixel, so the box sums for the
+   clipped windows at the edges of the tile need no special cases. The extra
+   rows at the top also mean that calc_ab() can overwrite each row of the
+   integral images with A and B as soon as it is no longer needed.
+*/
+static void integral_images(const uint8_t *src, int highbd, int width,
+                            int height, int src_stride, int32_t *ii,
+                            int32_t *ii_sq, int ii_stride) {
+  const int border = SGRPROJ_INTEGRAL_BORDER;
+  int i, j;
+  memset(ii, 0, border * ii_stride * sizeof(*ii));
+  memset(ii_sq, 0, border * ii_stride * sizeof(*ii_sq));
+
+  for (i = 0; i < height; ++i) {
+    const uint8_t *src_row = src + i * src_stride;
+    const int32_t *prev_a = ii_sq + (i + border - 1) * ii_stride + border;
+    const int32_t *prev_b = ii + (i + border - 1) * ii_stride + border;
+    int32_t *cur_a = ii_sq + (i + border) * ii_stride;
+    int32_t *cur_b = ii + (i + border) * ii_stride;
+    const __m256i last_lane = _mm256_set1_epi32(7);
+    __m256i carry_a = _mm256_setzero_si256();
+    __m256i carry_b = _mm256_setzero_si256();
+
+    memset(cur_a, 0, border * sizeof(*cur_a));
+    memset(cur_b, 0, border * sizeof(*cur_b));
+    cur_a += border;
+    cur_b += border;
+
+    for (j = 0; j < width; j += 8) {
+      const __m256i x =
+          (j + 8 <= width)
+              ? load_pixels_32(src_row + j, highbd)
+              : load_pixels_32_partial(src_row + j, highbd, width - j);
+      // The pixels are at most 16 bits wide, so madd gives us their squares
+      const __m256i x2 = _mm256_madd_epi16(x, x);
+
+      const __m256i row_b = _mm256_add_epi32(prefix_sum_32(x), carry_b);
+      const __m256i row_a = _mm256_add_epi32(prefix_sum_32(x2), carry_a);
+      carry_b = _mm256_permutevar8x32_epi32(row_b, last_lane);
+      carry_a = _mm256_permutevar8x32_epi32(row_a, last_lane);
+
+      _mm256_storeu_si256(
+          (__m256i *)&cur_b[j],
+          _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)&prev_b[j]),
+                           row_b));
+      _mm256_storeu_si256(
+          (__m256i *)&cur_a[j],
+          _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)&prev_a[j]),
+                           row_a));
+    }
+    for (j = width; j < ii_stride - border; ++j) {
+      cur_a[j] = cur_a[width - 1];
+      cur_b[j] = cur_b[width - 1];
+    }
+  }
+}
+
+/* Calculate the A and B arrays (corresponding to the first loop in the C
+   version of av1_selfguided_restoration) from the integral images. Row i of A
+   and B is stored in row i of the buffers, starting at column 0. The buffers
+   may be the same as the integral images of the source and of its square,
+   respectively, in which case those are overwritten.
+*/
+static void calc_ab(const int32_t *ii, const int32_t *ii_sq, int32_t *A,
+                    int32_t *B, int width, int height, int buf_stride, int r,
+                    int eps, int bit_depth) {
+  const int border = SGRPROJ_INTEGRAL_BORDER;
+  const int *mtable = sgrproj_mtable[eps - 1];
+  const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i r_ = _mm256_set1_epi32(r);
+  const __m256i last_col = _mm256_set1_epi32(width - 1);
+  const __m256i max_z = _mm256_set1_epi32(255);
+  const __m256i sgr = _mm256_set1_epi32(SGRPROJ_SGR);
+  const __m256i rounding_z = _mm256_set1_epi32((1 << SGRPROJ_MTABLE_BITS) >> 1);
+  const __m256i rounding_res =
+      _mm256_set1_epi32((1 << SGRPROJ_RECIP_BITS) >> 1);
+#if CONFIG_HIGHBITDEPTH
+  const __m256i rounding_a =
+      _mm256_set1_epi32((1 << (2 * (bit_depth - 8))) >> 1);
+  const __m256i rounding_b = _mm256_set1_epi32((1 << (bit_depth - 8)) >> 1);
+  const __m128i shift_a = _mm_cvtsi32_si128(2 * (bit_depth - 8));
+  const __m128i shift_b = _mm_cvtsi32_si128(bit_depth - 8);
+#else
+  (void)bit_depth;
+#endif
+  int i, j;
+
+  for (i = 0; i < height; ++i) {
+    const int i0 = AOMMAX(i - r, 0);
+    const int i1 = AOMMIN(i + r, height - 1);
+    // Rows (i0 - 1) and i1 of the integral images, offset so that column j
+    // of the box sums reads from columns (j - r - 1) and (j + r).
+    const int32_t *top_a =
+        ii_sq + (i0 - 1 + border) * buf_stride + border - r - 1;
+    const int32_t *top_b = ii + (i0 - 1 + border) * buf_stride + border - r - 1;
+    const int32_t *bot_a = ii_sq + (i1 + border) * buf_stride + border - r - 1;
+    const int32_t *bot_b = ii + (i1 + border) * buf_stride + border - r - 1;
+    const int rows = i1 - i0 + 1;
+    const __m256i rows_ = _mm256_set1_epi32(rows);
+    // Values for the columns whose windows are not clipped
+    const int n_full = rows * (2 * r + 1);
+    const __m256i n_full_ = _mm256_set1_epi32(n_full);
+    const __m256i s_full = _mm256_set1_epi32(mtable[n_full - 1]);
+    const __m256i one_over_n_full = _mm256_set1_epi32(one_by_x[n_full - 1]);
+
+    for (j = 0; j < width; j += 8) {
+      const __m256i sum = _mm256_sub_epi32(
+          _mm256_add_epi32(
+              _mm256_loadu_si256((const __m256i *)&bot_b[j + 2 * r + 1]),
+              _mm256_loadu_si256((const __m256i *)&top_b[j])),
+          _mm256_add_epi32(
+              _mm256_loadu_si256((const __m256i *)&bot_b[j]),
+              _mm256_loadu_si256((const __m256i *)&top_b[j + 2 * r + 1])));
+      const __m256i sum_sq = _mm256_sub_epi32(
+          _mm256_add_epi32(
+              _mm256_loadu_si256((const __m256i *)&bot_a[j + 2 * r + 1]),
+              _mm256_loadu_si256((const __m256i *)&top_a[j])),
+          _mm256_add_epi32(
+              _mm256_loadu_si256((const __m256i *)&bot_a[j]),
+              _mm256_loadu_si256((const __m256i *)&top_a[j + 2 * r + 1])));
+      __m256i n, s, one_over_n, a, b, p;
+
+      if (j >= r && j + 7 + r <= width - 1) {
+        n = n_full_;
+        s = s_full;
+        one_over_n = one_over_n_full;
+      } else {
+        // Count the pixels in the clipped windows. Lanes past the right-hand
+        // edge of the tile are "don't care", but must still give a valid
+        // table index.
+        const __m256i col = _mm256_add_epi32(_mm256_set1_epi32(j), lane);
+        const __m256i cols = _mm256_add_epi32(
+            _mm256_sub_epi32(
+                _mm256_min_epi32(_mm256_add_epi32(col, r_), last_col),
+                _mm256_max_epi32(_mm256_sub_epi32(col, r_),
+                                 _mm256_setzero_si256())),
+            one);
+        n = _mm256_mullo_epi32(_mm256_max_epi32(cols, one), rows_);
+        s = _mm256_i32gather_epi32(mtable, _mm256_sub_epi32(n, one), 4);
+        one_over_n =
+            _mm256_i32gather_epi32(one_by_x, _mm256_sub_epi32(n, one), 4);
+      }
+
+#if CONFIG_HIGHBITDEPTH
+      if (bit_depth > 8) {
+        a = _mm256_srl_epi32(_mm256_add_epi32(sum_sq, rounding_a), shift_a);
+        b = _mm256_srl_epi32(_mm256_add_epi32(sum, rounding_b), shift_b);
+        a = _mm256_mullo_epi32(a, n);
+        b = _mm256_mullo_epi32(b, b);
+        p = _mm256_sub_epi32(_mm256_max_epi32(a, b), b);
+      } else {
+#endif
+        a = _mm256_mullo_epi32(sum_sq, n);
+        b = _mm256_mullo_epi32(sum, sum);
+        p = _mm256_sub_epi32(a, b);
+#if CONFIG_HIGHBITDEPTH
+      }
+#endif
+
+      __m256i z = _mm256_srli_epi32(
+          _mm256_add_epi32(_mm256_mullo_epi32(p, s), rounding_z),
+          SGRPROJ_MTABLE_BITS);
+      z = _mm256_min_epu32(z, max_z);
+
+      const __m256i a_res = _mm256_i32gather_epi32(x_by_xplus1, z, 4);
+      const __m256i b_int =
+          _mm256_mullo_epi32(_mm256_sub_epi32(sgr, a_res),
+                             _mm256_mullo_epi32(sum, one_over_n));
+      const __m256i b_res = _mm256_srli_epi32(
+          _mm256_add_epi32(b_int, rounding_res), SGRPROJ_RECIP_BITS);
+
+      // This overwrites integral image entries which are only used by the
+      // current block, or by earlier blocks of this row.
+      _mm256_storeu_si256((__m256i *)&A[i * buf_stride + j], a_res);
+      _mm256_storeu_si256((__m256i *)&B[i * buf_stride + j], b_res);
+    }
+  }
+}
+
+// Weights used along the edges of the tile, where the 3x3 neighbourhood is
+// clipped. 'da' steps along the edge and 'di' steps into the tile.
+static INLINE int32_t edge_sum(const int32_t *X, int k, int da, int di) {
+  return X[k] + 2 * (X[k - da] + X[k + da]) + X[k + di] + X[k + di - da] +
+         X[k + di + da];
+}
+
+static INLINE int32_t corner_sum(const int32_t *X, int k, int dx, int dy) {
+  return 3 * X[k] + 2 * (X[k + dx] + X[k + dy]) + X[k + dx + dy];
+}
+
+static INLINE int32_t filter_pixel(int32_t a, int32_t b, int x, int nb) {
+  const int32_t v = a * x + b;
+  return ROUND_POWER_OF_TWO(v, SGRPROJ_SGR_BITS + nb - SGRPROJ_RST_BITS);
+}
+
+// 4 * (center + edge neighbours) + 3 * (corner neighbours), for 8 pixels
+static INLINE __m256i weighted_sum_3x3(const int32_t *X, int s) {
+  const __m256i edges = _mm256_add_epi32(
+      _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)&X[-s]),
+                       _mm256_loadu_si256((const __m256i *)&X[s])),
+      _mm256_add_epi32(
+          _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)&X[-1]),
+                           _mm256_loadu_si256((const __m256i *)&X[1])),
+          _mm256_loadu_si256((const __m256i *)&X[0])));
+  const __m256i corners = _mm256_add_epi32(
+      _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)&X[-s - 1]),
+                       _mm256_loadu_si256((const __m256i *)&X[-s + 1])),
+      _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)&X[s - 1]),
+                       _mm256_loadu_si256((const __m256i *)&X[s + 1])));
+  return _mm256_sub_epi32(
+      _mm256_slli_epi32(_mm256_add_epi32(edges, corners), 2), corners);
+}
+
+static INLINE void final_filter_8(const int32_t *A, const int32_t *B,
+                                  int buf_stride, const uint8_t *dgd,
+                                  int highbd, int32_t *dst) {
+  const int nb = 5;
+  const __m256i rounding =
+      _mm256_set1_epi32((1 << (SGRPROJ_SGR_BITS + nb - SGRPROJ_RST_BITS)) >> 1);
+  const __m256i a = weighted_sum_3x3(A, buf_stride);
+  const __m256i b = weighted_sum_3x3(B, buf_stride);
+  const __m256i src = load_pixels_32(dgd, highbd);
+  const __m256i v = _mm256_add_epi32(_mm256_mullo_epi32(a, src), b);
+  const __m256i w = _mm256_srai_epi32(_mm256_add_epi32(v, rounding),
+                                      SGRPROJ_SGR_BITS + nb - SGRPROJ_RST_BITS);
+  _mm256_storeu_si256((__m256i *)dst, w);
+}
+
+static void final_filter(const int32_t *A, const int32_t *B, int buf_stride,
+                         const uint8_t *dgd, int highbd, int width, int height,
+                         int stride, int32_t *dst, int dst_stride) {
+  const int s = buf_stride;
+  int i, j, k;
+
+  // Corners
+  k = 0;
+  dst[0] = filter_pixel(corner_sum(A, k, 1, s), corner_sum(B, k, 1, s),
+                        get_pixel(dgd, highbd, 0), 3);
+  k = width - 1;
+  dst[width - 1] =
+      filter_pixel(corner_sum(A, k, -1, s), corner_sum(B, k, -1, s),
+                   get_pixel(dgd, highbd, width - 1), 3);
+  k = (height - 1) * s;
+  dst[(height - 1) * dst_stride] =
+      filter_pixel(corner_sum(A, k, 1, -s), corner_sum(B, k, 1, -s),
+                   get_pixel(dgd, highbd, (height - 1) * stride), 3);
+  k = (height - 1) * s + width - 1;
+  dst[(height - 1) * dst_stride + width - 1] = filter_pixel(
+      corner_sum(A, k, -1, -s), corner_sum(B, k, -1, -s),
+      get_pixel(dgd, highbd, (height - 1) * stride + width - 1), 3);
+
+  // Top and bottom edges
+  for (j = 1; j < width - 1; ++j) {
+    k = j;
+    dst[j] = filter_pixel(edge_sum(A, k, 1, s), edge_sum(B, k, 1, s),
+                          get_pixel(dgd, highbd, j), 3);
+    k = (height - 1) * s + j;
+    dst[(height - 1) * dst_stride + j] =
+        filter_pixel(edge_sum(A, k, 1, -s), edge_sum(B, k, 1, -s),
+                     get_pixel(dgd, highbd, (height - 1) * stride + j), 3);
+  }
+
+  for (i = 1; i < height - 1; ++i) {
+    const int32_t *a_row = A + i * s;
+    const int32_t *b_row = B + i * s;
+    const uint8_t *dgd_row = dgd + i * stride;
+    int32_t *dst_row = dst + i * dst_stride;
+
+    // Left and right edges
+    dst_row[0] =
+        filter_pixel(edge_sum(a_row, 0, s, 1), edge_sum(b_row, 0, s, 1),
+                     get_pixel(dgd_row, highbd, 0), 3);
+    dst_row[width - 1] = filter_pixel(
+        edge_sum(a_row, width - 1, s, -1), edge_sum(b_row, width - 1, s, -1),
+        get_pixel(dgd_row, highbd, width - 1), 3);
+
+    for (j = 1; j + 8 <= width - 1; j += 8)
+      final_filter_8(a_row + j, b_row + j, s, dgd_row + j, highbd, dst_row + j);
+    // Finish the row with one more batch of 8 pixels, overlapping the
+    // previous one. Tiles which are too narrow for that are done pixel by
+    // pixel.
+    if (j < width - 1 && width - 9 >= 1) {
+      j = width - 9;
+      final_filter_8(a_row + j, b_row + j, s, dgd_row + j, highbd, dst_row + j);
+    } else {
+      for (; j < width - 1; ++j) {
+        const int32_t a =
+            (a_row[j] + a_row[j - 1] + a_row[j + 1] + a_row[j - s] +
+             a_row[j + s]) *
+                4 +
+            (a_row[j - 1 - s] + a_row[j - 1 + s] + a_row[j + 1 - s] +
+             a_row[j + 1 + s]) *
+                3;
+        const int32_t b =
+            (b_row[j] + b_row[j - 1] + b_row[j + 1] + b_row[j - s] +
+             b_row[j + s]) *
+                4 +
+            (b_row[j - 1 - s] + b_row[j - 1 + s] + b_row[j + 1 - s] +
+             b_row[j + 1 + s]) *
+                3;
+        dst_row[j] = filter_pixel(a, b, get_pixel(dgd_row, highbd, j), 5);
+      }
+    }
+  }
+}
+
+static void selfguided_restoration(const uint8_t *dgd, int highbd, int width,
+                                   int height, int stride, int32_t *dst,
+                                   int dst_stride, int bit_depth, int r,
+                                   int eps, int32_t *tmpbuf) {
+  int32_t *A = tmpbuf;
+  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
+  // Leave room for the integral image padding, and for the loads of 8 lanes
+  // past the last pixel in calc_ab().
+  const int buf_stride = SGRPROJ_INTEGRAL_STRIDE(width);
+
+  assert(r <= MAX_RADIUS);
+  assert((height + SGRPROJ_INTEGRAL_BORDER) * buf_stride <=
+         SGRPROJ_OUTBUF_SIZE);
+  integral_images(dgd, highbd, width, height, stride, B, A, buf_stride);
+  calc_ab(B, A, A, B, width, height, buf_stride, r, eps, bit_depth);
+  final_filter(A, B, buf_stride, dgd, highbd, width, height, stride, dst,
+               dst_stride);
+}
+
+static void selfguided_restoration_from_integral(
+    const uint8_t *dgd, int highbd, int width, int height, int stride,
+    const int32_t *ii, const int32_t *ii_sq, int32_t *dst, int dst_stride,
+    int bit_depth, int r, int eps, int32_t *tmpbuf) {
+  int32_t *A = tmpbuf;
+  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
+  // calc_ab() reads the integral images with the same stride as A and B
+  const int buf_stride = SGRPROJ_INTEGRAL_STRIDE(width);
+
+  assert(r <= MAX_RADIUS);
+  calc_ab(ii, ii_sq, A, B, width, height, buf_stride, r, eps, bit_depth);
+  final_filter(A, B, buf_stride, dgd, highbd, width, height, stride, dst,
+               dst_stride);
+}
+
+void av1_selfguided_restoration_avx2(uint8_t *dgd, int width, int height,
+                                     int stride, int32_t *dst, int dst_stride,
+                                     int r, int eps, int32_t *tmpbuf) {
+  // The C version reads from outside of tiles which are smaller than the
+  // filter window, and only copies the source for tiles it does not filter.
+  // Those are rare, so just hand them over to it.
+  if (AOMMIN(width, height) < AOMMAX(2 * r + 1, 5)) {
+    av1_selfguided_restoration_c(dgd, width, height, stride, dst, dst_stride, r,
+                                 eps, tmpbuf);
+    return;
+  }
+  selfguided_restoration(dgd, 0, width, height, stride, dst, dst_stride, 8, r,
+                         eps, tmpbuf);
+}
+
+void av1_selfguided_integral_images_avx2(uint8_t *dgd, int width, int height,
+                                         int stride, int32_t *ii,
+                                         int32_t *ii_sq) {
+  integral_images(dgd, 0, width, height, stride, ii, ii_sq,
+                  SGRPROJ_INTEGRAL_STRIDE(width));
+}
+
+void av1_selfguided_restoration_from_integral_avx2(
+    uint8_t *dgd, int width, int height, int stride, const int32_t *ii,
+    const int32_t *ii_sq, int32_t *dst, int dst_stride, int r, int eps,
+    int32_t *tmpbuf) {
+  if (width < 5 || height < 5) {
+    av1_selfguided_restoration_from_integral_c(dgd, width, height, stride, ii,
+                                               ii_sq, dst, dst_stride, r, eps,
+                                               tmpbuf);
+    return;
+  }
+  selfguided_restoration_from_integral(dgd, 0, width, height, stride, ii,
+                                       ii_sq, dst, dst_stride, 8, r, eps,
+                                       tmpbuf);
+}
+
+// The 3x3 high-pass filter, with the source clamped at the edges of the tile
+static INLINE int32_t highpass_pixel(const uint8_t *dgd, int highbd, int width,
+                                     int height, int stride, int i, int j,
+                                     int center, int corner, int edge) {
+  const int up = AOMMAX(i - 1, 0) * stride;
+  const int mid = i * stride;
+  const int down = AOMMIN(i + 1, height - 1) * stride;
+  const int left = AOMMAX(j - 1, 0);
+  const int right = AOMMIN(j + 1, width - 1);
+  return center * get_pixel(dgd, highbd, mid + j) +
+         edge * (get_pixel(dgd, highbd, up + j) +
+                 get_pixel(dgd, highbd, mid + left) +
+                 get_pixel(dgd, highbd, mid + right) +
+                 get_pixel(dgd, highbd, down + j)) +
+         corner * (get_pixel(dgd, highbd, up + left) +
+                   get_pixel(dgd, highbd, up + right) +
+                   get_pixel(dgd, highbd, down + left) +
+                   get_pixel(dgd, highbd, down + right));
+}
+
+static INLINE void highpass_filter_8(const uint8_t *dgd, int highbd,
+                                     int stride, __m256i center, __m256i corner,
+                                     __m256i edge, int32_t *dst) {
+  const uint8_t *up = dgd - stride;
+  const uint8_t *down = dgd + stride;
+  const __m256i c = load_pixels_32(dgd, highbd);
+  const __m256i e = _mm256_add_epi32(
+      _mm256_add_epi32(load_pixels_32(up, highbd),
+                       load_pixels_32(down, highbd)),
+      _mm256_add_epi32(load_pixels_32(dgd - 1, highbd),
+                       load_pixels_32(dgd + 1, highbd)));
+  const __m256i d = _mm256_add_epi32(
+      _mm256_add_epi32(load_pixels_32(up - 1, highbd),
+                       load_pixels_32(up + 1, highbd)),
+      _mm256_add_epi32(load_pixels_32(down - 1, highbd),
+                       load_pixels_32(down + 1, highbd)));
+  _mm256_storeu_si256(
+      (__m256i *)dst,
+      _mm256_add_epi32(_mm256_mullo_epi32(c, center),
+                       _mm256_add_epi32(_mm256_mullo_epi32(e, edge),
+                                        _mm256_mullo_epi32(d, corner))));
+}
+
+static void highpass_filter(const uint8_t *dgd, int highbd, int width,
+                            int height, int stride, int32_t *dst,
+                            int dst_stride, int corner, int edge) {
+  const int center = (1 << SGRPROJ_RST_BITS) - 4 * (corner + edge);
+  const __m256i center_ = _mm256_set1_epi32(center);
+  const __m256i corner_ = _mm256_set1_epi32(corner);
+  const __m256i edge_ = _mm256_set1_epi32(edge);
+  int i, j;
+
+  for (j = 0; j < width; ++j) {
+    dst[j] = highpass_pixel(dgd, highbd, width, height, stride, 0, j, center,
+                            corner, edge);
+    dst[(height - 1) * dst_stride + j] =
+        highpass_pixel(dgd, highbd, width, height, stride, height - 1, j,
+                       center, corner, edge);
+  }
+  for (i = 1; i < height - 1; ++i) {
+    const uint8_t *dgd_row = dgd + i * stride;
+    int32_t *dst_row = dst + i * dst_stride;
+    dst_row[0] = highpass_pixel(dgd, highbd, width, height, stride, i, 0,
+                                center, corner, edge);
+    dst_row[width - 1] = highpass_pixel(dgd, highbd, width, height, stride, i,
+                                        width - 1, center, corner, edge);
+
+    for (j = 1; j + 8 <= width - 1; j += 8)
+      highpass_filter_8(dgd_row + j, highbd, stride, center_, corner_, edge_,
+                        dst_row + j);
+    if (j < width - 1 && width - 9 >= 1) {
+      j = width - 9;
+      highpass_filter_8(dgd_row + j, highbd, stride, center_, corner_, edge_,
+                        dst_row + j);
+    } else {
+      for (; j < width - 1; ++j)
+        dst_row[j] = highpass_pixel(dgd, highbd, width, height, stride, i, j,
+                                    center, corner, edge);
+    }
+  }
+}
+
+void av1_highpass_filter_avx2(uint8_t *dgd, int width, int height, int stride,
+                              int32_t *dst, int dst_stride, int corner,
+                              int edge) {
+  highpass_filter(dgd, 0, width, height, stride, dst, dst_stride, corner,
+                  edge);
+}
+
+// Combine the two filter outputs for 8 pixels, returning the result before
+// clamping to the pixel range.
+static INLINE __m256i project_8(const uint8_t *dat, int highbd,
+                                const int32_t *flt1, const int32_t *flt2,
+                                __m256i xq0, __m256i xq1) {
+  const __m256i rounding =
+      _mm256_set1_epi32((1 << (SGRPROJ_PRJ_BITS + SGRPROJ_RST_BITS)) >> 1);
+  const __m256i u =
+      _mm256_slli_epi32(load_pixels_32(dat, highbd), SGRPROJ_RST_BITS);
+  const __m256i f1 =
+      _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)flt1), u);
+  const __m256i f2 =
+      _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)flt2), u);
+  const __m256i v =
+      _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(xq0, f1),
+                                        _mm256_mullo_epi32(xq1, f2)),
+                       _mm256_slli_epi32(u, SGRPROJ_PRJ_BITS));
+  return _mm256_srai_epi32(_mm256_add_epi32(v, rounding),
+                           SGRPROJ_PRJ_BITS + SGRPROJ_RST_BITS);
+}
+
+static INLINE int16_t project_pixel(int dat, int32_t flt1, int32_t flt2,
+                                    const int *xq) {
+  const int32_t u = ((int32_t)dat << SGRPROJ_RST_BITS);
+  const int32_t f1 = flt1 - u;
+  const int32_t f2 = flt2 - u;
+  const int32_t v = xq[0] * f1 + xq[1] * f2 + (u << SGRPROJ_PRJ_BITS);
+  return (int16_t)ROUND_POWER_OF_TWO(v, SGRPROJ_PRJ_BITS + SGRPROJ_RST_BITS);
+}
+
+void apply_selfguided_restoration_avx2(uint8_t *dat, int width, int height,
+                                       int stride, int eps, int *xqd,
+                                       uint8_t *dst, int dst_stride,
+                                       int32_t *tmpbuf) {
+  int xq[2];
+  int32_t *flt1 = tmpbuf;
+  int32_t *flt2 = flt1 + RESTORATION_TILEPELS_MAX;
+  int32_t *tmpbuf2 = flt2 + RESTORATION_TILEPELS_MAX;
+  int i, j;
+  assert(width * height <= RESTORATION_TILEPELS_MAX);
+#if USE_HIGHPASS_IN_SGRPROJ
+  av1_highpass_filter_avx2(dat, width, height, stride, flt1, width,
+                           sgr_params[eps].corner, sgr_params[eps].edge);
+#else
+  av1_selfguided_restoration_avx2(dat, width, height, stride, flt1, width,
+                                  sgr_params[eps].r1, sgr_params[eps].e1,
+                                  tmpbuf2);
+#endif  // USE_HIGHPASS_IN_SGRPROJ
+  av1_selfguided_restoration_avx2(dat, width, height, stride, flt2, width,
+                                  sgr_params[eps].r2, sgr_params[eps].e2,
+                                  tmpbuf2);
+  decode_xq(xqd, xq);
+
+  const __m256i xq0 = _mm256_set1_epi32(xq[0]);
+  const __m256i xq1 = _mm256_set1_epi32(xq[1]);
+  // Picks out the low 4 bytes of each 128-bit lane
+  const __m256i gather_lo = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+  for (i = 0; i < height; ++i) {
+    for (j = 0; j + 8 <= width; j += 8) {
+      const int k = i * width + j;
+      const __m256i w = project_8(&dat[i * stride + j], 0, &flt1[k], &flt2[k],
+                                  xq0, xq1);
+      const __m256i tmp = _mm256_packs_epi32(w, w);
+      const __m256i res = _mm256_permutevar8x32_epi32(
+          _mm256_packus_epi16(tmp, tmp), gather_lo);
+      _mm_storel_epi64((__m128i *)&dst[i * dst_stride + j],
+                       _mm256_castsi256_si128(res));
+    }
+    // Process leftover pixels
+    for (; j < width; ++j) {
+      const int k = i * width + j;
+      dst[i * dst_stride + j] = clip_pixel(
+          project_pixel(dat[i * stride + j], flt1[k], flt2[k], xq));
+    }
+  }
+}
+
+#if CONFIG_HIGHBITDEPTH
+void av1_selfguided_restoration_highbd_avx2(uint16_t *dgd, int width,
+                                            int height, int stride,
+                                            int32_t *dst, int dst_stride,
+                                            int bit_depth, int r, int eps,
+                                            int32_t *tmpbuf) {
+  if (AOMMIN(width, height) < AOMMAX(2 * r + 1, 5)) {
+    av1_selfguided_restoration_highbd_c(dgd, width, height, stride, dst,
+                                        dst_stride, bit_depth, r, eps, tmpbuf);
+    return;
+  }
+  selfguided_restoration(CONVERT_TO_BYTEPTR(dgd), 1, width, height, stride,
+                         dst, dst_stride, bit_depth, r, eps, tmpbuf);
+}
+
+void av1_selfguided_integral_images_highbd_avx2(uint16_t *dgd, int width,
+                                                int height, int stride,
+                                                int32_t *ii, int32_t *ii_sq) {
+  integral_images(CONVERT_TO_BYTEPTR(dgd), 1, width, height, stride, ii, ii_sq,
+                  SGRPROJ_INTEGRAL_STRIDE(width));
+}
+
+void av1_selfguided_restoration_from_integral_highbd_avx2(
+    uint16_t *dgd, int width, int height, int stride, const int32_t *ii,
+    const int32_t *ii_sq, int32_t *dst, int dst_stride, int bit_depth, int r,
+    int eps, int32_t *tmpbuf) {
+  if (width < 5 || height < 5) {
+    av1_selfguided_restoration_from_integral_highbd_c(
+        dgd, width, height, stride, ii, ii_sq, dst, dst_stride, bit_depth, r,
+        eps, tmpbuf);
+    return;
+  }
+  selfguided_restoration_from_integral(CONVERT_TO_BYTEPTR(dgd), 1, width,
+                                       height, stride, ii, ii_sq, dst,
+                                       dst_stride, bit_depth, r, eps, tmpbuf);
+}
+
+void av1_highpass_filter_highbd_avx2(uint16_t *dgd, int width, int height,
+                                     int stride, int32_t *dst, int dst_stride,
+                                     int corner, int edge) {
+  highpass_filter(CONVERT_TO_BYTEPTR(dgd), 1, width, height, stride, dst,
+                  dst_stride, corner, edge);
+}
+
+void apply_selfguided_restoration_highbd_avx2(
+    uint16_t *dat, int width, int height, int stride, int bit_depth, int eps,
+    int *xqd, uint16_t *dst, int dst_stride, int32_t *tmpbuf) {
+  int xq[2];
+  int32_t *flt1 = tmpbuf;
+  int32_t *flt2 = flt1 + RESTORATION_TILEPELS_MAX;
+  int32_t *tmpbuf2 = flt2 + RESTORATION_TILEPELS_MAX;
+  const uint8_t *dat8 = CONVERT_TO_BYTEPTR(dat);
+  int i, j;
+  assert(width * height <= RESTORATION_TILEPELS_MAX);
+#if USE_HIGHPASS_IN_SGRPROJ
+  av1_highpass_filter_highbd_avx2(dat, width, height, stride, flt1, width,
+                                  sgr_params[eps].corner,
+                                  sgr_params[eps].edge);
+#else
+  av1_selfguided_restoration_highbd_avx2(dat, width, height, stride, flt1,
+                                         width, bit_depth, sgr_params[eps].r1,
+                                         sgr_params[eps].e1, tmpbuf2);
+#endif  // USE_HIGHPASS_IN_SGRPROJ
+  av1_selfguided_restoration_highbd_avx2(dat, width, height, stride, flt2,
+                                         width, bit_depth, sgr_params[eps].r2,
+                                         sgr_params[eps].e2, tmpbuf2);
+  decode_xq(xqd, xq);
+
+  const __m256i xq0 = _mm256_set1_epi32(xq[0]);
+  const __m256i xq1 = _mm256_set1_epi32(xq[1]);
+  const __m256i max = _mm256_set1_epi32((1 << bit_depth) - 1);
+  for (i = 0; i < height; ++i) {
+    for (j = 0; j + 8 <= width; j += 8) {
+      const int k = i * width + j;
+      __m256i w = project_8(dat8 + i * stride + j, 1, &flt1[k], &flt2[k], xq0,
+                            xq1);
+      // Clamp to [0, 2^bit_depth) and pack into 16 bits
+      w = _mm256_min_epi32(_mm256_max_epi32(w, _mm256_setzero_si256()), max);
+      const __m256i res =
+          _mm256_permute4x64_epi64(_mm256_packus_epi32(w, w), 0x08);
+      _mm_storeu_si128((__m128i *)&dst[i * dst_stride + j],
+                       _mm256_castsi256_si128(res));
+    }
+    // Process leftover pixels
+    for (; j < width; ++j) {
+      const int k = i * width + j;
+      dst[i * dst_stride + j] = (uint16_t)clip_pixel_highbd(
+          project_pixel(dat[i * stride + j], flt1[k], flt2[k], xq), bit_depth);
+    }
+  }
+}
+#endif  // CONFIG_HIGHBITDEPTH
@@ -663,33 +663,75 @@ static void selfguided_restoration_3_h(int32_t *A, int32_t *B, int width,
   }
 }
 
-void av1_selfguided_restoration_sse4_1(uint8_t *dgd, int width, int height,
-                                       int stride, int32_t *dst, int dst_stride,
-                                       int r, int eps, int32_t *tmpbuf) {
-  int32_t *A = tmpbuf;
-  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
-  int i, j;
-  // Adjusting the stride of A and B here appears to avoid bad cache effects,
-  // leading to a significant speed improvement.
-  // We also align the stride to a multiple of 16 bytes for efficiency.
-  int buf_stride = ((width + 3) & ~3) + 16;
-
-  // Don't filter tiles with dimensions < 5 on any axis
-  if ((width < 5) || (height < 5)) return;
-
-  if (r == 1) {
-    selfguided_restoration_1_v(dgd, width, height, stride, A, B, buf_stride);
-    selfguided_restoration_1_h(A, B, width, height, buf_stride, eps, 8);
-  } else if (r == 2) {
-    selfguided_restoration_2_v(dgd, width, height, stride, A, B, buf_stride);
-    selfguided_restoration_2_h(A, B, width, height, buf_stride, eps, 8);
-  } else if (r == 3) {
-    selfguided_restoration_3_v(dgd, width, height, stride, A, B, buf_stride);
-    selfguided_restoration_3_h(A, B, width, height, buf_stride, eps, 8);
-  } else {
-    assert(0);
+/* Calculate the A and B arrays from the integral images built by
+   av1_selfguided_integral_images(), rather than from sliding-window box sums.
+   This works for every radius, as the padding of the integral images takes
+   care of the windows which are clipped at the edges of the tile.
+*/
+static void calc_ab_from_integral(const int32_t *ii, const int32_t *ii_sq,
+                                  int width, int height, int r, int eps,
+                                  int bit_depth, int32_t *A, int32_t *B,
+                                  int buf_stride) {
+  const int ii_stride = SGRPROJ_INTEGRAL_STRIDE(width);
+  const int border = SGRPROJ_INTEGRAL_BORDER;
+  const int *mtable = sgrproj_mtable[eps - 1];
+  int i, j, k;
+  for (i = 0; i < height; ++i) {
+    const int i0 = AOMMAX(i - r, 0);
+    const int i1 = AOMMIN(i + r, height - 1);
+    const int rows = i1 - i0 + 1;
+    // Rows (i0 - 1) and i1 of the integral images, offset so that column j
+    // of the box sums reads from columns (j - r - 1) and (j + r).
+    const int32_t *top = ii + (i0 - 1 + border) * ii_stride + border - r - 1;
+    const int32_t *bot = ii + (i1 + border) * ii_stride + border - r - 1;
+    const int32_t *top_sq =
+        ii_sq + (i0 - 1 + border) * ii_stride + border - r - 1;
+    const int32_t *bot_sq = ii_sq + (i1 + border) * ii_stride + border - r - 1;
+    const int n_full = rows * (2 * r + 1);
+    const __m128i n_full_ = _mm_set1_epi32(n_full);
+    const __m128i one_over_n_full = _mm_set1_epi32(one_by_x[n_full - 1]);
+    const __m128i s_full = _mm_set1_epi32(mtable[n_full - 1]);
+
+    for (j = 0; j < width; j += 4) {
+      const __m128i sum = _mm_sub_epi32(
+          _mm_add_epi32(_mm_loadu_si128((__m128i *)&bot[j + 2 * r + 1]),
+                        _mm_loadu_si128((__m128i *)&top[j])),
+          _mm_add_epi32(_mm_loadu_si128((__m128i *)&bot[j]),
+                        _mm_loadu_si128((__m128i *)&top[j + 2 * r + 1])));
+      const __m128i sum_sq = _mm_sub_epi32(
+          _mm_add_epi32(_mm_loadu_si128((__m128i *)&bot_sq[j + 2 * r + 1]),
+                        _mm_loadu_si128((__m128i *)&top_sq[j])),
+          _mm_add_epi32(_mm_loadu_si128((__m128i *)&bot_sq[j]),
+                        _mm_loadu_si128((__m128i *)&top_sq[j + 2 * r + 1])));
+
+      if (j >= r && j + 3 + r <= width - 1) {
+        calc_block(sum, sum_sq, n_full_, one_over_n_full, s_full, bit_depth,
+                   i * buf_stride + j, A, B);
+      } else {
+        // Count the pixels in the clipped windows. Columns past the
+        // right-hand edge of the tile are "don't care", but must still give
+        // a valid table index.
+        int n[4];
+        for (k = 0; k < 4; ++k) {
+          const int col = AOMMIN(j + k, width - 1);
+          n[k] = rows * (AOMMIN(col + r, width - 1) - AOMMAX(col - r, 0) + 1);
+        }
+        calc_block(
+            sum, sum_sq, _mm_loadu_si128((__m128i *)n),
+            _mm_set_epi32(one_by_x[n[3] - 1], one_by_x[n[2] - 1],
+                          one_by_x[n[1] - 1], one_by_x[n[0] - 1]),
+            _mm_set_epi32(mtable[n[3] - 1], mtable[n[2] - 1], mtable[n[1] - 1],
+                          mtable[n[0] - 1]),
+            bit_depth, i * buf_stride + j, A, B);
+      }
+    }
   }
+}
 
+static void final_filter(int32_t *A, int32_t *B, int buf_stride, uint8_t *dgd,
+                         int width, int height, int stride, int32_t *dst,
+                         int dst_stride) {
+  int i, j;
   {
     i = 0;
     j = 0;
@@ -883,6 +925,55 @@ void av1_selfguided_restoration_sse4_1(uint8_t *dgd, int width, int height,
   }
 }
 
+void av1_selfguided_restoration_sse4_1(uint8_t *dgd, int width, int height,
+                                       int stride, int32_t *dst, int dst_stride,
+                                       int r, int eps, int32_t *tmpbuf) {
+  int32_t *A = tmpbuf;
+  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
+  // Adjusting the stride of A and B here appears to avoid bad cache effects,
+  // leading to a significant speed improvement.
+  // We also align the stride to a multiple of 16 bytes for efficiency.
+  int buf_stride = ((width + 3) & ~3) + 16;
+
+  // Don't filter tiles with dimensions < 5 on any axis
+  if ((width < 5) || (height < 5)) return;
+
+  if (r == 1) {
+    selfguided_restoration_1_v(dgd, width, height, stride, A, B, buf_stride);
+    selfguided_restoration_1_h(A, B, width, height, buf_stride, eps, 8);
+  } else if (r == 2) {
+    selfguided_restoration_2_v(dgd, width, height, stride, A, B, buf_stride);
+    selfguided_restoration_2_h(A, B, width, height, buf_stride, eps, 8);
+  } else if (r == 3) {
+    selfguided_restoration_3_v(dgd, width, height, stride, A, B, buf_stride);
+    selfguided_restoration_3_h(A, B, width, height, buf_stride, eps, 8);
+  } else {
+    assert(0);
+  }
+
+  final_filter(A, B, buf_stride, dgd, width, height, stride, dst, dst_stride);
+}
+
+void av1_selfguided_restoration_from_integral_sse4_1(
+    uint8_t *dgd, int width, int height, int stride, const int32_t *ii,
+    const int32_t *ii_sq, int32_t *dst, int dst_stride, int r, int eps,
+    int32_t *tmpbuf) {
+  int32_t *A = tmpbuf;
+  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
+  int buf_stride = ((width + 3) & ~3) + 16;
+
+  // The C version copies the source for the tiles which it doesn't filter
+  if ((width < 5) || (height < 5)) {
+    av1_selfguided_restoration_from_integral_c(dgd, width, height, stride, ii,
+                                               ii_sq, dst, dst_stride, r, eps,
+                                               tmpbuf);
+    return;
+  }
+
+  calc_ab_from_integral(ii, ii_sq, width, height, r, eps, 8, A, B, buf_stride);
+  final_filter(A, B, buf_stride, dgd, width, height, stride, dst, dst_stride);
+}
+
 void av1_highpass_filter_sse4_1(uint8_t *dgd, int width, int height, int stride,
                                 int32_t *dst, int dst_stride, int corner,
                                 int edge) {
@@ -1363,38 +1454,10 @@ static void highbd_selfguided_restoration_3_v(uint16_t *src, int width,
   }
 }
 
-void av1_selfguided_restoration_highbd_sse4_1(uint16_t *dgd, int width,
-                                              int height, int stride,
-                                              int32_t *dst, int dst_stride,
-                                              int bit_depth, int r, int eps,
-                                              int32_t *tmpbuf) {
-  int32_t *A = tmpbuf;
-  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
+static void highbd_final_filter(int32_t *A, int32_t *B, int buf_stride,
+                                uint16_t *dgd, int width, int height,
+                                int stride, int32_t *dst, int dst_stride) {
   int i, j;
-  // Adjusting the stride of A and B here appears to avoid bad cache effects,
-  // leading to a significant speed improvement.
-  // We also align the stride to a multiple of 16 bytes for efficiency.
-  int buf_stride = ((width + 3) & ~3) + 16;
-
-  // Don't filter tiles with dimensions < 5 on any axis
-  if ((width < 5) || (height < 5)) return;
-
-  if (r == 1) {
-    highbd_selfguided_restoration_1_v(dgd, width, height, stride, A, B,
-                                      buf_stride);
-    selfguided_restoration_1_h(A, B, width, height, buf_stride, eps, bit_depth);
-  } else if (r == 2) {
-    highbd_selfguided_restoration_2_v(dgd, width, height, stride, A, B,
-                                      buf_stride);
-    selfguided_restoration_2_h(A, B, width, height, buf_stride, eps, bit_depth);
-  } else if (r == 3) {
-    highbd_selfguided_restoration_3_v(dgd, width, height, stride, A, B,
-                                      buf_stride);
-    selfguided_restoration_3_h(A, B, width, height, buf_stride, eps, bit_depth);
-  } else {
-    assert(0);
-  }
-
   {
     i = 0;
     j = 0;
@@ -1588,6 +1651,62 @@ void av1_selfguided_restoration_highbd_sse4_1(uint16_t *dgd, int width,
   }
 }
 
+void av1_selfguided_restoration_highbd_sse4_1(uint16_t *dgd, int width,
+                                              int height, int stride,
+                                              int32_t *dst, int dst_stride,
+                                              int bit_depth, int r, int eps,
+                                              int32_t *tmpbuf) {
+  int32_t *A = tmpbuf;
+  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
+  // Adjusting the stride of A and B here appears to avoid bad cache effects,
+  // leading to a significant speed improvement.
+  // We also align the stride to a multiple of 16 bytes for efficiency.
+  int buf_stride = ((width + 3) & ~3) + 16;
+
+  // Don't filter tiles with dimensions < 5 on any axis
+  if ((width < 5) || (height < 5)) return;
+
+  if (r == 1) {
+    highbd_selfguided_restoration_1_v(dgd, width, height, stride, A, B,
+                                      buf_stride);
+    selfguided_restoration_1_h(A, B, width, height, buf_stride, eps, bit_depth);
+  } else if (r == 2) {
+    highbd_selfguided_restoration_2_v(dgd, width, height, stride, A, B,
+                                      buf_stride);
+    selfguided_restoration_2_h(A, B, width, height, buf_stride, eps, bit_depth);
+  } else if (r == 3) {
+    highbd_selfguided_restoration_3_v(dgd, width, height, stride, A, B,
+                                      buf_stride);
+    selfguided_restoration_3_h(A, B, width, height, buf_stride, eps, bit_depth);
+  } else {
+    assert(0);
+  }
+
+  highbd_final_filter(A, B, buf_stride, dgd, width, height, stride, dst,
+                      dst_stride);
+}
+
+void av1_selfguided_restoration_from_integral_highbd_sse4_1(
+    uint16_t *dgd, int width, int height, int stride, const int32_t *ii,
+    const int32_t *ii_sq, int32_t *dst, int dst_stride, int bit_depth, int r,
+    int eps, int32_t *tmpbuf) {
+  int32_t *A = tmpbuf;
+  int32_t *B = A + SGRPROJ_OUTBUF_SIZE;
+  int buf_stride = ((width + 3) & ~3) + 16;
+
+  if ((width < 5) || (height < 5)) {
+    av1_selfguided_restoration_from_integral_highbd_c(
+        dgd, width, height, stride, ii, ii_sq, dst, dst_stride, bit_depth, r,
+        eps, tmpbuf);
+    return;
+  }
+
+  calc_ab_from_integral(ii, ii_sq, width, height, r, eps, bit_depth, A, B,
+                        buf_stride);
+  highbd_final_filter(A, B, buf_stride, dgd, width, height, stride, dst,
+                      dst_stride);
+}
+
 void av1_highpass_filter_highbd_sse4_1(uint16_t *dgd, int width, int height,
                                        int stride, int32_t *dst, int dst_stride,
                                        int corner, int edge) {
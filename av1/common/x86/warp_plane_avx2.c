@@ -0,0 +1,664 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "./av1_rtcd.h"
+#include "av1/common/warped_motion.h"
+
+/* The filters in this file follow the same structure as the SSSE3 versions in
+   warp_plane_ssse3.c and highbd_warp_plane_ssse3.c, but each pass works on
+   two 8-pixel rows at once: the first row in the low 128-bit lane and the
+   second row in the high lane. Since all of the shuffles and unpacks used
+   work within a lane, the arithmetic is exactly the same as for SSSE3.
+
+   Note: For this code to work, the left/right frame borders need to be
+   extended by at least 13 pixels each.
+*/
+
+// Same shuffle masks as in warp_plane_ssse3.c, repeated for both lanes
+static const uint8_t even_mask[32] = { 0, 2,  2,  4,  4,  6,  6,  8,
+                                       8, 10, 10, 12, 12, 14, 14, 0,
+                                       0, 2,  2,  4,  4,  6,  6,  8,
+                                       8, 10, 10, 12, 12, 14, 14, 0 };
+static const uint8_t odd_mask[32] = { 1, 3,  3,  5,  5,  7,  7,  9,
+                                      9, 11, 11, 13, 13, 15, 15, 0,
+                                      1, 3,  3,  5,  5,  7,  7,  9,
+                                      9, 11, 11, 13, 13, 15, 15, 0 };
+
+static INLINE __m256i pair_128(__m128i lo, __m128i hi) {
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// Load the coefficients for offsets sx0 (low lane) and sx1 (high lane)
+static INLINE __m256i load_filter_8bit_x2(int sx0, int sx1) {
+  return pair_128(
+      _mm_loadl_epi64(
+          (__m128i *)&warped_filter_8bit[sx0 >> WARPEDDIFF_PREC_BITS]),
+      _mm_loadl_epi64(
+          (__m128i *)&warped_filter_8bit[sx1 >> WARPEDDIFF_PREC_BITS]));
+}
+
+static INLINE __m256i load_filter_x2(int sx0, int sx1) {
+  return pair_128(
+      _mm_loadu_si128((__m128i *)warped_filter[sx0 >> WARPEDDIFF_PREC_BITS]),
+      _mm_loadu_si128((__m128i *)warped_filter[sx1 >> WARPEDDIFF_PREC_BITS]));
+}
+
+// Work out where the 8x8 block centred on (dst_x, dst_y) comes from in the
+// reference frame. The returned sx4 and sy4 include all of the constant
+// terms (rounding and offset), as in the SSSE3 filters.
+static INLINE void get_block_position(const int32_t *mat, int32_t dst_x,
+                                      int32_t dst_y, int subsampling_x,
+                                      int subsampling_y, int16_t alpha,
+                                      int16_t beta, int16_t gamma,
+                                      int16_t delta, int32_t *ix4, int32_t *sx4,
+                                      int32_t *iy4, int32_t *sy4) {
+  int32_t x4, y4;
+  if (subsampling_x)
+    x4 = (mat[2] * 4 * dst_x + mat[3] * 4 * dst_y + mat[0] * 2 +
+          (mat[2] + mat[3] - (1 << WARPEDMODEL_PREC_BITS))) /
+         4;
+  else
+    x4 = mat[2] * dst_x + mat[3] * dst_y + mat[0];
+
+  if (subsampling_y)
+    y4 = (mat[4] * 4 * dst_x + mat[5] * 4 * dst_y + mat[1] * 2 +
+          (mat[4] + mat[5] - (1 << WARPEDMODEL_PREC_BITS))) /
+         4;
+  else
+    y4 = mat[4] * dst_x + mat[5] * dst_y + mat[1];
+
+  *ix4 = x4 >> WARPEDMODEL_PREC_BITS;
+  *sx4 = x4 & ((1 << WARPEDMODEL_PREC_BITS) - 1);
+  *iy4 = y4 >> WARPEDMODEL_PREC_BITS;
+  *sy4 = y4 & ((1 << WARPEDMODEL_PREC_BITS) - 1);
+
+  *sx4 += alpha * (-4) + beta * (-4) + (1 << (WARPEDDIFF_PREC_BITS - 1)) +
+          (WARPEDPIXEL_PREC_SHIFTS << WARPEDDIFF_PREC_BITS);
+  *sy4 += gamma * (-4) + delta * (-4) + (1 << (WARPEDDIFF_PREC_BITS - 1)) +
+          (WARPEDPIXEL_PREC_SHIFTS << WARPEDDIFF_PREC_BITS);
+
+  *sx4 &= ~((1 << WARP_PARAM_REDUCE_BITS) - 1);
+  *sy4 &= ~((1 << WARP_PARAM_REDUCE_BITS) - 1);
+}
+
+static INLINE int clamp_row(int iy, int height) {
+  if (iy < 0) return 0;
+  if (iy > height - 1) return height - 1;
+  return iy;
+}
+
+// Horizontally filter rows k = -7 ... rows - 8 of the current block into
+// tmp[0 ... rows - 1]. Rows are processed in pairs, so one extra row may be
+// written; 'tmp' must have space for 16 rows.
+static INLINE void horizontal_filter(const uint8_t *ref, int width, int height,
+                                     int stride, int32_t ix4, int32_t iy4,
+                                     int32_t sx4, int16_t alpha, int16_t beta,
+                                     int rows, int reduce_bits,
+                                     __m128i *tmp) {
+  const int bd = 8;
+  int k;
+
+  // If the block is aligned such that, after clamping, every sample
+  // would be taken from the leftmost/rightmost column, then we can
+  // skip the expensive horizontal filter.
+  if (ix4 <= -7 || ix4 >= width + 6) {
+    const int col = ix4 <= -7 ? 0 : width - 1;
+    for (k = -7; k < rows - 7; ++k) {
+      const int iy = clamp_row(iy4 + k, height);
+      tmp[k + 7] = _mm_set1_epi16(
+          (1 << (bd + WARPEDPIXEL_FILTER_BITS - reduce_bits - 1)) +
+          ref[iy * stride + col] *
+              (1 << (WARPEDPIXEL_FILTER_BITS - reduce_bits)));
+    }
+    return;
+  }
+
+  {
+    const __m256i even = _mm256_loadu_si256((__m256i *)even_mask);
+    const __m256i odd = _mm256_loadu_si256((__m256i *)odd_mask);
+    const __m256i round_const =
+        _mm256_set1_epi16((1 << (bd + WARPEDPIXEL_FILTER_BITS - 1)) +
+                          ((1 << reduce_bits) >> 1));
+    const __m128i shift = _mm_cvtsi32_si128(reduce_bits);
+
+    for (k = -7; k < rows - 7; k += 2) {
+      const int iy0 = clamp_row(iy4 + k, height);
+      const int iy1 = clamp_row(iy4 + k + 1, height);
+      const int sx0 = sx4 + beta * (k + 4);
+      const int sx1 = sx0 + beta;
+
+      // Load source pixels
+      const __m256i src = pair_128(
+          _mm_loadu_si128((__m128i *)(ref + iy0 * stride + ix4 - 7)),
+          _mm_loadu_si128((__m128i *)(ref + iy1 * stride + ix4 - 7)));
+      const __m256i src_even = _mm256_shuffle_epi8(src, even);
+      const __m256i src_odd = _mm256_shuffle_epi8(src, odd);
+
+      const __m256i tmp_0 = load_filter_8bit_x2(sx0, sx1);
+      const __m256i tmp_1 = load_filter_8bit_x2(sx0 + alpha, sx1 + alpha);
+      const __m256i tmp_2 =
+          load_filter_8bit_x2(sx0 + 2 * alpha, sx1 + 2 * alpha);
+      const __m256i tmp_3 =
+          load_filter_8bit_x2(sx0 + 3 * alpha, sx1 + 3 * alpha);
+      const __m256i tmp_4 =
+          load_filter_8bit_x2(sx0 + 4 * alpha, sx1 + 4 * alpha);
+      const __m256i tmp_5 =
+          load_filter_8bit_x2(sx0 + 5 * alpha, sx1 + 5 * alpha);
+      const __m256i tmp_6 =
+          load_filter_8bit_x2(sx0 + 6 * alpha, sx1 + 6 * alpha);
+      const __m256i tmp_7 =
+          load_filter_8bit_x2(sx0 + 7 * alpha, sx1 + 7 * alpha);
+
+      const __m256i tmp_8 = _mm256_unpacklo_epi16(tmp_0, tmp_2);
+      const __m256i tmp_9 = _mm256_unpacklo_epi16(tmp_1, tmp_3);
+      const __m256i tmp_10 = _mm256_unpacklo_epi16(tmp_4, tmp_6);
+      const __m256i tmp_11 = _mm256_unpacklo_epi16(tmp_5, tmp_7);
+
+      const __m256i tmp_12 = _mm256_unpacklo_epi32(tmp_8, tmp_10);
+      const __m256i tmp_13 = _mm256_unpackhi_epi32(tmp_8, tmp_10);
+      const __m256i tmp_14 = _mm256_unpacklo_epi32(tmp_9, tmp_11);
+      const __m256i tmp_15 = _mm256_unpackhi_epi32(tmp_9, tmp_11);
+
+      // Coeffs 0 2, 4 6, 1 3 and 5 7 for pixels 0 2 4 6 1 3 5 7
+      const __m256i coeff_02 = _mm256_unpacklo_epi64(tmp_12, tmp_14);
+      const __m256i coeff_46 = _mm256_unpackhi_epi64(tmp_12, tmp_14);
+      const __m256i coeff_13 = _mm256_unpacklo_epi64(tmp_13, tmp_15);
+      const __m256i coeff_57 = _mm256_unpackhi_epi64(tmp_13, tmp_15);
+
+      const __m256i src_02 = _mm256_unpacklo_epi64(src_even, src_odd);
+      const __m256i res_02 = _mm256_maddubs_epi16(src_02, coeff_02);
+      const __m256i src_46 = _mm256_unpacklo_epi64(
+          _mm256_srli_si256(src_even, 4), _mm256_srli_si256(src_odd, 4));
+      const __m256i res_46 = _mm256_maddubs_epi16(src_46, coeff_46);
+      const __m256i src_13 =
+          _mm256_unpacklo_epi64(src_odd, _mm256_srli_si256(src_even, 2));
+      const __m256i res_13 = _mm256_maddubs_epi16(src_13, coeff_13);
+      const __m256i src_57 = _mm256_unpacklo_epi64(
+          _mm256_srli_si256(src_odd, 4), _mm256_srli_si256(src_even, 6));
+      const __m256i res_57 = _mm256_maddubs_epi16(src_57, coeff_57);
+
+      // See warp_plane_ssse3.c for why the wrapping adds give the correct
+      // (unsigned) result here.
+      const __m256i res_even = _mm256_add_epi16(res_02, res_46);
+      const __m256i res_odd = _mm256_add_epi16(res_13, res_57);
+      const __m256i res = _mm256_srl_epi16(
+          _mm256_add_epi16(_mm256_add_epi16(res_even, res_odd), round_const),
+          shift);
+      tmp[k + 7] = _mm256_castsi256_si128(res);
+      tmp[k + 8] = _mm256_extracti128_si256(res, 1);
+    }
+  }
+}
+
+// Vertically filter the pair of output rows k, k + 1, where src = tmp + k + 4.
+// On return, the low lanes of *res_lo and *res_hi hold pixels 0-3 and 4-7 of
+// row k, unrounded, and the high lanes hold the same for row k + 1.
+static INLINE void vertical_filter_2rows(const __m128i *src, int sy,
+                                         int16_t gamma, int16_t delta,
+                                         __m256i *res_lo, __m256i *res_hi) {
+  const int sy1 = sy + delta;
+
+  // Rows r (low lane) and r + 1 (high lane) of the intermediate block
+  const __m256i s_0 = pair_128(src[0], src[1]);
+  const __m256i s_1 = pair_128(src[1], src[2]);
+  const __m256i s_2 = pair_128(src[2], src[3]);
+  const __m256i s_3 = pair_128(src[3], src[4]);
+  const __m256i s_4 = pair_128(src[4], src[5]);
+  const __m256i s_5 = pair_128(src[5], src[6]);
+  const __m256i s_6 = pair_128(src[6], src[7]);
+  const __m256i s_7 = pair_128(src[7], src[8]);
+
+  // Rearrange pairs of consecutive rows into the column order
+  // 0 0 2 2 4 4 6 6; 1 1 3 3 5 5 7 7
+  const __m256i src_0 = _mm256_unpacklo_epi16(s_0, s_1);
+  const __m256i src_2 = _mm256_unpacklo_epi16(s_2, s_3);
+  const __m256i src_4 = _mm256_unpacklo_epi16(s_4, s_5);
+  const __m256i src_6 = _mm256_unpacklo_epi16(s_6, s_7);
+  const __m256i src_1 = _mm256_unpackhi_epi16(s_0, s_1);
+  const __m256i src_3 = _mm256_unpackhi_epi16(s_2, s_3);
+  const __m256i src_5 = _mm256_unpackhi_epi16(s_4, s_5);
+  const __m256i src_7 = _mm256_unpackhi_epi16(s_6, s_7);
+
+  // Filter even-index pixels
+  const __m256i tmp_0 = load_filter_x2(sy, sy1);
+  const __m256i tmp_2 = load_filter_x2(sy + 2 * gamma, sy1 + 2 * gamma);
+  const __m256i tmp_4 = load_filter_x2(sy + 4 * gamma, sy1 + 4 * gamma);
+  const __m256i tmp_6 = load_filter_x2(sy + 6 * gamma, sy1 + 6 * gamma);
+
+  const __m256i tmp_8 = _mm256_unpacklo_epi32(tmp_0, tmp_2);
+  const __m256i tmp_10 = _mm256_unpacklo_epi32(tmp_4, tmp_6);
+  const __m256i tmp_12 = _mm256_unpackhi_epi32(tmp_0, tmp_2);
+  const __m256i tmp_14 = _mm256_unpackhi_epi32(tmp_4, tmp_6);
+
+  const __m256i coeff_0 = _mm256_unpacklo_epi64(tmp_8, tmp_10);
+  const __m256i coeff_2 = _mm256_unpackhi_epi64(tmp_8, tmp_10);
+  const __m256i coeff_4 = _mm256_unpacklo_epi64(tmp_12, tmp_14);
+  const __m256i coeff_6 = _mm256_unpackhi_epi64(tmp_12, tmp_14);
+
+  const __m256i res_0 = _mm256_madd_epi16(src_0, coeff_0);
+  const __m256i res_2 = _mm256_madd_epi16(src_2, coeff_2);
+  const __m256i res_4 = _mm256_madd_epi16(src_4, coeff_4);
+  const __m256i res_6 = _mm256_madd_epi16(src_6, coeff_6);
+
+  const __m256i res_even = _mm256_add_epi32(_mm256_add_epi32(res_0, res_2),
+                                            _mm256_add_epi32(res_4, res_6));
+
+  // Filter odd-index pixels
+  const __m256i tmp_1 = load_filter_x2(sy + gamma, sy1 + gamma);
+  const __m256i tmp_3 = load_filter_x2(sy + 3 * gamma, sy1 + 3 * gamma);
+  const __m256i tmp_5 = load_filter_x2(sy + 5 * gamma, sy1 + 5 * gamma);
+  const __m256i tmp_7 = load_filter_x2(sy + 7 * gamma, sy1 + 7 * gamma);
+
+  const __m256i tmp_9 = _mm256_unpacklo_epi32(tmp_1, tmp_3);
+  const __m256i tmp_11 = _mm256_unpacklo_epi32(tmp_5, tmp_7);
+  const __m256i tmp_13 = _mm256_unpackhi_epi32(tmp_1, tmp_3);
+  const __m256i tmp_15 = _mm256_unpackhi_epi32(tmp_5, tmp_7);
+
+  const __m256i coeff_1 = _mm256_unpacklo_epi64(tmp_9, tmp_11);
+  const __m256i coeff_3 = _mm256_unpackhi_epi64(tmp_9, tmp_11);
+  const __m256i coeff_5 = _mm256_unpacklo_epi64(tmp_13, tmp_15);
+  const __m256i coeff_7 = _mm256_unpackhi_epi64(tmp_13, tmp_15);
+
+  const __m256i res_1 = _mm256_madd_epi16(src_1, coeff_1);
+  const __m256i res_3 = _mm256_madd_epi16(src_3, coeff_3);
+  const __m256i res_5 = _mm256_madd_epi16(src_5, coeff_5);
+  const __m256i res_7 = _mm256_madd_epi16(src_7, coeff_7);
+
+  const __m256i res_odd = _mm256_add_epi32(_mm256_add_epi32(res_1, res_3),
+                                           _mm256_add_epi32(res_5, res_7));
+
+  // Rearrange pixels back into the order 0 ... 7
+  *res_lo = _mm256_unpacklo_epi32(res_even, res_odd);
+  *res_hi = _mm256_unpackhi_epi32(res_even, res_odd);
+}
+
+static INLINE void store_8bit_row(uint8_t *p, __m128i res_8bit, int p_width,
+                                  int comp_avg) {
+  // Note: If we're outputting a 4x4 block, we need to be very careful
+  // to only output 4 pixels at this point, to avoid encode/decode
+  // mismatches when encoding with multiple threads.
+  if (p_width == 4) {
+    if (comp_avg)
+      res_8bit = _mm_avg_epu8(res_8bit, _mm_cvtsi32_si128(*(uint32_t *)p));
+    *(uint32_t *)p = _mm_cvtsi128_si32(res_8bit);
+  } else {
+    if (comp_avg)
+      res_8bit = _mm_avg_epu8(res_8bit, _mm_loadl_epi64((__m128i *)p));
+    _mm_storel_epi64((__m128i *)p, res_8bit);
+  }
+}
+
+#if CONFIG_CONVOLVE_ROUND
+// Add the rounded results for rows k (low lanes) and k + 1 (high lanes) to
+// the 32-bit convolve buffer.
+static INLINE void accumulate_rows(CONV_BUF_TYPE *dst, int dst_stride,
+                                   __m256i res_lo, __m256i res_hi,
+                                   int width) {
+  if (width == 4) {
+    __m128i *const p0 = (__m128i *)dst;
+    __m128i *const p1 = (__m128i *)(dst + dst_stride);
+    _mm_storeu_si128(p0, _mm_add_epi32(_mm_loadu_si128(p0),
+                                       _mm256_castsi256_si128(res_lo)));
+    _mm_storeu_si128(p1, _mm_add_epi32(_mm_loadu_si128(p1),
+                                       _mm256_extracti128_si256(res_lo, 1)));
+  } else {
+    __m256i *const p0 = (__m256i *)dst;
+    __m256i *const p1 = (__m256i *)(dst + dst_stride);
+    const __m256i row_0 = _mm256_permute2x128_si256(res_lo, res_hi, 0x20);
+    const __m256i row_1 = _mm256_permute2x128_si256(res_lo, res_hi, 0x31);
+    _mm256_storeu_si256(p0, _mm256_add_epi32(_mm256_loadu_si256(p0), row_0));
+    _mm256_storeu_si256(p1, _mm256_add_epi32(_mm256_loadu_si256(p1), row_1));
+  }
+}
+#endif  // CONFIG_CONVOLVE_ROUND
+
+void av1_warp_affine_avx2(const int32_t *mat, const uint8_t *ref, int width,
+                          int height, int stride, uint8_t *pred, int p_col,
+                          int p_row, int p_width, int p_height, int p_stride,
+                          int subsampling_x, int subsampling_y,
+                          ConvolveParams *conv_params, int16_t alpha,
+                          int16_t beta, int16_t gamma, int16_t delta) {
+  const int comp_avg = conv_params->do_average;
+  const int bd = 8;
+  const __m256i round_const =
+      _mm256_set1_epi32(-(1 << (bd + VERSHEAR_REDUCE_PREC_BITS - 1)) +
+                        ((1 << VERSHEAR_REDUCE_PREC_BITS) >> 1));
+  __m128i tmp[16];
+  int i, j, k;
+
+  for (i = 0; i < p_height; i += 8) {
+    for (j = 0; j < p_width; j += 8) {
+      int32_t ix4, sx4, iy4, sy4;
+      get_block_position(mat, p_col + j + 4, p_row + i + 4, subsampling_x,
+                         subsampling_y, alpha, beta, gamma, delta, &ix4, &sx4,
+                         &iy4, &sy4);
+
+      horizontal_filter(ref, width, height, stride, ix4, iy4, sx4, alpha, beta,
+                        AOMMIN(8, p_height - i) + 7, HORSHEAR_REDUCE_PREC_BITS,
+                        tmp);
+
+      // Vertical filter, two rows at a time
+      for (k = -4; k < AOMMIN(4, p_height - i - 4); k += 2) {
+        __m256i res_lo, res_hi;
+        vertical_filter_2rows(tmp + (k + 4), sy4 + delta * (k + 4), gamma,
+                              delta, &res_lo, &res_hi);
+
+        // Round and pack into 8 bits
+        res_lo = _mm256_srai_epi32(_mm256_add_epi32(res_lo, round_const),
+                                   VERSHEAR_REDUCE_PREC_BITS);
+        res_hi = _mm256_srai_epi32(_mm256_add_epi32(res_hi, round_const),
+                                   VERSHEAR_REDUCE_PREC_BITS);
+        {
+          const __m256i res_16bit = _mm256_packs_epi32(res_lo, res_hi);
+          const __m256i res_8bit = _mm256_packus_epi16(res_16bit, res_16bit);
+          uint8_t *const p = &pred[(i + k + 4) * p_stride + j];
+
+          store_8bit_row(p, _mm256_castsi256_si128(res_8bit), p_width,
+                         comp_avg);
+          store_8bit_row(p + p_stride, _mm256_extracti128_si256(res_8bit, 1),
+                         p_width, comp_avg);
+        }
+      }
+    }
+  }
+}
+
+#if CONFIG_CONVOLVE_ROUND
+void av1_warp_affine_post_round_avx2(
+    const int32_t *mat, const uint8_t *ref, int width, int height, int stride,
+    uint8_t *pred, int p_col, int p_row, int p_width, int p_height,
+    int p_stride, int subsampling_x, int subsampling_y,
+    ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma,
+    int16_t delta) {
+  const int bd = 8;
+  const int offset_bits_horiz = bd + FILTER_BITS - 1;
+  const int offset_bits_vert = bd + 2 * FILTER_BITS - conv_params->round_0;
+  const __m256i round_const =
+      _mm256_set1_epi32((1 << offset_bits_vert) +
+                        ((1 << conv_params->round_1) >> 1));
+  const __m256i offset = _mm256_set1_epi32(
+      (1 << (offset_bits_horiz + FILTER_BITS - conv_params->round_0 -
+             conv_params->round_1)) +
+      (1 << (offset_bits_vert - conv_params->round_1)));
+  const __m128i shift = _mm_cvtsi32_si128(conv_params->round_1);
+  __m128i tmp[16];
+  int i, j, k;
+  (void)pred;
+  (void)p_stride;
+  assert(FILTER_BITS == WARPEDPIXEL_FILTER_BITS);
+
+  for (i = 0; i < p_height; i += 8) {
+    for (j = 0; j < p_width; j += 8) {
+      int32_t ix4, sx4, iy4, sy4;
+      get_block_position(mat, p_col + j + 4, p_row + i + 4, subsampling_x,
+                         subsampling_y, alpha, beta, gamma, delta, &ix4, &sx4,
+                         &iy4, &sy4);
+
+      horizontal_filter(ref, width, height, stride, ix4, iy4, sx4, alpha, beta,
+                        AOMMIN(8, p_height - i) + 7, conv_params->round_0,
+                        tmp);
+
+      for (k = -4; k < AOMMIN(4, p_height - i - 4); k += 2) {
+        __m256i res_lo, res_hi;
+        vertical_filter_2rows(tmp + (k + 4), sy4 + delta * (k + 4), gamma,
+                              delta, &res_lo, &res_hi);
+
+        res_lo = _mm256_sub_epi32(
+            _mm256_sra_epi32(_mm256_add_epi32(res_lo, round_const), shift),
+            offset);
+        res_hi = _mm256_sub_epi32(
+            _mm256_sra_epi32(_mm256_add_epi32(res_hi, round_const), shift),
+            offset);
+        accumulate_rows(
+            &conv_params->dst[(i + k + 4) * conv_params->dst_stride + j],
+            conv_params->dst_stride, res_lo, res_hi, AOMMIN(8, p_width - j));
+      }
+    }
+  }
+}
+#endif  // CONFIG_CONVOLVE_ROUND
+
+#if CONFIG_HIGHBITDEPTH
+// As horizontal_filter(), but for high bitdepth input.
+static INLINE void highbd_horizontal_filter(const uint16_t *ref, int width,
+                                            int height, int stride,
+                                            int32_t ix4, int32_t iy4,
+                                            int32_t sx4, int16_t alpha,
+                                            int16_t beta, int rows, int bd,
+                                            int reduce_bits, __m128i *tmp) {
+  int k;
+
+  if (ix4 <= -7 || ix4 >= width + 6) {
+    const int col = ix4 <= -7 ? 0 : width - 1;
+    for (k = -7; k < rows - 7; ++k) {
+      const int iy = clamp_row(iy4 + k, height);
+      tmp[k + 7] = _mm_set1_epi16(
+          (1 << (bd + WARPEDPIXEL_FILTER_BITS - reduce_bits - 1)) +
+          ref[iy * stride + col] *
+              (1 << (WARPEDPIXEL_FILTER_BITS - reduce_bits)));
+    }
+    return;
+  }
+
+  {
+    const __m256i round_const =
+        _mm256_set1_epi32((1 << (bd + WARPEDPIXEL_FILTER_BITS - 1)) +
+                          ((1 << reduce_bits) >> 1));
+    const __m128i shift = _mm_cvtsi32_si128(reduce_bits);
+
+    for (k = -7; k < rows - 7; k += 2) {
+      const uint16_t *const ref0 =
+          ref + clamp_row(iy4 + k, height) * stride + ix4 - 7;
+      const uint16_t *const ref1 =
+          ref + clamp_row(iy4 + k + 1, height) * stride + ix4 - 7;
+      const int sx0 = sx4 + beta * (k + 4);
+      const int sx1 = sx0 + beta;
+
+      // Load source pixels
+      const __m256i src = pair_128(_mm_loadu_si128((__m128i *)ref0),
+                                   _mm_loadu_si128((__m128i *)ref1));
+      const __m256i src2 = pair_128(_mm_loadu_si128((__m128i *)(ref0 + 8)),
+                                    _mm_loadu_si128((__m128i *)(ref1 + 8)));
+
+      // Filter even-index pixels
+      const __m256i tmp_0 = load_filter_x2(sx0, sx1);
+      const __m256i tmp_2 = load_filter_x2(sx0 + 2 * alpha, sx1 + 2 * alpha);
+      const __m256i tmp_4 = load_filter_x2(sx0 + 4 * alpha, sx1 + 4 * alpha);
+      const __m256i tmp_6 = load_filter_x2(sx0 + 6 * alpha, sx1 + 6 * alpha);
+
+      const __m256i tmp_8 = _mm256_unpacklo_epi32(tmp_0, tmp_2);
+      const __m256i tmp_10 = _mm256_unpacklo_epi32(tmp_4, tmp_6);
+      const __m256i tmp_12 = _mm256_unpackhi_epi32(tmp_0, tmp_2);
+      const __m256i tmp_14 = _mm256_unpackhi_epi32(tmp_4, tmp_6);
+
+      const __m256i coeff_0 = _mm256_unpacklo_epi64(tmp_8, tmp_10);
+      const __m256i coeff_2 = _mm256_unpackhi_epi64(tmp_8, tmp_10);
+      const __m256i coeff_4 = _mm256_unpacklo_epi64(tmp_12, tmp_14);
+      const __m256i coeff_6 = _mm256_unpackhi_epi64(tmp_12, tmp_14);
+
+      const __m256i res_0 = _mm256_madd_epi16(src, coeff_0);
+      const __m256i res_2 =
+          _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 4), coeff_2);
+      const __m256i res_4 =
+          _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 8), coeff_4);
+      const __m256i res_6 =
+          _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 12), coeff_6);
+
+      __m256i res_even = _mm256_add_epi32(_mm256_add_epi32(res_0, res_4),
+                                          _mm256_add_epi32(res_2, res_6));
+      res_even =
+          _mm256_sra_epi32(_mm256_add_epi32(res_even, round_const), shift);
+
+      // Filter odd-index pixels
+      const __m256i tmp_1 = load_filter_x2(sx0 + alpha, sx1 + alpha);
+      const __m256i tmp_3 = load_filter_x2(sx0 + 3 * alpha, sx1 + 3 * alpha);
+      const __m256i tmp_5 = load_filter_x2(sx0 + 5 * alpha, sx1 + 5 * alpha);
+      const __m256i tmp_7 = load_filter_x2(sx0 + 7 * alpha, sx1 + 7 * alpha);
+
+      const __m256i tmp_9 = _mm256_unpacklo_epi32(tmp_1, tmp_3);
+      const __m256i tmp_11 = _mm256_unpacklo_epi32(tmp_5, tmp_7);
+      const __m256i tmp_13 = _mm256_unpackhi_epi32(tmp_1, tmp_3);
+      const __m256i tmp_15 = _mm256_unpackhi_epi32(tmp_5, tmp_7);
+
+      const __m256i coeff_1 = _mm256_unpacklo_epi64(tmp_9, tmp_11);
+      const __m256i coeff_3 = _mm256_unpackhi_epi64(tmp_9, tmp_11);
+      const __m256i coeff_5 = _mm256_unpacklo_epi64(tmp_13, tmp_15);
+      const __m256i coeff_7 = _mm256_unpackhi_epi64(tmp_13, tmp_15);
+
+      const __m256i res_1 =
+          _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 2), coeff_1);
+      const __m256i res_3 =
+          _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 6), coeff_3);
+      const __m256i res_5 =
+          _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 10), coeff_5);
+      const __m256i res_7 =
+          _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 14), coeff_7);
+
+      __m256i res_odd = _mm256_add_epi32(_mm256_add_epi32(res_1, res_5),
+                                         _mm256_add_epi32(res_3, res_7));
+      res_odd = _mm256_sra_epi32(_mm256_add_epi32(res_odd, round_const), shift);
+
+      // Combine results into one register per row, with the columns in the
+      // order 0, 2, 4, 6, 1, 3, 5, 7 as for SSSE3.
+      {
+        const __m256i res = _mm256_packs_epi32(res_even, res_odd);
+        tmp[k + 7] = _mm256_castsi256_si128(res);
+        tmp[k + 8] = _mm256_extracti128_si256(res, 1);
+      }
+    }
+  }
+}
+
+static INLINE void store_highbd_row(uint16_t *p, __m128i res_16bit,
+                                    int p_width, int comp_avg) {
+  if (p_width == 4) {
+    if (comp_avg)
+      res_16bit = _mm_avg_epu16(res_16bit, _mm_loadl_epi64((__m128i *)p));
+    _mm_storel_epi64((__m128i *)p, res_16bit);
+  } else {
+    if (comp_avg)
+      res_16bit = _mm_avg_epu16(res_16bit, _mm_loadu_si128((__m128i *)p));
+    _mm_storeu_si128((__m128i *)p, res_16bit);
+  }
+}
+
+void av1_highbd_warp_affine_avx2(const int32_t *mat, const uint16_t *ref,
+                                 int width, int height, int stride,
+                                 uint16_t *pred, int p_col, int p_row,
+                                 int p_width, int p_height, int p_stride,
+                                 int subsampling_x, int subsampling_y, int bd,
+                                 ConvolveParams *conv_params, int16_t alpha,
+                                 int16_t beta, int16_t gamma, int16_t delta) {
+  const int comp_avg = conv_params->do_average;
+  const __m256i round_const =
+      _mm256_set1_epi32(-(1 << (bd + VERSHEAR_REDUCE_PREC_BITS - 1)) +
+                        ((1 << VERSHEAR_REDUCE_PREC_BITS) >> 1));
+  const __m256i max_val = _mm256_set1_epi16((1 << bd) - 1);
+  const __m256i zero = _mm256_setzero_si256();
+  __m128i tmp[16];
+  int i, j, k;
+
+  for (i = 0; i < p_height; i += 8) {
+    for (j = 0; j < p_width; j += 8) {
+      int32_t ix4, sx4, iy4, sy4;
+      get_block_position(mat, p_col + j + 4, p_row + i + 4, subsampling_x,
+                         subsampling_y, alpha, beta, gamma, delta, &ix4, &sx4,
+                         &iy4, &sy4);
+
+      highbd_horizontal_filter(ref, width, height, stride, ix4, iy4, sx4,
+                               alpha, beta, AOMMIN(8, p_height - i) + 7, bd,
+                               HORSHEAR_REDUCE_PREC_BITS, tmp);
+
+      // Vertical filter, two rows at a time
+      for (k = -4; k < AOMMIN(4, p_height - i - 4); k += 2) {
+        __m256i res_lo, res_hi, res_16bit;
+        vertical_filter_2rows(tmp + (k + 4), sy4 + delta * (k + 4), gamma,
+                              delta, &res_lo, &res_hi);
+
+        res_lo = _mm256_srai_epi32(_mm256_add_epi32(res_lo, round_const),
+                                   VERSHEAR_REDUCE_PREC_BITS);
+        res_hi = _mm256_srai_epi32(_mm256_add_epi32(res_hi, round_const),
+                                   VERSHEAR_REDUCE_PREC_BITS);
+
+        // Clamp to the range [0, 2^bd - 1]
+        res_16bit = _mm256_packs_epi32(res_lo, res_hi);
+        res_16bit =
+            _mm256_max_epi16(_mm256_min_epi16(res_16bit, max_val), zero);
+        {
+          uint16_t *const p = &pred[(i + k + 4) * p_stride + j];
+          store_highbd_row(p, _mm256_castsi256_si128(res_16bit), p_width,
+                           comp_avg);
+          store_highbd_row(p + p_stride,
+                           _mm256_extracti128_si256(res_16bit, 1), p_width,
+                           comp_avg);
+        }
+      }
+    }
+  }
+}
+
+#if CONFIG_CONVOLVE_ROUND
+void av1_highbd_warp_affine_post_round_avx2(
+    const int32_t *mat, const uint16_t *ref, int width, int height, int stride,
+    uint16_t *pred, int p_col, int p_row, int p_width, int p_height,
+    int p_stride, int subsampling_x, int subsampling_y, int bd,
+    ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma,
+    int16_t delta) {
+  const int offset_bits_horiz = bd + FILTER_BITS - 1;
+  const int offset_bits_vert = bd + 2 * FILTER_BITS - conv_params->round_0;
+  const __m256i round_const =
+      _mm256_set1_epi32((1 << offset_bits_vert) +
+                        ((1 << conv_params->round_1) >> 1));
+  const __m256i offset = _mm256_set1_epi32(
+      (1 << (offset_bits_horiz + FILTER_BITS - conv_params->round_0 -
+             conv_params->round_1)) +
+      (1 << (offset_bits_vert - conv_params->round_1)));
+  const __m128i shift = _mm_cvtsi32_si128(conv_params->round_1);
+  __m128i tmp[16];
+  int i, j, k;
+  (void)pred;
+  (void)p_stride;
+  assert(FILTER_BITS == WARPEDPIXEL_FILTER_BITS);
+
+  for (i = 0; i < p_height; i += 8) {
+    for (j = 0; j < p_width; j += 8) {
+      int32_t ix4, sx4, iy4, sy4;
+      get_block_position(mat, p_col + j + 4, p_row + i + 4, subsampling_x,
+                         subsampling_y, alpha, beta, gamma, delta, &ix4, &sx4,
+                         &iy4, &sy4);
+
+      highbd_horizontal_filter(ref, width, height, stride, ix4, iy4, sx4,
+                               alpha, beta, AOMMIN(8, p_height - i) + 7, bd,
+                               conv_params->round_0, tmp);
+
+      for (k = -4; k < AOMMIN(4, p_height - i - 4); k += 2) {
+        __m256i res_lo, res_hi;
+        vertical_filter_2rows(tmp + (k + 4), sy4 + delta * (k + 4), gamma,
+                              delta, &res_lo, &res_hi);
+
+        res_lo = _mm256_sub_epi32(
+            _mm256_sra_epi32(_mm256_add_epi32(res_lo, round_const), shift),
+            offset);
+        res_hi = _mm256_sub_epi32(
+            _mm256_sra_epi32(_mm256_add_epi32(res_hi, round_const), shift),
+            offset);
+        // Like the C version, this always writes 8 columns
+        accumulate_rows(
+            &conv_params->dst[(i + k + 4) * conv_params->dst_stride + j],
+            conv_params->dst_stride, res_lo, res_hi, 8);
+      }
+    }
+  }
+}
+#endif  // CONFIG_CONVOLVE_ROUND
+#endif  // CONFIG_HIGHBITDEPTH
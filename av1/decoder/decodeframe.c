@@ -86,6 +86,14 @@
 #include "av1/common/cfl.h"
 #endif
 
+// Whether the superblock rows of a tile can be parsed ahead of their
+// reconstruction, possibly on other threads. The excluded tools either
+// reconstruct while parsing or predict from pixels outside the wavefront.
+#define DEC_ROW_MT                                                        \
+  (!CONFIG_PVQ && !CONFIG_CFL && !CONFIG_COEF_INTERLEAVE &&               \
+   !CONFIG_SUPERTX && !CONFIG_INTRABC &&                                  \
+   !(CONFIG_MOTION_VAR && (CONFIG_NCOBMC || CONFIG_NCOBMC_ADAPT_WEIGHT)))
+
 static struct aom_read_bit_buffer *init_read_bit_buffer(
     AV1Decoder *pbi, struct aom_read_bit_buffer *rb, const uint8_t *data,
     const uint8_t *data_end, uint8_t clear_data[MAX_AV1_HEADER_SIZE]);
@@ -685,35 +693,102 @@ static void inverse_transform_block_dpcm(MACROBLOCKD *xd, int plane,
 }
 #endif  // CONFIG_DPCM_INTRA
 
+#if !CONFIG_PVQ
+// Number of coefficients of a transform block, from the first one, which may
+// not be zero.
+static int txb_coeff_span(TX_SIZE tx_size, int16_t max_scan_line) {
+#if CONFIG_LV_MAP
+  // The coefficient reader only tracks the end of block in scan order.
+  (void)max_scan_line;
+  return tx_size_2d[tx_size];
+#else
+  (void)tx_size;
+  return max_scan_line + 1;
+#endif  // CONFIG_LV_MAP
+}
+
+// Reads the coefficients of a transform block into pd->dqcoeff. Given both a
+// reader and 'tokens', the block is only parsed and its coefficients move on
+// to 'tokens'. Without a reader, they come back from 'tokens' for the
+// reconstruction of the parsed block.
+static int read_txb_tokens(AV1_COMMON *cm, MACROBLOCKD *const xd,
+                           aom_reader *const r, DecRowTokens *const tokens,
+                           int segment_id, int plane, int block_idx, int row,
+                           int col, TX_SIZE tx_size, int16_t *max_scan_line) {
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  DecTxbInfo *txb;
+  int eob;
+
+  if (r == NULL) {
+    txb = &tokens->txb[tokens->txb_pos++];
+    eob = txb->eob;
+    *max_scan_line = txb->max_scan_line;
+    if (eob) {
+      const int n = txb_coeff_span(tx_size, *max_scan_line);
+      memcpy(pd->dqcoeff, tokens->dqcoeff + tokens->dqcoeff_pos,
+             n * sizeof(*pd->dqcoeff));
+      tokens->dqcoeff_pos += n;
+    }
+    return eob;
+  }
+
+#if CONFIG_LV_MAP
+  (void)segment_id;
+  av1_read_coeffs_txb_facade(cm, xd, r, row, col, block_idx, plane,
+                             pd->dqcoeff, tx_size, max_scan_line, &eob);
+#else
+  {
+    const TX_TYPE tx_type =
+        get_tx_type(get_plane_type(plane), xd, block_idx, tx_size);
+    const SCAN_ORDER *const scan_order =
+        get_scan(cm, tx_size, tx_type, &xd->mi[0]->mbmi);
+    eob = av1_decode_block_tokens(cm, xd, plane, scan_order, col, row, tx_size,
+                                  tx_type, max_scan_line, r, segment_id);
+  }
+#endif  // CONFIG_LV_MAP
+
+  if (tokens) {
+    txb = &tokens->txb[tokens->txb_pos++];
+    txb->eob = eob;
+    txb->max_scan_line = *max_scan_line;
+    if (eob) {
+      const int n = txb_coeff_span(tx_size, *max_scan_line);
+      memcpy(tokens->dqcoeff + tokens->dqcoeff_pos, pd->dqcoeff,
+             n * sizeof(*pd->dqcoeff));
+      memset(pd->dqcoeff, 0, n * sizeof(*pd->dqcoeff));
+      tokens->dqcoeff_pos += n;
+    }
+  }
+  return eob;
+}
+#endif  // !CONFIG_PVQ
+
+// Without a reader, reconstructs a block parsed into 'tokens'. Given both, only
+// parses it.
 static void predict_and_reconstruct_intra_block(
     AV1_COMMON *cm, MACROBLOCKD *const xd, aom_reader *const r,
-    MB_MODE_INFO *const mbmi, int plane, int row, int col, TX_SIZE tx_size) {
+    DecRowTokens *const tokens, MB_MODE_INFO *const mbmi, int plane, int row,
+    int col, TX_SIZE tx_size) {
   PLANE_TYPE plane_type = get_plane_type(plane);
   const int block_idx = get_block_idx(xd, plane, row, col);
+  const int recon = !(r && tokens);
 #if CONFIG_PVQ
   (void)r;
+  (void)tokens;
 #endif
-  av1_predict_intra_block_facade(xd, plane, block_idx, col, row, tx_size);
+  if (recon)
+    av1_predict_intra_block_facade(xd, plane, block_idx, col, row, tx_size);
 
   if (!mbmi->skip) {
 #if !CONFIG_PVQ
     struct macroblockd_plane *const pd = &xd->plane[plane];
-#if CONFIG_LV_MAP
-    int16_t max_scan_line = 0;
-    int eob;
-    av1_read_coeffs_txb_facade(cm, xd, r, row, col, block_idx, plane,
-                               pd->dqcoeff, tx_size, &max_scan_line, &eob);
-    // tx_type will be read out in av1_read_coeffs_txb_facade
-    TX_TYPE tx_type = get_tx_type(plane_type, xd, block_idx, tx_size);
-#else   // CONFIG_LV_MAP
-    TX_TYPE tx_type = get_tx_type(plane_type, xd, block_idx, tx_size);
-    const SCAN_ORDER *scan_order = get_scan(cm, tx_size, tx_type, mbmi);
     int16_t max_scan_line = 0;
     const int eob =
-        av1_decode_block_tokens(cm, xd, plane, scan_order, col, row, tx_size,
-                                tx_type, &max_scan_line, r, mbmi->segment_id);
-#endif  // CONFIG_LV_MAP
-    if (eob) {
+        read_txb_tokens(cm, xd, r, tokens, mbmi->segment_id, plane, block_idx,
+                        row, col, tx_size, &max_scan_line);
+    // tx_type will be read out in av1_read_coeffs_txb_facade
+    const TX_TYPE tx_type = get_tx_type(plane_type, xd, block_idx, tx_size);
+    if (eob && recon) {
       uint8_t *dst =
           &pd->dst.buf[(row * pd->dst.stride + col) << tx_size_wide_log2[0]];
 #if CONFIG_DPCM_INTRA
@@ -750,10 +825,11 @@ static void predict_and_reconstruct_intra_block(
 
 #if CONFIG_VAR_TX && !CONFIG_COEF_INTERLEAVE
 static void decode_reconstruct_tx(AV1_COMMON *cm, MACROBLOCKD *const xd,
-                                  aom_reader *r, MB_MODE_INFO *const mbmi,
-                                  int plane, BLOCK_SIZE plane_bsize,
-                                  int blk_row, int blk_col, int block,
-                                  TX_SIZE tx_size, int *eob_total) {
+                                  aom_reader *r, DecRowTokens *const tokens,
+                                  MB_MODE_INFO *const mbmi, int plane,
+                                  BLOCK_SIZE plane_bsize, int blk_row,
+                                  int blk_col, int block, TX_SIZE tx_size,
+                                  int *eob_total) {
   const struct macroblockd_plane *const pd = &xd->plane[plane];
   const BLOCK_SIZE bsize = txsize_to_bsize[tx_size];
   const int tx_row = blk_row >> (1 - pd->subsampling_y);
@@ -769,25 +845,17 @@ static void decode_reconstruct_tx(AV1_COMMON *cm, MACROBLOCKD *const xd,
 
   if (tx_size == plane_tx_size) {
     PLANE_TYPE plane_type = get_plane_type(plane);
-#if CONFIG_LV_MAP
     int16_t max_scan_line = 0;
-    int eob;
-    av1_read_coeffs_txb_facade(cm, xd, r, blk_row, blk_col, block, plane,
-                               pd->dqcoeff, tx_size, &max_scan_line, &eob);
+    const int eob =
+        read_txb_tokens(cm, xd, r, tokens, mbmi->segment_id, plane, block,
+                        blk_row, blk_col, plane_tx_size, &max_scan_line);
     // tx_type will be read out in av1_read_coeffs_txb_facade
-    TX_TYPE tx_type = get_tx_type(plane_type, xd, block, plane_tx_size);
-#else   // CONFIG_LV_MAP
-    TX_TYPE tx_type = get_tx_type(plane_type, xd, block, plane_tx_size);
-    const SCAN_ORDER *sc = get_scan(cm, plane_tx_size, tx_type, mbmi);
-    int16_t max_scan_line = 0;
-    const int eob = av1_decode_block_tokens(
-        cm, xd, plane, sc, blk_col, blk_row, plane_tx_size, tx_type,
-        &max_scan_line, r, mbmi->segment_id);
-#endif  // CONFIG_LV_MAP
-    inverse_transform_block(xd, plane, tx_type, plane_tx_size,
-                            &pd->dst.buf[(blk_row * pd->dst.stride + blk_col)
-                                         << tx_size_wide_log2[0]],
-                            pd->dst.stride, max_scan_line, eob);
+    const TX_TYPE tx_type = get_tx_type(plane_type, xd, block, plane_tx_size);
+    if (!(r && tokens))
+      inverse_transform_block(xd, plane, tx_type, plane_tx_size,
+                              &pd->dst.buf[(blk_row * pd->dst.stride + blk_col)
+                                           << tx_size_wide_log2[0]],
+                              pd->dst.stride, max_scan_line, eob);
     *eob_total += eob;
   } else {
     const TX_SIZE sub_txs = sub_tx_size_map[tx_size];
@@ -804,8 +872,8 @@ static void decode_reconstruct_tx(AV1_COMMON *cm, MACROBLOCKD *const xd,
 
       if (offsetr >= max_blocks_high || offsetc >= max_blocks_wide) continue;
 
-      decode_reconstruct_tx(cm, xd, r, mbmi, plane, plane_bsize, offsetr,
-                            offsetc, block, sub_txs, eob_total);
+      decode_reconstruct_tx(cm, xd, r, tokens, mbmi, plane, plane_bsize,
+                            offsetr, offsetc, block, sub_txs, eob_total);
       block += sub_step;
     }
   }
@@ -815,7 +883,8 @@ static void decode_reconstruct_tx(AV1_COMMON *cm, MACROBLOCKD *const xd,
 #if !CONFIG_VAR_TX || CONFIG_SUPERTX || CONFIG_COEF_INTERLEAVE || \
     (!CONFIG_VAR_TX && CONFIG_EXT_TX && CONFIG_RECT_TX)
 static int reconstruct_inter_block(AV1_COMMON *cm, MACROBLOCKD *const xd,
-                                   aom_reader *const r, int segment_id,
+                                   aom_reader *const r,
+                                   DecRowTokens *const tokens, int segment_id,
                                    int plane, int row, int col,
                                    TX_SIZE tx_size) {
   PLANE_TYPE plane_type = get_plane_type(plane);
@@ -823,32 +892,21 @@ static int reconstruct_inter_block(AV1_COMMON *cm, MACROBLOCKD *const xd,
 #if CONFIG_PVQ
   int eob;
   (void)r;
+  (void)tokens;
   (void)segment_id;
 #else
   struct macroblockd_plane *const pd = &xd->plane[plane];
 #endif
 
 #if !CONFIG_PVQ
-#if CONFIG_LV_MAP
-  (void)segment_id;
   int16_t max_scan_line = 0;
-  int eob;
-  av1_read_coeffs_txb_facade(cm, xd, r, row, col, block_idx, plane, pd->dqcoeff,
-                             tx_size, &max_scan_line, &eob);
+  const int eob = read_txb_tokens(cm, xd, r, tokens, segment_id, plane,
+                                  block_idx, row, col, tx_size, &max_scan_line);
   // tx_type will be read out in av1_read_coeffs_txb_facade
-  TX_TYPE tx_type = get_tx_type(plane_type, xd, block_idx, tx_size);
-#else   // CONFIG_LV_MAP
-  int16_t max_scan_line = 0;
-  TX_TYPE tx_type = get_tx_type(plane_type, xd, block_idx, tx_size);
-  const SCAN_ORDER *scan_order =
-      get_scan(cm, tx_size, tx_type, &xd->mi[0]->mbmi);
-  const int eob =
-      av1_decode_block_tokens(cm, xd, plane, scan_order, col, row, tx_size,
-                              tx_type, &max_scan_line, r, segment_id);
-#endif  // CONFIG_LV_MAP
+  const TX_TYPE tx_type = get_tx_type(plane_type, xd, block_idx, tx_size);
   uint8_t *dst =
       &pd->dst.buf[(row * pd->dst.stride + col) << tx_size_wide_log2[0]];
-  if (eob)
+  if (eob && !(r && tokens))
     inverse_transform_block(xd, plane, tx_type, tx_size, dst, pd->dst.stride,
                             max_scan_line, eob);
 #else
@@ -860,24 +918,13 @@ static int reconstruct_inter_block(AV1_COMMON *cm, MACROBLOCKD *const xd,
 }
 #endif  // !CONFIG_VAR_TX || CONFIG_SUPER_TX
 
-static void set_offsets(AV1_COMMON *const cm, MACROBLOCKD *const xd,
-                        BLOCK_SIZE bsize, int mi_row, int mi_col, int bw,
-                        int bh, int x_mis, int y_mis) {
-  const int offset = mi_row * cm->mi_stride + mi_col;
-  int x, y;
+// Sets up xd for a block whose mode info is already in the mi grid.
+static void set_block_offsets(AV1_COMMON *const cm, MACROBLOCKD *const xd,
+                              BLOCK_SIZE bsize, int mi_row, int mi_col, int bw,
+                              int bh) {
   const TileInfo *const tile = &xd->tile;
 
-  xd->mi = cm->mi_grid_visible + offset;
-  xd->mi[0] = &cm->mi[offset];
-  // TODO(slavarnway): Generate sb_type based on bwl and bhl, instead of
-  // passing bsize from decode_partition().
-  xd->mi[0]->mbmi.sb_type = bsize;
-#if CONFIG_RD_DEBUG
-  xd->mi[0]->mbmi.mi_row = mi_row;
-  xd->mi[0]->mbmi.mi_col = mi_col;
-#endif
-  for (y = 0; y < y_mis; ++y)
-    for (x = !y; x < x_mis; ++x) xd->mi[y * cm->mi_stride + x] = xd->mi[0];
+  xd->mi = cm->mi_grid_visible + mi_row * cm->mi_stride + mi_col;
 
   set_plane_n4(xd, bw, bh);
   set_skip_context(xd, mi_row, mi_col);
@@ -898,6 +945,27 @@ static void set_offsets(AV1_COMMON *const cm, MACROBLOCKD *const xd,
                        mi_col);
 }
 
+static void set_offsets(AV1_COMMON *const cm, MACROBLOCKD *const xd,
+                        BLOCK_SIZE bsize, int mi_row, int mi_col, int bw,
+                        int bh, int x_mis, int y_mis) {
+  const int offset = mi_row * cm->mi_stride + mi_col;
+  MODE_INFO **const mi = cm->mi_grid_visible + offset;
+  int x, y;
+
+  mi[0] = &cm->mi[offset];
+  // TODO(slavarnway): Generate sb_type based on bwl and bhl, instead of
+  // passing bsize from decode_partition().
+  mi[0]->mbmi.sb_type = bsize;
+#if CONFIG_RD_DEBUG
+  mi[0]->mbmi.mi_row = mi_row;
+  mi[0]->mbmi.mi_col = mi_col;
+#endif
+  for (y = 0; y < y_mis; ++y)
+    for (x = !y; x < x_mis; ++x) mi[y * cm->mi_stride + x] = mi[0];
+
+  set_block_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh);
+}
+
 #if CONFIG_SUPERTX
 static MB_MODE_INFO *set_offsets_extend(AV1_COMMON *const cm,
                                         MACROBLOCKD *const xd,
@@ -1843,21 +1911,53 @@ static void decode_mbmi_block(AV1Decoder *const pbi, MACROBLOCKD *const xd,
   aom_merge_corrupted_flag(&xd->corrupted, reader_corrupted_flag);
 }
 
+#if CONFIG_PALETTE
+// Reads the palette color indices of a block, or brings back those parsed
+// into 'tokens', as read_txb_tokens() does with the coefficients.
+static void read_palette_tokens(MACROBLOCKD *const xd, int plane,
+                                aom_reader *r, DecRowTokens *const tokens) {
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  int plane_block_width = 0, plane_block_height = 0;
+
+  if (tokens) {
+    av1_get_block_dimensions(xd->mi[0]->mbmi.sb_type, plane, xd,
+                             &plane_block_width, &plane_block_height, NULL,
+                             NULL);
+  }
+  if (r == NULL) {
+    pd->color_index_map =
+        tokens->color_index_map + tokens->color_index_map_pos;
+  } else {
+    av1_decode_palette_tokens(xd, plane, r);
+    if (tokens) {
+      memcpy(tokens->color_index_map + tokens->color_index_map_pos,
+             pd->color_index_map, plane_block_width * plane_block_height);
+    }
+  }
+  if (tokens) {
+    tokens->color_index_map_pos += plane_block_width * plane_block_height;
+  }
+}
+#endif  // CONFIG_PALETTE
+
+// Parses and reconstructs a block whose mode info has been read. With
+// 'tokens', the block is only parsed if there is a reader, and only
+// reconstructed otherwise.
 static void decode_token_and_recon_block(AV1Decoder *const pbi,
                                          MACROBLOCKD *const xd, int mi_row,
                                          int mi_col, aom_reader *r,
+                                         DecRowTokens *const tokens,
                                          BLOCK_SIZE bsize) {
   AV1_COMMON *const cm = &pbi->common;
   const int bw = mi_size_wide[bsize];
   const int bh = mi_size_high[bsize];
-  const int x_mis = AOMMIN(bw, cm->mi_cols - mi_col);
-  const int y_mis = AOMMIN(bh, cm->mi_rows - mi_row);
+  const int recon = !(r && tokens);
 
-  set_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh, x_mis, y_mis);
+  set_block_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh);
   MB_MODE_INFO *mbmi = &xd->mi[0]->mbmi;
 
 #if CONFIG_DELTA_Q
-  if (cm->delta_q_present_flag) {
+  if (r && cm->delta_q_present_flag) {
     int i;
     for (i = 0; i < MAX_SEGMENTS; i++) {
 #if CONFIG_EXT_DELTA_Q
@@ -1897,14 +1997,15 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
 #endif
 
 #if CONFIG_CB4X4
-  if (mbmi->skip) av1_reset_skip_context(xd, mi_row, mi_col, bsize);
+  if (r && mbmi->skip) av1_reset_skip_context(xd, mi_row, mi_col, bsize);
 #else
-  if (mbmi->skip) {
+  if (r && mbmi->skip) {
     av1_reset_skip_context(xd, mi_row, mi_col, AOMMAX(BLOCK_8X8, bsize));
   }
 #endif
 
 #if CONFIG_COEF_INTERLEAVE
+  (void)recon;
   {
     const struct macroblockd_plane *const pd_y = &xd->plane[0];
     const struct macroblockd_plane *const pd_c = &xd->plane[1];
@@ -1948,15 +2049,16 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
       for (row_y = 0; row_y < tu_num_h_y; row_y++) {
         for (col_y = 0; col_y < tu_num_w_y; col_y++) {
           // luma
-          predict_and_reconstruct_intra_block(
-              cm, xd, r, mbmi, 0, row_y * tx_sz_y, col_y * tx_sz_y, tx_log2_y);
+          predict_and_reconstruct_intra_block(cm, xd, r, NULL, mbmi, 0,
+                                              row_y * tx_sz_y, col_y * tx_sz_y,
+                                              tx_log2_y);
           // chroma
           if (tu_idx_c < tu_num_c) {
             row_c = (tu_idx_c / tu_num_w_c) * tx_sz_c;
             col_c = (tu_idx_c % tu_num_w_c) * tx_sz_c;
-            predict_and_reconstruct_intra_block(cm, xd, r, mbmi, 1, row_c,
+            predict_and_reconstruct_intra_block(cm, xd, r, NULL, mbmi, 1, row_c,
                                                 col_c, tx_log2_c);
-            predict_and_reconstruct_intra_block(cm, xd, r, mbmi, 2, row_c,
+            predict_and_reconstruct_intra_block(cm, xd, r, NULL, mbmi, 2, row_c,
                                                 col_c, tx_log2_c);
             tu_idx_c++;
           }
@@ -1967,10 +2069,10 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
       while (tu_idx_c < tu_num_c) {
         row_c = (tu_idx_c / tu_num_w_c) * tx_sz_c;
         col_c = (tu_idx_c % tu_num_w_c) * tx_sz_c;
-        predict_and_reconstruct_intra_block(cm, xd, r, mbmi, 1, row_c, col_c,
-                                            tx_log2_c);
-        predict_and_reconstruct_intra_block(cm, xd, r, mbmi, 2, row_c, col_c,
-                                            tx_log2_c);
+        predict_and_reconstruct_intra_block(cm, xd, r, NULL, mbmi, 1, row_c,
+                                            col_c, tx_log2_c);
+        predict_and_reconstruct_intra_block(cm, xd, r, NULL, mbmi, 2, row_c,
+                                            col_c, tx_log2_c);
         tu_idx_c++;
       }
     } else {
@@ -1987,17 +2089,19 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
         for (row_y = 0; row_y < tu_num_h_y; row_y++) {
           for (col_y = 0; col_y < tu_num_w_y; col_y++) {
             // luma
-            eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id, 0,
-                                                row_y * tx_sz_y,
-                                                col_y * tx_sz_y, tx_log2_y);
+            eobtotal += reconstruct_inter_block(
+                cm, xd, r, NULL, mbmi->segment_id, 0, row_y * tx_sz_y,
+                col_y * tx_sz_y, tx_log2_y);
             // chroma
             if (tu_idx_c < tu_num_c) {
               row_c = (tu_idx_c / tu_num_w_c) * tx_sz_c;
               col_c = (tu_idx_c % tu_num_w_c) * tx_sz_c;
-              eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id,
-                                                  1, row_c, col_c, tx_log2_c);
-              eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id,
-                                                  2, row_c, col_c, tx_log2_c);
+              eobtotal += reconstruct_inter_block(cm, xd, r, NULL,
+                                                  mbmi->segment_id, 1, row_c,
+                                                  col_c, tx_log2_c);
+              eobtotal += reconstruct_inter_block(cm, xd, r, NULL,
+                                                  mbmi->segment_id, 2, row_c,
+                                                  col_c, tx_log2_c);
               tu_idx_c++;
             }
           }
@@ -2007,10 +2111,12 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
         while (tu_idx_c < tu_num_c) {
           row_c = (tu_idx_c / tu_num_w_c) * tx_sz_c;
           col_c = (tu_idx_c % tu_num_w_c) * tx_sz_c;
-          eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id, 1,
-                                              row_c, col_c, tx_log2_c);
-          eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id, 2,
-                                              row_c, col_c, tx_log2_c);
+          eobtotal += reconstruct_inter_block(cm, xd, r, NULL,
+                                              mbmi->segment_id, 1, row_c, col_c,
+                                              tx_log2_c);
+          eobtotal += reconstruct_inter_block(cm, xd, r, NULL,
+                                              mbmi->segment_id, 2, row_c, col_c,
+                                              tx_log2_c);
           tu_idx_c++;
         }
 
@@ -2026,7 +2132,7 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
 #if CONFIG_PALETTE
     for (plane = 0; plane <= 1; ++plane) {
       if (mbmi->palette_mode_info.palette_size[plane])
-        av1_decode_palette_tokens(xd, plane, r);
+        read_palette_tokens(xd, plane, r, tokens);
     }
 #endif  // CONFIG_PALETTE
     for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
@@ -2054,8 +2160,8 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
 
       for (row = 0; row < max_blocks_high; row += stepr)
         for (col = 0; col < max_blocks_wide; col += stepc)
-          predict_and_reconstruct_intra_block(cm, xd, r, mbmi, plane, row, col,
-                                              tx_size);
+          predict_and_reconstruct_intra_block(cm, xd, r, tokens, mbmi, plane,
+                                              row, col, tx_size);
     }
   } else {
     int ref;
@@ -2088,15 +2194,17 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
       }
     }
 
+    if (recon) {
 #if CONFIG_CB4X4
-    av1_build_inter_predictors_sb(cm, xd, mi_row, mi_col, NULL, bsize);
+      av1_build_inter_predictors_sb(cm, xd, mi_row, mi_col, NULL, bsize);
 #else
-    av1_build_inter_predictors_sb(cm, xd, mi_row, mi_col, NULL,
-                                  AOMMAX(bsize, BLOCK_8X8));
+      av1_build_inter_predictors_sb(cm, xd, mi_row, mi_col, NULL,
+                                    AOMMAX(bsize, BLOCK_8X8));
 #endif
+    }
 
 #if CONFIG_MOTION_VAR
-    if (mbmi->motion_mode == OBMC_CAUSAL) {
+    if (recon && mbmi->motion_mode == OBMC_CAUSAL) {
 #if CONFIG_NCOBMC
       av1_build_ncobmc_inter_predictors_sb(cm, xd, mi_row, mi_col);
 #else
@@ -2140,8 +2248,8 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
             tx_size_wide_unit[max_tx_size] * tx_size_high_unit[max_tx_size];
         for (row = 0; row < max_blocks_high; row += bh_var_tx) {
           for (col = 0; col < max_blocks_wide; col += bw_var_tx) {
-            decode_reconstruct_tx(cm, xd, r, mbmi, plane, plane_bsize, row, col,
-                                  block, max_tx_size, &eobtotal);
+            decode_reconstruct_tx(cm, xd, r, tokens, mbmi, plane, plane_bsize,
+                                  row, col, block, max_tx_size, &eobtotal);
             block += step;
           }
         }
@@ -2151,21 +2259,29 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
         const int stepc = tx_size_wide_unit[tx_size];
         for (row = 0; row < max_blocks_high; row += stepr)
           for (col = 0; col < max_blocks_wide; col += stepc)
-            eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id,
-                                                plane, row, col, tx_size);
+            eobtotal += reconstruct_inter_block(cm, xd, r, tokens,
+                                                mbmi->segment_id, plane, row,
+                                                col, tx_size);
 #endif
       }
     }
   }
 #endif  // CONFIG_COEF_INTERLEAVE
 
-  int reader_corrupted_flag = aom_reader_has_error(r);
-  aom_merge_corrupted_flag(&xd->corrupted, reader_corrupted_flag);
+  if (r) {
+    int reader_corrupted_flag = aom_reader_has_error(r);
+    aom_merge_corrupted_flag(&xd->corrupted, reader_corrupted_flag);
+  }
 }
 
-#if (CONFIG_NCOBMC || CONFIG_NCOBMC_ADAPT_WEIGHT) && CONFIG_MOTION_VAR
+#if ((CONFIG_NCOBMC || CONFIG_NCOBMC_ADAPT_WEIGHT) && CONFIG_MOTION_VAR) || \
+    DEC_ROW_MT
+// Parses the tokens of the blocks of a superblock and reconstructs them, once
+// their mode info has been read. See decode_token_and_recon_block() for
+// 'tokens'.
 static void detoken_and_recon_sb(AV1Decoder *const pbi, MACROBLOCKD *const xd,
                                  int mi_row, int mi_col, aom_reader *r,
+                                 DecRowTokens *const tokens,
                                  BLOCK_SIZE bsize) {
   AV1_COMMON *const cm = &pbi->common;
   const int hbs = mi_size_wide[bsize] >> 1;
@@ -2190,52 +2306,67 @@ static void detoken_and_recon_sb(AV1Decoder *const pbi, MACROBLOCKD *const xd,
   if (!hbs && !unify_bsize) {
     xd->bmode_blocks_wl = 1 >> !!(partition & PARTITION_VERT);
     xd->bmode_blocks_hl = 1 >> !!(partition & PARTITION_HORZ);
-    decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, subsize);
+    decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, tokens, subsize);
   } else {
     switch (partition) {
       case PARTITION_NONE:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, bsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, tokens, bsize);
         break;
       case PARTITION_HORZ:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, tokens,
+                                     subsize);
         if (has_rows)
-          decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r,
+          decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, tokens,
                                        subsize);
         break;
       case PARTITION_VERT:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, tokens,
+                                     subsize);
         if (has_cols)
-          decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r,
+          decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, tokens,
                                        subsize);
         break;
       case PARTITION_SPLIT:
-        detoken_and_recon_sb(pbi, xd, mi_row, mi_col, r, subsize);
-        detoken_and_recon_sb(pbi, xd, mi_row, mi_col + hbs, r, subsize);
-        detoken_and_recon_sb(pbi, xd, mi_row + hbs, mi_col, r, subsize);
-        detoken_and_recon_sb(pbi, xd, mi_row + hbs, mi_col + hbs, r, subsize);
+        detoken_and_recon_sb(pbi, xd, mi_row, mi_col, r, tokens, subsize);
+        detoken_and_recon_sb(pbi, xd, mi_row, mi_col + hbs, r, tokens,
+                             subsize);
+        detoken_and_recon_sb(pbi, xd, mi_row + hbs, mi_col, r, tokens,
+                             subsize);
+        detoken_and_recon_sb(pbi, xd, mi_row + hbs, mi_col + hbs, r, tokens,
+                             subsize);
         break;
 #if CONFIG_EXT_PARTITION_TYPES
       case PARTITION_HORZ_A:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, tokens,
+                                     bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, tokens,
+                                     bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, tokens,
+                                     subsize);
         break;
       case PARTITION_HORZ_B:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, subsize);
-        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col + hbs, r,
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, tokens,
+                                     subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, tokens,
                                      bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col + hbs, r,
+                                     tokens, bsize2);
         break;
       case PARTITION_VERT_A:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, tokens,
+                                     bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, tokens,
+                                     bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, tokens,
+                                     subsize);
         break;
       case PARTITION_VERT_B:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, subsize);
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col + hbs, r,
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, tokens,
+                                     subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, tokens,
                                      bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col + hbs, r,
+                                     tokens, bsize2);
         break;
 #endif
       default: assert(0 && "Invalid partition type");
@@ -2267,7 +2398,8 @@ static void decode_block(AV1Decoder *const pbi, MACROBLOCKD *const xd,
 #if CONFIG_SUPERTX
   if (!supertx_enabled)
 #endif  // CONFIG_SUPERTX
-    decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, bsize);
+    decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, pbi->parse_tokens,
+                                 bsize);
 #endif
 }
 
@@ -2654,8 +2786,10 @@ static void decode_partition(AV1Decoder *const pbi, MACROBLOCKD *const xd,
 
         for (row = 0; row < max_blocks_high; row += stepr)
           for (col = 0; col < max_blocks_wide; col += stepc)
-            eobtotal += reconstruct_inter_block(
-                cm, xd, r, mbmi->segment_id_supertx, i, row, col, tx_size);
+            eobtotal +=
+                reconstruct_inter_block(cm, xd, r, NULL,
+                                        mbmi->segment_id_supertx, i, row, col,
+                                        tx_size);
       }
       if ((unify_bsize || !(subsize < BLOCK_8X8)) && eobtotal == 0) skip = 1;
     }
@@ -3722,6 +3856,196 @@ static void daala_dec_init(AV1_COMMON *const cm, daala_dec_ctx *daala_dec,
 }
 #endif  // #if CONFIG_PVQ
 
+// Returns 1 if decode_tiles() leaves deblocking to the post filter pipeline.
+// Frame parallel decoding keeps the whole frame loop filter, as it signals
+// the frame as decoded once deblocking is done.
+static int deblock_in_post_filter(const AV1_COMMON *const cm) {
+#if CONFIG_VAR_TX || CONFIG_CB4X4
+  return !cm->frame_parallel_decode;
+#else
+  (void)cm;
+  return 0;
+#endif  // CONFIG_VAR_TX || CONFIG_CB4X4
+}
+
+// Creates the tile workers on first use. They decode tiles in
+// decode_tiles_mt(), reconstruct superblock rows in decode_tile_row_mt() and
+// run the post filters in av1_decode_frame().
+static void create_tile_workers(AV1Decoder *pbi) {
+  AV1_COMMON *const cm = &pbi->common;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  int i;
+
+  // TODO(jzern): See if we can remove the restriction of passing in max
+  // threads to the decoder.
+  if (pbi->num_tile_workers == 0) {
+    const int num_threads = pbi->max_threads & ~1;
+    CHECK_MEM_ERROR(cm, pbi->tile_workers,
+                    aom_malloc(num_threads * sizeof(*pbi->tile_workers)));
+    // Ensure tile data offsets will be properly aligned. This may fail on
+    // platforms without DECLARE_ALIGNED().
+    assert((sizeof(*pbi->tile_worker_data) % 16) == 0);
+    CHECK_MEM_ERROR(
+        cm, pbi->tile_worker_data,
+        aom_memalign(32, num_threads * sizeof(*pbi->tile_worker_data)));
+    CHECK_MEM_ERROR(cm, pbi->tile_worker_info,
+                    aom_malloc(num_threads * sizeof(*pbi->tile_worker_info)));
+    if (!aom_job_queue_alloc(&pbi->tile_queue, num_threads))
+      aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                         "Failed to allocate tile job queue");
+    for (i = 0; i < num_threads; ++i) {
+      AVxWorker *const worker = &pbi->tile_workers[i];
+      ++pbi->num_tile_workers;
+
+      winterface->init(worker);
+      if (i < num_threads - 1 && !winterface->reset(worker)) {
+        aom_internal_error(&cm->error, AOM_CODEC_ERROR,
+                           "Tile decoder thread creation failed");
+      }
+    }
+  }
+}
+
+#if DEC_ROW_MT
+// Reconstructs superblock row 'sb_row' of a tile from the tokens parsed into
+// its buffer. Returns 0 if the decoding was aborted.
+static int recon_sb_row(AV1Decoder *pbi, MACROBLOCKD *const xd,
+                        const TileInfo *const tile, int sb_row) {
+  AV1_COMMON *const cm = &pbi->common;
+  AV1DecRowMTSync *const row_mt_sync = &pbi->row_mt_sync;
+  const int mi_row = tile->mi_row_start + (sb_row << cm->mib_size_log2);
+  const DecRowTokens *const buf =
+      av1_dec_row_mt_begin_recon(row_mt_sync, sb_row);
+  DecRowTokens tokens;
+  int mi_col, sb_col;
+
+  if (buf == NULL) return 0;
+  tokens = *buf;
+  tokens.dqcoeff_pos = tokens.txb_pos = tokens.color_index_map_pos = 0;
+
+  for (mi_col = tile->mi_col_start, sb_col = 0; mi_col < tile->mi_col_end;
+       mi_col += cm->mib_size, ++sb_col) {
+    if (!av1_dec_row_mt_sync_read(row_mt_sync, sb_row, sb_col)) return 0;
+    detoken_and_recon_sb(pbi, xd, mi_row, mi_col, NULL, &tokens, cm->sb_size);
+    av1_dec_row_mt_sync_write(row_mt_sync, sb_row, sb_col);
+  }
+  return 1;
+}
+
+// Reconstructs the superblock rows of a tile handed out by the row based
+// multi-threading sync, as the main thread parses them.
+static int row_mt_worker_hook(TileWorkerData *const tile_data,
+                              TileInfo *const tile) {
+  AV1Decoder *const pbi = tile_data->pbi;
+  AV1_COMMON *const cm = &pbi->common;
+  AV1DecRowMTSync *const row_mt_sync = &pbi->row_mt_sync;
+  MACROBLOCKD *const xd = &tile_data->xd;
+  int sb_row;
+
+  if (setjmp(tile_data->error_info.jmp)) {
+    tile_data->error_info.setjmp = 0;
+    av1_dec_row_mt_abort(row_mt_sync);
+    return 0;
+  }
+
+  tile_data->error_info.setjmp = 1;
+
+  *xd = pbi->mb;
+  xd->corrupted = 0;
+  xd->counts = NULL;
+  xd->error_info = &tile_data->error_info;
+  xd->tile = *tile;
+  av1_zero(tile_data->dqcoeff);
+  av1_init_macroblockd(cm, xd, tile_data->dqcoeff);
+
+  while ((sb_row = av1_dec_row_mt_next_row(row_mt_sync)) >= 0) {
+    if (!recon_sb_row(pbi, xd, tile, sb_row)) break;
+  }
+
+  tile_data->error_info.setjmp = 0;
+  return 1;
+}
+
+// Decodes a tile in two stages: this thread parses the superblock rows into
+// the token buffers of pbi->row_mt_sync, and the tile workers reconstruct
+// them, this thread joining in once it is done parsing. Without tile workers,
+// this thread reconstructs each row after parsing the row below it.
+static void decode_tile_row_mt(AV1Decoder *pbi, TileData *const td,
+                               const TileInfo *const tile) {
+  AV1_COMMON *const cm = &pbi->common;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  AV1DecRowMTSync *const row_mt_sync = &pbi->row_mt_sync;
+  // Without threads, the workers would run before the rows are parsed.
+  const int num_workers = CONFIG_MULTITHREAD ? pbi->num_tile_workers : 0;
+  const int sb_rows = (tile->mi_row_end - tile->mi_row_start +
+                       cm->mib_size - 1) >> cm->mib_size_log2;
+  const int sb_cols = (tile->mi_col_end - tile->mi_col_start +
+                       cm->mib_size - 1) >> cm->mib_size_log2;
+  int sb_row, i;
+
+  av1_dec_row_mt_reset(row_mt_sync, sb_rows, sb_cols);
+
+  for (i = 0; i < num_workers; ++i) {
+    AVxWorker *const worker = &pbi->tile_workers[i];
+    TileWorkerData *const twd = &pbi->tile_worker_data[i];
+
+    winterface->sync(worker);
+    worker->hook = (AVxWorkerHook)row_mt_worker_hook;
+    worker->data1 = twd;
+    worker->data2 = &pbi->tile_worker_info[i];
+    worker->had_error = 0;
+    twd->pbi = pbi;
+    pbi->tile_worker_info[i] = *tile;
+    if (i < num_workers - 1) winterface->launch(worker);
+  }
+
+  for (sb_row = 0; sb_row < sb_rows; ++sb_row) {
+    const int mi_row = tile->mi_row_start + (sb_row << cm->mib_size_log2);
+    DecRowTokens *const buf = av1_dec_row_mt_begin_parse(row_mt_sync, sb_row);
+    DecRowTokens tokens;
+    int mi_col;
+
+    // A worker failed.
+    if (buf == NULL) break;
+    tokens = *buf;
+    tokens.dqcoeff_pos = tokens.txb_pos = tokens.color_index_map_pos = 0;
+    pbi->parse_tokens = &tokens;
+
+    av1_zero_left_context(&td->xd);
+
+    for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
+         mi_col += cm->mib_size) {
+      av1_update_boundary_info(cm, tile, mi_row, mi_col);
+      decode_partition(pbi, &td->xd, mi_row, mi_col, &td->bit_reader,
+                       cm->sb_size, b_width_log2_lookup[cm->sb_size]);
+    }
+    pbi->parse_tokens = NULL;
+    av1_dec_row_mt_parsed(row_mt_sync, sb_row);
+
+    aom_merge_corrupted_flag(&pbi->mb.corrupted, td->xd.corrupted);
+    if (pbi->mb.corrupted) {
+      av1_dec_row_mt_abort(row_mt_sync);
+      break;
+    }
+    // The reconstruction leaves no state in td->xd that the parsing of the
+    // next row depends on.
+    if (num_workers == 0 && sb_row > 0)
+      recon_sb_row(pbi, &td->xd, tile, sb_row - 1);
+  }
+
+  if (num_workers > 0)
+    winterface->execute(&pbi->tile_workers[num_workers - 1]);
+  else if (!pbi->mb.corrupted)
+    recon_sb_row(pbi, &td->xd, tile, sb_rows - 1);
+  for (i = num_workers; i > 0; --i) {
+    pbi->mb.corrupted |= !winterface->sync(&pbi->tile_workers[i - 1]);
+  }
+  if (pbi->mb.corrupted)
+    aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
+                       "Failed to decode tile data");
+}
+#endif  // DEC_ROW_MT
+
 static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
                                    const uint8_t *data_end) {
   AV1_COMMON *const cm = &pbi->common;
@@ -3749,8 +4073,24 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
   const int inv_col_order = pbi->inv_tile_order;
   const int inv_row_order = pbi->inv_tile_order;
 #endif  // CONFIG_EXT_TILE
+#if DEC_ROW_MT
+  // Frame parallel decoding signals the progress of the frame by tile row.
+  const int row_mt = pbi->row_mt && !cm->frame_parallel_decode;
+#endif  // DEC_ROW_MT
   int tile_row, tile_col;
 
+  pbi->parse_tokens = NULL;
+#if DEC_ROW_MT
+  if (row_mt) {
+    if (pbi->max_threads > 1) create_tile_workers(pbi);
+    // Room for a row being parsed, the one parsed ahead of it and one per
+    // worker reconstructing.
+    av1_dec_row_mt_alloc(
+        &pbi->row_mt_sync, cm, pbi->num_tile_workers + 2,
+        (cm->mi_cols + cm->mib_size - 1) >> cm->mib_size_log2);
+  }
+#endif  // DEC_ROW_MT
+
   if (cm->lf.filter_level && !cm->skip_loop_filter &&
       pbi->lf_worker.data1 == NULL) {
     CHECK_MEM_ERROR(cm, pbi->lf_worker.data1,
@@ -3878,6 +4218,14 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
       av1_zero_above_context(cm, tile_info.mi_col_start, tile_info.mi_col_end);
 #endif
 
+#if DEC_ROW_MT
+      if (row_mt) {
+        decode_tile_row_mt(pbi, td, &tile_info);
+        mi_row = tile_info.mi_row_end;
+        continue;
+      }
+#endif  // DEC_ROW_MT
+
       for (mi_row = tile_info.mi_row_start; mi_row < tile_info.mi_row_end;
            mi_row += cm->mib_size) {
         int mi_col;
@@ -3895,7 +4243,7 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
                            b_width_log2_lookup[cm->sb_size]);
 #if (CONFIG_NCOBMC || CONFIG_NCOBMC_ADAPT_WEIGHT) && CONFIG_MOTION_VAR
           detoken_and_recon_sb(pbi, &td->xd, mi_row, mi_col, &td->bit_reader,
-                               cm->sb_size);
+                               NULL, cm->sb_size);
 #endif
         }
         aom_merge_corrupted_flag(&pbi->mb.corrupted, td->xd.corrupted);
@@ -3944,9 +4292,11 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
   }
 
 #if CONFIG_VAR_TX || CONFIG_CB4X4
-  // Loopfilter the whole frame.
-  av1_loop_filter_frame(get_frame_new_buffer(cm), cm, &pbi->mb,
-                        cm->lf.filter_level, 0, 0);
+  // Loopfilter the whole frame, unless av1_decode_frame() pipelines it with
+  // the other post filters.
+  if (!deblock_in_post_filter(cm))
+    av1_loop_filter_frame(get_frame_new_buffer(cm), cm, &pbi->mb,
+                          cm->lf.filter_level, 0, 0);
 #else
 #if CONFIG_PARALLEL_DEBLOCKING
   // Loopfilter all rows in the frame in the frame.
@@ -3996,10 +4346,11 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
 #endif  // CONFIG_EXT_TILE
 }
 
-static int tile_worker_hook(TileWorkerData *const tile_data,
-                            const TileInfo *const tile) {
+static int tile_worker_decode(TileWorkerData *const tile_data,
+                              TileInfo *const tile,
+                              const TileBufferDec *const buf) {
   AV1Decoder *const pbi = tile_data->pbi;
-  const AV1_COMMON *const cm = &pbi->common;
+  AV1_COMMON *const cm = &pbi->common;
   int mi_row, mi_col;
 
   if (setjmp(tile_data->error_info.jmp)) {
@@ -4009,7 +4360,45 @@ static int tile_worker_hook(TileWorkerData *const tile_data,
   }
 
   tile_data->error_info.setjmp = 1;
+
+  tile_data->xd = pbi->mb;
+  tile_data->xd.corrupted = 0;
+  tile_data->xd.counts =
+      cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD
+          ? &tile_data->counts
+          : NULL;
   tile_data->xd.error_info = &tile_data->error_info;
+  av1_zero(tile_data->dqcoeff);
+  av1_tile_init(tile, cm, tile_data->tile_row, buf->col);
+  av1_tile_init(&tile_data->xd.tile, cm, tile_data->tile_row, buf->col);
+  setup_bool_decoder(buf->data, tile_data->data_end, buf->size,
+                     &tile_data->error_info, &tile_data->bit_reader,
+#if CONFIG_ANS && ANS_MAX_SYMBOLS
+                     1 << cm->ans_window_size_log2,
+#endif  // CONFIG_ANS && ANS_MAX_SYMBOLS
+                     pbi->decrypt_cb, pbi->decrypt_state);
+  av1_init_macroblockd(cm, &tile_data->xd,
+#if CONFIG_PVQ
+                       tile_data->pvq_ref_coeff,
+#endif
+#if CONFIG_CFL
+                       &tile_data->cfl,
+#endif
+                       tile_data->dqcoeff);
+#if CONFIG_PVQ
+  daala_dec_init(cm, &tile_data->xd.daala_dec, &tile_data->bit_reader);
+  tile_data->xd.daala_dec.state.adapt = &tile_data->tctx.pvq_context;
+#endif
+#if CONFIG_EC_ADAPT
+  // Initialise the tile context from the frame context
+  tile_data->tctx = *cm->fc;
+  tile_data->xd.tile_ctx = &tile_data->tctx;
+#endif
+#if CONFIG_PALETTE
+  tile_data->xd.plane[0].color_index_map = tile_data->color_index_map[0];
+  tile_data->xd.plane[1].color_index_map = tile_data->color_index_map[1];
+#endif  // CONFIG_PALETTE
+
 #if CONFIG_DEPENDENT_HORZTILES
 #if CONFIG_TILE_GROUPS
   if (!cm->dependent_horz_tiles || tile->tg_horz_boundary) {
@@ -4036,13 +4425,35 @@ static int tile_worker_hook(TileWorkerData *const tile_data,
                        b_width_log2_lookup[cm->sb_size]);
 #if (CONFIG_NCOBMC || CONFIG_NCOBMC_ADAPT_WEIGHT) && CONFIG_MOTION_VAR
       detoken_and_recon_sb(pbi, &tile_data->xd, mi_row, mi_col,
-                           &tile_data->bit_reader, cm->sb_size);
+                           &tile_data->bit_reader, NULL, cm->sb_size);
 #endif
     }
   }
   return !tile_data->xd.corrupted;
 }
 
+// Decodes the tiles of the current tile row handed out by the tile job queue.
+static int tile_worker_hook(TileWorkerData *const tile_data,
+                            TileInfo *const tile) {
+  AV1Decoder *const pbi = tile_data->pbi;
+  const TileBufferDec *const tile_buffers =
+      &pbi->tile_buffers[tile_data->tile_row][tile_data->tile_col_start];
+  int job;
+  int ok = 1;
+
+  while (aom_job_queue_pop(&pbi->tile_queue, tile_data->worker_id, &job)) {
+    const TileBufferDec *const buf = &tile_buffers[job];
+    ok &= tile_worker_decode(tile_data, tile, buf);
+#if !(CONFIG_ANS || CONFIG_EXT_TILE)
+    if (tile_data->tile_row == pbi->common.tile_rows - 1 &&
+        buf->col == pbi->common.tile_cols - 1) {
+      tile_data->tile_data_end = aom_reader_find_end(&tile_data->bit_reader);
+    }
+#endif  // !(CONFIG_ANS || CONFIG_EXT_TILE)
+  }
+  return ok;
+}
+
 // sorts in descending order
 static int compare_tile_buffers(const void *a, const void *b) {
   const TileBufferDec *const buf1 = (const TileBufferDec *)a;
@@ -4073,51 +4484,30 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
   const int tile_cols_start = 0;
   const int tile_cols_end = tile_cols;
 #endif  // CONFIG_EXT_TILE
-  int tile_row, tile_col;
+  int tile_row;
   int i;
 
-#if !(CONFIG_ANS || CONFIG_EXT_TILE)
-  int final_worker = -1;
-#endif  // !(CONFIG_ANS || CONFIG_EXT_TILE)
-
   assert(tile_rows <= MAX_TILE_ROWS);
   assert(tile_cols <= MAX_TILE_COLS);
 
   assert(tile_cols * tile_rows > 1);
 
-  // TODO(jzern): See if we can remove the restriction of passing in max
-  // threads to the decoder.
-  if (pbi->num_tile_workers == 0) {
-    const int num_threads = pbi->max_threads & ~1;
-    CHECK_MEM_ERROR(cm, pbi->tile_workers,
-                    aom_malloc(num_threads * sizeof(*pbi->tile_workers)));
-    // Ensure tile data offsets will be properly aligned. This may fail on
-    // platforms without DECLARE_ALIGNED().
-    assert((sizeof(*pbi->tile_worker_data) % 16) == 0);
-    CHECK_MEM_ERROR(
-        cm, pbi->tile_worker_data,
-        aom_memalign(32, num_threads * sizeof(*pbi->tile_worker_data)));
-    CHECK_MEM_ERROR(cm, pbi->tile_worker_info,
-                    aom_malloc(num_threads * sizeof(*pbi->tile_worker_info)));
-    for (i = 0; i < num_threads; ++i) {
-      AVxWorker *const worker = &pbi->tile_workers[i];
-      ++pbi->num_tile_workers;
-
-      winterface->init(worker);
-      if (i < num_threads - 1 && !winterface->reset(worker)) {
-        aom_internal_error(&cm->error, AOM_CODEC_ERROR,
-                           "Tile decoder thread creation failed");
-      }
-    }
-  }
+  create_tile_workers(pbi);
 
   // Reset tile decoding hook
   for (i = 0; i < num_workers; ++i) {
     AVxWorker *const worker = &pbi->tile_workers[i];
+    TileWorkerData *const twd = &pbi->tile_worker_data[i];
     winterface->sync(worker);
     worker->hook = (AVxWorkerHook)tile_worker_hook;
-    worker->data1 = &pbi->tile_worker_data[i];
+    worker->data1 = twd;
     worker->data2 = &pbi->tile_worker_info[i];
+
+    twd->pbi = pbi;
+    twd->worker_id = i;
+    twd->tile_col_start = tile_cols_start;
+    twd->data_end = data_end;
+    twd->tile_data_end = NULL;
   }
 
   // Initialize thread frame counts.
@@ -4133,98 +4523,37 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
 
   for (tile_row = tile_rows_start; tile_row < tile_rows_end; ++tile_row) {
     // Sort the buffers in this tile row based on size in descending order.
+    // The job queue hands the largest, and presumably the most difficult,
+    // tiles out first and lets idle workers steal what is left.
     qsort(&tile_buffers[tile_row][tile_cols_start],
           tile_cols_end - tile_cols_start, sizeof(tile_buffers[0][0]),
           compare_tile_buffers);
 
-    // Rearrange the tile buffers in this tile row such that per-tile group
-    // the largest, and presumably the most difficult tile will be decoded in
-    // the main thread. This should help minimize the number of instances
-    // where the main thread is waiting for a worker to complete.
-    {
-      int group_start;
-      for (group_start = tile_cols_start; group_start < tile_cols_end;
-           group_start += num_workers) {
-        const int group_end = AOMMIN(group_start + num_workers, tile_cols);
-        const TileBufferDec largest = tile_buffers[tile_row][group_start];
-        memmove(&tile_buffers[tile_row][group_start],
-                &tile_buffers[tile_row][group_start + 1],
-                (group_end - group_start - 1) * sizeof(tile_buffers[0][0]));
-        tile_buffers[tile_row][group_end - 1] = largest;
-      }
-    }
-
-    for (tile_col = tile_cols_start; tile_col < tile_cols_end;) {
-      // Launch workers for individual columns
-      for (i = 0; i < num_workers && tile_col < tile_cols_end;
-           ++i, ++tile_col) {
-        TileBufferDec *const buf = &tile_buffers[tile_row][tile_col];
-        AVxWorker *const worker = &pbi->tile_workers[i];
-        TileWorkerData *const twd = (TileWorkerData *)worker->data1;
-        TileInfo *const tile_info = (TileInfo *)worker->data2;
-
-        twd->pbi = pbi;
-        twd->xd = pbi->mb;
-        twd->xd.corrupted = 0;
-        twd->xd.counts =
-            cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD
-                ? &twd->counts
-                : NULL;
-        av1_zero(twd->dqcoeff);
-        av1_tile_init(tile_info, cm, tile_row, buf->col);
-        av1_tile_init(&twd->xd.tile, cm, tile_row, buf->col);
-        setup_bool_decoder(buf->data, data_end, buf->size, &cm->error,
-                           &twd->bit_reader,
-#if CONFIG_ANS && ANS_MAX_SYMBOLS
-                           1 << cm->ans_window_size_log2,
-#endif  // CONFIG_ANS && ANS_MAX_SYMBOLS
-                           pbi->decrypt_cb, pbi->decrypt_state);
-        av1_init_macroblockd(cm, &twd->xd,
-#if CONFIG_PVQ
-                             twd->pvq_ref_coeff,
-#endif
-#if CONFIG_CFL
-                             &twd->cfl,
-#endif
-                             twd->dqcoeff);
-#if CONFIG_PVQ
-        daala_dec_init(cm, &twd->xd.daala_dec, &twd->bit_reader);
-        twd->xd.daala_dec.state.adapt = &twd->tctx.pvq_context;
-#endif
-#if CONFIG_EC_ADAPT
-        // Initialise the tile context from the frame context
-        twd->tctx = *cm->fc;
-        twd->xd.tile_ctx = &twd->tctx;
-#endif
-#if CONFIG_PALETTE
-        twd->xd.plane[0].color_index_map = twd->color_index_map[0];
-        twd->xd.plane[1].color_index_map = twd->color_index_map[1];
-#endif  // CONFIG_PALETTE
-
-        worker->had_error = 0;
-        if (i == num_workers - 1 || tile_col == tile_cols_end - 1) {
-          winterface->execute(worker);
-        } else {
-          winterface->launch(worker);
-        }
+    aom_job_queue_reset(&pbi->tile_queue, num_workers,
+                        tile_cols_end - tile_cols_start);
+    for (i = 0; i < num_workers; ++i) {
+      AVxWorker *const worker = &pbi->tile_workers[i];
+      TileWorkerData *const twd = (TileWorkerData *)worker->data1;
 
-#if !(CONFIG_ANS || CONFIG_EXT_TILE)
-        if (tile_row == tile_rows - 1 && buf->col == tile_cols - 1) {
-          final_worker = i;
-        }
-#endif  // !(CONFIG_ANS || CONFIG_EXT_TILE)
+      twd->tile_row = tile_row;
+      worker->had_error = 0;
+      if (i == num_workers - 1) {
+        winterface->execute(worker);
+      } else {
+        winterface->launch(worker);
       }
+    }
 
-      // Sync all workers
-      for (; i > 0; --i) {
-        AVxWorker *const worker = &pbi->tile_workers[i - 1];
-        // TODO(jzern): The tile may have specific error data associated with
-        // its aom_internal_error_info which could be propagated to the main
-        // info in cm. Additionally once the threads have been synced and an
-        // error is detected, there's no point in continuing to decode tiles.
-        pbi->mb.corrupted |= !winterface->sync(worker);
-      }
+    // Sync all workers
+    for (i = num_workers; i > 0; --i) {
+      AVxWorker *const worker = &pbi->tile_workers[i - 1];
+      // TODO(jzern): The tile may have specific error data associated with
+      // its aom_internal_error_info which could be propagated to the main
+      // info in cm. Additionally once the threads have been synced and an
+      // error is detected, there's no point in continuing to decode tiles.
+      pbi->mb.corrupted |= !winterface->sync(worker);
     }
+    aom_job_queue_finish(&pbi->tile_queue);
   }
 
   // Accumulate thread frame counts.
@@ -4242,11 +4571,15 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
 #if CONFIG_ANS
   return data_end;
 #else
-  assert(final_worker != -1);
   {
-    TileWorkerData *const twd =
-        (TileWorkerData *)pbi->tile_workers[final_worker].data1;
-    return aom_reader_find_end(&twd->bit_reader);
+    // Only the worker that decoded the last tile of the frame has its end set.
+    const uint8_t *end = NULL;
+    for (i = 0; i < num_workers; ++i) {
+      const TileWorkerData *const twd = &pbi->tile_worker_data[i];
+      if (twd->tile_data_end != NULL) end = twd->tile_data_end;
+    }
+    assert(end != NULL || pbi->mb.corrupted);
+    return end != NULL ? end : data_end;
   }
 #endif  // CONFIG_ANS
 #endif  // CONFIG_EXT_TILE
@@ -5332,6 +5665,81 @@ static void make_update_tile_list_dec(AV1Decoder *pbi, int tile_rows,
 }
 #endif
 
+// Signals the frame parallel decoder that the frame context the next frame
+// starts from is ready, as done after the frame header when the context is
+// not adapted.
+static void signal_frame_context_ready(AV1Decoder *pbi) {
+  AVxWorker *const worker = pbi->frame_worker_owner;
+  FrameWorkerData *const frame_worker_data = worker->data1;
+  av1_frameworker_lock_stats(worker);
+  frame_worker_data->frame_context_ready = 1;
+  // Signal the main thread that context is ready.
+  av1_frameworker_signal_stats(worker);
+  av1_frameworker_unlock_stats(worker);
+}
+
+// Adapts the frame context to the symbol counts of the frame, then stores it
+// for the frames that follow unless 'context_updated' says it is already
+// stored. This only reads the counts and the tile contexts, so it can run
+// alongside the post filters.
+static void adapt_frame_context(AV1Decoder *pbi, int context_updated) {
+  AV1_COMMON *const cm = &pbi->common;
+
+  if (cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD) {
+#if CONFIG_EC_ADAPT
+    FRAME_CONTEXT **tile_ctxs = aom_malloc(cm->tile_rows * cm->tile_cols *
+                                           sizeof(&pbi->tile_data[0].tctx));
+    aom_cdf_prob **cdf_ptrs =
+        aom_malloc(cm->tile_rows * cm->tile_cols *
+                   sizeof(&pbi->tile_data[0].tctx.partition_cdf[0][0]));
+    make_update_tile_list_dec(pbi, cm->tile_rows, cm->tile_cols, tile_ctxs);
+#endif
+    av1_adapt_coef_probs(cm);
+    av1_adapt_intra_frame_probs(cm);
+#if CONFIG_EC_ADAPT
+    av1_average_tile_coef_cdfs(cm->fc, tile_ctxs, cdf_ptrs,
+                               cm->tile_rows * cm->tile_cols);
+    av1_average_tile_intra_cdfs(cm->fc, tile_ctxs, cdf_ptrs,
+                                cm->tile_rows * cm->tile_cols);
+#if CONFIG_PVQ
+    av1_average_tile_pvq_cdfs(cm->fc, tile_ctxs, cm->tile_rows * cm->tile_cols);
+#endif  // CONFIG_PVQ
+#endif  // CONFIG_EC_ADAPT
+#if CONFIG_ADAPT_SCAN
+    av1_adapt_scan_order(cm);
+#endif  // CONFIG_ADAPT_SCAN
+
+    if (!frame_is_intra_only(cm)) {
+      av1_adapt_inter_frame_probs(cm);
+      av1_adapt_mv_probs(cm, cm->allow_high_precision_mv);
+#if CONFIG_EC_ADAPT
+      av1_average_tile_inter_cdfs(cm, cm->fc, tile_ctxs, cdf_ptrs,
+                                  cm->tile_rows * cm->tile_cols);
+      av1_average_tile_mv_cdfs(cm->fc, tile_ctxs, cdf_ptrs,
+                               cm->tile_rows * cm->tile_cols);
+#endif
+    }
+#if CONFIG_EC_ADAPT
+    aom_free(tile_ctxs);
+    aom_free(cdf_ptrs);
+#endif
+  } else {
+    debug_check_frame_counts(cm);
+  }
+
+  if (!cm->error_resilient_mode && !context_updated)
+    cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
+  if (cm->frame_parallel_decode &&
+      cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD)
+    signal_frame_context_ready(pbi);
+}
+
+static int adapt_frame_context_worker(AV1Decoder *pbi,
+                                      const int *context_updated) {
+  adapt_frame_context(pbi, *context_updated);
+  return 1;
+}
+
 #if CONFIG_FRAME_SUPERRES
 void superres_post_decode(AV1Decoder *pbi) {
   AV1_COMMON *const cm = &pbi->common;
@@ -5350,10 +5758,21 @@ void av1_decode_frame(AV1Decoder *pbi, const uint8_t *data,
   AV1_COMMON *const cm = &pbi->common;
   MACROBLOCKD *const xd = &pbi->mb;
   struct aom_read_bit_buffer rb;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  AVxWorker *adapt_worker = NULL;
   int context_updated = 0;
   uint8_t clear_data[MAX_AV1_HEADER_SIZE];
   size_t first_partition_size;
   YV12_BUFFER_CONFIG *new_fb;
+  int deblock = 0;
+  int cdef = 0;
+  int restoration = 0;
+#if CONFIG_LOOP_RESTORATION
+  int restoration_mt = 0;
+#if CONFIG_FRAME_SUPERRES
+  int superres_restoration;
+#endif  // CONFIG_FRAME_SUPERRES
+#endif  // CONFIG_LOOP_RESTORATION
 #if CONFIG_EXT_REFS || CONFIG_TEMPMV_SIGNALING
   RefBuffer *last_fb_ref_buf = &cm->frame_refs[LAST_FRAME - LAST_FRAME];
 #endif  // CONFIG_EXT_REFS || CONFIG_TEMPMV_SIGNALING
@@ -5521,81 +5940,78 @@ void av1_decode_frame(AV1Decoder *pbi, const uint8_t *data,
     }
   } else {
     *p_data_end = decode_tiles(pbi, data + first_partition_size, data_end);
+    deblock = deblock_in_post_filter(cm) && cm->lf.filter_level;
   }
 
 #if CONFIG_CDEF
-  if (!cm->skip_loop_filter) {
-    av1_cdef_frame(&pbi->cur_buf->buf, cm, &pbi->mb);
-  }
+  cdef = !cm->skip_loop_filter;
 #endif  // CONFIG_CDEF
-
+#if CONFIG_LOOP_RESTORATION
+  restoration = cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+                cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+                cm->rst_info[2].frame_restoration_type != RESTORE_NONE;
 #if CONFIG_FRAME_SUPERRES
-  superres_post_decode(pbi);
+  // Loop restoration runs on the upscaled frame.
+  superres_restoration = restoration && !av1_superres_unscaled(cm);
+  if (superres_restoration) restoration = 0;
 #endif  // CONFIG_FRAME_SUPERRES
-
+#endif  // CONFIG_LOOP_RESTORATION
+  // Deblocking, CDEF and loop restoration run pipelined a superblock row at
+  // a time, sharing the tile workers.
+  if (pbi->max_threads > 1) create_tile_workers(pbi);
 #if CONFIG_LOOP_RESTORATION
-  if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
-      cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
-      cm->rst_info[2].frame_restoration_type != RESTORE_NONE) {
-    av1_loop_restoration_frame(new_fb, cm, cm->rst_info, 7, 0, NULL);
+  // With several workers loop restoration, the most expensive filter, is
+  // split over them by restoration tile once the other filters are done.
+  if (restoration && pbi->num_tile_workers > 1) {
+    restoration = 0;
+    restoration_mt = 1;
   }
 #endif  // CONFIG_LOOP_RESTORATION
-
+  // The backward adaptation of the frame context only depends on the symbol
+  // counts, so it takes the first worker while the others run the post
+  // filters. Without a spare worker it runs first, which makes the context
+  // of the next frame available to the frame parallel decoder sooner.
   if (!xd->corrupted) {
-    if (cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD) {
-#if CONFIG_EC_ADAPT
-      FRAME_CONTEXT **tile_ctxs = aom_malloc(cm->tile_rows * cm->tile_cols *
-                                             sizeof(&pbi->tile_data[0].tctx));
-      aom_cdf_prob **cdf_ptrs =
-          aom_malloc(cm->tile_rows * cm->tile_cols *
-                     sizeof(&pbi->tile_data[0].tctx.partition_cdf[0][0]));
-      make_update_tile_list_dec(pbi, cm->tile_rows, cm->tile_cols, tile_ctxs);
-#endif
-      av1_adapt_coef_probs(cm);
-      av1_adapt_intra_frame_probs(cm);
-#if CONFIG_EC_ADAPT
-      av1_average_tile_coef_cdfs(pbi->common.fc, tile_ctxs, cdf_ptrs,
-                                 cm->tile_rows * cm->tile_cols);
-      av1_average_tile_intra_cdfs(pbi->common.fc, tile_ctxs, cdf_ptrs,
-                                  cm->tile_rows * cm->tile_cols);
-#if CONFIG_PVQ
-      av1_average_tile_pvq_cdfs(pbi->common.fc, tile_ctxs,
-                                cm->tile_rows * cm->tile_cols);
-#endif  // CONFIG_PVQ
-#endif  // CONFIG_EC_ADAPT
-#if CONFIG_ADAPT_SCAN
-      av1_adapt_scan_order(cm);
-#endif  // CONFIG_ADAPT_SCAN
-
-      if (!frame_is_intra_only(cm)) {
-        av1_adapt_inter_frame_probs(cm);
-        av1_adapt_mv_probs(cm, cm->allow_high_precision_mv);
-#if CONFIG_EC_ADAPT
-        av1_average_tile_inter_cdfs(&pbi->common, pbi->common.fc, tile_ctxs,
-                                    cdf_ptrs, cm->tile_rows * cm->tile_cols);
-        av1_average_tile_mv_cdfs(pbi->common.fc, tile_ctxs, cdf_ptrs,
-                                 cm->tile_rows * cm->tile_cols);
-#endif
-      }
-#if CONFIG_EC_ADAPT
-      aom_free(tile_ctxs);
-      aom_free(cdf_ptrs);
-#endif
+    if (pbi->num_tile_workers > 1) {
+      adapt_worker = &pbi->tile_workers[0];
+      adapt_worker->hook = (AVxWorkerHook)adapt_frame_context_worker;
+      adapt_worker->data1 = pbi;
+      adapt_worker->data2 = &context_updated;
+      winterface->launch(adapt_worker);
     } else {
-      debug_check_frame_counts(cm);
+      adapt_frame_context(pbi, context_updated);
     }
-  } else {
+  }
+  av1_post_filter_frame(&pbi->cur_buf->buf, cm, &pbi->mb, deblock, cdef,
+                        restoration, pbi->tile_workers + (adapt_worker != NULL),
+                        pbi->num_tile_workers - (adapt_worker != NULL),
+                        &pbi->post_filter_sync);
+  if (adapt_worker != NULL) winterface->sync(adapt_worker);
+
+#if CONFIG_FRAME_SUPERRES
+  superres_post_decode(pbi);
+#if CONFIG_LOOP_RESTORATION
+  if (superres_restoration) {
+    if (pbi->num_tile_workers > 1)
+      restoration_mt = 1;
+    else
+      av1_loop_restoration_frame(new_fb, cm, cm->rst_info, 7, 0, NULL);
+  }
+#endif  // CONFIG_LOOP_RESTORATION
+#endif  // CONFIG_FRAME_SUPERRES
+#if CONFIG_LOOP_RESTORATION
+  if (restoration_mt)
+    av1_loop_restoration_frame_mt(new_fb, cm, pbi->tile_workers,
+                                  pbi->num_tile_workers, &pbi->lr_sync);
+#endif  // CONFIG_LOOP_RESTORATION
+
+  if (xd->corrupted)
     aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
                        "Decode failed. Frame data is corrupted.");
-  }
 
 #if CONFIG_INSPECTION
   if (pbi->inspect_cb != NULL) {
     (*pbi->inspect_cb)(pbi, pbi->inspect_ctx);
   }
 #endif
-
-  // Non frame parallel update frame context here.
-  if (!cm->error_resilient_mode && !context_updated)
-    cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
 }
@@ -158,6 +158,21 @@ void av1_decoder_remove(AV1Decoder *pbi) {
 
   if (!pbi) return;
 
+#if CONFIG_INTERNAL_STATS
+  if (pbi->common.current_video_frame > 0) {
+    // The load of each worker of the job queues, to check how evenly the work
+    // stealing balances them.
+    FILE *f = fopen("dec_jobs.stt", "a");
+    fprintf(f, "Queue\tWorker\tBusyMs\tIdleMs\tJobs\tSteals\n");
+    av1_print_job_stats(f, "tiles", &pbi->tile_queue);
+    av1_print_job_stats(f, "loopfilter", &pbi->lf_row_sync.job_queue);
+#if CONFIG_LOOP_RESTORATION
+    av1_print_job_stats(f, "restoration", &pbi->lr_sync.job_queue);
+#endif  // CONFIG_LOOP_RESTORATION
+    fclose(f);
+  }
+#endif  // CONFIG_INTERNAL_STATS
+
   aom_get_worker_interface()->end(&pbi->lf_worker);
   aom_free(pbi->lf_worker.data1);
   aom_free(pbi->tile_data);
@@ -168,10 +183,16 @@ void av1_decoder_remove(AV1Decoder *pbi) {
   aom_free(pbi->tile_worker_data);
   aom_free(pbi->tile_worker_info);
   aom_free(pbi->tile_workers);
+  aom_job_queue_free(&pbi->tile_queue);
 
   if (pbi->num_tile_workers > 0) {
     av1_loop_filter_dealloc(&pbi->lf_row_sync);
   }
+  av1_post_filter_dealloc(&pbi->post_filter_sync);
+#if CONFIG_LOOP_RESTORATION
+  av1_loop_restoration_dealloc(&pbi->lr_sync);
+#endif  // CONFIG_LOOP_RESTORATION
+  av1_dec_row_mt_dealloc(&pbi->row_mt_sync);
 
 #if CONFIG_ACCOUNTING
   aom_accounting_clear(&pbi->accounting);
@@ -266,7 +287,7 @@ aom_codec_err_t av1_set_reference_dec(AV1_COMMON *cm,
     return cm->error.error_code;
   }
 
-  if (idx < 0 || idx >= FRAME_BUFFERS) {
+  if (idx < 0 || idx >= cm->buffer_pool->num_frame_bufs) {
     aom_internal_error(&cm->error, AOM_CODEC_ERROR,
                        "Invalid reference frame map");
     return cm->error.error_code;
@@ -397,8 +418,10 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     pbi->ready_for_new_data = 1;
 
     // Synchronize all threads immediately as a subsequent decode call may
-    // cause a resize invalidating some allocations.
+    // cause a resize invalidating some allocations. Tile workers waiting on
+    // superblock rows that will not be parsed are released first.
     winterface->sync(&pbi->lf_worker);
+    av1_dec_row_mt_abort(&pbi->row_mt_sync);
     for (i = 0; i < pbi->num_tile_workers; ++i) {
       winterface->sync(&pbi->tile_workers[i]);
     }
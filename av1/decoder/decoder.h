@@ -82,6 +82,13 @@ typedef struct TileWorkerData {
   DECLARE_ALIGNED(16, uint8_t, color_index_map[2][MAX_SB_SQUARE]);
 #endif  // CONFIG_PALETTE
   struct aom_internal_error_info error_info;
+  // Position of the worker in the tile job queue and the tile row it works on.
+  int worker_id;
+  int tile_row;
+  int tile_col_start;
+  const uint8_t *data_end;
+  // End of the last tile of the frame, if decoded by this worker.
+  const uint8_t *tile_data_end;
 } TileWorkerData;
 
 typedef struct TileBufferDec {
@@ -111,6 +118,8 @@ typedef struct AV1Decoder {
   TileWorkerData *tile_worker_data;
   TileInfo *tile_worker_info;
   int num_tile_workers;
+  // Tile jobs of the multi-threaded tile decoder.
+  AVxJobQueue tile_queue;
 
   TileData *tile_data;
   int allocated_tiles;
@@ -118,12 +127,26 @@ typedef struct AV1Decoder {
   TileBufferDec tile_buffers[MAX_TILE_ROWS][MAX_TILE_COLS];
 
   AV1LfSync lf_row_sync;
+  // Deblocking, CDEF and loop restoration pipelined on the tile workers.
+  AV1PostFilterSync post_filter_sync;
+#if CONFIG_LOOP_RESTORATION
+  AV1LrSync lr_sync;
+#endif  // CONFIG_LOOP_RESTORATION
+  // Parsing of the superblock rows of a tile ahead of their reconstruction on
+  // the tile workers.
+  AV1DecRowMTSync row_mt_sync;
+  // Where decode_block() leaves the tokens of the blocks it parses, if the
+  // reconstruction is left to the tile workers.
+  DecRowTokens *parse_tokens;
 
   aom_decrypt_cb decrypt_cb;
   void *decrypt_state;
 
   int allow_lowbitdepth;
   int max_threads;
+  // Whether the superblock rows of a tile are parsed ahead of their
+  // reconstruction, which the tile workers then take on if there are any.
+  int row_mt;
   int inv_tile_order;
   int need_resync;   // wait for key/intra-only frame.
   int hold_ref_buf;  // hold the reference buffer.
@@ -192,3 +192,252 @@ void av1_frameworker_copy_context(AVxWorker *const dst_worker,
   (void)src_worker;
 #endif  // CONFIG_MULTITHREAD
 }
+
+void av1_dec_row_mt_alloc(AV1DecRowMTSync *row_mt_sync, AV1_COMMON *cm,
+                          int num_bufs, int sb_cols) {
+  // A superblock has at most as many coefficients as pixels in each plane,
+  // and at most one transform block per 4x4 coefficients.
+  const int buf_size =
+      sb_cols *
+      (MAX_SB_SQUARE +
+       2 * (MAX_SB_SQUARE >> (cm->subsampling_x + cm->subsampling_y)));
+  int i;
+
+  if (num_bufs == row_mt_sync->num_bufs && buf_size <= row_mt_sync->buf_size)
+    return;
+
+  av1_dec_row_mt_dealloc(row_mt_sync);
+
+#if CONFIG_MULTITHREAD
+  CHECK_MEM_ERROR(cm, row_mt_sync->mutex_,
+                  aom_malloc(sizeof(*row_mt_sync->mutex_) * num_bufs));
+  if (row_mt_sync->mutex_) {
+    for (i = 0; i < num_bufs; ++i) {
+      pthread_mutex_init(&row_mt_sync->mutex_[i], NULL);
+    }
+  }
+
+  CHECK_MEM_ERROR(cm, row_mt_sync->cond_,
+                  aom_malloc(sizeof(*row_mt_sync->cond_) * num_bufs));
+  if (row_mt_sync->cond_) {
+    for (i = 0; i < num_bufs; ++i) {
+      pthread_cond_init(&row_mt_sync->cond_[i], NULL);
+    }
+  }
+
+  CHECK_MEM_ERROR(cm, row_mt_sync->job_mutex_,
+                  aom_malloc(sizeof(*row_mt_sync->job_mutex_)));
+  if (row_mt_sync->job_mutex_) {
+    pthread_mutex_init(row_mt_sync->job_mutex_, NULL);
+  }
+#endif  // CONFIG_MULTITHREAD
+  row_mt_sync->num_bufs = num_bufs;
+
+  CHECK_MEM_ERROR(cm, row_mt_sync->tokens,
+                  aom_calloc(num_bufs, sizeof(*row_mt_sync->tokens)));
+  for (i = 0; i < num_bufs; ++i) {
+    DecRowTokens *const tokens = &row_mt_sync->tokens[i];
+    CHECK_MEM_ERROR(cm, tokens->dqcoeff,
+                    aom_memalign(32, buf_size * sizeof(*tokens->dqcoeff)));
+    CHECK_MEM_ERROR(cm, tokens->txb,
+                    aom_malloc((buf_size >> 4) * sizeof(*tokens->txb)));
+#if CONFIG_PALETTE
+    CHECK_MEM_ERROR(cm, tokens->color_index_map, aom_malloc(buf_size));
+#endif  // CONFIG_PALETTE
+  }
+  row_mt_sync->buf_size = buf_size;
+
+  CHECK_MEM_ERROR(cm, row_mt_sync->row,
+                  aom_malloc(sizeof(*row_mt_sync->row) * num_bufs));
+  CHECK_MEM_ERROR(cm, row_mt_sync->parsed,
+                  aom_malloc(sizeof(*row_mt_sync->parsed) * num_bufs));
+  CHECK_MEM_ERROR(cm, row_mt_sync->recon_cols,
+                  aom_malloc(sizeof(*row_mt_sync->recon_cols) * num_bufs));
+}
+
+void av1_dec_row_mt_dealloc(AV1DecRowMTSync *row_mt_sync) {
+  int i;
+
+  if (row_mt_sync == NULL) return;
+#if CONFIG_MULTITHREAD
+  if (row_mt_sync->mutex_ != NULL) {
+    for (i = 0; i < row_mt_sync->num_bufs; ++i) {
+      pthread_mutex_destroy(&row_mt_sync->mutex_[i]);
+    }
+    aom_free(row_mt_sync->mutex_);
+  }
+  if (row_mt_sync->cond_ != NULL) {
+    for (i = 0; i < row_mt_sync->num_bufs; ++i) {
+      pthread_cond_destroy(&row_mt_sync->cond_[i]);
+    }
+    aom_free(row_mt_sync->cond_);
+  }
+  if (row_mt_sync->job_mutex_ != NULL) {
+    pthread_mutex_destroy(row_mt_sync->job_mutex_);
+    aom_free(row_mt_sync->job_mutex_);
+  }
+#endif  // CONFIG_MULTITHREAD
+  if (row_mt_sync->tokens != NULL) {
+    for (i = 0; i < row_mt_sync->num_bufs; ++i) {
+      aom_free(row_mt_sync->tokens[i].dqcoeff);
+      aom_free(row_mt_sync->tokens[i].txb);
+#if CONFIG_PALETTE
+      aom_free(row_mt_sync->tokens[i].color_index_map);
+#endif  // CONFIG_PALETTE
+    }
+    aom_free(row_mt_sync->tokens);
+  }
+  aom_free(row_mt_sync->row);
+  aom_free(row_mt_sync->parsed);
+  aom_free(row_mt_sync->recon_cols);
+  av1_zero(*row_mt_sync);
+}
+
+void av1_dec_row_mt_reset(AV1DecRowMTSync *row_mt_sync, int sb_rows,
+                          int sb_cols) {
+  int i;
+
+  for (i = 0; i < row_mt_sync->num_bufs; ++i) {
+    row_mt_sync->row[i] = -1;
+    row_mt_sync->parsed[i] = 0;
+    row_mt_sync->recon_cols[i] = 0;
+  }
+  row_mt_sync->sb_rows = sb_rows;
+  row_mt_sync->sb_cols = sb_cols;
+  row_mt_sync->next_row = 0;
+  row_mt_sync->abort = 0;
+}
+
+DecRowTokens *av1_dec_row_mt_begin_parse(AV1DecRowMTSync *row_mt_sync,
+                                         int r) {
+  const int b = r % row_mt_sync->num_bufs;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *const mutex = &row_mt_sync->mutex_[b];
+
+  pthread_mutex_lock(mutex);
+  // The buffer is free once the row it held is reconstructed.
+  while (!row_mt_sync->abort && row_mt_sync->row[b] >= 0 &&
+         row_mt_sync->recon_cols[b] < row_mt_sync->sb_cols) {
+    pthread_cond_wait(&row_mt_sync->cond_[b], mutex);
+  }
+  row_mt_sync->row[b] = r;
+  row_mt_sync->parsed[b] = 0;
+  row_mt_sync->recon_cols[b] = 0;
+  pthread_mutex_unlock(mutex);
+#else
+  row_mt_sync->row[b] = r;
+  row_mt_sync->parsed[b] = 0;
+  row_mt_sync->recon_cols[b] = 0;
+#endif  // CONFIG_MULTITHREAD
+  return row_mt_sync->abort ? NULL : &row_mt_sync->tokens[b];
+}
+
+void av1_dec_row_mt_parsed(AV1DecRowMTSync *row_mt_sync, int r) {
+  const int b = r % row_mt_sync->num_bufs;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&row_mt_sync->mutex_[b]);
+  row_mt_sync->parsed[b] = 1;
+  pthread_cond_broadcast(&row_mt_sync->cond_[b]);
+  pthread_mutex_unlock(&row_mt_sync->mutex_[b]);
+#else
+  row_mt_sync->parsed[b] = 1;
+#endif  // CONFIG_MULTITHREAD
+}
+
+int av1_dec_row_mt_next_row(AV1DecRowMTSync *row_mt_sync) {
+  int r = -1;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(row_mt_sync->job_mutex_);
+#endif
+  if (!row_mt_sync->abort && row_mt_sync->next_row < row_mt_sync->sb_rows)
+    r = row_mt_sync->next_row++;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(row_mt_sync->job_mutex_);
+#endif
+  return r;
+}
+
+#if CONFIG_MULTITHREAD
+// Whether row 'r' is parsed, or already out of its buffer.
+static int row_parsed(const AV1DecRowMTSync *row_mt_sync, int r) {
+  const int b = r % row_mt_sync->num_bufs;
+  return row_mt_sync->row[b] > r ||
+         (row_mt_sync->row[b] == r && row_mt_sync->parsed[b]);
+}
+#endif  // CONFIG_MULTITHREAD
+
+const DecRowTokens *av1_dec_row_mt_begin_recon(AV1DecRowMTSync *row_mt_sync,
+                                               int r) {
+  // Overlapped block motion compensation briefly modifies the mode info of
+  // the neighbouring blocks above and to the left, which the parsing of the
+  // row below reads. So a row is only reconstructed once the row below it
+  // is parsed too. The motion vector search of the parser does not look
+  // further up than the row above.
+  const int wait_row = AOMMIN(r + 1, row_mt_sync->sb_rows - 1);
+#if CONFIG_MULTITHREAD
+  const int b = wait_row % row_mt_sync->num_bufs;
+  pthread_mutex_t *const mutex = &row_mt_sync->mutex_[b];
+
+  pthread_mutex_lock(mutex);
+  while (!row_mt_sync->abort && !row_parsed(row_mt_sync, wait_row)) {
+    pthread_cond_wait(&row_mt_sync->cond_[b], mutex);
+  }
+  pthread_mutex_unlock(mutex);
+#else
+  (void)wait_row;
+#endif  // CONFIG_MULTITHREAD
+  return row_mt_sync->abort
+             ? NULL
+             : &row_mt_sync->tokens[r % row_mt_sync->num_bufs];
+}
+
+int av1_dec_row_mt_sync_read(AV1DecRowMTSync *row_mt_sync, int r, int c) {
+#if CONFIG_MULTITHREAD
+  if (r) {
+    // Intra prediction reads the above-right superblock.
+    const int b = (r - 1) % row_mt_sync->num_bufs;
+    const int cols = AOMMIN(c + 2, row_mt_sync->sb_cols);
+    pthread_mutex_t *const mutex = &row_mt_sync->mutex_[b];
+
+    pthread_mutex_lock(mutex);
+    while (!row_mt_sync->abort && row_mt_sync->row[b] == r - 1 &&
+           row_mt_sync->recon_cols[b] < cols) {
+      pthread_cond_wait(&row_mt_sync->cond_[b], mutex);
+    }
+    pthread_mutex_unlock(mutex);
+  }
+#else
+  (void)r;
+  (void)c;
+#endif  // CONFIG_MULTITHREAD
+  return !row_mt_sync->abort;
+}
+
+void av1_dec_row_mt_sync_write(AV1DecRowMTSync *row_mt_sync, int r, int c) {
+  const int b = r % row_mt_sync->num_bufs;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&row_mt_sync->mutex_[b]);
+  row_mt_sync->recon_cols[b] = c + 1;
+  pthread_cond_broadcast(&row_mt_sync->cond_[b]);
+  pthread_mutex_unlock(&row_mt_sync->mutex_[b]);
+#else
+  row_mt_sync->recon_cols[b] = c + 1;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void av1_dec_row_mt_abort(AV1DecRowMTSync *row_mt_sync) {
+  int i;
+
+  if (row_mt_sync->num_bufs == 0) return;
+  row_mt_sync->abort = 1;
+#if CONFIG_MULTITHREAD
+  for (i = 0; i < row_mt_sync->num_bufs; ++i) {
+    pthread_mutex_lock(&row_mt_sync->mutex_[i]);
+    pthread_cond_broadcast(&row_mt_sync->cond_[i]);
+    pthread_mutex_unlock(&row_mt_sync->mutex_[i]);
+  }
+#else
+  (void)i;
+#endif  // CONFIG_MULTITHREAD
+}
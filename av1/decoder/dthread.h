@@ -13,6 +13,7 @@
 #define AV1_DECODER_DTHREAD_H_
 
 #include "./aom_config.h"
+#include "aom_dsp/aom_dsp_common.h"
 #include "aom_util/aom_thread.h"
 #include "aom/internal/aom_codec_internal.h"
 
@@ -68,6 +69,87 @@ void av1_frameworker_broadcast(RefCntBuffer *const buf, int row);
 void av1_frameworker_copy_context(AVxWorker *const dst_worker,
                                   AVxWorker *const src_worker);
 
+// A transform block parsed ahead of its reconstruction.
+typedef struct DecTxbInfo {
+  int eob;
+  int16_t max_scan_line;
+} DecTxbInfo;
+
+// Coefficients and palette color indices of a superblock row, in the order
+// they are parsed. The positions are where the next transform block and
+// color index map go when parsing, and where they come from when
+// reconstructing.
+typedef struct DecRowTokens {
+  tran_low_t *dqcoeff;
+  DecTxbInfo *txb;
+#if CONFIG_PALETTE
+  uint8_t *color_index_map;
+#endif  // CONFIG_PALETTE
+  int dqcoeff_pos;
+  int txb_pos;
+  int color_index_map_pos;
+} DecRowTokens;
+
+// Superblock row synchronization within a tile for row based multi-threading.
+// The main thread parses the rows of the tile into a ring of token buffers,
+// one row per buffer, while the tile workers reconstruct the parsed rows in a
+// wavefront.
+typedef struct AV1DecRowMTSync {
+#if CONFIG_MULTITHREAD
+  // One per buffer.
+  pthread_mutex_t *mutex_;
+  pthread_cond_t *cond_;
+  pthread_mutex_t *job_mutex_;
+#endif
+  DecRowTokens *tokens;
+  // The superblock row held by each buffer, whether it is completely parsed
+  // and how many of its superblocks are reconstructed.
+  int *row;
+  int *parsed;
+  int *recon_cols;
+  int num_bufs;
+  // Number of coefficients each buffer holds.
+  int buf_size;
+  // Size of the tile, in superblocks.
+  int sb_rows;
+  int sb_cols;
+  // The next superblock row to hand out to a tile worker.
+  int next_row;
+  // Set when the tile cannot be decoded: every wait returns at once.
+  int abort;
+} AV1DecRowMTSync;
+
+// Allocates 'num_bufs' token buffers of 'sb_cols' superblocks, unless the
+// current ones are already as large.
+void av1_dec_row_mt_alloc(AV1DecRowMTSync *row_mt_sync, struct AV1Common *cm,
+                          int num_bufs, int sb_cols);
+void av1_dec_row_mt_dealloc(AV1DecRowMTSync *row_mt_sync);
+
+// Prepares the decoding of a tile of 'sb_rows' x 'sb_cols' superblocks.
+void av1_dec_row_mt_reset(AV1DecRowMTSync *row_mt_sync, int sb_rows,
+                          int sb_cols);
+
+// Waits for a free buffer and returns it for the parsing of row 'r', or NULL
+// if the decoding was aborted.
+DecRowTokens *av1_dec_row_mt_begin_parse(AV1DecRowMTSync *row_mt_sync, int r);
+// Marks row 'r' as parsed.
+void av1_dec_row_mt_parsed(AV1DecRowMTSync *row_mt_sync, int r);
+
+// Returns the next row to reconstruct, or -1 if there is none left.
+int av1_dec_row_mt_next_row(AV1DecRowMTSync *row_mt_sync);
+// Waits until row 'r' may be reconstructed and returns its tokens, or NULL if
+// the decoding was aborted.
+const DecRowTokens *av1_dec_row_mt_begin_recon(AV1DecRowMTSync *row_mt_sync,
+                                               int r);
+// Waits until superblock 'c' of row 'r' may be reconstructed. Returns 0 if the
+// decoding was aborted.
+int av1_dec_row_mt_sync_read(AV1DecRowMTSync *row_mt_sync, int r, int c);
+// Marks superblock 'c' of row 'r' as reconstructed.
+void av1_dec_row_mt_sync_write(AV1DecRowMTSync *row_mt_sync, int r, int c);
+
+// Releases all the waiting threads after an error.
+void av1_dec_row_mt_abort(AV1DecRowMTSync *row_mt_sync);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -490,7 +490,7 @@ int av1_background_sprite(AV1_COMP *cpi, int distance) {
   TransformationType model = AFFINE;
   for (int frame = 0; frame < distance; ++frame) {
     const int global_motion_ret = compute_global_motion_feature_based(
-        model, frames[frame + 1], frames[frame],
+        model, frames[frame + 1], NULL, 0, frames[frame], NULL, 0,
 #if CONFIG_HIGHBITDEPTH
         cpi->common.bit_depth,
 #endif  // CONFIG_HIGHBITDEPTH
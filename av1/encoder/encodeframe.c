@@ -4291,6 +4291,11 @@ static void encode_rd_sb_row(AV1_COMP *cpi, ThreadData *td,
 #else
   const int leaf_nodes = 64;
 #endif  // CONFIG_EXT_PARTITION
+  const int sb_row_in_tile =
+      (mi_row - tile_info->mi_row_start) >> cm->mib_size_log2;
+  const int sb_cols_in_tile =
+      (tile_info->mi_col_end - tile_info->mi_col_start + cm->mib_size - 1) >>
+      cm->mib_size_log2;
 
   // Initialize the left context for the new SB row
   av1_zero_left_context(xd);
@@ -4321,6 +4326,12 @@ static void encode_rd_sb_row(AV1_COMP *cpi, ThreadData *td,
     const int idx_str = cm->mi_stride * mi_row + mi_col;
     MODE_INFO **mi = cm->mi_grid_visible + idx_str;
     PC_TREE *const pc_root = td->pc_root[cm->mib_size_log2 - MIN_MIB_SIZE_LOG2];
+    const int sb_col_in_tile =
+        (mi_col - tile_info->mi_col_start) >> cm->mib_size_log2;
+
+    // Wait for the above and above-right superblocks to be encoded.
+    (*(cpi->row_mt_sync_read_ptr))(&tile_data->row_mt_sync, sb_row_in_tile,
+                                   sb_col_in_tile);
 
     av1_update_boundary_info(cm, tile_info, mi_row, mi_col);
 
@@ -4453,6 +4464,9 @@ static void encode_rd_sb_row(AV1_COMP *cpi, ThreadData *td,
                         INT64_MAX, pc_root);
 #endif  // CONFIG_SPEED_REFS
     }
+
+    (*(cpi->row_mt_sync_write_ptr))(&tile_data->row_mt_sync, sb_row_in_tile,
+                                    sb_col_in_tile, sb_cols_in_tile);
   }
 }
 
@@ -4549,6 +4563,7 @@ void av1_init_tile_data(AV1_COMP *cpi) {
   unsigned int tile_tok = 0;
 
   if (cpi->tile_data == NULL || cpi->allocated_tiles < tile_cols * tile_rows) {
+    av1_row_mt_tiles_dealloc(cpi);
     if (cpi->tile_data != NULL) aom_free(cpi->tile_data);
     CHECK_MEM_ERROR(
         cm, cpi->tile_data,
@@ -4566,6 +4581,8 @@ void av1_init_tile_data(AV1_COMP *cpi) {
             tile_data->mode_map[i][j] = j;
           }
         }
+        av1_zero(tile_data->row_mt_sync);
+        tile_data->row_tok_count = NULL;
 #if CONFIG_PVQ
         // This will be dynamically increased as more pvq block is encoded.
         tile_data->pvq_q.buf_len = 1000;
@@ -4593,14 +4610,11 @@ void av1_init_tile_data(AV1_COMP *cpi) {
   }
 }
 
-void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
-                     int tile_col) {
+void av1_encode_tile_init(AV1_COMP *cpi, int tile_row, int tile_col) {
   AV1_COMMON *const cm = &cpi->common;
   TileDataEnc *const this_tile =
       &cpi->tile_data[tile_row * cm->tile_cols + tile_col];
   const TileInfo *const tile_info = &this_tile->tile_info;
-  TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col];
-  int mi_row;
 
 #if CONFIG_DEPENDENT_HORZTILES
 #if CONFIG_TILE_GROUPS
@@ -4615,6 +4629,22 @@ void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
   av1_zero_above_context(cm, tile_info->mi_col_start, tile_info->mi_col_end);
 #endif
 
+#if CONFIG_EC_ADAPT
+  this_tile->tctx = *cm->fc;
+#endif  // CONFIG_EC_ADAPT
+}
+
+void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
+                     int tile_col) {
+  AV1_COMMON *const cm = &cpi->common;
+  TileDataEnc *const this_tile =
+      &cpi->tile_data[tile_row * cm->tile_cols + tile_col];
+  const TileInfo *const tile_info = &this_tile->tile_info;
+  TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col];
+  int mi_row;
+
+  av1_encode_tile_init(cpi, tile_row, tile_col);
+
   // Set up pointers to per thread motion search counters.
   this_tile->m_search_count = 0;   // Count of motion search hits.
   this_tile->ex_search_count = 0;  // Exhaustive mesh search hits.
@@ -4693,7 +4723,6 @@ void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
 #endif  // #if CONFIG_PVQ
 
 #if CONFIG_EC_ADAPT
-  this_tile->tctx = *cm->fc;
   td->mb.e_mbd.tile_ctx = &this_tile->tctx;
 #endif  // #if CONFIG_EC_ADAPT
 
@@ -4731,6 +4760,59 @@ void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
 #endif
 }
 
+void av1_encode_sb_row(AV1_COMP *cpi, ThreadData *td, TileDataEnc *row_data,
+                       int tile_row, int tile_col, int mi_row) {
+  AV1_COMMON *const cm = &cpi->common;
+  TileDataEnc *const this_tile =
+      &cpi->tile_data[tile_row * cm->tile_cols + tile_col];
+  const TileInfo *const tile_info = &this_tile->tile_info;
+  const int sb_row = (mi_row - tile_info->mi_row_start) >> cm->mib_size_log2;
+  TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col] +
+                    get_sb_row_tok_offset(*tile_info, mi_row);
+  TOKENEXTRA *const tok_start = tok;
+
+  // Every superblock row starts from the adaptive rd thresholds of the tile,
+  // so that the result does not depend on how rows are spread over threads.
+  row_data->tile_info = this_tile->tile_info;
+  row_data->row_mt_sync = this_tile->row_mt_sync;
+  memcpy(row_data->thresh_freq_fact, this_tile->thresh_freq_fact,
+         sizeof(this_tile->thresh_freq_fact));
+  memcpy(row_data->mode_map, this_tile->mode_map,
+         sizeof(this_tile->mode_map));
+
+  // Set up pointers to per row motion search counters.
+  row_data->m_search_count = 0;
+  row_data->ex_search_count = 0;
+  td->mb.m_search_count_ptr = &row_data->m_search_count;
+  td->mb.ex_search_count_ptr = &row_data->ex_search_count;
+
+#if CONFIG_EC_ADAPT
+  td->mb.e_mbd.tile_ctx = &this_tile->tctx;
+#endif  // CONFIG_EC_ADAPT
+
+#if CONFIG_CFL
+  td->mb.e_mbd.cfl = &row_data->cfl;
+  cfl_init(td->mb.e_mbd.cfl, cm);
+#endif
+
+  encode_rd_sb_row(cpi, td, row_data, mi_row, &tok);
+
+  this_tile->row_tok_count[sb_row] = (unsigned int)(tok - tok_start);
+  assert(tok - cpi->tile_tok[tile_row][tile_col] <=
+         get_sb_row_tok_offset(*tile_info,
+                               AOMMIN(mi_row + cm->mib_size,
+                                      tile_info->mi_row_end)));
+
+  // The bottom row has finished after all the rows above it, and it carries
+  // the adapted thresholds over to the next frame.
+  if (mi_row + cm->mib_size >= tile_info->mi_row_end) {
+    memcpy(this_tile->thresh_freq_fact, row_data->thresh_freq_fact,
+           sizeof(this_tile->thresh_freq_fact));
+    memcpy(this_tile->mode_map, row_data->mode_map,
+           sizeof(this_tile->mode_map));
+  }
+}
+
 static void encode_tiles(AV1_COMP *cpi) {
   AV1_COMMON *const cm = &cpi->common;
   int tile_col, tile_row;
@@ -4841,6 +4923,219 @@ static int do_gm_search_logic(SPEED_FEATURES *const sf, int num_refs_using_gm,
   }
   return 1;
 }
+// Global motion searches of the reference frames, one per job of the encoder
+// workers.
+typedef struct {
+  AV1_COMP *cpi;
+  YV12_BUFFER_CONFIG *ref_buf[TOTAL_REFS_PER_FRAME];
+  // Buffers of the searched reference frames, which cache their corners.
+  RefCntBuffer *ref_cnt_buf[TOTAL_REFS_PER_FRAME];
+  // The searched reference frames.
+  int frames[TOTAL_REFS_PER_FRAME];
+  int num_frames;
+  // Corners of the source frame, shared by all the searches.
+  int *src_corners;
+  int num_src_corners;
+  // Result of the search of each reference frame, and its error unwarped.
+  WarpedMotionParams params[TOTAL_REFS_PER_FRAME];
+  int64_t ref_frame_error[TOTAL_REFS_PER_FRAME];
+  AVxJobQueue job_queue;
+} GlobalMotionSync;
+
+// Finds the global motion of the reference 'frame', leaving it in
+// gm_sync->params[frame]. Reads nothing but the frames and the common state,
+// so the reference frames can be searched in parallel.
+static void search_ref_global_motion(GlobalMotionSync *gm_sync, int frame) {
+  AV1_COMP *const cpi = gm_sync->cpi;
+  AV1_COMMON *const cm = &cpi->common;
+  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+  YV12_BUFFER_CONFIG *const ref_buf = gm_sync->ref_buf[frame];
+  RefCntBuffer *const ref_cnt_buf = gm_sync->ref_cnt_buf[frame];
+  WarpedMotionParams *const params = &gm_sync->params[frame];
+  double params_by_motion[RANSAC_NUM_MOTIONS * (MAX_PARAMDIM - 1)];
+  const double *params_this_motion;
+  int inliers_by_motion[RANSAC_NUM_MOTIONS];
+  WarpedMotionParams tmp_wm_params;
+  static const double kIdentityParams[MAX_PARAMDIM - 1] = {
+    0.0, 0.0, 1.0, 0.0, 0.0, 1.0, 0.0, 0.0
+  };
+  TransformationType model;
+  int i;
+  const int64_t ref_frame_error = av1_frame_error(
+#if CONFIG_HIGHBITDEPTH
+      xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH, xd->bd,
+#endif  // CONFIG_HIGHBITDEPTH
+      ref_buf->y_buffer, ref_buf->y_stride, cpi->source->y_buffer,
+      cpi->source->y_width, cpi->source->y_height, cpi->source->y_stride);
+
+  gm_sync->ref_frame_error[frame] = ref_frame_error;
+  if (ref_frame_error == 0) return;
+
+  if (ref_cnt_buf->num_corners < 0)
+    ref_cnt_buf->num_corners = compute_frame_corners(ref_buf,
+#if CONFIG_HIGHBITDEPTH
+                                                     cm->bit_depth,
+#endif  // CONFIG_HIGHBITDEPTH
+                                                     ref_cnt_buf->corners);
+
+  aom_clear_system_state();
+  for (model = ROTZOOM; model < GLOBAL_TRANS_TYPES_ENC; ++model) {
+    int64_t best_warp_error = INT64_MAX;
+    // Initially set all params to identity.
+    for (i = 0; i < RANSAC_NUM_MOTIONS; ++i) {
+      memcpy(params_by_motion + (MAX_PARAMDIM - 1) * i, kIdentityParams,
+             (MAX_PARAMDIM - 1) * sizeof(*params_by_motion));
+    }
+
+    compute_global_motion_feature_based(
+        model, cpi->source, gm_sync->src_corners, gm_sync->num_src_corners,
+        ref_buf, ref_cnt_buf->corners, ref_cnt_buf->num_corners,
+#if CONFIG_HIGHBITDEPTH
+        cpi->common.bit_depth,
+#endif  // CONFIG_HIGHBITDEPTH
+        inliers_by_motion, params_by_motion, RANSAC_NUM_MOTIONS);
+
+    for (i = 0; i < RANSAC_NUM_MOTIONS; ++i) {
+      if (inliers_by_motion[i] == 0) continue;
+
+      params_this_motion = params_by_motion + (MAX_PARAMDIM - 1) * i;
+      convert_model_to_params(params_this_motion, &tmp_wm_params);
+
+      if (tmp_wm_params.wmtype != IDENTITY) {
+        const int64_t warp_error = refine_integerized_param(
+            &tmp_wm_params, tmp_wm_params.wmtype,
+#if CONFIG_HIGHBITDEPTH
+            xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH, xd->bd,
+#endif  // CONFIG_HIGHBITDEPTH
+            ref_buf->y_buffer, ref_buf->y_width, ref_buf->y_height,
+            ref_buf->y_stride, cpi->source->y_buffer, cpi->source->y_width,
+            cpi->source->y_height, cpi->source->y_stride, 5, best_warp_error);
+        if (warp_error < best_warp_error) {
+          best_warp_error = warp_error;
+          // Save the wm_params modified by refine_integerized_param()
+          // rather than motion index to avoid rerunning refine() below.
+          memcpy(params, &tmp_wm_params, sizeof(WarpedMotionParams));
+        }
+      }
+    }
+    if (params->wmtype <= AFFINE)
+      if (!get_shear_params(params)) set_default_warp_params(params);
+
+    if (params->wmtype == TRANSLATION) {
+      params->wmmat[0] = convert_to_trans_prec(cm->allow_high_precision_mv,
+                                               params->wmmat[0]) *
+                         GM_TRANS_ONLY_DECODE_FACTOR;
+      params->wmmat[1] = convert_to_trans_prec(cm->allow_high_precision_mv,
+                                               params->wmmat[1]) *
+                         GM_TRANS_ONLY_DECODE_FACTOR;
+    }
+
+    // If the best error advantage found doesn't meet the threshold for
+    // this motion type, revert to IDENTITY.
+    if (!is_enough_erroradvantage(
+            (double)best_warp_error / ref_frame_error,
+            gm_get_params_cost(params, &cm->prev_frame->global_motion[frame],
+                               cm->allow_high_precision_mv))) {
+      set_default_warp_params(params);
+    }
+    if (params->wmtype != IDENTITY) break;
+  }
+  aom_clear_system_state();
+}
+
+static int gm_search_worker_hook(GlobalMotionSync *const gm_sync,
+                                 void *worker_index) {
+  const int worker = (int)(intptr_t)worker_index;
+  int job;
+  while (aom_job_queue_pop(&gm_sync->job_queue, worker, &job))
+    search_ref_global_motion(gm_sync, gm_sync->frames[job]);
+  return 1;
+}
+
+// Searches the global motion of every reference frame that the search logic
+// may ask for, on the encoder workers. Whether a reference is searched can
+// depend on how many of the previous ones use global motion, so the searches
+// are speculative: the caller picks the results in reference order.
+static void search_global_motion(AV1_COMP *cpi, GlobalMotionSync *gm_sync) {
+  AV1_COMMON *const cm = &cpi->common;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  int num_workers;
+  int frame, i;
+
+  gm_sync->cpi = cpi;
+  gm_sync->num_frames = 0;
+  for (frame = LAST_FRAME; frame <= ALTREF_FRAME; ++frame) {
+    int pframe;
+    gm_sync->ref_buf[frame] = get_ref_frame_buffer(cpi, frame);
+    for (pframe = LAST_FRAME; pframe < frame; ++pframe) {
+      if (gm_sync->ref_buf[frame] == gm_sync->ref_buf[pframe]) break;
+    }
+    // With no reference using global motion yet, the search logic asks for
+    // every reference it may ever ask for.
+    if (pframe == frame && gm_sync->ref_buf[frame] &&
+        do_gm_search_logic(&cpi->sf, 0, frame)) {
+      RefCntBuffer *const ref_cnt_buf =
+          &cm->buffer_pool->frame_bufs[get_ref_frame_buf_idx(cpi, frame)];
+      // The corners are detected by the worker searching the frame.
+      if (!ref_cnt_buf->corners) {
+        CHECK_MEM_ERROR(
+            cm, ref_cnt_buf->corners,
+            aom_malloc(2 * MAX_CORNERS * sizeof(*ref_cnt_buf->corners)));
+        ref_cnt_buf->num_corners = -1;
+      }
+      gm_sync->ref_cnt_buf[frame] = ref_cnt_buf;
+      gm_sync->params[frame] = cm->global_motion[frame];
+      gm_sync->frames[gm_sync->num_frames++] = frame;
+    }
+  }
+  if (gm_sync->num_frames == 0) return;
+
+#if CONFIG_HIGHBITDEPTH
+  // The source buffers are refilled without being reallocated, so an 8-bit
+  // copy made for an earlier frame would be stale.
+  if (cpi->source->y_buffer_8bit) {
+    free(cpi->source->y_buffer_8bit);
+    cpi->source->y_buffer_8bit = NULL;
+  }
+#endif  // CONFIG_HIGHBITDEPTH
+  // The source frame is converted to 8 bits here, before the workers share
+  // it.
+  CHECK_MEM_ERROR(cm, gm_sync->src_corners,
+                  aom_malloc(2 * MAX_CORNERS * sizeof(*gm_sync->src_corners)));
+  gm_sync->num_src_corners = compute_frame_corners(cpi->source,
+#if CONFIG_HIGHBITDEPTH
+                                                   cm->bit_depth,
+#endif  // CONFIG_HIGHBITDEPTH
+                                                   gm_sync->src_corners);
+
+  num_workers = AOMMIN(cpi->num_workers, gm_sync->num_frames);
+  if (num_workers <= 1) {
+    for (i = 0; i < gm_sync->num_frames; ++i)
+      search_ref_global_motion(gm_sync, gm_sync->frames[i]);
+  } else {
+    if (!aom_job_queue_alloc(&gm_sync->job_queue, num_workers))
+      aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                         "Failed to allocate global motion job queue");
+    aom_job_queue_reset(&gm_sync->job_queue, num_workers, gm_sync->num_frames);
+    for (i = 0; i < num_workers; ++i) {
+      AVxWorker *const worker = &cpi->workers[i];
+      worker->hook = (AVxWorkerHook)gm_search_worker_hook;
+      worker->data1 = gm_sync;
+      worker->data2 = (void *)(intptr_t)i;
+      if (i == num_workers - 1) {
+        winterface->execute(worker);
+      } else {
+        winterface->launch(worker);
+      }
+    }
+    for (i = 0; i < num_workers; ++i) {
+      winterface->sync(&cpi->workers[i]);
+    }
+    aom_job_queue_finish(&gm_sync->job_queue);
+    aom_job_queue_free(&gm_sync->job_queue);
+  }
+  aom_free(gm_sync->src_corners);
+}
 #endif  // CONFIG_GLOBAL_MOTION
 
 static void encode_frame_internal(AV1_COMP *cpi) {
@@ -4874,109 +5169,25 @@ static void encode_frame_internal(AV1_COMP *cpi) {
   av1_zero(cpi->gmparams_cost);
   if (cpi->common.frame_type == INTER_FRAME && cpi->source &&
       !cpi->global_motion_search_done) {
-    YV12_BUFFER_CONFIG *ref_buf[TOTAL_REFS_PER_FRAME];
+    GlobalMotionSync gm_sync;
     int frame;
-    double params_by_motion[RANSAC_NUM_MOTIONS * (MAX_PARAMDIM - 1)];
-    const double *params_this_motion;
-    int inliers_by_motion[RANSAC_NUM_MOTIONS];
-    WarpedMotionParams tmp_wm_params;
-    static const double kIdentityParams[MAX_PARAMDIM - 1] = {
-      0.0, 0.0, 1.0, 0.0, 0.0, 1.0, 0.0, 0.0
-    };
     int num_refs_using_gm = 0;
 
+    search_global_motion(cpi, &gm_sync);
+
     for (frame = LAST_FRAME; frame <= ALTREF_FRAME; ++frame) {
-      ref_buf[frame] = get_ref_frame_buffer(cpi, frame);
       int pframe;
       // check for duplicate buffer
       for (pframe = LAST_FRAME; pframe < frame; ++pframe) {
-        if (ref_buf[frame] == ref_buf[pframe]) break;
+        if (gm_sync.ref_buf[frame] == gm_sync.ref_buf[pframe]) break;
       }
       if (pframe < frame) {
         memcpy(&cm->global_motion[frame], &cm->global_motion[pframe],
                sizeof(WarpedMotionParams));
-      } else if (ref_buf[frame] &&
+      } else if (gm_sync.ref_buf[frame] &&
                  do_gm_search_logic(&cpi->sf, num_refs_using_gm, frame)) {
-        TransformationType model;
-        const int64_t ref_frame_error = av1_frame_error(
-#if CONFIG_HIGHBITDEPTH
-            xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH, xd->bd,
-#endif  // CONFIG_HIGHBITDEPTH
-            ref_buf[frame]->y_buffer, ref_buf[frame]->y_stride,
-            cpi->source->y_buffer, cpi->source->y_width, cpi->source->y_height,
-            cpi->source->y_stride);
-
-        if (ref_frame_error == 0) continue;
-
-        aom_clear_system_state();
-        for (model = ROTZOOM; model < GLOBAL_TRANS_TYPES_ENC; ++model) {
-          int64_t best_warp_error = INT64_MAX;
-          // Initially set all params to identity.
-          for (i = 0; i < RANSAC_NUM_MOTIONS; ++i) {
-            memcpy(params_by_motion + (MAX_PARAMDIM - 1) * i, kIdentityParams,
-                   (MAX_PARAMDIM - 1) * sizeof(*params_by_motion));
-          }
-
-          compute_global_motion_feature_based(
-              model, cpi->source, ref_buf[frame],
-#if CONFIG_HIGHBITDEPTH
-              cpi->common.bit_depth,
-#endif  // CONFIG_HIGHBITDEPTH
-              inliers_by_motion, params_by_motion, RANSAC_NUM_MOTIONS);
-
-          for (i = 0; i < RANSAC_NUM_MOTIONS; ++i) {
-            if (inliers_by_motion[i] == 0) continue;
-
-            params_this_motion = params_by_motion + (MAX_PARAMDIM - 1) * i;
-            convert_model_to_params(params_this_motion, &tmp_wm_params);
-
-            if (tmp_wm_params.wmtype != IDENTITY) {
-              const int64_t warp_error = refine_integerized_param(
-                  &tmp_wm_params, tmp_wm_params.wmtype,
-#if CONFIG_HIGHBITDEPTH
-                  xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH, xd->bd,
-#endif  // CONFIG_HIGHBITDEPTH
-                  ref_buf[frame]->y_buffer, ref_buf[frame]->y_width,
-                  ref_buf[frame]->y_height, ref_buf[frame]->y_stride,
-                  cpi->source->y_buffer, cpi->source->y_width,
-                  cpi->source->y_height, cpi->source->y_stride, 5,
-                  best_warp_error);
-              if (warp_error < best_warp_error) {
-                best_warp_error = warp_error;
-                // Save the wm_params modified by refine_integerized_param()
-                // rather than motion index to avoid rerunning refine() below.
-                memcpy(&(cm->global_motion[frame]), &tmp_wm_params,
-                       sizeof(WarpedMotionParams));
-              }
-            }
-          }
-          if (cm->global_motion[frame].wmtype <= AFFINE)
-            if (!get_shear_params(&cm->global_motion[frame]))
-              set_default_warp_params(&cm->global_motion[frame]);
-
-          if (cm->global_motion[frame].wmtype == TRANSLATION) {
-            cm->global_motion[frame].wmmat[0] =
-                convert_to_trans_prec(cm->allow_high_precision_mv,
-                                      cm->global_motion[frame].wmmat[0]) *
-                GM_TRANS_ONLY_DECODE_FACTOR;
-            cm->global_motion[frame].wmmat[1] =
-                convert_to_trans_prec(cm->allow_high_precision_mv,
-                                      cm->global_motion[frame].wmmat[1]) *
-                GM_TRANS_ONLY_DECODE_FACTOR;
-          }
-
-          // If the best error advantage found doesn't meet the threshold for
-          // this motion type, revert to IDENTITY.
-          if (!is_enough_erroradvantage(
-                  (double)best_warp_error / ref_frame_error,
-                  gm_get_params_cost(&cm->global_motion[frame],
-                                     &cm->prev_frame->global_motion[frame],
-                                     cm->allow_high_precision_mv))) {
-            set_default_warp_params(&cm->global_motion[frame]);
-          }
-          if (cm->global_motion[frame].wmtype != IDENTITY) break;
-        }
-        aom_clear_system_state();
+        if (gm_sync.ref_frame_error[frame] == 0) continue;
+        cm->global_motion[frame] = gm_sync.params[frame];
       }
       if (cm->global_motion[frame].wmtype != IDENTITY) num_refs_using_gm++;
       cpi->gmparams_cost[frame] =
@@ -5100,10 +5311,24 @@ static void encode_frame_internal(AV1_COMP *cpi) {
     // TODO(geza.lore): The multi-threaded encoder is not safe with more than
     // 1 tile rows, as it uses the single above_context et al arrays from
     // cpi->common
-    if (AOMMIN(cpi->oxcf.max_threads, cm->tile_cols) > 1 && cm->tile_rows == 1)
+    // Row based multi-threading is not possible when delta q is signaled, as
+    // the q index is predicted from the previous superblock in raster order.
+    // PVQ keeps a single queue of coded blocks per tile.
+    const int use_row_mt =
+        !CONFIG_PVQ && cpi->oxcf.row_mt && !cm->delta_q_present_flag;
+
+    cpi->row_mt_sync_read_ptr = av1_row_mt_sync_read_dummy;
+    cpi->row_mt_sync_write_ptr = av1_row_mt_sync_write_dummy;
+    if (use_row_mt) {
+      cpi->row_mt_sync_read_ptr = av1_row_sync_read;
+      cpi->row_mt_sync_write_ptr = av1_row_sync_write;
+      av1_encode_tiles_row_mt(cpi);
+    } else if (AOMMIN(cpi->oxcf.max_threads, cm->tile_cols) > 1 &&
+               cm->tile_rows == 1) {
       av1_encode_tiles_mt(cpi);
-    else
+    } else {
       encode_tiles(cpi);
+    }
 
     aom_usec_timer_mark(&emr_timer);
     cpi->time_encode_sb_row += aom_usec_timer_elapsed(&emr_timer);
@@ -24,6 +24,7 @@ struct macroblock;
 struct yv12_buffer_config;
 struct AV1_COMP;
 struct ThreadData;
+struct TileDataEnc;
 
 void av1_setup_src_planes(struct macroblock *x,
                           const struct yv12_buffer_config *src, int mi_row,
@@ -32,8 +33,14 @@ void av1_setup_src_planes(struct macroblock *x,
 void av1_encode_frame(struct AV1_COMP *cpi);
 
 void av1_init_tile_data(struct AV1_COMP *cpi);
+void av1_encode_tile_init(struct AV1_COMP *cpi, int tile_row, int tile_col);
 void av1_encode_tile(struct AV1_COMP *cpi, struct ThreadData *td, int tile_row,
                      int tile_col);
+// Encode one superblock row of a tile for row based multi-threading. The
+// per row rd state is kept in row_data, which must be private to the thread.
+void av1_encode_sb_row(struct AV1_COMP *cpi, struct ThreadData *td,
+                       struct TileDataEnc *row_data, int tile_row,
+                       int tile_col, int mi_row);
 
 void av1_update_tx_type_count(const struct AV1Common *cm, MACROBLOCKD *xd,
 #if CONFIG_TXK_SEL
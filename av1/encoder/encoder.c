@@ -491,6 +491,8 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
       }
   }
 #endif
+  av1_row_mt_tiles_dealloc(cpi);
+  av1_fp_row_mt_dealloc(cpi);
   aom_free(cpi->tile_data);
   cpi->tile_data = NULL;
 
@@ -524,7 +526,7 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
 #endif
   av1_free_context_buffers(cm);
 
-  aom_free_frame_buffer(&cpi->last_frame_uf);
+  av1_lpf_sync_dealloc(cpi);
 #if CONFIG_LOOP_RESTORATION
   av1_free_restoration_buffers(cm);
   aom_free_frame_buffer(&cpi->last_frame_db);
@@ -546,6 +548,10 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
 
   av1_free_pc_tree(&cpi->td);
 
+  aom_free(cpi->twopass.row_stats);
+  cpi->twopass.row_stats = NULL;
+  cpi->twopass.row_stats_rows = 0;
+
 #if CONFIG_PALETTE
   if (cpi->common.allow_screen_content_tools)
     aom_free(cpi->td.mb.palette_buffer);
@@ -765,16 +771,6 @@ static void alloc_raw_frame_buffers(AV1_COMP *cpi) {
 
 static void alloc_util_frame_buffers(AV1_COMP *cpi) {
   AV1_COMMON *const cm = &cpi->common;
-  if (aom_realloc_frame_buffer(&cpi->last_frame_uf, cm->width, cm->height,
-                               cm->subsampling_x, cm->subsampling_y,
-#if CONFIG_HIGHBITDEPTH
-                               cm->use_highbitdepth,
-#endif
-                               AOM_BORDER_IN_PIXELS, cm->byte_alignment, NULL,
-                               NULL, NULL))
-    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
-                       "Failed to allocate last frame buffer");
-
 #if CONFIG_LOOP_RESTORATION
   if (aom_realloc_frame_buffer(&cpi->last_frame_db, cm->width, cm->height,
                                cm->subsampling_x, cm->subsampling_y,
@@ -2595,6 +2591,20 @@ void av1_remove_compressor(AV1_COMP *cpi) {
       fclose(f);
     }
 
+    {
+      // The load of each worker of the job queues kept across frames, to
+      // check how evenly the work stealing balances them.
+      FILE *f = fopen("jobs.stt", "a");
+      fprintf(f, "Queue\tWorker\tBusyMs\tIdleMs\tJobs\tSteals\n");
+      av1_print_job_stats(f, "tiles", &cpi->tile_queue);
+      av1_print_job_stats(f, "loopfilter", &cpi->lf_row_sync.job_queue);
+      if (cpi->lpf_sync != NULL)
+        av1_print_job_stats(f, "lpfsearch", &cpi->lpf_sync->job_queue);
+#if CONFIG_LOOP_RESTORATION
+      av1_print_job_stats(f, "restoration", &cpi->lr_sync.job_queue);
+#endif  // CONFIG_LOOP_RESTORATION
+      fclose(f);
+    }
 #endif
 
 #if 0
@@ -2609,6 +2619,8 @@ void av1_remove_compressor(AV1_COMP *cpi) {
 #endif
   }
 
+  av1_row_mt_mem_dealloc(cpi);
+
   for (t = 0; t < cpi->num_workers; ++t) {
     AVxWorker *const worker = &cpi->workers[t];
     EncWorkerData *const thread_data = &cpi->tile_thr_data[t];
@@ -2617,7 +2629,7 @@ void av1_remove_compressor(AV1_COMP *cpi) {
     aom_get_worker_interface()->end(worker);
 
     // Deallocate allocated thread data.
-    if (t < cpi->num_workers - 1) {
+    if (thread_data->td != &cpi->td) {
 #if CONFIG_PALETTE
       if (cpi->common.allow_screen_content_tools)
         aom_free(thread_data->td->palette_buffer);
@@ -2635,8 +2647,13 @@ void av1_remove_compressor(AV1_COMP *cpi) {
   }
   aom_free(cpi->tile_thr_data);
   aom_free(cpi->workers);
+  aom_job_queue_free(&cpi->tile_queue);
 
   if (cpi->num_workers > 1) av1_loop_filter_dealloc(&cpi->lf_row_sync);
+  av1_post_filter_dealloc(&cpi->post_filter_sync);
+#if CONFIG_LOOP_RESTORATION
+  av1_loop_restoration_dealloc(&cpi->lr_sync);
+#endif  // CONFIG_LOOP_RESTORATION
 
   dealloc_compressor_data(cpi);
 
@@ -3869,10 +3886,15 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
   } else {
     // Find cm->dering_level, cm->clpf_strength_u and cm->clpf_strength_v
     av1_cdef_search(cm->frame_to_show, cpi->source, cm, xd,
-                    cpi->oxcf.speed > 0);
+                    cpi->oxcf.speed > 0, cpi->sf.cdef_early_exit, cpi->workers,
+                    cpi->num_workers);
 
     // Apply the filter
-    av1_cdef_frame(cm->frame_to_show, cm, xd);
+    if (cpi->num_workers > 1)
+      av1_post_filter_frame(cm->frame_to_show, cm, xd, 0, 1, 0, cpi->workers,
+                            cpi->num_workers, &cpi->post_filter_sync);
+    else
+      av1_cdef_frame(cm->frame_to_show, cm, xd);
   }
 #endif
 
@@ -3885,7 +3907,12 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
   if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
       cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
       cm->rst_info[2].frame_restoration_type != RESTORE_NONE) {
-    av1_loop_restoration_frame(cm->frame_to_show, cm, cm->rst_info, 7, 0, NULL);
+    if (cpi->num_workers > 1)
+      av1_loop_restoration_frame_mt(cm->frame_to_show, cm, cpi->workers,
+                                    cpi->num_workers, &cpi->lr_sync);
+    else
+      av1_loop_restoration_frame(cm->frame_to_show, cm, cm->rst_info, 7, 0,
+                                 NULL);
   }
 #endif  // CONFIG_LOOP_RESTORATION
   // TODO(debargha): Fix mv search range on encoder side
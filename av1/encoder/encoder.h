@@ -30,6 +30,7 @@
 #include "av1/encoder/av1_quantize.h"
 #include "av1/encoder/context_tree.h"
 #include "av1/encoder/encodemb.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/firstpass.h"
 #include "av1/encoder/lookahead.h"
 #include "av1/encoder/mbgraph.h"
@@ -265,6 +266,13 @@ typedef struct AV1EncoderConfig {
 #endif  // CONFIG_LOOPFILTERING_ACROSS_TILES
 
   int max_threads;
+  // Encode the superblock rows of a tile on multiple threads.
+  int row_mt;
+  // Index in the sequence of the first frame of the chunk coded by the first
+  // pass, or 0 for the whole sequence. See AV1E_SET_FIRST_PASS_CHUNK_START.
+  int first_pass_chunk_start;
+  // Number of frames coded before the chunk to build up its references.
+  int first_pass_chunk_warmup;
 
   aom_fixed_buf_t two_pass_stats_in;
   struct aom_codec_pkt_list *output_pkt_list;
@@ -320,6 +328,9 @@ typedef struct TileDataEnc {
 #if CONFIG_EC_ADAPT
   DECLARE_ALIGNED(16, FRAME_CONTEXT, tctx);
 #endif
+  // Row based multi-threading
+  AV1RowSync row_mt_sync;
+  unsigned int *row_tok_count;
 } TileDataEnc;
 
 typedef struct RD_COUNTS {
@@ -429,7 +440,8 @@ typedef struct AV1_COMP {
   int ext_refresh_frame_context_pending;
   int ext_refresh_frame_context;
 
-  YV12_BUFFER_CONFIG last_frame_uf;
+  // Scratch data of the filter level search.
+  struct AV1LpfSync *lpf_sync;
 #if CONFIG_LOOP_RESTORATION
   YV12_BUFFER_CONFIG last_frame_db;
   YV12_BUFFER_CONFIG trial_frame_rst;
@@ -629,7 +641,17 @@ typedef struct AV1_COMP {
   int num_workers;
   AVxWorker *workers;
   struct EncWorkerData *tile_thr_data;
+  // Tile jobs of av1_encode_tiles_mt(), with per-worker busy/idle counters.
+  AVxJobQueue tile_queue;
   AV1LfSync lf_row_sync;
+  AV1PostFilterSync post_filter_sync;
+#if CONFIG_LOOP_RESTORATION
+  AV1LrSync lr_sync;
+#endif  // CONFIG_LOOP_RESTORATION
+  AV1RowMTInfo row_mt_info;
+  AV1FpRowMT fp_row_mt;
+  void (*row_mt_sync_read_ptr)(AV1RowSync *const, int, int);
+  void (*row_mt_sync_write_ptr)(AV1RowSync *const, int, int, const int);
 #if CONFIG_ANS
   struct BufAnsCoder buf_ans;
 #endif
@@ -776,6 +798,14 @@ static INLINE unsigned int allocated_tokens(TileInfo tile) {
   return get_token_alloc(tile_mb_rows, tile_mb_cols);
 }
 
+// Get the offset of the tokens of the superblock row starting at mi_row from
+// the start of the tile tokens. Superblock rows are aligned to whole
+// macroblocks, so the tokens of the rows above add up exactly.
+static INLINE unsigned int get_sb_row_tok_offset(TileInfo tile, int mi_row) {
+  tile.mi_row_end = mi_row;
+  return allocated_tokens(tile);
+}
+
 void av1_alloc_compressor_data(AV1_COMP *cpi);
 
 void av1_scale_references(AV1_COMP *cpi);
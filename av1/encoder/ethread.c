@@ -44,13 +44,13 @@ static int enc_worker_hook(EncWorkerData *const thread_data, void *unused) {
   AV1_COMP *const cpi = thread_data->cpi;
   const AV1_COMMON *const cm = &cpi->common;
   const int tile_cols = cm->tile_cols;
-  const int tile_rows = cm->tile_rows;
   int t;
 
   (void)unused;
 
-  for (t = thread_data->start; t < tile_rows * tile_cols;
-       t += cpi->num_workers) {
+  // Tiles are handed out by the shared job queue so that workers done with
+  // cheap tiles pick up the remaining work of the others.
+  while (aom_job_queue_pop(&cpi->tile_queue, thread_data->start, &t)) {
     int tile_row = t / tile_cols;
     int tile_col = t % tile_cols;
 
@@ -60,97 +60,110 @@ static int enc_worker_hook(EncWorkerData *const thread_data, void *unused) {
   return 0;
 }
 
-void av1_encode_tiles_mt(AV1_COMP *cpi) {
+// Create a worker per thread and allocate the thread data, once for the
+// whole encode. Each multi-threaded stage uses as many of the workers as it
+// has jobs for, so the pool must not be sized by the stage that runs first.
+static void create_enc_workers(AV1_COMP *cpi) {
   AV1_COMMON *const cm = &cpi->common;
-  const int tile_cols = cm->tile_cols;
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
-  const int num_workers = AOMMIN(cpi->oxcf.max_threads, tile_cols);
+  const int num_workers = AOMMAX(cpi->oxcf.max_threads, 1);
   int i;
 
-  av1_init_tile_data(cpi);
+  if (cpi->num_workers > 0) return;
 
-  // Only run once to create threads and allocate thread data.
-  if (cpi->num_workers == 0) {
-    CHECK_MEM_ERROR(cm, cpi->workers,
-                    aom_malloc(num_workers * sizeof(*cpi->workers)));
+  CHECK_MEM_ERROR(cm, cpi->workers,
+                  aom_malloc(num_workers * sizeof(*cpi->workers)));
 
-    CHECK_MEM_ERROR(cm, cpi->tile_thr_data,
-                    aom_calloc(num_workers, sizeof(*cpi->tile_thr_data)));
+  CHECK_MEM_ERROR(cm, cpi->tile_thr_data,
+                  aom_calloc(num_workers, sizeof(*cpi->tile_thr_data)));
 
-    for (i = 0; i < num_workers; i++) {
-      AVxWorker *const worker = &cpi->workers[i];
-      EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+  if (!aom_job_queue_alloc(&cpi->tile_queue, num_workers))
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate tile job queue");
 
-      ++cpi->num_workers;
-      winterface->init(worker);
+  for (i = 0; i < num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+
+    ++cpi->num_workers;
+    winterface->init(worker);
 
-      thread_data->cpi = cpi;
+    thread_data->cpi = cpi;
 
-      if (i < num_workers - 1) {
-        // Allocate thread data.
-        CHECK_MEM_ERROR(cm, thread_data->td,
-                        aom_memalign(32, sizeof(*thread_data->td)));
-        av1_zero(*thread_data->td);
+    if (i > 0) {
+      // Allocate thread data.
+      CHECK_MEM_ERROR(cm, thread_data->td,
+                      aom_memalign(32, sizeof(*thread_data->td)));
+      av1_zero(*thread_data->td);
 
-        // Set up pc_tree.
-        thread_data->td->leaf_tree = NULL;
-        thread_data->td->pc_tree = NULL;
-        av1_setup_pc_tree(cm, thread_data->td);
+      // Set up pc_tree.
+      thread_data->td->leaf_tree = NULL;
+      thread_data->td->pc_tree = NULL;
+      av1_setup_pc_tree(cm, thread_data->td);
 
 #if CONFIG_MOTION_VAR
 #if CONFIG_HIGHBITDEPTH
-        int buf_scaler = 2;
+      int buf_scaler = 2;
 #else
-        int buf_scaler = 1;
+      int buf_scaler = 1;
 #endif
-        CHECK_MEM_ERROR(cm, thread_data->td->above_pred_buf,
-                        (uint8_t *)aom_memalign(
-                            16, buf_scaler * MAX_MB_PLANE * MAX_SB_SQUARE *
-                                    sizeof(*thread_data->td->above_pred_buf)));
-        CHECK_MEM_ERROR(cm, thread_data->td->left_pred_buf,
-                        (uint8_t *)aom_memalign(
-                            16, buf_scaler * MAX_MB_PLANE * MAX_SB_SQUARE *
-                                    sizeof(*thread_data->td->left_pred_buf)));
-        CHECK_MEM_ERROR(
-            cm, thread_data->td->wsrc_buf,
-            (int32_t *)aom_memalign(
-                16, MAX_SB_SQUARE * sizeof(*thread_data->td->wsrc_buf)));
-        CHECK_MEM_ERROR(
-            cm, thread_data->td->mask_buf,
-            (int32_t *)aom_memalign(
-                16, MAX_SB_SQUARE * sizeof(*thread_data->td->mask_buf)));
+      CHECK_MEM_ERROR(cm, thread_data->td->above_pred_buf,
+                      (uint8_t *)aom_memalign(
+                          16, buf_scaler * MAX_MB_PLANE * MAX_SB_SQUARE *
+                                  sizeof(*thread_data->td->above_pred_buf)));
+      CHECK_MEM_ERROR(cm, thread_data->td->left_pred_buf,
+                      (uint8_t *)aom_memalign(
+                          16, buf_scaler * MAX_MB_PLANE * MAX_SB_SQUARE *
+                                  sizeof(*thread_data->td->left_pred_buf)));
+      CHECK_MEM_ERROR(
+          cm, thread_data->td->wsrc_buf,
+          (int32_t *)aom_memalign(
+              16, MAX_SB_SQUARE * sizeof(*thread_data->td->wsrc_buf)));
+      CHECK_MEM_ERROR(
+          cm, thread_data->td->mask_buf,
+          (int32_t *)aom_memalign(
+              16, MAX_SB_SQUARE * sizeof(*thread_data->td->mask_buf)));
 #endif
-        // Allocate frame counters in thread data.
-        CHECK_MEM_ERROR(cm, thread_data->td->counts,
-                        aom_calloc(1, sizeof(*thread_data->td->counts)));
+      // Allocate frame counters in thread data.
+      CHECK_MEM_ERROR(cm, thread_data->td->counts,
+                      aom_calloc(1, sizeof(*thread_data->td->counts)));
 
 #if CONFIG_PALETTE
-        // Allocate buffers used by palette coding mode.
-        if (cpi->common.allow_screen_content_tools) {
-          CHECK_MEM_ERROR(
-              cm, thread_data->td->palette_buffer,
-              aom_memalign(16, sizeof(*thread_data->td->palette_buffer)));
-        }
-#endif  // CONFIG_PALETTE
-
-        // Create threads
-        if (!winterface->reset(worker))
-          aom_internal_error(&cm->error, AOM_CODEC_ERROR,
-                             "Tile encoder thread creation failed");
-      } else {
-        // Main thread acts as a worker and uses the thread data in cpi.
-        thread_data->td = &cpi->td;
+      // Allocate buffers used by palette coding mode.
+      if (cpi->common.allow_screen_content_tools) {
+        CHECK_MEM_ERROR(
+            cm, thread_data->td->palette_buffer,
+            aom_memalign(16, sizeof(*thread_data->td->palette_buffer)));
       }
+#endif  // CONFIG_PALETTE
+    } else {
+      // Every stage runs the first worker, so it uses the thread data in cpi,
+      // which is read back after the stage.
+      thread_data->td = &cpi->td;
+    }
 
-      winterface->sync(worker);
+    // The last worker only ever runs on the calling thread, when a stage
+    // uses all of them.
+    if (i < num_workers - 1) {
+      // Create threads
+      if (!winterface->reset(worker))
+        aom_internal_error(&cm->error, AOM_CODEC_ERROR,
+                           "Tile encoder thread creation failed");
     }
+
+    winterface->sync(worker);
   }
+}
+
+static void prepare_enc_workers(AV1_COMP *cpi, AVxWorkerHook hook,
+                                int num_workers) {
+  int i;
 
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
     EncWorkerData *thread_data;
 
-    worker->hook = (AVxWorkerHook)enc_worker_hook;
+    worker->hook = hook;
     worker->data1 = &cpi->tile_thr_data[i];
     worker->data2 = NULL;
     thread_data = (EncWorkerData *)worker->data1;
@@ -172,12 +185,16 @@ void av1_encode_tiles_mt(AV1_COMP *cpi) {
     }
 
 #if CONFIG_PALETTE
-    if (cpi->common.allow_screen_content_tools && i < num_workers - 1)
+    if (cpi->common.allow_screen_content_tools && thread_data->td != &cpi->td)
       thread_data->td->mb.palette_buffer = thread_data->td->palette_buffer;
 #endif  // CONFIG_PALETTE
   }
+}
+
+static void launch_enc_workers(AV1_COMP *cpi, int num_workers) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  int i;
 
-  // Encode a frame
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
     EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
@@ -185,24 +202,33 @@ void av1_encode_tiles_mt(AV1_COMP *cpi) {
     // Set the starting tile for each thread.
     thread_data->start = i;
 
-    if (i == cpi->num_workers - 1)
+    if (i == num_workers - 1)
       winterface->execute(worker);
     else
       winterface->launch(worker);
   }
+}
+
+static void sync_enc_workers(AV1_COMP *cpi, int num_workers) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  int i;
 
-  // Encoding ends.
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
     winterface->sync(worker);
   }
+}
+
+static void accumulate_counters_enc_workers(AV1_COMP *cpi, int num_workers) {
+  AV1_COMMON *const cm = &cpi->common;
+  int i;
 
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
     EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
 
     // Accumulate counters.
-    if (i < cpi->num_workers - 1) {
+    if (thread_data->td != &cpi->td) {
       av1_accumulate_frame_counts(&cm->counts, thread_data->td->counts);
       accumulate_rd_opt(&cpi->td, thread_data->td);
 #if CONFIG_VAR_TX
@@ -211,3 +237,311 @@ void av1_encode_tiles_mt(AV1_COMP *cpi) {
     }
   }
 }
+
+void av1_encode_tiles_mt(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int tile_cols = cm->tile_cols;
+  const int num_tiles = cm->tile_rows * tile_cols;
+  int num_workers;
+
+  av1_init_tile_data(cpi);
+
+  create_enc_workers(cpi);
+  num_workers = AOMMIN(cpi->num_workers, num_tiles);
+
+  prepare_enc_workers(cpi, (AVxWorkerHook)enc_worker_hook, num_workers);
+  aom_job_queue_reset(&cpi->tile_queue, num_workers, num_tiles);
+  launch_enc_workers(cpi, num_workers);
+  sync_enc_workers(cpi, num_workers);
+  aom_job_queue_finish(&cpi->tile_queue);
+  accumulate_counters_enc_workers(cpi, num_workers);
+}
+
+// Every superblock uses the above-right superblock for prediction, so a row
+// may start on a superblock only once the row above has finished the next
+// one.
+#define ROW_MT_SYNC_RANGE 1
+
+void av1_row_mt_sync_read_dummy(AV1RowSync *const row_mt_sync, int r, int c) {
+  (void)row_mt_sync;
+  (void)r;
+  (void)c;
+}
+
+void av1_row_mt_sync_write_dummy(AV1RowSync *const row_mt_sync, int r, int c,
+                                 const int cols) {
+  (void)row_mt_sync;
+  (void)r;
+  (void)c;
+  (void)cols;
+}
+
+void av1_row_mt_tiles_dealloc(AV1_COMP *cpi) {
+  int i;
+
+  if (cpi->tile_data == NULL) return;
+
+  for (i = 0; i < cpi->allocated_tiles; ++i) {
+    TileDataEnc *const tile_data = &cpi->tile_data[i];
+    av1_row_sync_dealloc(&tile_data->row_mt_sync);
+    aom_free(tile_data->row_tok_count);
+    tile_data->row_tok_count = NULL;
+  }
+}
+
+void av1_row_mt_mem_dealloc(AV1_COMP *cpi) {
+  int i;
+
+  av1_row_mt_tiles_dealloc(cpi);
+
+  for (i = 0; i < cpi->num_workers; ++i) {
+    aom_free(cpi->tile_thr_data[i].row_data);
+    cpi->tile_thr_data[i].row_data = NULL;
+  }
+
+#if CONFIG_MULTITHREAD
+  if (cpi->row_mt_info.job_mutex_ != NULL) {
+    pthread_mutex_destroy(cpi->row_mt_info.job_mutex_);
+    aom_free(cpi->row_mt_info.job_mutex_);
+  }
+#endif  // CONFIG_MULTITHREAD
+  av1_zero(cpi->row_mt_info);
+}
+
+static void alloc_row_mt_job_mutex(AV1_COMP *cpi) {
+#if CONFIG_MULTITHREAD
+  AV1_COMMON *const cm = &cpi->common;
+
+  if (cpi->row_mt_info.job_mutex_ == NULL) {
+    CHECK_MEM_ERROR(cm, cpi->row_mt_info.job_mutex_,
+                    aom_malloc(sizeof(*cpi->row_mt_info.job_mutex_)));
+    pthread_mutex_init(cpi->row_mt_info.job_mutex_, NULL);
+  }
+#else
+  (void)cpi;
+#endif  // CONFIG_MULTITHREAD
+}
+
+static int get_next_row_mt_job(AV1RowMTInfo *const row_mt_info, int *job) {
+  int found = 0;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(row_mt_info->job_mutex_);
+#endif
+  if (row_mt_info->next_job < row_mt_info->num_jobs) {
+    *job = row_mt_info->next_job++;
+    found = 1;
+  }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(row_mt_info->job_mutex_);
+#endif
+  return found;
+}
+
+// Superblock rows are handed out in raster order across the tiles of a tile
+// row. A row only waits on rows above it, which have already been picked up
+// by running workers, so the wavefront cannot deadlock.
+static int enc_row_mt_worker_hook(EncWorkerData *const thread_data,
+                                  void *unused) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const AV1_COMMON *const cm = &cpi->common;
+  const int tile_cols = cm->tile_cols;
+  const int tile_row = cpi->row_mt_info.tile_row;
+  int job;
+
+  (void)unused;
+
+  while (get_next_row_mt_job(&cpi->row_mt_info, &job)) {
+    const int tile_col = job % tile_cols;
+    const TileInfo *const tile_info =
+        &cpi->tile_data[tile_row * tile_cols + tile_col].tile_info;
+    const int mi_row =
+        tile_info->mi_row_start + (job / tile_cols) * cm->mib_size;
+
+    av1_encode_sb_row(cpi, thread_data->td, thread_data->row_data, tile_row,
+                      tile_col, mi_row);
+  }
+
+  return 1;
+}
+
+// Move the tokens of each superblock row next to the tokens of the row above,
+// giving the same layout as encoding the tile on a single thread.
+static void pack_sb_row_tokens(AV1_COMP *cpi, int tile_row, int tile_col) {
+  AV1_COMMON *const cm = &cpi->common;
+  const TileDataEnc *const this_tile =
+      &cpi->tile_data[tile_row * cm->tile_cols + tile_col];
+  const TileInfo *const tile_info = &this_tile->tile_info;
+  TOKENEXTRA *const tile_tok = cpi->tile_tok[tile_row][tile_col];
+  TOKENEXTRA *tok = tile_tok;
+  int mi_row, sb_row = 0;
+
+  for (mi_row = tile_info->mi_row_start; mi_row < tile_info->mi_row_end;
+       mi_row += cm->mib_size, ++sb_row) {
+    const TOKENEXTRA *const row_tok =
+        tile_tok + get_sb_row_tok_offset(*tile_info, mi_row);
+    const unsigned int count = this_tile->row_tok_count[sb_row];
+
+    if (tok != row_tok) memmove(tok, row_tok, count * sizeof(*tok));
+    tok += count;
+  }
+
+  cpi->tok_count[tile_row][tile_col] = (unsigned int)(tok - tile_tok);
+  assert(cpi->tok_count[tile_row][tile_col] <= allocated_tokens(*tile_info));
+}
+
+void av1_encode_tiles_row_mt(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int tile_cols = cm->tile_cols;
+  const int tile_rows = cm->tile_rows;
+  int max_sb_rows = 0;
+  int num_workers;
+  int tile_row, tile_col, i;
+
+  av1_init_tile_data(cpi);
+
+  create_enc_workers(cpi);
+
+  alloc_row_mt_job_mutex(cpi);
+
+  for (i = 0; i < tile_rows * tile_cols; ++i) {
+    TileDataEnc *const this_tile = &cpi->tile_data[i];
+    const TileInfo *const tile_info = &this_tile->tile_info;
+    const int sb_rows =
+        (tile_info->mi_row_end - tile_info->mi_row_start + cm->mib_size - 1) >>
+        cm->mib_size_log2;
+
+    if (this_tile->row_mt_sync.rows != sb_rows) {
+      av1_row_sync_dealloc(&this_tile->row_mt_sync);
+      aom_free(this_tile->row_tok_count);
+      av1_row_sync_alloc(&this_tile->row_mt_sync, cm, sb_rows,
+                         ROW_MT_SYNC_RANGE);
+      CHECK_MEM_ERROR(cm, this_tile->row_tok_count,
+                      aom_calloc(sb_rows, sizeof(*this_tile->row_tok_count)));
+    }
+    av1_row_sync_reset(&this_tile->row_mt_sync, sb_rows);
+    max_sb_rows = AOMMAX(max_sb_rows, sb_rows);
+  }
+
+  num_workers = AOMMIN(cpi->num_workers, max_sb_rows * tile_cols);
+  for (i = 0; i < num_workers; ++i) {
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+    if (thread_data->row_data == NULL) {
+      CHECK_MEM_ERROR(cm, thread_data->row_data,
+                      aom_memalign(32, sizeof(*thread_data->row_data)));
+    }
+  }
+
+  prepare_enc_workers(cpi, (AVxWorkerHook)enc_row_mt_worker_hook,
+                      num_workers);
+
+  // The tiles of a tile row share the above context arrays with the tiles
+  // below them, so the tile rows are encoded one after another.
+  for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
+    const TileInfo *const tile_info =
+        &cpi->tile_data[tile_row * tile_cols].tile_info;
+    const int sb_rows =
+        (tile_info->mi_row_end - tile_info->mi_row_start + cm->mib_size - 1) >>
+        cm->mib_size_log2;
+
+    for (tile_col = 0; tile_col < tile_cols; ++tile_col)
+      av1_encode_tile_init(cpi, tile_row, tile_col);
+
+    cpi->row_mt_info.tile_row = tile_row;
+    cpi->row_mt_info.next_job = 0;
+    cpi->row_mt_info.num_jobs = sb_rows * tile_cols;
+
+    launch_enc_workers(cpi, AOMMIN(num_workers, sb_rows * tile_cols));
+    sync_enc_workers(cpi, AOMMIN(num_workers, sb_rows * tile_cols));
+
+    for (tile_col = 0; tile_col < tile_cols; ++tile_col)
+      pack_sb_row_tokens(cpi, tile_row, tile_col);
+  }
+
+  accumulate_counters_enc_workers(cpi, num_workers);
+}
+
+void av1_fp_row_mt_dealloc(AV1_COMP *cpi) {
+  AV1FpRowMT *const fp_row_mt = &cpi->fp_row_mt;
+
+  av1_row_sync_dealloc(&fp_row_mt->row_mt_sync);
+  aom_free(fp_row_mt->mi_grid);
+  aom_free(fp_row_mt->mi);
+  av1_zero(*fp_row_mt);
+}
+
+// Macroblock rows of the first pass, handed out in raster order.
+static int fp_row_mt_worker_hook(EncWorkerData *const thread_data,
+                                 FIRSTPASS_ROW_STATS *const row_stats) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  int mb_row;
+
+  while (get_next_row_mt_job(&cpi->row_mt_info, &mb_row))
+    av1_first_pass_row(cpi, &thread_data->td->mb, mb_row, &row_stats[mb_row],
+                       &cpi->fp_row_mt.row_mt_sync);
+
+  return 1;
+}
+
+void av1_first_pass_row_mt(AV1_COMP *cpi, FIRSTPASS_ROW_STATS *row_stats) {
+  AV1_COMMON *const cm = &cpi->common;
+  AV1FpRowMT *const fp_row_mt = &cpi->fp_row_mt;
+  const int grid_size = cm->mi_stride + 1;
+  int num_workers;
+  int i;
+
+  create_enc_workers(cpi);
+  num_workers = AOMMIN(cpi->num_workers, cm->mb_rows);
+
+  alloc_row_mt_job_mutex(cpi);
+
+  if (fp_row_mt->row_mt_sync.rows != cm->mb_rows) {
+    av1_row_sync_dealloc(&fp_row_mt->row_mt_sync);
+    av1_row_sync_alloc(&fp_row_mt->row_mt_sync, cm, cm->mb_rows,
+                       ROW_MT_SYNC_RANGE);
+  }
+  av1_row_sync_reset(&fp_row_mt->row_mt_sync, cm->mb_rows);
+
+  // The first pass codes every macroblock with the one mode info the
+  // macroblock points at, whose above and left neighbours in the grid are
+  // NULL. The main thread uses the frame's, the other workers a copy in a
+  // grid of their own.
+  if (fp_row_mt->grid_size != grid_size) {
+    aom_free(fp_row_mt->mi_grid);
+    aom_free(fp_row_mt->mi);
+    fp_row_mt->mi_grid = NULL;
+    fp_row_mt->grid_size = 0;
+    CHECK_MEM_ERROR(cm, fp_row_mt->mi,
+                    aom_malloc(cpi->num_workers * sizeof(*fp_row_mt->mi)));
+    CHECK_MEM_ERROR(cm, fp_row_mt->mi_grid,
+                    aom_calloc(cpi->num_workers * grid_size,
+                               sizeof(*fp_row_mt->mi_grid)));
+    fp_row_mt->grid_size = grid_size;
+  }
+
+  for (i = 0; i < num_workers; ++i) {
+    AVxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+    ThreadData *const td = thread_data->td;
+
+    worker->hook = (AVxWorkerHook)fp_row_mt_worker_hook;
+    worker->data1 = thread_data;
+    worker->data2 = row_stats;
+
+    if (td != &cpi->td) {
+      MODE_INFO **const grid =
+          fp_row_mt->mi_grid + i * grid_size + cm->mi_stride;
+      td->mb = cpi->td.mb;
+      av1_first_pass_setup_coeff_bufs(td);
+      fp_row_mt->mi[i] = *cpi->td.mb.e_mbd.mi[0];
+      grid[0] = &fp_row_mt->mi[i];
+      td->mb.e_mbd.mi = grid;
+    }
+  }
+
+  cpi->row_mt_info.next_job = 0;
+  cpi->row_mt_info.num_jobs = cm->mb_rows;
+
+  launch_enc_workers(cpi, num_workers);
+  sync_enc_workers(cpi, num_workers);
+}
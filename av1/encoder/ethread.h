@@ -12,21 +12,73 @@
 #ifndef AV1_ENCODER_ETHREAD_H_
 #define AV1_ENCODER_ETHREAD_H_
 
+#include "./aom_config.h"
+#include "aom_util/aom_thread.h"
+#include "av1/common/thread_common.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct AV1_COMP;
+struct AV1Common;
 struct ThreadData;
+struct TileDataEnc;
+struct FIRSTPASS_ROW_STATS;
+struct MODE_INFO;
 
 typedef struct EncWorkerData {
   struct AV1_COMP *cpi;
   struct ThreadData *td;
   int start;
+  // Scratch tile data holding the per superblock row rd state in row based
+  // multi-threading.
+  struct TileDataEnc *row_data;
 } EncWorkerData;
 
+// Superblock row job distribution for row based multi-threading.
+typedef struct AV1RowMTInfo {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *job_mutex_;
+#endif
+  // The tile row whose superblock rows are being encoded.
+  int tile_row;
+  int next_job;
+  int num_jobs;
+} AV1RowMTInfo;
+
+// Scratch of the row based multi-threaded first pass, kept across frames.
+typedef struct AV1FpRowMT {
+  AV1RowSync row_mt_sync;
+  // A mode info per worker, and a grid of mi_stride + 1 entries per worker
+  // pointing at it.
+  struct MODE_INFO *mi;
+  struct MODE_INFO **mi_grid;
+  int grid_size;
+} AV1FpRowMT;
+
+void av1_row_mt_sync_read_dummy(AV1RowSync *const row_mt_sync, int r, int c);
+void av1_row_mt_sync_write_dummy(AV1RowSync *const row_mt_sync, int r, int c,
+                                 const int cols);
+
+// Deallocate the row based multi-threading data attached to the tiles.
+void av1_row_mt_tiles_dealloc(struct AV1_COMP *cpi);
+
+// Deallocate the scratch of the row based multi-threaded first pass.
+void av1_fp_row_mt_dealloc(struct AV1_COMP *cpi);
+
+// Deallocate all row based multi-threading data.
+void av1_row_mt_mem_dealloc(struct AV1_COMP *cpi);
+
 void av1_encode_tiles_mt(struct AV1_COMP *cpi);
 
+void av1_encode_tiles_row_mt(struct AV1_COMP *cpi);
+
+// Code the macroblock rows of the first pass on the encoder workers, leaving
+// the statistics of each row in 'row_stats'.
+void av1_first_pass_row_mt(struct AV1_COMP *cpi,
+                           struct FIRSTPASS_ROW_STATS *row_stats);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -12,6 +12,7 @@
 #ifndef AV1_ENCODER_FIRSTPASS_H_
 #define AV1_ENCODER_FIRSTPASS_H_
 
+#include "av1/common/mv.h"
 #include "av1/encoder/lookahead.h"
 #include "av1/encoder/ratectrl.h"
 
@@ -79,6 +80,36 @@ typedef struct {
   double count;
 } FIRSTPASS_STATS;
 
+// Statistics of one macroblock row of the first pass. The rows are merged in
+// raster order, so the frame statistics do not depend on the number of
+// threads coding the rows.
+typedef struct FIRSTPASS_ROW_STATS {
+  int64_t intra_error;
+  int64_t coded_error;
+  int64_t sr_coded_error;
+  int sum_mvr;
+  int sum_mvc;
+  int sum_mvr_abs;
+  int sum_mvc_abs;
+  int64_t sum_mvrs;
+  int64_t sum_mvcs;
+  int mvcount;
+  int intercount;
+  int second_ref_count;
+  double neutral_count;
+  int intra_skip_count;
+  // Whether the row has a block with image data past the first column.
+  int image_data;
+  // Changes of non zero vector within the row. The first non zero vector is
+  // compared with the last one of the rows above when merging.
+  int new_mv_count;
+  MV first_mv;
+  MV last_mv;
+  int sum_in_vectors;
+  double intra_factor;
+  double brightness_factor;
+} FIRSTPASS_ROW_STATS;
+
 typedef enum {
   KF_UPDATE = 0,
   LF_UPDATE = 1,
@@ -132,6 +163,10 @@ typedef struct {
   double modified_error_left;
   double mb_av_energy;
 
+  // Statistics of each macroblock row of the first pass frame.
+  FIRSTPASS_ROW_STATS *row_stats;
+  int row_stats_rows;
+
 #if CONFIG_FP_MB_STATS
   uint8_t *frame_mb_stats_buf;
   uint8_t *this_frame_mb_stats;
@@ -164,10 +199,24 @@ typedef struct {
 } TWO_PASS;
 
 struct AV1_COMP;
+struct AV1RowSync;
+struct ThreadData;
+struct macroblock;
 
 void av1_init_first_pass(struct AV1_COMP *cpi);
 void av1_rc_get_first_pass_params(struct AV1_COMP *cpi);
 void av1_first_pass(struct AV1_COMP *cpi, const struct lookahead_entry *source);
+
+// Point the coefficient buffers of the first pass macroblock of 'td' at its
+// pick mode context.
+void av1_first_pass_setup_coeff_bufs(struct ThreadData *td);
+
+// Code one macroblock row of the first pass with 'x', once the first pass
+// state of the frame is set up. Each macroblock waits on 'row_mt_sync' for
+// the row above to be reconstructed, unless it is NULL.
+void av1_first_pass_row(struct AV1_COMP *cpi, struct macroblock *x, int mb_row,
+                        FIRSTPASS_ROW_STATS *stats,
+                        struct AV1RowSync *row_mt_sync);
 void av1_end_first_pass(struct AV1_COMP *cpi);
 
 void av1_init_second_pass(struct AV1_COMP *cpi);
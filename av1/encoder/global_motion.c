@@ -24,7 +24,6 @@
 #include "av1/encoder/corner_match.h"
 #include "av1/encoder/ransac.h"
 
-#define MAX_CORNERS 4096
 #define MIN_INLIER_PROB 0.1
 
 #define MIN_TRANS_THRESH (1 * GM_TRANS_DECODE_FACTOR)
@@ -254,43 +253,68 @@ static unsigned char *downconvert_frame(YV12_BUFFER_CONFIG *frm,
 }
 #endif
 
+// Returns the y plane of 'frm' with 8 bits per pixel. The conversion of a
+// high bitdepth frame is cached until the frame is released.
+static unsigned char *get_8bit_y_buffer(YV12_BUFFER_CONFIG *frm,
+                                        int bit_depth) {
+#if CONFIG_HIGHBITDEPTH
+  if (frm->flags & YV12_FLAG_HIGHBITDEPTH) {
+    if (!frm->y_buffer_8bit)
+      frm->y_buffer_8bit = downconvert_frame(frm, bit_depth);
+    return frm->y_buffer_8bit;
+  }
+#else
+  (void)bit_depth;
+#endif
+  return frm->y_buffer;
+}
+
+int compute_frame_corners(YV12_BUFFER_CONFIG *frm,
+#if CONFIG_HIGHBITDEPTH
+                          int bit_depth,
+#endif
+                          int *corners) {
+#if !CONFIG_HIGHBITDEPTH
+  const int bit_depth = 8;
+#endif
+  unsigned char *const buffer = get_8bit_y_buffer(frm, bit_depth);
+  return fast_corner_detect(buffer, frm->y_width, frm->y_height, frm->y_stride,
+                            corners, MAX_CORNERS);
+}
+
 int compute_global_motion_feature_based(
-    TransformationType type, YV12_BUFFER_CONFIG *frm, YV12_BUFFER_CONFIG *ref,
+    TransformationType type, YV12_BUFFER_CONFIG *frm, const int *frm_corners,
+    int num_frm_corners, YV12_BUFFER_CONFIG *ref, const int *ref_corners,
+    int num_ref_corners,
 #if CONFIG_HIGHBITDEPTH
     int bit_depth,
 #endif
     int *num_inliers_by_motion, double *params_by_motion, int num_motions) {
+#if !CONFIG_HIGHBITDEPTH
+  const int bit_depth = 8;
+#endif
   int i;
-  int num_frm_corners, num_ref_corners;
   int num_correspondences;
   int *correspondences;
-  int frm_corners[2 * MAX_CORNERS], ref_corners[2 * MAX_CORNERS];
-  unsigned char *frm_buffer = frm->y_buffer;
-  unsigned char *ref_buffer = ref->y_buffer;
+  int detected_frm_corners[2 * MAX_CORNERS];
+  int detected_ref_corners[2 * MAX_CORNERS];
+  unsigned char *const frm_buffer = get_8bit_y_buffer(frm, bit_depth);
+  unsigned char *const ref_buffer = get_8bit_y_buffer(ref, bit_depth);
   RansacFunc ransac = get_ransac_type(type);
 
-#if CONFIG_HIGHBITDEPTH
-  if (frm->flags & YV12_FLAG_HIGHBITDEPTH) {
-    // The frame buffer is 16-bit, so we need to convert to 8 bits for the
-    // following code. We cache the result until the frame is released.
-    if (frm->y_buffer_8bit)
-      frm_buffer = frm->y_buffer_8bit;
-    else
-      frm_buffer = frm->y_buffer_8bit = downconvert_frame(frm, bit_depth);
+  // compute interest points in images using FAST features
+  if (!frm_corners) {
+    num_frm_corners =
+        fast_corner_detect(frm_buffer, frm->y_width, frm->y_height,
+                           frm->y_stride, detected_frm_corners, MAX_CORNERS);
+    frm_corners = detected_frm_corners;
   }
-  if (ref->flags & YV12_FLAG_HIGHBITDEPTH) {
-    if (ref->y_buffer_8bit)
-      ref_buffer = ref->y_buffer_8bit;
-    else
-      ref_buffer = ref->y_buffer_8bit = downconvert_frame(ref, bit_depth);
+  if (!ref_corners) {
+    num_ref_corners =
+        fast_corner_detect(ref_buffer, ref->y_width, ref->y_height,
+                           ref->y_stride, detected_ref_corners, MAX_CORNERS);
+    ref_corners = detected_ref_corners;
   }
-#endif
-
-  // compute interest points in images using FAST features
-  num_frm_corners = fast_corner_detect(frm_buffer, frm->y_width, frm->y_height,
-                                       frm->y_stride, frm_corners, MAX_CORNERS);
-  num_ref_corners = fast_corner_detect(ref_buffer, ref->y_width, ref->y_height,
-                                       ref->y_stride, ref_corners, MAX_CORNERS);
 
   // find correspondences between the two images
   correspondences =
@@ -21,6 +21,7 @@ extern "C" {
 #endif
 
 #define RANSAC_NUM_MOTIONS 1
+#define MAX_CORNERS 4096
 
 void convert_model_to_params(const double *params, WarpedMotionParams *model);
 
@@ -39,6 +40,15 @@ int64_t refine_integerized_param(WarpedMotionParams *wm,
                                  int d_height, int d_stride, int n_refinements,
                                  int64_t best_frame_error);
 
+// Detects the FAST corners of "frm" into "corners", which should be of length
+// 2 * MAX_CORNERS, and returns their number. A high bitdepth frame is
+// converted to 8 bits, and the conversion is cached in the frame buffer.
+int compute_frame_corners(YV12_BUFFER_CONFIG *frm,
+#if CONFIG_HIGHBITDEPTH
+                          int bit_depth,
+#endif
+                          int *corners);
+
 /*
   Computes "num_motions" candidate global motion parameters between two frames.
   The array "params_by_motion" should be length 8 * "num_motions". The ordering
@@ -53,9 +63,15 @@ int64_t refine_integerized_param(WarpedMotionParams *wm,
   "num_inliers" should be length "num_motions", and will be populated with the
   number of inlier feature points for each motion. Params for which the
   num_inliers entry is 0 should be ignored by the caller.
+
+  "frm_corners" and "ref_corners" are the corners of the frames found by
+  compute_frame_corners(), so that they can be reused across searches, or
+  NULL to detect them here.
 */
 int compute_global_motion_feature_based(
-    TransformationType type, YV12_BUFFER_CONFIG *frm, YV12_BUFFER_CONFIG *ref,
+    TransformationType type, YV12_BUFFER_CONFIG *frm, const int *frm_corners,
+    int num_frm_corners, YV12_BUFFER_CONFIG *ref, const int *ref_corners,
+    int num_ref_corners,
 #if CONFIG_HIGHBITDEPTH
     int bit_depth,
 #endif
@@ -231,7 +231,8 @@ static INLINE uint64_t mse_4x4_16bit(uint16_t *dst, int dstride, uint16_t *src,
   return sum;
 }
 
-/* Compute MSE only on the blocks we filtered. */
+/* Compute MSE only on the blocks we filtered. The result still has to be
+   scaled down by 2 * coeff_shift bits. */
 uint64_t compute_dering_dist(uint16_t *dst, int dstride, uint16_t *src,
                              dering_list *dlist, int dering_count,
                              BLOCK_SIZE bsize, int coeff_shift, int pli) {
@@ -276,33 +277,187 @@ uint64_t compute_dering_dist(uint16_t *dst, int dstride, uint16_t *src,
                            &src[bi << (2 + 2)], 4);
     }
   }
-  return sum >> 2 * coeff_shift;
+  return sum;
 }
 
-void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
-                     AV1_COMMON *cm, MACROBLOCKD *xd, int fast) {
-  int r, c;
-  int sbr, sbc;
+/* Scratch buffers of one worker of the search. */
+typedef struct {
+  DECLARE_ALIGNED(32, uint16_t, inbuf[OD_DERING_INBUF_SIZE]);
+  /* Copy of inbuf receiving the deringing output with the early exit */
+  DECLARE_ALIGNED(32, uint16_t, dering_buf[OD_DERING_INBUF_SIZE]);
+  DECLARE_ALIGNED(32, uint16_t, tmp_dst[MAX_SB_SQUARE]);
+  dering_list dlist[MAX_MIB_SIZE * MAX_MIB_SIZE];
+  int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS];
+  int var[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS];
+} CdefSearchScratch;
+
+/* State shared by the workers filling in the mse table. Each job is one of
+   the superblocks that are not all skip, and fills in its row of the table. */
+typedef struct {
+  const AV1_COMMON *cm;
   uint16_t *src[3];
   uint16_t *ref_coeff[3];
-  dering_list dlist[MAX_MIB_SIZE * MAX_MIB_SIZE];
-  int dir[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS] = { { 0 } };
-  int var[OD_DERING_NBLOCKS][OD_DERING_NBLOCKS] = { { 0 } };
   int stride[3];
   int bsize[3];
   int mi_wide_l2[3];
   int mi_high_l2[3];
   int xdec[3];
   int ydec[3];
+  int nvsb;
+  int nhsb;
+  int nplanes;
+  int coeff_shift;
+  int clpf_damping;
+  int dering_damping;
+  int chroma_dering;
+  int fast;
+  int early_exit;
+  /* sbr * nhsb + sbc of the superblock of each job */
+  const int *sb_pos;
+  uint64_t (*mse[2])[TOTAL_STRENGTHS];
+  CdefSearchScratch *scratch;
+  AVxJobQueue job_queue;
+} CdefSearchSync;
+
+/* Number of blocks filtered at a time when the early exit is enabled. */
+#define EARLY_EXIT_BLOCKS 8
+
+/* Fill in the mse of every strength for the superblock of job 'job'. */
+static void search_sb(const CdefSearchSync *const s,
+                      CdefSearchScratch *const scratch, int job) {
+  const AV1_COMMON *const cm = s->cm;
+  const int sbr = s->sb_pos[job] / s->nhsb;
+  const int sbc = s->sb_pos[job] % s->nhsb;
+  const int nhb = AOMMIN(MAX_MIB_SIZE, cm->mi_cols - MAX_MIB_SIZE * sbc);
+  const int nvb = AOMMIN(MAX_MIB_SIZE, cm->mi_rows - MAX_MIB_SIZE * sbr);
+  const int total_strengths =
+      s->fast ? REDUCED_TOTAL_STRENGTHS : TOTAL_STRENGTHS;
+  uint16_t *const in =
+      scratch->inbuf + OD_FILT_VBORDER * OD_FILT_BSTRIDE + OD_FILT_HBORDER;
+  uint16_t *const dering_in =
+      scratch->dering_buf + OD_FILT_VBORDER * OD_FILT_BSTRIDE + OD_FILT_HBORDER;
+  dering_list *const dlist = scratch->dlist;
+  const int dering_count = sb_compute_dering_list(
+      cm, sbr * MAX_MIB_SIZE, sbc * MAX_MIB_SIZE, dlist, 1);
+  int dirinit = 0;
+  int pli, gi, i;
+
+  for (pli = 0; pli < s->nplanes; pli++) {
+    uint64_t plane_mse[TOTAL_STRENGTHS];
+    uint64_t best_mse = (uint64_t)1 << 63;
+    uint16_t *clpf_in = in;
+    int dering_done = 1;
+    /* Without chroma deringing, all the thresholds filter the chroma the same
+       way. */
+    const int num_filtered = pli > 0 && !s->chroma_dering ? CLPF_STRENGTHS
+                                                          : total_strengths;
+    const int block_l2 = 6 - s->xdec[pli] - s->ydec[pli];
+    /* We avoid filtering the pixels for which some of the pixels to average
+       are outside the frame. We could change the filter instead, but it would
+       add special cases for any future vectorization. */
+    const int yoff = OD_FILT_VBORDER * (sbr != 0);
+    const int xoff = OD_FILT_HBORDER * (sbc != 0);
+    const int ysize = (nvb << s->mi_high_l2[pli]) +
+                      OD_FILT_VBORDER * (sbr != s->nvsb - 1) + yoff;
+    const int xsize = (nhb << s->mi_wide_l2[pli]) +
+                      OD_FILT_HBORDER * (sbc != s->nhsb - 1) + xoff;
+    uint16_t *const ref =
+        s->ref_coeff[pli] +
+        (sbr * MAX_MIB_SIZE << s->mi_high_l2[pli]) * s->stride[pli] +
+        (sbc * MAX_MIB_SIZE << s->mi_wide_l2[pli]);
+
+    for (i = 0; i < OD_DERING_INBUF_SIZE; i++)
+      scratch->inbuf[i] = OD_DERING_VERY_LARGE;
+    for (gi = 0; gi < num_filtered; gi++) {
+      const int clpf_strength = gi % CLPF_STRENGTHS;
+      int threshold = gi / CLPF_STRENGTHS;
+      int chunk = AOMMAX(dering_count, 1);
+      uint64_t curr_mse = 0;
+      int bi;
+      if (s->fast) threshold = priconv[threshold];
+      if (pli > 0 && !s->chroma_dering) threshold = 0;
+      if (clpf_strength == 0) {
+        copy_sb16_16(&in[(-yoff * OD_FILT_BSTRIDE - xoff)], OD_FILT_BSTRIDE,
+                     s->src[pli],
+                     (sbr * MAX_MIB_SIZE << s->mi_high_l2[pli]) - yoff,
+                     (sbc * MAX_MIB_SIZE << s->mi_wide_l2[pli]) - xoff,
+                     s->stride[pli], ysize, xsize);
+        clpf_in = in;
+        /* The deringing leaves its output in 'in' for the clpf strengths
+           with the same threshold. To filter a few blocks at a time, that
+           output goes to a copy of 'in' instead, so that the later blocks
+           are still deringed from unfiltered neighbours. */
+        if (s->early_exit && threshold) {
+          memcpy(scratch->dering_buf, scratch->inbuf,
+                 sizeof(scratch->dering_buf));
+          clpf_in = dering_in;
+          chunk = EARLY_EXIT_BLOCKS;
+        }
+      } else if (!dering_done) {
+        /* There is nothing to apply the clpf to. */
+        plane_mse[gi] = plane_mse[gi - clpf_strength];
+        continue;
+      } else if (s->early_exit) {
+        chunk = EARLY_EXIT_BLOCKS;
+      }
+      /* With the early exit, a strength is given up on as soon as its mse
+         exceeds the best one of the superblock so far. Its entry is then
+         left at the partial mse. */
+      for (bi = 0; bi < dering_count &&
+                   curr_mse >> 2 * s->coeff_shift <= best_mse;
+           bi += chunk) {
+        const int count = AOMMIN(chunk, dering_count - bi);
+        uint16_t *const dst = scratch->tmp_dst + (bi << block_l2);
+        od_dering(clpf_strength ? NULL : (uint8_t *)clpf_in, OD_FILT_BSTRIDE,
+                  dst, clpf_strength ? clpf_in : in, s->xdec[pli],
+                  s->ydec[pli], scratch->dir, &dirinit, scratch->var, pli,
+                  dlist + bi, count, threshold,
+                  clpf_strength + (clpf_strength == 3), s->clpf_damping,
+                  s->dering_damping, s->coeff_shift, clpf_strength != 0, 1);
+        curr_mse +=
+            compute_dering_dist(ref, s->stride[pli], dst, dlist + bi, count,
+                                s->bsize[pli], s->coeff_shift, pli);
+      }
+      if (clpf_strength == 0) dering_done = bi >= dering_count;
+      plane_mse[gi] = curr_mse >> 2 * s->coeff_shift;
+      if (plane_mse[gi] < best_mse) best_mse = plane_mse[gi];
+    }
+    for (; gi < total_strengths; gi++)
+      plane_mse[gi] = plane_mse[gi % CLPF_STRENGTHS];
+
+    for (gi = 0; gi < total_strengths; gi++) {
+      if (pli < 2)
+        s->mse[pli][job][gi] = plane_mse[gi];
+      else
+        s->mse[1][job][gi] += plane_mse[gi];
+    }
+  }
+}
+
+static int cdef_search_worker(CdefSearchSync *const s,
+                              CdefSearchScratch *const scratch) {
+  const int worker = (int)(scratch - s->scratch);
+  int job;
+  while (aom_job_queue_pop(&s->job_queue, worker, &job))
+    search_sb(s, scratch, job);
+  return 1;
+}
+
+void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
+                     AV1_COMMON *cm, MACROBLOCKD *xd, int fast, int early_exit,
+                     AVxWorker *workers, int num_workers) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  CdefSearchSync s;
+  int r, c;
+  int sbr, sbc;
   int pli;
-  int dering_count;
-  int coeff_shift = AOMMAX(cm->bit_depth - 8, 0);
   uint64_t best_tot_mse = (uint64_t)1 << 63;
   uint64_t tot_mse;
   int sb_count;
   int nvsb = (cm->mi_rows + MAX_MIB_SIZE - 1) / MAX_MIB_SIZE;
   int nhsb = (cm->mi_cols + MAX_MIB_SIZE - 1) / MAX_MIB_SIZE;
   int *sb_index = aom_malloc(nvsb * nhsb * sizeof(*sb_index));
+  int *sb_pos = aom_malloc(nvsb * nhsb * sizeof(*sb_pos));
   int *selected_strength = aom_malloc(nvsb * nhsb * sizeof(*sb_index));
   uint64_t(*mse[2])[TOTAL_STRENGTHS];
   int clpf_damping = 3 + (cm->base_qindex >> 6);
@@ -313,13 +468,6 @@ void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
   int quantizer;
   double lambda;
   int nplanes = 3;
-  const int total_strengths = fast ? REDUCED_TOTAL_STRENGTHS : TOTAL_STRENGTHS;
-  DECLARE_ALIGNED(32, uint16_t, inbuf[OD_DERING_INBUF_SIZE]);
-  uint16_t *in;
-  DECLARE_ALIGNED(32, uint16_t, tmp_dst[MAX_SB_SQUARE]);
-  int chroma_dering =
-      xd->plane[1].subsampling_x == xd->plane[1].subsampling_y &&
-      xd->plane[2].subsampling_x == xd->plane[2].subsampling_y;
   quantizer =
       av1_ac_quant(cm->base_qindex, 0, cm->bit_depth) >> (cm->bit_depth - 8);
   lambda = .12 * quantizer * quantizer / 256.;
@@ -327,9 +475,26 @@ void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
   av1_setup_dst_planes(xd->plane, cm->sb_size, frame, 0, 0);
   mse[0] = aom_malloc(sizeof(**mse) * nvsb * nhsb);
   mse[1] = aom_malloc(sizeof(**mse) * nvsb * nhsb);
+  memset(&s, 0, sizeof(s));
+  s.cm = cm;
+  s.nvsb = nvsb;
+  s.nhsb = nhsb;
+  s.nplanes = nplanes;
+  s.coeff_shift = AOMMAX(cm->bit_depth - 8, 0);
+  s.clpf_damping = clpf_damping;
+  s.dering_damping = dering_damping;
+  s.chroma_dering = xd->plane[1].subsampling_x == xd->plane[1].subsampling_y &&
+                    xd->plane[2].subsampling_x == xd->plane[2].subsampling_y;
+  s.fast = fast;
+  s.early_exit = early_exit;
+  s.sb_pos = sb_pos;
+  s.mse[0] = mse[0];
+  s.mse[1] = mse[1];
   for (pli = 0; pli < nplanes; pli++) {
     uint8_t *ref_buffer;
     int ref_stride;
+    uint16_t *src, *ref_coeff;
+    const int stride = cm->mi_cols << MI_SIZE_LOG2;
     switch (pli) {
       case 0:
         ref_buffer = ref->y_buffer;
@@ -344,17 +509,17 @@ void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
         ref_stride = ref->uv_stride;
         break;
     }
-    src[pli] = aom_memalign(
+    src = s.src[pli] = aom_memalign(
         32, sizeof(*src) * cm->mi_rows * cm->mi_cols * MI_SIZE * MI_SIZE);
-    ref_coeff[pli] = aom_memalign(
+    ref_coeff = s.ref_coeff[pli] = aom_memalign(
         32, sizeof(*ref_coeff) * cm->mi_rows * cm->mi_cols * MI_SIZE * MI_SIZE);
-    xdec[pli] = xd->plane[pli].subsampling_x;
-    ydec[pli] = xd->plane[pli].subsampling_y;
-    bsize[pli] = ydec[pli] ? (xdec[pli] ? BLOCK_4X4 : BLOCK_8X4)
-                           : (xdec[pli] ? BLOCK_4X8 : BLOCK_8X8);
-    stride[pli] = cm->mi_cols << MI_SIZE_LOG2;
-    mi_wide_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_x;
-    mi_high_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_y;
+    s.xdec[pli] = xd->plane[pli].subsampling_x;
+    s.ydec[pli] = xd->plane[pli].subsampling_y;
+    s.bsize[pli] = s.ydec[pli] ? (s.xdec[pli] ? BLOCK_4X4 : BLOCK_8X4)
+                               : (s.xdec[pli] ? BLOCK_4X8 : BLOCK_8X8);
+    s.stride[pli] = stride;
+    s.mi_wide_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_x;
+    s.mi_high_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_y;
 
     const int frame_height =
         (cm->mi_rows * MI_SIZE) >> xd->plane[pli].subsampling_y;
@@ -365,85 +530,66 @@ void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
       for (c = 0; c < frame_width; ++c) {
 #if CONFIG_HIGHBITDEPTH
         if (cm->use_highbitdepth) {
-          src[pli][r * stride[pli] + c] = CONVERT_TO_SHORTPTR(
+          src[r * stride + c] = CONVERT_TO_SHORTPTR(
               xd->plane[pli].dst.buf)[r * xd->plane[pli].dst.stride + c];
-          ref_coeff[pli][r * stride[pli] + c] =
+          ref_coeff[r * stride + c] =
               CONVERT_TO_SHORTPTR(ref_buffer)[r * ref_stride + c];
         } else {
 #endif
-          src[pli][r * stride[pli] + c] =
+          src[r * stride + c] =
               xd->plane[pli].dst.buf[r * xd->plane[pli].dst.stride + c];
-          ref_coeff[pli][r * stride[pli] + c] = ref_buffer[r * ref_stride + c];
+          ref_coeff[r * stride + c] = ref_buffer[r * ref_stride + c];
 #if CONFIG_HIGHBITDEPTH
         }
 #endif
       }
     }
   }
-  in = inbuf + OD_FILT_VBORDER * OD_FILT_BSTRIDE + OD_FILT_HBORDER;
   sb_count = 0;
   for (sbr = 0; sbr < nvsb; ++sbr) {
     for (sbc = 0; sbc < nhsb; ++sbc) {
-      int nvb, nhb;
-      int gi;
-      int dirinit = 0;
-      nhb = AOMMIN(MAX_MIB_SIZE, cm->mi_cols - MAX_MIB_SIZE * sbc);
-      nvb = AOMMIN(MAX_MIB_SIZE, cm->mi_rows - MAX_MIB_SIZE * sbr);
       cm->mi_grid_visible[MAX_MIB_SIZE * sbr * cm->mi_stride +
                           MAX_MIB_SIZE * sbc]
           ->mbmi.cdef_strength = -1;
       if (sb_all_skip(cm, sbr * MAX_MIB_SIZE, sbc * MAX_MIB_SIZE)) continue;
-      dering_count = sb_compute_dering_list(cm, sbr * MAX_MIB_SIZE,
-                                            sbc * MAX_MIB_SIZE, dlist, 1);
-      for (pli = 0; pli < nplanes; pli++) {
-        for (i = 0; i < OD_DERING_INBUF_SIZE; i++)
-          inbuf[i] = OD_DERING_VERY_LARGE;
-        for (gi = 0; gi < total_strengths; gi++) {
-          int threshold;
-          uint64_t curr_mse;
-          int clpf_strength;
-          threshold = gi / CLPF_STRENGTHS;
-          if (fast) threshold = priconv[threshold];
-          if (pli > 0 && !chroma_dering) threshold = 0;
-          /* We avoid filtering the pixels for which some of the pixels to
-             average
-             are outside the frame. We could change the filter instead, but it
-             would add special cases for any future vectorization. */
-          int yoff = OD_FILT_VBORDER * (sbr != 0);
-          int xoff = OD_FILT_HBORDER * (sbc != 0);
-          int ysize = (nvb << mi_high_l2[pli]) +
-                      OD_FILT_VBORDER * (sbr != nvsb - 1) + yoff;
-          int xsize = (nhb << mi_wide_l2[pli]) +
-                      OD_FILT_HBORDER * (sbc != nhsb - 1) + xoff;
-          clpf_strength = gi % CLPF_STRENGTHS;
-          if (clpf_strength == 0)
-            copy_sb16_16(&in[(-yoff * OD_FILT_BSTRIDE - xoff)], OD_FILT_BSTRIDE,
-                         src[pli],
-                         (sbr * MAX_MIB_SIZE << mi_high_l2[pli]) - yoff,
-                         (sbc * MAX_MIB_SIZE << mi_wide_l2[pli]) - xoff,
-                         stride[pli], ysize, xsize);
-          od_dering(clpf_strength ? NULL : (uint8_t *)in, OD_FILT_BSTRIDE,
-                    tmp_dst, in, xdec[pli], ydec[pli], dir, &dirinit, var, pli,
-                    dlist, dering_count, threshold,
-                    clpf_strength + (clpf_strength == 3), clpf_damping,
-                    dering_damping, coeff_shift, clpf_strength != 0, 1);
-          curr_mse = compute_dering_dist(
-              ref_coeff[pli] +
-                  (sbr * MAX_MIB_SIZE << mi_high_l2[pli]) * stride[pli] +
-                  (sbc * MAX_MIB_SIZE << mi_wide_l2[pli]),
-              stride[pli], tmp_dst, dlist, dering_count, bsize[pli],
-              coeff_shift, pli);
-          if (pli < 2)
-            mse[pli][sb_count][gi] = curr_mse;
-          else
-            mse[1][sb_count][gi] += curr_mse;
-          sb_index[sb_count] =
-              MAX_MIB_SIZE * sbr * cm->mi_stride + MAX_MIB_SIZE * sbc;
-        }
-      }
+      sb_pos[sb_count] = sbr * nhsb + sbc;
+      sb_index[sb_count] =
+          MAX_MIB_SIZE * sbr * cm->mi_stride + MAX_MIB_SIZE * sbc;
       sb_count++;
     }
   }
+
+  /* The superblocks are independent of each other, so the workers fill in
+     the mse table a superblock at a time. */
+  num_workers = AOMMAX(AOMMIN(num_workers, sb_count), 1);
+  CHECK_MEM_ERROR(cm, s.scratch,
+                  aom_memalign(32, num_workers * sizeof(*s.scratch)));
+  if (num_workers == 1) {
+    for (i = 0; i < sb_count; i++) search_sb(&s, &s.scratch[0], i);
+  } else {
+    if (!aom_job_queue_alloc(&s.job_queue, num_workers))
+      aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                         "Failed to allocate CDEF search job queue");
+    aom_job_queue_reset(&s.job_queue, num_workers, sb_count);
+    for (i = 0; i < num_workers; i++) {
+      AVxWorker *const worker = &workers[i];
+      worker->hook = (AVxWorkerHook)cdef_search_worker;
+      worker->data1 = &s;
+      worker->data2 = &s.scratch[i];
+      if (i == num_workers - 1) {
+        winterface->execute(worker);
+      } else {
+        winterface->launch(worker);
+      }
+    }
+    for (i = 0; i < num_workers; i++) {
+      winterface->sync(&workers[i]);
+    }
+    aom_job_queue_finish(&s.job_queue);
+    aom_job_queue_free(&s.job_queue);
+  }
+  aom_free(s.scratch);
+
   nb_strength_bits = 0;
   /* Search for different number of signalling bits. */
   for (i = 0; i <= 3; i++) {
@@ -506,9 +652,10 @@ void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
   aom_free(mse[0]);
   aom_free(mse[1]);
   for (pli = 0; pli < nplanes; pli++) {
-    aom_free(src[pli]);
-    aom_free(ref_coeff[pli]);
+    aom_free(s.src[pli]);
+    aom_free(s.ref_coeff[pli]);
   }
   aom_free(sb_index);
+  aom_free(sb_pos);
   aom_free(selected_strength);
 }
@@ -11,6 +11,7 @@
 
 #include <assert.h>
 #include <limits.h>
+#include <string.h>
 
 #include "./aom_scale_rtcd.h"
 
@@ -36,39 +37,295 @@ int av1_get_max_filter_level(const AV1_COMP *cpi) {
   }
 }
 
-static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
-                                AV1_COMP *const cpi, int filt_level,
-                                int partial_frame) {
+// Most levels tried at once: the middle level, its two neighbours and the
+// four levels which the step after them may need.
+#define MAX_STEP_LEVELS 7
+
+static void lpf_sync_alloc(AV1_COMP *cpi, int num_workers) {
   AV1_COMMON *const cm = &cpi->common;
-  int64_t filt_err;
+  AV1LpfSync *lpf_sync;
+  int i;
+  CHECK_MEM_ERROR(cm, cpi->lpf_sync, aom_calloc(1, sizeof(*cpi->lpf_sync)));
+  lpf_sync = cpi->lpf_sync;
+  CHECK_MEM_ERROR(cm, lpf_sync->lpfdata,
+                  aom_calloc(num_workers, sizeof(*lpf_sync->lpfdata)));
+  lpf_sync->num_workers = num_workers;
+  for (i = 0; i < num_workers; ++i) {
+    CHECK_MEM_ERROR(cm, lpf_sync->lpfdata[i].cm,
+                    aom_malloc(sizeof(*lpf_sync->lpfdata[i].cm)));
+  }
+  if (!aom_job_queue_alloc(&lpf_sync->job_queue, num_workers))
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate filter level search job queue");
+}
 
-#if CONFIG_VAR_TX || CONFIG_EXT_PARTITION || CONFIG_CB4X4
-  av1_loop_filter_frame(cm->frame_to_show, cm, &cpi->td.mb.e_mbd, filt_level, 1,
-                        partial_frame);
-#else
-  if (cpi->num_workers > 1)
-    av1_loop_filter_frame_mt(cm->frame_to_show, cm, cpi->td.mb.e_mbd.plane,
-                             filt_level, 1, partial_frame, cpi->workers,
-                             cpi->num_workers, &cpi->lf_row_sync);
-  else
-    av1_loop_filter_frame(cm->frame_to_show, cm, &cpi->td.mb.e_mbd, filt_level,
-                          1, partial_frame);
+void av1_lpf_sync_dealloc(AV1_COMP *cpi) {
+  AV1LpfSync *const lpf_sync = cpi->lpf_sync;
+  if (lpf_sync != NULL) {
+    int i;
+    if (lpf_sync->lpfdata != NULL) {
+      for (i = 0; i < lpf_sync->num_workers; ++i) {
+        AV1LpfWorkerData *const lpf_data = &lpf_sync->lpfdata[i];
+#if CONFIG_VAR_TX
+        int j;
+        for (j = 0; j < MAX_MB_PLANE; ++j)
+          aom_free(lpf_data->top_txfm_context[j]);
+#endif  // CONFIG_VAR_TX
+        aom_free_frame_buffer(&lpf_data->frame);
+        aom_free(lpf_data->cm);
+      }
+      aom_free(lpf_sync->lpfdata);
+    }
+    aom_job_queue_free(&lpf_sync->job_queue);
+    aom_free(lpf_sync);
+    cpi->lpf_sync = NULL;
+  }
+}
+
+// Make sure the scratch data of the first num_workers workers fits the frame.
+static void lpf_workers_alloc(AV1_COMP *cpi, int num_workers) {
+  AV1_COMMON *const cm = &cpi->common;
+  int i;
+  if (cpi->lpf_sync != NULL && cpi->lpf_sync->num_workers < num_workers)
+    av1_lpf_sync_dealloc(cpi);
+  if (cpi->lpf_sync == NULL) lpf_sync_alloc(cpi, num_workers);
+
+  for (i = 0; i < num_workers; ++i) {
+    AV1LpfWorkerData *const lpf_data = &cpi->lpf_sync->lpfdata[i];
+    if (aom_realloc_frame_buffer(&lpf_data->frame, cm->width, cm->height,
+                                 cm->subsampling_x, cm->subsampling_y,
+#if CONFIG_HIGHBITDEPTH
+                                 cm->use_highbitdepth,
 #endif
+                                 AOM_BORDER_IN_PIXELS, cm->byte_alignment, NULL,
+                                 NULL, NULL))
+      aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                         "Failed to allocate filter level search buffer");
+#if CONFIG_VAR_TX
+    if (lpf_data->txfm_context_cols < cm->mi_cols) {
+      int j;
+      for (j = 0; j < MAX_MB_PLANE; ++j) {
+        aom_free(lpf_data->top_txfm_context[j]);
+        CHECK_MEM_ERROR(cm, lpf_data->top_txfm_context[j],
+                        aom_calloc(cm->mi_cols << TX_UNIT_WIDE_LOG2,
+                                   sizeof(*lpf_data->top_txfm_context[j])));
+      }
+      lpf_data->txfm_context_cols = cm->mi_cols;
+    }
+#endif  // CONFIG_VAR_TX
+  }
+}
 
+// Copy rows [start, end) of the luma plane.
+static void copy_y_rows(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst,
+                        int start, int end) {
+  int r;
 #if CONFIG_HIGHBITDEPTH
-  if (cm->use_highbitdepth) {
-    filt_err = aom_highbd_get_y_sse(sd, cm->frame_to_show);
-  } else {
-    filt_err = aom_get_y_sse(sd, cm->frame_to_show);
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    const uint16_t *src16 = CONVERT_TO_SHORTPTR(src->y_buffer);
+    uint16_t *dst16 = CONVERT_TO_SHORTPTR(dst->y_buffer);
+    for (r = start; r < end; ++r)
+      memcpy(dst16 + r * dst->y_stride, src16 + r * src->y_stride,
+             src->y_width * sizeof(*src16));
+    return;
   }
+#endif  // CONFIG_HIGHBITDEPTH
+  for (r = start; r < end; ++r)
+    memcpy(dst->y_buffer + r * dst->y_stride, src->y_buffer + r * src->y_stride,
+           src->y_width);
+}
+
+static int64_t get_y_sse_rows(const YV12_BUFFER_CONFIG *a,
+                              const YV12_BUFFER_CONFIG *b, int start,
+                              int end) {
+#if CONFIG_HIGHBITDEPTH
+  if (a->flags & YV12_FLAG_HIGHBITDEPTH)
+    return aom_highbd_get_y_sse_part(a, b, 0, a->y_crop_width, start,
+                                     end - start);
+#endif  // CONFIG_HIGHBITDEPTH
+  return aom_get_y_sse_part(a, b, 0, a->y_crop_width, start, end - start);
+}
+
+// Set up the rows searched by try_filter_level().
+static void init_filter_rows(AV1LpfSync *lpf_sync,
+                             const YV12_BUFFER_CONFIG *sd, AV1_COMMON *cm,
+                             const struct macroblockd_plane *planes,
+                             int partial_frame) {
+  const YV12_BUFFER_CONFIG *const frame = cm->frame_to_show;
+  int start_mi_row = 0;
+  int mi_rows_to_filter = cm->mi_rows;
+  int i;
+  for (i = 0; i < lpf_sync->num_workers; ++i)
+    memcpy(lpf_sync->lpfdata[i].planes, planes,
+           sizeof(lpf_sync->lpfdata[i].planes));
+  // As in av1_loop_filter_frame()
+  if (partial_frame && cm->mi_rows > 8) {
+    start_mi_row = cm->mi_rows >> 1;
+    start_mi_row &= 0xfffffff8;
+    mi_rows_to_filter = AOMMAX(cm->mi_rows / 8, 8);
+  }
+  lpf_sync->sd = sd;
+  lpf_sync->cm = cm;
+  lpf_sync->start_mi_row = start_mi_row;
+  lpf_sync->end_mi_row = start_mi_row + mi_rows_to_filter;
+
+  // Filtering the rows changes the pixels from the top edge of the first row,
+  // less the reach of the longest filter, and reads one more line above.
+  // Copy an extra line below the last row as well, which the filters of its
+  // bottom blocks may read.
+  lpf_sync->copy_start = AOMMAX(start_mi_row * MI_SIZE - 8, 0);
+  lpf_sync->copy_end =
+      AOMMIN(lpf_sync->end_mi_row * MI_SIZE + 8, frame->y_height);
+  lpf_sync->sse_start = lpf_sync->copy_start;
+  lpf_sync->sse_end =
+      AOMMIN(lpf_sync->end_mi_row * MI_SIZE, frame->y_crop_height);
+
+  // The error of the other rows does not depend on the level.
+  if (lpf_sync->sse_start == 0 && lpf_sync->sse_end == frame->y_crop_height) {
+    lpf_sync->outside_err = 0;
+  } else {
+#if CONFIG_HIGHBITDEPTH
+    if (cm->use_highbitdepth)
+      lpf_sync->outside_err = aom_highbd_get_y_sse(sd, frame);
+    else
+      lpf_sync->outside_err = aom_get_y_sse(sd, frame);
 #else
-  filt_err = aom_get_y_sse(sd, cm->frame_to_show);
+    lpf_sync->outside_err = aom_get_y_sse(sd, frame);
 #endif  // CONFIG_HIGHBITDEPTH
+    lpf_sync->outside_err -=
+        get_y_sse_rows(sd, frame, lpf_sync->sse_start, lpf_sync->sse_end);
+  }
+}
+
+// Returns the error of the frame filtered at 'filt_level'. The searched rows
+// are copied from the unfiltered frame and filtered in the scratch buffer of
+// the worker, so the frame itself is left untouched.
+static int64_t try_filter_level(const AV1LpfSync *lpf_sync,
+                                AV1LpfWorkerData *lpf_data, int filt_level) {
+  AV1_COMMON *const cm = lpf_data->cm;
+  int64_t filt_err;
+#if CONFIG_VAR_TX
+  int i;
+#endif  // CONFIG_VAR_TX
 
-  // Re-instate the unfiltered frame
-  aom_yv12_copy_y(&cpi->last_frame_uf, cm->frame_to_show);
+  if (!filt_level)
+    return lpf_sync->outside_err +
+           get_y_sse_rows(lpf_sync->sd, lpf_sync->cm->frame_to_show,
+                          lpf_sync->sse_start, lpf_sync->sse_end);
 
-  return filt_err;
+  *cm = *lpf_sync->cm;
+#if CONFIG_VAR_TX
+  for (i = 0; i < MAX_MB_PLANE; ++i)
+    cm->top_txfm_context[i] = lpf_data->top_txfm_context[i];
+#endif  // CONFIG_VAR_TX
+  copy_y_rows(lpf_sync->cm->frame_to_show, &lpf_data->frame,
+              lpf_sync->copy_start, lpf_sync->copy_end);
+
+  av1_loop_filter_frame_init(cm, filt_level);
+#if CONFIG_EXT_DELTA_Q
+  cm->lf.filter_level = filt_level;
+#endif
+  av1_loop_filter_rows(&lpf_data->frame, cm, lpf_data->planes,
+                       lpf_sync->start_mi_row, lpf_sync->end_mi_row, 1);
+
+  filt_err = get_y_sse_rows(lpf_sync->sd, &lpf_data->frame,
+                            lpf_sync->sse_start, lpf_sync->sse_end);
+  return lpf_sync->outside_err + filt_err;
+}
+
+static int lpf_search_worker(AV1LpfSync *const lpf_sync,
+                             AV1LpfWorkerData *const lpf_data) {
+  const int worker = (int)(lpf_data - lpf_sync->lpfdata);
+  int job;
+  while (aom_job_queue_pop(&lpf_sync->job_queue, worker, &job))
+    lpf_sync->errs[job] = try_filter_level(lpf_sync, lpf_data,
+                                           lpf_sync->levels[job]);
+  return 1;
+}
+
+// Fills in ss_err[] for the first num_levels entries of levels[], one level
+// per job of the workers.
+static void try_filter_levels(AV1_COMP *cpi, const int *levels, int num_levels,
+                              int64_t *ss_err) {
+  AV1LpfSync *const lpf_sync = cpi->lpf_sync;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const int num_workers = AOMMIN(num_levels, lpf_sync->num_workers);
+  int64_t errs[MAX_LOOP_FILTER + 1];
+  int i;
+
+  lpf_sync->levels = levels;
+  lpf_sync->errs = errs;
+  if (num_workers <= 1) {
+    for (i = 0; i < num_levels; ++i)
+      errs[i] = try_filter_level(lpf_sync, &lpf_sync->lpfdata[0], levels[i]);
+  } else {
+    aom_job_queue_reset(&lpf_sync->job_queue, num_workers, num_levels);
+    for (i = 0; i < num_workers; ++i) {
+      AVxWorker *const worker = &cpi->workers[i];
+      worker->hook = (AVxWorkerHook)lpf_search_worker;
+      worker->data1 = lpf_sync;
+      worker->data2 = &lpf_sync->lpfdata[i];
+      if (i == num_workers - 1) {
+        winterface->execute(worker);
+      } else {
+        winterface->launch(worker);
+      }
+    }
+    for (i = 0; i < num_workers; ++i) {
+      winterface->sync(&cpi->workers[i]);
+    }
+    aom_job_queue_finish(&lpf_sync->job_queue);
+  }
+  for (i = 0; i < num_levels; ++i) ss_err[levels[i]] = errs[i];
+  lpf_sync->levels = NULL;
+  lpf_sync->errs = NULL;
+}
+
+// Adds 'level' to the levels to try, unless it is already known or listed.
+static void add_filter_level(int *levels, int *num_levels,
+                             const int64_t *ss_err, int level) {
+  int i;
+  if (ss_err[level] >= 0) return;
+  for (i = 0; i < *num_levels; ++i)
+    if (levels[i] == level) return;
+  levels[(*num_levels)++] = level;
+}
+
+// Tries the levels needed by the next step of the search. When there are
+// workers to spare, they try the levels that the step after may need at the
+// same time: half the step around the middle if it stays the best, or one
+// more step away from it otherwise.
+static void try_search_step(AV1_COMP *cpi, int64_t *ss_err, int filt_mid,
+                            int filt_low, int filt_high, int filter_step,
+                            int filt_direction) {
+  const int min_filter_level = 0;
+  const int max_filter_level = av1_get_max_filter_level(cpi);
+  const int max_levels = cpi->lpf_sync->num_workers;
+  int levels[MAX_LOOP_FILTER + 1];
+  int num_levels = 0;
+  int num_needed;
+
+  add_filter_level(levels, &num_levels, ss_err, filt_mid);
+  if (filt_direction <= 0)
+    add_filter_level(levels, &num_levels, ss_err, filt_low);
+  if (filt_direction >= 0)
+    add_filter_level(levels, &num_levels, ss_err, filt_high);
+  num_needed = num_levels;
+  if (num_needed == 0) return;
+
+  add_filter_level(levels, &num_levels, ss_err,
+                   AOMMAX(filt_mid - filter_step / 2, min_filter_level));
+  add_filter_level(levels, &num_levels, ss_err,
+                   AOMMIN(filt_mid + filter_step / 2, max_filter_level));
+  if (filt_direction <= 0)
+    add_filter_level(levels, &num_levels, ss_err,
+                     AOMMAX(filt_low - filter_step, min_filter_level));
+  if (filt_direction >= 0)
+    add_filter_level(levels, &num_levels, ss_err,
+                     AOMMIN(filt_high + filter_step, max_filter_level));
+  num_levels = AOMMAX(num_needed, AOMMIN(num_levels, max_levels));
+
+  try_filter_levels(cpi, levels, num_levels, ss_err);
 }
 
 int av1_search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
@@ -92,12 +349,18 @@ int av1_search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
   // Set each entry to -1
   memset(ss_err, 0xFF, sizeof(ss_err));
 
-  //  Make a copy of the unfiltered / processed recon buffer
-  aom_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
+  // The frame itself stays unfiltered: each level is tried on a copy of the
+  // searched rows.
+  lpf_workers_alloc(cpi, AOMMIN(AOMMAX(cpi->num_workers, 1), MAX_STEP_LEVELS));
+  init_filter_rows(cpi->lpf_sync, sd, &cpi->common, x->e_mbd.plane,
+                   partial_frame);
 
-  best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame);
+  try_search_step(cpi, ss_err, filt_mid,
+                  AOMMAX(filt_mid - filter_step, min_filter_level),
+                  AOMMIN(filt_mid + filter_step, max_filter_level),
+                  filter_step, filt_direction);
+  best_err = ss_err[filt_mid];
   filt_best = filt_mid;
-  ss_err[filt_mid] = best_err;
 
   while (filter_step > 0) {
     const int filt_high = AOMMIN(filt_mid + filter_step, max_filter_level);
@@ -112,11 +375,10 @@ int av1_search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
     // yx, bias less for large block size
     if (cm->tx_mode != ONLY_4X4) bias >>= 1;
 
+    try_search_step(cpi, ss_err, filt_mid, filt_low, filt_high, filter_step,
+                    filt_direction);
+
     if (filt_direction <= 0 && filt_low != filt_mid) {
-      // Get Low filter error score
-      if (ss_err[filt_low] < 0) {
-        ss_err[filt_low] = try_filter_frame(sd, cpi, filt_low, partial_frame);
-      }
       // If value is close to the best so far then bias towards a lower loop
       // filter value.
       if (ss_err[filt_low] < (best_err + bias)) {
@@ -130,9 +392,6 @@ int av1_search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
 
     // Now look at filt_high
     if (filt_direction >= 0 && filt_high != filt_mid) {
-      if (ss_err[filt_high] < 0) {
-        ss_err[filt_high] = try_filter_frame(sd, cpi, filt_high, partial_frame);
-      }
       // If value is significantly better than previous best, bias added against
       // raising filter value
       if (ss_err[filt_high] < (best_err - bias)) {
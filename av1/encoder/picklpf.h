@@ -20,6 +20,44 @@ extern "C" {
 
 struct yv12_buffer_config;
 struct AV1_COMP;
+
+// Scratch data of one worker of the filter level search.
+typedef struct AV1LpfWorkerData {
+  // Copy of the AV1Common of the frame, holding the filter level tables of
+  // the level being tried.
+  struct AV1Common *cm;
+  // The searched rows of the frame, filtered at that level.
+  YV12_BUFFER_CONFIG frame;
+  struct macroblockd_plane planes[MAX_MB_PLANE];
+#if CONFIG_VAR_TX
+  TXFM_CONTEXT *top_txfm_context[MAX_MB_PLANE];
+  int txfm_context_cols;
+#endif  // CONFIG_VAR_TX
+} AV1LpfWorkerData;
+
+// Filter levels shared by the workers of the filter level search.
+typedef struct AV1LpfSync {
+  AV1LpfWorkerData *lpfdata;
+  int num_workers;
+  AVxJobQueue job_queue;
+  // Valid during one batch of levels.
+  const YV12_BUFFER_CONFIG *sd;
+  struct AV1Common *cm;
+  int start_mi_row;
+  int end_mi_row;
+  int copy_start;
+  int copy_end;
+  int sse_start;
+  int sse_end;
+  // Error of the rows outside of [sse_start, sse_end).
+  int64_t outside_err;
+  const int *levels;
+  int64_t *errs;
+} AV1LpfSync;
+
+// Deallocate the scratch data of the filter level search.
+void av1_lpf_sync_dealloc(struct AV1_COMP *cpi);
+
 int av1_get_max_filter_level(const AV1_COMP *cpi);
 int av1_search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
                             int partial_frame, double *err);
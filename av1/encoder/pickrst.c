@@ -15,6 +15,7 @@
 #include <math.h>
 
 #include "./aom_scale_rtcd.h"
+#include "./av1_rtcd.h"
 
 #include "aom_dsp/aom_dsp_common.h"
 #include "aom_dsp/binary_codes_writer.h"
@@ -348,14 +349,30 @@ void encode_xq(int *xq, int *xqd) {
 static void search_selfguided_restoration(uint8_t *dat8, int width, int height,
                                           int dat_stride, uint8_t *src8,
                                           int src_stride, int bit_depth,
-                                          int *eps, int *xqd, int32_t *rstbuf) {
+                                          int *eps, int *xqd, int32_t *rstbuf,
+                                          uint8_t *extbuf) {
   int32_t *flt1 = rstbuf;
   int32_t *flt2 = flt1 + RESTORATION_TILEPELS_MAX;
   int32_t *tmpbuf2 = flt2 + RESTORATION_TILEPELS_MAX;
+  // The box sums for every set of parameters come from the same integral
+  // images, so build those once per tile. The box sums of a radius are not
+  // kept across the eps values: in the SIMD filters they cost four loads per
+  // pixel, fused into the eps dependent stage, and the filter passes are only
+  // a small part of the search next to the projection and its refinement.
+  int32_t *ii = (int32_t *)extbuf;
+  int32_t *ii_sq = ii + SGRPROJ_INTEGRAL_SIZE;
   int ep, bestep = 0;
   int64_t err, besterr = -1;
   int exqd[2], bestxqd[2] = { 0, 0 };
 
+#if CONFIG_HIGHBITDEPTH
+  if (bit_depth > 8)
+    av1_selfguided_integral_images_highbd(CONVERT_TO_SHORTPTR(dat8), width,
+                                          height, dat_stride, ii, ii_sq);
+  else
+#endif  // CONFIG_HIGHBITDEPTH
+    av1_selfguided_integral_images(dat8, width, height, dat_stride, ii, ii_sq);
+
   for (ep = 0; ep < SGRPROJ_PARAMS; ep++) {
     int exq[2];
 #if CONFIG_HIGHBITDEPTH
@@ -365,24 +382,26 @@ static void search_selfguided_restoration(uint8_t *dat8, int width, int height,
       av1_highpass_filter_highbd(dat, width, height, dat_stride, flt1, width,
                                  sgr_params[ep].corner, sgr_params[ep].edge);
 #else
-      av1_selfguided_restoration_highbd(dat, width, height, dat_stride, flt1,
-                                        width, bit_depth, sgr_params[ep].r1,
-                                        sgr_params[ep].e1, tmpbuf2);
+      av1_selfguided_restoration_from_integral_highbd(
+          dat, width, height, dat_stride, ii, ii_sq, flt1, width, bit_depth,
+          sgr_params[ep].r1, sgr_params[ep].e1, tmpbuf2);
 #endif  // USE_HIGHPASS_IN_SGRPROJ
-      av1_selfguided_restoration_highbd(dat, width, height, dat_stride, flt2,
-                                        width, bit_depth, sgr_params[ep].r2,
-                                        sgr_params[ep].e2, tmpbuf2);
+      av1_selfguided_restoration_from_integral_highbd(
+          dat, width, height, dat_stride, ii, ii_sq, flt2, width, bit_depth,
+          sgr_params[ep].r2, sgr_params[ep].e2, tmpbuf2);
     } else {
 #endif
 #if USE_HIGHPASS_IN_SGRPROJ
       av1_highpass_filter(dat8, width, height, dat_stride, flt1, width,
                           sgr_params[ep].corner, sgr_params[ep].edge);
 #else
-    av1_selfguided_restoration(dat8, width, height, dat_stride, flt1, width,
-                               sgr_params[ep].r1, sgr_params[ep].e1, tmpbuf2);
+    av1_selfguided_restoration_from_integral(
+        dat8, width, height, dat_stride, ii, ii_sq, flt1, width,
+        sgr_params[ep].r1, sgr_params[ep].e1, tmpbuf2);
 #endif  // USE_HIGHPASS_IN_SGRPROJ
-      av1_selfguided_restoration(dat8, width, height, dat_stride, flt2, width,
-                                 sgr_params[ep].r2, sgr_params[ep].e2, tmpbuf2);
+      av1_selfguided_restoration_from_integral(
+          dat8, width, height, dat_stride, ii, ii_sq, flt2, width,
+          sgr_params[ep].r2, sgr_params[ep].e2, tmpbuf2);
 #if CONFIG_HIGHBITDEPTH
     }
 #endif
@@ -490,7 +509,8 @@ static double search_sgrproj(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
         8,
 #endif  // CONFIG_HIGHBITDEPTH
         &rsi[plane].sgrproj_info[tile_idx].ep,
-        rsi[plane].sgrproj_info[tile_idx].xqd, cm->rst_internal.tmpbuf);
+        rsi[plane].sgrproj_info[tile_idx].xqd, cm->rst_internal.tmpbuf,
+        cpi->extra_rstbuf);
     rsi[plane].restoration_type[tile_idx] = RESTORE_SGRPROJ;
     err = try_restoration_tile(src, cpi, rsi, (1 << plane), partial_frame,
                                tile_idx, 0, 0, dst_frame);
@@ -536,42 +556,42 @@ static double search_sgrproj(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
   return cost_sgrproj;
 }
 
-static double find_average(uint8_t *src, int h_start, int h_end, int v_start,
-                           int v_end, int stride) {
+// The statistics are taken relative to the rounded average of the degraded
+// tile. Since the taps of the Wiener filter sum to one, any offset which is
+// common to the source and the degraded tile gives the same filter, and
+// keeping it an integer lets us accumulate the statistics exactly.
+static int find_average(const uint8_t *src, int h_start, int h_end,
+                        int v_start, int v_end, int stride) {
   uint64_t sum = 0;
-  double avg = 0;
+  const uint64_t n = (uint64_t)(v_end - v_start) * (h_end - h_start);
   int i, j;
-  aom_clear_system_state();
   for (i = v_start; i < v_end; i++)
     for (j = h_start; j < h_end; j++) sum += src[i * stride + j];
-  avg = (double)sum / ((v_end - v_start) * (h_end - h_start));
-  return avg;
+  return (int)((sum + n / 2) / n);
 }
 
-static void compute_stats(uint8_t *dgd, uint8_t *src, int h_start, int h_end,
-                          int v_start, int v_end, int dgd_stride,
-                          int src_stride, double *M, double *H) {
+void av1_compute_stats_c(const uint8_t *dgd, const uint8_t *src, int avg,
+                         int h_start, int h_end, int v_start, int v_end,
+                         int dgd_stride, int src_stride, int64_t *M,
+                         int64_t *H) {
   int i, j, k, l;
-  double Y[WIENER_WIN2];
-  const double avg =
-      find_average(dgd, h_start, h_end, v_start, v_end, dgd_stride);
+  int32_t Y[WIENER_WIN2];
 
   memset(M, 0, sizeof(*M) * WIENER_WIN2);
   memset(H, 0, sizeof(*H) * WIENER_WIN2 * WIENER_WIN2);
   for (i = v_start; i < v_end; i++) {
     for (j = h_start; j < h_end; j++) {
-      const double X = (double)src[i * src_stride + j] - avg;
+      const int32_t X = src[i * src_stride + j] - avg;
       int idx = 0;
       for (k = -WIENER_HALFWIN; k <= WIENER_HALFWIN; k++) {
         for (l = -WIENER_HALFWIN; l <= WIENER_HALFWIN; l++) {
-          Y[idx] = (double)dgd[(i + l) * dgd_stride + (j + k)] - avg;
+          Y[idx] = dgd[(i + l) * dgd_stride + (j + k)] - avg;
           idx++;
         }
       }
       for (k = 0; k < WIENER_WIN2; ++k) {
         M[k] += Y[k] * X;
-        H[k * WIENER_WIN2 + k] += Y[k] * Y[k];
-        for (l = k + 1; l < WIENER_WIN2; ++l) {
+        for (l = k; l < WIENER_WIN2; ++l) {
           // H is a symmetric matrix, so we only need to fill out the upper
           // triangle here. We can copy it down to the lower triangle outside
           // the (i, j) loops.
@@ -587,50 +607,62 @@ static void compute_stats(uint8_t *dgd, uint8_t *src, int h_start, int h_end,
   }
 }
 
+static void stats_to_double(const int64_t *M_int, const int64_t *H_int,
+                            double *M, double *H) {
+  int k;
+  for (k = 0; k < WIENER_WIN2; ++k) M[k] = (double)M_int[k];
+  for (k = 0; k < WIENER_WIN2 * WIENER_WIN2; ++k) H[k] = (double)H_int[k];
+}
+
+static void compute_stats(uint8_t *dgd, uint8_t *src, int h_start, int h_end,
+                          int v_start, int v_end, int dgd_stride,
+                          int src_stride, double *M, double *H) {
+  int64_t M_int[WIENER_WIN2];
+  int64_t H_int[WIENER_WIN2 * WIENER_WIN2];
+  const int avg = find_average(dgd, h_start, h_end, v_start, v_end, dgd_stride);
+  av1_compute_stats(dgd, src, avg, h_start, h_end, v_start, v_end, dgd_stride,
+                    src_stride, M_int, H_int);
+  aom_clear_system_state();
+  stats_to_double(M_int, H_int, M, H);
+}
+
 #if CONFIG_HIGHBITDEPTH
-static double find_average_highbd(uint16_t *src, int h_start, int h_end,
-                                  int v_start, int v_end, int stride) {
+static int find_average_highbd(const uint16_t *src, int h_start, int h_end,
+                               int v_start, int v_end, int stride) {
   uint64_t sum = 0;
-  double avg = 0;
+  const uint64_t n = (uint64_t)(v_end - v_start) * (h_end - h_start);
   int i, j;
-  aom_clear_system_state();
   for (i = v_start; i < v_end; i++)
     for (j = h_start; j < h_end; j++) sum += src[i * stride + j];
-  avg = (double)sum / ((v_end - v_start) * (h_end - h_start));
-  return avg;
+  return (int)((sum + n / 2) / n);
 }
 
-static void compute_stats_highbd(uint8_t *dgd8, uint8_t *src8, int h_start,
-                                 int h_end, int v_start, int v_end,
-                                 int dgd_stride, int src_stride, double *M,
-                                 double *H) {
+void av1_compute_stats_highbd_c(const uint16_t *dgd, const uint16_t *src,
+                                int avg, int h_start, int h_end, int v_start,
+                                int v_end, int dgd_stride, int src_stride,
+                                int64_t *M, int64_t *H) {
   int i, j, k, l;
-  double Y[WIENER_WIN2];
-  uint16_t *src = CONVERT_TO_SHORTPTR(src8);
-  uint16_t *dgd = CONVERT_TO_SHORTPTR(dgd8);
-  const double avg =
-      find_average_highbd(dgd, h_start, h_end, v_start, v_end, dgd_stride);
+  int32_t Y[WIENER_WIN2];
 
   memset(M, 0, sizeof(*M) * WIENER_WIN2);
   memset(H, 0, sizeof(*H) * WIENER_WIN2 * WIENER_WIN2);
   for (i = v_start; i < v_end; i++) {
     for (j = h_start; j < h_end; j++) {
-      const double X = (double)src[i * src_stride + j] - avg;
+      const int32_t X = src[i * src_stride + j] - avg;
       int idx = 0;
       for (k = -WIENER_HALFWIN; k <= WIENER_HALFWIN; k++) {
         for (l = -WIENER_HALFWIN; l <= WIENER_HALFWIN; l++) {
-          Y[idx] = (double)dgd[(i + l) * dgd_stride + (j + k)] - avg;
+          Y[idx] = dgd[(i + l) * dgd_stride + (j + k)] - avg;
           idx++;
         }
       }
       for (k = 0; k < WIENER_WIN2; ++k) {
-        M[k] += Y[k] * X;
-        H[k * WIENER_WIN2 + k] += Y[k] * Y[k];
-        for (l = k + 1; l < WIENER_WIN2; ++l) {
+        M[k] += (int64_t)Y[k] * X;
+        for (l = k; l < WIENER_WIN2; ++l) {
           // H is a symmetric matrix, so we only need to fill out the upper
           // triangle here. We can copy it down to the lower triangle outside
           // the (i, j) loops.
-          H[k * WIENER_WIN2 + l] += Y[k] * Y[l];
+          H[k * WIENER_WIN2 + l] += (int64_t)Y[k] * Y[l];
         }
       }
     }
@@ -641,6 +673,22 @@ static void compute_stats_highbd(uint8_t *dgd8, uint8_t *src8, int h_start,
     }
   }
 }
+
+static void compute_stats_highbd(uint8_t *dgd8, uint8_t *src8, int h_start,
+                                 int h_end, int v_start, int v_end,
+                                 int dgd_stride, int src_stride, double *M,
+                                 double *H) {
+  int64_t M_int[WIENER_WIN2];
+  int64_t H_int[WIENER_WIN2 * WIENER_WIN2];
+  const uint16_t *src = CONVERT_TO_SHORTPTR(src8);
+  const uint16_t *dgd = CONVERT_TO_SHORTPTR(dgd8);
+  const int avg =
+      find_average_highbd(dgd, h_start, h_end, v_start, v_end, dgd_stride);
+  av1_compute_stats_highbd(dgd, src, avg, h_start, h_end, v_start, v_end,
+                           dgd_stride, src_stride, M_int, H_int);
+  aom_clear_system_state();
+  stats_to_double(M_int, H_int, M, H);
+}
 #endif  // CONFIG_HIGHBITDEPTH
 
 static INLINE int wrap_index(int i) {
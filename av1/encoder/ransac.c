@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <assert.h>
 
+#include "./av1_rtcd.h"
 #include "av1/encoder/ransac.h"
 #include "av1/encoder/mathutils.h"
 
@@ -22,11 +23,11 @@
 #define MAX_DEGENERATE_ITER 10
 #define MINPTS_MULTIPLIER 5
 
-#define INLIER_THRESHOLD 1.0
 #define MIN_TRIALS 20
 
 ////////////////////////////////////////////////////////////////////////////////
 // ransac
+typedef void (*ToAffineFunc)(const double *params, double *mat);
 typedef int (*IsDegenerateFunc)(double *p);
 typedef void (*NormalizeFunc)(double *p, int np, double *T);
 typedef void (*DenormalizeFunc)(double *params, double *T1, double *T2);
@@ -79,6 +80,57 @@ static void project_points_double_affine(double *mat, double *points,
   }
 }
 
+// The translation, rotzoom and affine models as a 6-parameter affine matrix,
+// for av1_ransac_affine_inliers(). The products with 0 and 1 and the negated
+// coefficient give the same projections as the functions above.
+static void translation_to_affine(const double *params, double *mat) {
+  mat[0] = params[0];
+  mat[1] = params[1];
+  mat[2] = 1.0;
+  mat[3] = 0.0;
+  mat[4] = 0.0;
+  mat[5] = 1.0;
+}
+
+static void rotzoom_to_affine(const double *params, double *mat) {
+  mat[0] = params[0];
+  mat[1] = params[1];
+  mat[2] = params[2];
+  mat[3] = params[3];
+  mat[4] = -params[3];
+  mat[5] = params[2];
+}
+
+static void affine_to_affine(const double *params, double *mat) {
+  memcpy(mat, params, 6 * sizeof(*mat));
+}
+
+// Project 'points1' with the affine 'mat' and store the indices of the points
+// that land within INLIER_THRESHOLD of 'points2', along with their distances.
+// Returns the number of inliers, or some number below 'min_inliers' as soon
+// as the remaining points cannot bring the count up to 'min_inliers'.
+int av1_ransac_affine_inliers_c(const double *mat, const double *points1,
+                                const double *points2, int npoints,
+                                int min_inliers, int *inlier_indices,
+                                double *distances) {
+  int num_inliers = 0;
+  int i;
+  for (i = 0; i < npoints; ++i) {
+    const double x = points1[i * 2], y = points1[i * 2 + 1];
+    const double dx = mat[2] * x + mat[3] * y + mat[0] - points2[i * 2];
+    const double dy = mat[4] * x + mat[5] * y + mat[1] - points2[i * 2 + 1];
+    const double distance = sqrt(dx * dx + dy * dy);
+
+    if (distance < INLIER_THRESHOLD) {
+      inlier_indices[num_inliers] = i;
+      distances[num_inliers++] = distance;
+    } else if (num_inliers + npoints - 1 - i < min_inliers) {
+      break;
+    }
+  }
+  return num_inliers;
+}
+
 static void project_points_double_hortrapezoid(double *mat, double *points,
                                                double *proj, const int n,
                                                const int stride_points,
@@ -661,7 +713,8 @@ static int ransac(const int *matched_points, int npoints,
                   int num_desired_motions, const int minpts,
                   IsDegenerateFunc is_degenerate,
                   FindTransformationFunc find_transformation,
-                  ProjectPointsDoubleFunc projectpoints) {
+                  ProjectPointsDoubleFunc projectpoints,
+                  ToAffineFunc to_affine) {
   static const double PROBABILITY_REQUIRED = 0.9;
   static const double EPS = 1e-12;
 
@@ -676,6 +729,7 @@ static int ransac(const int *matched_points, int npoints,
   double *points1, *points2;
   double *corners1, *corners2;
   double *image1_coord;
+  double *distances;
 
   // Store information for the num_desired_motions best transformations found
   // and the worst motion among them, as well as the motion currently under
@@ -701,6 +755,7 @@ static int ransac(const int *matched_points, int npoints,
   corners1 = (double *)aom_malloc(sizeof(*corners1) * npoints * 2);
   corners2 = (double *)aom_malloc(sizeof(*corners2) * npoints * 2);
   image1_coord = (double *)aom_malloc(sizeof(*image1_coord) * npoints * 2);
+  distances = (double *)aom_malloc(sizeof(*distances) * npoints);
 
   motions =
       (RANSAC_MOTION *)aom_malloc(sizeof(RANSAC_MOTION) * num_desired_motions);
@@ -715,8 +770,8 @@ static int ransac(const int *matched_points, int npoints,
 
   worst_kept_motion = motions;
 
-  if (!(points1 && points2 && corners1 && corners2 && image1_coord && motions &&
-        current_motion.inlier_indices)) {
+  if (!(points1 && points2 && corners1 && corners2 && image1_coord &&
+        distances && motions && current_motion.inlier_indices)) {
     ret_val = 1;
     goto finish_ransac;
   }
@@ -761,17 +816,35 @@ static int ransac(const int *matched_points, int npoints,
       continue;
     }
 
-    projectpoints(params_this_motion, corners1, image1_coord, npoints, 2, 2);
-
-    for (i = 0; i < npoints; ++i) {
-      double dx = image1_coord[i * 2] - corners2[i * 2];
-      double dy = image1_coord[i * 2 + 1] - corners2[i * 2 + 1];
-      double distance = sqrt(dx * dx + dy * dy);
-
-      if (distance < INLIER_THRESHOLD) {
-        current_motion.inlier_indices[current_motion.num_inliers++] = i;
-        sum_distance += distance;
-        sum_distance_squared += distance * distance;
+    if (to_affine) {
+      // A motion with fewer inliers than the worst kept one is rejected
+      // below, so the scoring can give up as soon as it cannot get there.
+      double mat[6];
+      to_affine(params_this_motion, mat);
+      current_motion.num_inliers = av1_ransac_affine_inliers(
+          mat, corners1, corners2, npoints, worst_kept_motion->num_inliers,
+          current_motion.inlier_indices, distances);
+      if (current_motion.num_inliers < worst_kept_motion->num_inliers) {
+        trial_count++;
+        continue;
+      }
+      for (i = 0; i < current_motion.num_inliers; ++i) {
+        sum_distance += distances[i];
+        sum_distance_squared += distances[i] * distances[i];
+      }
+    } else {
+      projectpoints(params_this_motion, corners1, image1_coord, npoints, 2, 2);
+
+      for (i = 0; i < npoints; ++i) {
+        double dx = image1_coord[i * 2] - corners2[i * 2];
+        double dy = image1_coord[i * 2 + 1] - corners2[i * 2 + 1];
+        double distance = sqrt(dx * dx + dy * dy);
+
+        if (distance < INLIER_THRESHOLD) {
+          current_motion.inlier_indices[current_motion.num_inliers++] = i;
+          sum_distance += distance;
+          sum_distance_squared += distance * distance;
+        }
       }
     }
 
@@ -841,6 +914,7 @@ finish_ransac:
   aom_free(corners1);
   aom_free(corners2);
   aom_free(image1_coord);
+  aom_free(distances);
   aom_free(current_motion.inlier_indices);
   for (i = 0; i < num_desired_motions; ++i) {
     aom_free(motions[i].inlier_indices);
@@ -876,21 +950,21 @@ int ransac_translation(int *matched_points, int npoints,
   return ransac(matched_points, npoints, num_inliers_by_motion,
                 params_by_motion, num_desired_motions, 3,
                 is_degenerate_translation, find_translation,
-                project_points_double_translation);
+                project_points_double_translation, translation_to_affine);
 }
 
 int ransac_rotzoom(int *matched_points, int npoints, int *num_inliers_by_motion,
                    double *params_by_motion, int num_desired_motions) {
   return ransac(matched_points, npoints, num_inliers_by_motion,
                 params_by_motion, num_desired_motions, 3, is_degenerate_affine,
-                find_rotzoom, project_points_double_rotzoom);
+                find_rotzoom, project_points_double_rotzoom, rotzoom_to_affine);
 }
 
 int ransac_affine(int *matched_points, int npoints, int *num_inliers_by_motion,
                   double *params_by_motion, int num_desired_motions) {
   return ransac(matched_points, npoints, num_inliers_by_motion,
                 params_by_motion, num_desired_motions, 3, is_degenerate_affine,
-                find_affine, project_points_double_affine);
+                find_affine, project_points_double_affine, affine_to_affine);
 }
 
 int ransac_homography(int *matched_points, int npoints,
@@ -899,7 +973,7 @@ int ransac_homography(int *matched_points, int npoints,
   return ransac(matched_points, npoints, num_inliers_by_motion,
                 params_by_motion, num_desired_motions, 4,
                 is_degenerate_homography, find_homography,
-                project_points_double_homography);
+                project_points_double_homography, NULL);
 }
 
 int ransac_hortrapezoid(int *matched_points, int npoints,
@@ -908,7 +982,7 @@ int ransac_hortrapezoid(int *matched_points, int npoints,
   return ransac(matched_points, npoints, num_inliers_by_motion,
                 params_by_motion, num_desired_motions, 4,
                 is_degenerate_homography, find_hortrapezoid,
-                project_points_double_hortrapezoid);
+                project_points_double_hortrapezoid, NULL);
 }
 
 int ransac_vertrapezoid(int *matched_points, int npoints,
@@ -917,5 +991,5 @@ int ransac_vertrapezoid(int *matched_points, int npoints,
   return ransac(matched_points, npoints, num_inliers_by_motion,
                 params_by_motion, num_desired_motions, 4,
                 is_degenerate_homography, find_vertrapezoid,
-                project_points_double_vertrapezoid);
+                project_points_double_vertrapezoid, NULL);
 }
@@ -19,6 +19,10 @@
 
 #include "av1/common/warped_motion.h"
 
+// A point is an inlier of a motion if the motion projects it closer than
+// this to its match.
+#define INLIER_THRESHOLD 1.0
+
 typedef int (*RansacFunc)(int *matched_points, int npoints,
                           int *num_inliers_by_motion, double *params_by_motion,
                           int num_motions);
@@ -204,6 +204,7 @@ static void set_good_speed_features_framesize_independent(AV1_COMP *cpi,
     sf->allow_partition_search_skip = 1;
     sf->use_upsampled_references = 0;
     sf->adaptive_rd_thresh = 2;
+    sf->cdef_early_exit = 1;
 #if CONFIG_EXT_TX
     sf->tx_type_search.prune_mode = PRUNE_TWO;
 #endif
@@ -409,6 +410,7 @@ void av1_set_speed_features_framesize_independent(AV1_COMP *cpi) {
   }
   sf->use_rd_breakout = 0;
   sf->lpf_pick = LPF_PICK_FROM_FULL_IMAGE;
+  sf->cdef_early_exit = 0;
   sf->use_fast_coef_updates = TWO_LOOP;
   sf->use_fast_coef_costing = 0;
   sf->mode_skip_start = MAX_MODES;  // Mode index at which mode skip mask set
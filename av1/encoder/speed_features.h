@@ -412,6 +412,10 @@ typedef struct SPEED_FEATURES {
   // This feature controls how the loop filter level is determined.
   LPF_PICK_METHOD lpf_pick;
 
+  // Stop filtering a superblock with a CDEF strength in the search once its
+  // mse so far exceeds the best one found for the superblock.
+  int cdef_early_exit;
+
   // This feature limits the number of coefficients updates we actually do
   // by only looking at counts from 1/2 the bands.
   FAST_COEFF_UPDATE use_fast_coef_updates;
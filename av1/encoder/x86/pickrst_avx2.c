@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+#include <string.h>
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/mem.h"
+#include "av1/common/restoration.h"
+
+/* The C version of av1_compute_stats() multiplies out all WIENER_WIN2^2 / 2
+   pairs of taps at every pixel. But each entry of H is the sum, over the tile
+   shifted by the position of the first tap, of the products of the degraded
+   pixels at a fixed displacement from each other. There are only 85 distinct
+   displacements, and the tiles for the different shifts overlap everywhere
+   except within WIENER_HALFWIN pixels of their edges.
+
+   So, taking rows and columns relative to the tile extended by WIENER_HALFWIN
+   pixels on each side, we sum the products for each displacement over the
+   "middle" of the extended tile, which is common to every shift, and keep the
+   products within (2 * WIENER_HALFWIN) pixels of the edges separately. Each
+   entry of H is then the middle sum plus the edge terms for its shift.
+
+   The sums over the middle run along each row as dot products of 16-bit
+   vectors, so that neighbouring pixels share the loads for all of their
+   taps. The pixels (less the average) fit in 16 bits at any bit depth, and
+   the 32-bit partial sums cannot overflow within one row.
+
+   The high bitdepth functions share all of the code below: the source is
+   passed around as a CONVERT_TO_BYTEPTR() pointer plus a 'highbd' flag.
+*/
+
+#define EDGE (2 * WIENER_HALFWIN)
+#define NUM_EDGE (2 * EDGE)
+// Displacements between the two taps, (dl, dk), are indexed as
+// dl * DK_RANGE + dk + EDGE, with 0 <= dl <= EDGE and -EDGE <= dk <= EDGE.
+#define DK_RANGE (2 * EDGE + 1)
+#define NUM_DISP ((EDGE + 1) * DK_RANGE)
+#define MAX_TILE_W (RESTORATION_TILESIZE_MAX * 3 / 2)
+// Each buffered row holds the extended tile, followed by zeros for the dot
+// products to run on into.
+#define ROW_STRIDE (MAX_TILE_W + 32)
+// Number of buffered rows of the degraded tile. Must be a power of 2 and at
+// least WIENER_WIN.
+#define NUM_ROWS 8
+
+typedef struct {
+  // Sums over the middle rows and the middle columns
+  int64_t mid[NUM_DISP];
+  // Sums over the middle rows, for each edge column
+  int64_t col[NUM_DISP][NUM_EDGE];
+  // Sums over the middle columns, for each edge row
+  int64_t row[NUM_DISP][NUM_EDGE];
+  // Products at the corners, for each edge row and column
+  int32_t corner[NUM_DISP][NUM_EDGE][NUM_EDGE];
+} StatsAcc;
+
+static INLINE int get_pixel(const uint8_t *src, int highbd, int idx) {
+#if CONFIG_HIGHBITDEPTH
+  if (highbd) return CONVERT_TO_SHORTPTR(src)[idx];
+#else
+  (void)highbd;
+#endif
+  return src[idx];
+}
+
+static INLINE void load_row(int16_t *dst, const uint8_t *src, int highbd,
+                            int n, int avg) {
+  int j;
+  for (j = 0; j < n; ++j) dst[j] = get_pixel(src, highbd, j) - avg;
+}
+
+// Sum of a[i] * b[i] for i < n, where n is rounded up to a multiple of 16.
+// The result is returned as eight 32-bit partial sums.
+static INLINE __m256i dot_product(const int16_t *a, const int16_t *b, int n) {
+  __m256i sum = _mm256_setzero_si256();
+  int i;
+  for (i = 0; i < n; i += 16) {
+    sum = _mm256_add_epi32(
+        sum, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *)&a[i]),
+                               _mm256_loadu_si256((const __m256i *)&b[i])));
+  }
+  return sum;
+}
+
+static INLINE int64_t hsum_epi32(__m256i x) {
+  DECLARE_ALIGNED(16, int64_t, sum[2]);
+  const __m256i x64 =
+      _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)),
+                       _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+  _mm_store_si128((__m128i *)sum,
+                  _mm_add_epi64(_mm256_castsi256_si128(x64),
+                                _mm256_extracti128_si256(x64, 1)));
+  return sum[0] + sum[1];
+}
+
+// Accumulate the products between row u of the extended tile and the rows
+// below it.
+static void accumulate_row(StatsAcc *acc, int16_t (*rows)[ROW_STRIDE],
+                           int16_t *mid_row, int u, int w, int h) {
+  const int16_t *upper = rows[u & (NUM_ROWS - 1)];
+  // Index of the edge row, or -1 for the middle rows
+  const int t = u < EDGE ? u : (u >= h ? EDGE + u - h : -1);
+  int dl, dk, e;
+
+  // Copy the middle of the row, so that the dot products see zeros past it
+  memcpy(mid_row + EDGE, upper + EDGE, (w - EDGE) * sizeof(*mid_row));
+
+  for (dl = 0; dl <= EDGE && u + dl < h + EDGE; ++dl) {
+    const int16_t *lower = rows[(u + dl) & (NUM_ROWS - 1)];
+    for (dk = dl ? -EDGE : 0; dk <= EDGE; ++dk) {
+      const int d = dl * DK_RANGE + dk + EDGE;
+      const int64_t sum = hsum_epi32(
+          dot_product(mid_row + EDGE, lower + EDGE + dk, w - EDGE));
+      if (t < 0)
+        acc->mid[d] += sum;
+      else
+        acc->row[d][t] = sum;
+
+      for (e = 0; e < NUM_EDGE; ++e) {
+        const int p = e < EDGE ? e : w + e - EDGE;
+        int32_t prod;
+        // Products with the lower tap outside of the extended tile are never
+        // used.
+        if (p + dk < 0 || p + dk >= w + EDGE) continue;
+        prod = upper[p] * lower[p + dk];
+        if (t < 0)
+          acc->col[d][e] += prod;
+        else
+          acc->corner[d][t][e] = prod;
+      }
+    }
+  }
+}
+
+// Fill in H from the accumulated sums
+static void build_h(const StatsAcc *acc, int64_t *H) {
+  int a, b, t, e;
+  for (a = 0; a < WIENER_WIN2; ++a) {
+    for (b = a; b < WIENER_WIN2; ++b) {
+      int k1 = a / WIENER_WIN - WIENER_HALFWIN;
+      int l1 = a % WIENER_WIN - WIENER_HALFWIN;
+      int k2 = b / WIENER_WIN - WIENER_HALFWIN;
+      int l2 = b % WIENER_WIN - WIENER_HALFWIN;
+      int d;
+      int64_t sum;
+      // Make (k1, l1) the upper tap
+      if (l1 > l2) {
+        int tmp = k1;
+        k1 = k2;
+        k2 = tmp;
+        tmp = l1;
+        l1 = l2;
+        l2 = tmp;
+      }
+      d = (l2 - l1) * DK_RANGE + (k2 - k1) + EDGE;
+
+      // The tile shifted by (l1, k1) covers the middle of the extended tile,
+      // plus edge rows and columns [l1, l1 + EDGE) + WIENER_HALFWIN and
+      // [k1, k1 + EDGE) + WIENER_HALFWIN respectively.
+      sum = acc->mid[d];
+      for (e = k1 + WIENER_HALFWIN; e < k1 + WIENER_HALFWIN + EDGE; ++e)
+        sum += acc->col[d][e];
+      for (t = l1 + WIENER_HALFWIN; t < l1 + WIENER_HALFWIN + EDGE; ++t) {
+        sum += acc->row[d][t];
+        for (e = k1 + WIENER_HALFWIN; e < k1 + WIENER_HALFWIN + EDGE; ++e)
+          sum += acc->corner[d][t][e];
+      }
+      H[a * WIENER_WIN2 + b] = H[b * WIENER_WIN2 + a] = sum;
+    }
+  }
+}
+
+static void compute_stats(const uint8_t *dgd, const uint8_t *src, int highbd,
+                          int avg, int h_start, int h_end, int v_start,
+                          int v_end, int dgd_stride, int src_stride,
+                          int64_t *M, int64_t *H) {
+  const int w = h_end - h_start;
+  const int h = v_end - v_start;
+  DECLARE_ALIGNED(32, int16_t, rows[NUM_ROWS][ROW_STRIDE]);
+  DECLARE_ALIGNED(32, int16_t, mid_row[ROW_STRIDE]);
+  DECLARE_ALIGNED(32, int16_t, src_row[ROW_STRIDE]);
+  StatsAcc acc;
+  int u, k, l, loaded = 0;
+
+  memset(rows, 0, sizeof(rows));
+  memset(mid_row, 0, sizeof(mid_row));
+  memset(src_row, 0, sizeof(src_row));
+  memset(&acc, 0, sizeof(acc));
+  memset(M, 0, sizeof(*M) * WIENER_WIN2);
+
+  // Row u of the extended tile is row (v_start - WIENER_HALFWIN + u) of the
+  // frame, and it is buffered from column (h_start - WIENER_HALFWIN).
+  dgd += (v_start - WIENER_HALFWIN) * dgd_stride + h_start - WIENER_HALFWIN;
+  src += v_start * src_stride + h_start;
+
+  for (u = 0; u < h + EDGE; ++u) {
+    for (; loaded < AOMMIN(u + WIENER_WIN, h + EDGE); ++loaded) {
+      load_row(rows[loaded & (NUM_ROWS - 1)], dgd + loaded * dgd_stride,
+               highbd, w + EDGE, avg);
+    }
+
+    accumulate_row(&acc, rows, mid_row, u, w, h);
+
+    // Rows u to (u + EDGE) of the extended tile are the window for row u of
+    // the tile itself.
+    if (u < h) {
+      load_row(src_row, src + u * src_stride, highbd, w, avg);
+      for (k = 0; k < WIENER_WIN; ++k) {
+        for (l = 0; l < WIENER_WIN; ++l) {
+          M[k * WIENER_WIN + l] += hsum_epi32(dot_product(
+              src_row, rows[(u + l) & (NUM_ROWS - 1)] + k, w));
+        }
+      }
+    }
+  }
+
+  build_h(&acc, H);
+}
+
+void av1_compute_stats_avx2(const uint8_t *dgd, const uint8_t *src, int avg,
+                            int h_start, int h_end, int v_start, int v_end,
+                            int dgd_stride, int src_stride, int64_t *M,
+                            int64_t *H) {
+  const int w = h_end - h_start;
+  const int h = v_end - v_start;
+  if (w < EDGE || h < EDGE || w > MAX_TILE_W) {
+    av1_compute_stats_c(dgd, src, avg, h_start, h_end, v_start, v_end,
+                        dgd_stride, src_stride, M, H);
+    return;
+  }
+  compute_stats(dgd, src, 0, avg, h_start, h_end, v_start, v_end, dgd_stride,
+                src_stride, M, H);
+}
+
+#if CONFIG_HIGHBITDEPTH
+void av1_compute_stats_highbd_avx2(const uint16_t *dgd, const uint16_t *src,
+                                   int avg, int h_start, int h_end,
+                                   int v_start, int v_end, int dgd_stride,
+                                   int src_stride, int64_t *M, int64_t *H) {
+  const int w = h_end - h_start;
+  const int h = v_end - v_start;
+  if (w < EDGE || h < EDGE || w > MAX_TILE_W) {
+    av1_compute_stats_highbd_c(dgd, src, avg, h_start, h_end, v_start, v_end,
+                               dgd_stride, src_stride, M, H);
+    return;
+  }
+  compute_stats(CONVERT_TO_BYTEPTR(dgd), CONVERT_TO_BYTEPTR(src), 1, avg,
+                h_start, h_end, v_start, v_end, dgd_stride, src_stride, M, H);
+}
+#endif  // CONFIG_HIGHBITDEPTH
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "./av1_rtcd.h"
+#include "aom_ports/mem.h"
+#include "av1/encoder/ransac.h"
+
+/* The points are interleaved x, y pairs, which are split into vectors of x
+   and y. The products and sums are done in the same order as the C version,
+   without fused multiply-adds, and the square root is correctly rounded, so
+   the distances match it exactly. The inliers are then picked out of a mask
+   in index order. Points left over at the end go to the C version. */
+
+int av1_ransac_affine_inliers_avx2(const double *mat, const double *points1,
+                                   const double *points2, int npoints,
+                                   int min_inliers, int *inlier_indices,
+                                   double *distances) {
+  DECLARE_ALIGNED(32, double, dist[4]);
+  const __m256d m0 = _mm256_set1_pd(mat[0]);
+  const __m256d m1 = _mm256_set1_pd(mat[1]);
+  const __m256d m2 = _mm256_set1_pd(mat[2]);
+  const __m256d m3 = _mm256_set1_pd(mat[3]);
+  const __m256d m4 = _mm256_set1_pd(mat[4]);
+  const __m256d m5 = _mm256_set1_pd(mat[5]);
+  const __m256d threshold = _mm256_set1_pd(INLIER_THRESHOLD);
+  int num_inliers = 0;
+  int i, j;
+
+  for (i = 0; i + 4 <= npoints; i += 4) {
+    const __m256d a1 = _mm256_loadu_pd(points1 + i * 2);
+    const __m256d b1 = _mm256_loadu_pd(points1 + i * 2 + 4);
+    const __m256d a2 = _mm256_loadu_pd(points2 + i * 2);
+    const __m256d b2 = _mm256_loadu_pd(points2 + i * 2 + 4);
+    // The unpacks work within 128-bit lanes, so these hold points 0, 2, 1, 3.
+    const __m256d x = _mm256_unpacklo_pd(a1, b1);
+    const __m256d y = _mm256_unpackhi_pd(a1, b1);
+    const __m256d dx = _mm256_sub_pd(
+        _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(m2, x), _mm256_mul_pd(m3, y)), m0),
+        _mm256_unpacklo_pd(a2, b2));
+    const __m256d dy = _mm256_sub_pd(
+        _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(m4, x), _mm256_mul_pd(m5, y)), m1),
+        _mm256_unpackhi_pd(a2, b2));
+    const __m256d d = _mm256_permute4x64_pd(
+        _mm256_sqrt_pd(
+            _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))),
+        0xd8);
+    const int mask =
+        _mm256_movemask_pd(_mm256_cmp_pd(d, threshold, _CMP_LT_OQ));
+
+    _mm256_store_pd(dist, d);
+    for (j = 0; j < 4; ++j) {
+      inlier_indices[num_inliers] = i + j;
+      distances[num_inliers] = dist[j];
+      num_inliers += (mask >> j) & 1;
+    }
+    // No motion with fewer inliers than 'min_inliers' is kept, so stop as
+    // soon as the remaining points cannot make up the difference.
+    if (num_inliers + npoints - i - 4 < min_inliers) return num_inliers;
+  }
+
+  if (i < npoints) {
+    const int n = av1_ransac_affine_inliers_c(
+        mat, points1 + i * 2, points2 + i * 2, npoints - i,
+        min_inliers - num_inliers, inlier_indices + num_inliers,
+        distances + num_inliers);
+    for (j = 0; j < n; ++j) inlier_indices[num_inliers + j] += i;
+    num_inliers += n;
+  }
+  return num_inliers;
+}
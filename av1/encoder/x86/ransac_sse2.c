@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <emmintrin.h>
+
+#include "./av1_rtcd.h"
+#include "aom_ports/mem.h"
+#include "av1/encoder/ransac.h"
+
+/* Same as the AVX2 version, two points at a time. */
+
+int av1_ransac_affine_inliers_sse2(const double *mat, const double *points1,
+                                   const double *points2, int npoints,
+                                   int min_inliers, int *inlier_indices,
+                                   double *distances) {
+  DECLARE_ALIGNED(16, double, dist[2]);
+  const __m128d m0 = _mm_set1_pd(mat[0]);
+  const __m128d m1 = _mm_set1_pd(mat[1]);
+  const __m128d m2 = _mm_set1_pd(mat[2]);
+  const __m128d m3 = _mm_set1_pd(mat[3]);
+  const __m128d m4 = _mm_set1_pd(mat[4]);
+  const __m128d m5 = _mm_set1_pd(mat[5]);
+  const __m128d threshold = _mm_set1_pd(INLIER_THRESHOLD);
+  int num_inliers = 0;
+  int i, j;
+
+  for (i = 0; i + 2 <= npoints; i += 2) {
+    const __m128d a1 = _mm_loadu_pd(points1 + i * 2);
+    const __m128d b1 = _mm_loadu_pd(points1 + i * 2 + 2);
+    const __m128d a2 = _mm_loadu_pd(points2 + i * 2);
+    const __m128d b2 = _mm_loadu_pd(points2 + i * 2 + 2);
+    const __m128d x = _mm_unpacklo_pd(a1, b1);
+    const __m128d y = _mm_unpackhi_pd(a1, b1);
+    const __m128d dx = _mm_sub_pd(
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(m2, x), _mm_mul_pd(m3, y)), m0),
+        _mm_unpacklo_pd(a2, b2));
+    const __m128d dy = _mm_sub_pd(
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(m4, x), _mm_mul_pd(m5, y)), m1),
+        _mm_unpackhi_pd(a2, b2));
+    const __m128d d =
+        _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+    const int mask = _mm_movemask_pd(_mm_cmplt_pd(d, threshold));
+
+    _mm_store_pd(dist, d);
+    for (j = 0; j < 2; ++j) {
+      inlier_indices[num_inliers] = i + j;
+      distances[num_inliers] = dist[j];
+      num_inliers += (mask >> j) & 1;
+    }
+    if (num_inliers + npoints - i - 2 < min_inliers) return num_inliers;
+  }
+
+  if (i < npoints) {
+    const int n = av1_ransac_affine_inliers_c(
+        mat, points1 + i * 2, points2 + i * 2, npoints - i,
+        min_inliers - num_inliers, inlier_indices + num_inliers,
+        distances + num_inliers);
+    for (j = 0; j < n; ++j) inlier_indices[num_inliers + j] += i;
+    num_inliers += n;
+  }
+  return num_inliers;
+}
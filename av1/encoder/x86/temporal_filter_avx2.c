@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+#include <string.h>
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "aom_ports/mem.h"
+#include "av1/encoder/x86/temporal_filter_simd.h"
+
+/* The modifier of each pixel comes from the sum of the squared differences
+   over its 3x3 neighbourhood, clipped to the block. The squared differences
+   of each row are summed horizontally into a buffer with a zero row above
+   and below the block, which then only needs vertical sums of three rows.
+
+   The high bitdepth function shares all of the code below: the pixels are
+   passed around as CONVERT_TO_BYTEPTR() pointers plus a 'highbd' flag. */
+
+// Load 8 pixels, zero-extended to 32 bits.
+static INLINE __m256i load_pixels_32(const uint8_t *src, int highbd) {
+#if CONFIG_HIGHBITDEPTH
+  if (highbd)
+    return _mm256_cvtepu16_epi32(
+        _mm_loadu_si128((const __m128i *)CONVERT_TO_SHORTPTR(src)));
+#else
+  (void)highbd;
+#endif
+  return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)src));
+}
+
+static INLINE const uint8_t *offset_pixels(const uint8_t *src, int highbd,
+                                           int offset) {
+#if CONFIG_HIGHBITDEPTH
+  if (highbd) return CONVERT_TO_BYTEPTR(CONVERT_TO_SHORTPTR(src) + offset);
+#else
+  (void)highbd;
+#endif
+  return src + offset;
+}
+
+// Exact x / d for the per-lane divisors d encoded in 'magic', see
+// TF_DIV_MAGIC_*.
+static INLINE __m256i div_by_magic(__m256i x, __m256i magic) {
+  const __m256i even = _mm256_mul_epu32(x, magic);
+  const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32),
+                                       _mm256_srli_epi64(magic, 32));
+  return _mm256_blend_epi32(_mm256_srli_epi64(even, TF_DIV_SHIFT),
+                            _mm256_srli_epi64(odd, TF_DIV_SHIFT - 32), 0xaa);
+}
+
+static INLINE void temporal_filter_apply(const uint8_t *frame1,
+                                         unsigned int stride,
+                                         const uint8_t *frame2, int highbd,
+                                         unsigned int block_width,
+                                         unsigned int block_height,
+                                         int strength, int filter_weight,
+                                         unsigned int *accumulator,
+                                         uint16_t *count) {
+  // Horizontal sums of the squared differences, with a zero row above and
+  // below the block
+  DECLARE_ALIGNED(32, uint32_t, hsum[(TF_MAX_BLOCK + 2) * TF_MAX_BLOCK]);
+  // Squared differences of one row, with a zero column on either side
+  DECLARE_ALIGNED(32, uint32_t, sq[TF_MAX_BLOCK + 8]);
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+  const __m256i rounding =
+      _mm256_set1_epi32(strength > 0 ? 1 << (strength - 1) : 0);
+  const __m256i sixteen = _mm256_set1_epi32(16);
+  const __m256i weight = _mm256_set1_epi32(filter_weight);
+  const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  __m256i magic[2][TF_MAX_BLOCK / 8];
+  unsigned int i, j;
+
+  // The divisor of each pixel is the number of its neighbours within the
+  // block: 3 x 3 in the interior, down to 2 x 2 in the corners.
+  for (j = 0; j < block_width; j += 8) {
+    const __m256i col = _mm256_add_epi32(lane, _mm256_set1_epi32(j));
+    const __m256i col_edge =
+        _mm256_or_si256(_mm256_cmpeq_epi32(col, _mm256_setzero_si256()),
+                        _mm256_cmpeq_epi32(col, _mm256_set1_epi32(
+                                                    block_width - 1)));
+    magic[0][j / 8] = _mm256_blendv_epi8(_mm256_set1_epi32(TF_DIV_MAGIC_9),
+                                         _mm256_set1_epi32(TF_DIV_MAGIC_6),
+                                         col_edge);
+    magic[1][j / 8] = _mm256_blendv_epi8(_mm256_set1_epi32(TF_DIV_MAGIC_6),
+                                         _mm256_set1_epi32(TF_DIV_MAGIC_4),
+                                         col_edge);
+  }
+
+  memset(sq, 0, sizeof(sq));
+  memset(hsum, 0, TF_MAX_BLOCK * sizeof(*hsum));
+  memset(hsum + (block_height + 1) * TF_MAX_BLOCK, 0,
+         TF_MAX_BLOCK * sizeof(*hsum));
+  for (i = 0; i < block_height; ++i) {
+    for (j = 0; j < block_width; j += 8) {
+      const __m256i diff = _mm256_sub_epi32(
+          load_pixels_32(offset_pixels(frame1, highbd, i * stride + j), highbd),
+          load_pixels_32(offset_pixels(frame2, highbd, i * block_width + j),
+                         highbd));
+      _mm256_storeu_si256((__m256i *)(sq + 1 + j),
+                          _mm256_mullo_epi32(diff, diff));
+    }
+    for (j = 0; j < block_width; j += 8) {
+      const __m256i s = _mm256_add_epi32(
+          _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(sq + j)),
+                           _mm256_loadu_si256((const __m256i *)(sq + j + 1))),
+          _mm256_loadu_si256((const __m256i *)(sq + j + 2)));
+      _mm256_store_si256((__m256i *)(hsum + (i + 1) * TF_MAX_BLOCK + j), s);
+    }
+  }
+
+  for (i = 0; i < block_height; ++i) {
+    const int row_edge = i == 0 || i == block_height - 1;
+    const uint32_t *const h = hsum + i * TF_MAX_BLOCK;
+    for (j = 0; j < block_width; j += 8) {
+      const int k = i * block_width + j;
+      const __m256i sum = _mm256_add_epi32(
+          _mm256_add_epi32(_mm256_load_si256((const __m256i *)(h + j)),
+                           _mm256_load_si256(
+                               (const __m256i *)(h + TF_MAX_BLOCK + j))),
+          _mm256_load_si256((const __m256i *)(h + 2 * TF_MAX_BLOCK + j)));
+      const __m256i pixel =
+          load_pixels_32(offset_pixels(frame2, highbd, k), highbd);
+      __m256i modifier = div_by_magic(
+          _mm256_add_epi32(sum, _mm256_slli_epi32(sum, 1)),
+          magic[row_edge][j / 8]);
+      __m128i cnt;
+      modifier = _mm256_srl_epi32(_mm256_add_epi32(modifier, rounding), shift);
+      modifier = _mm256_sub_epi32(sixteen, _mm256_min_epi32(modifier, sixteen));
+      modifier = _mm256_mullo_epi32(modifier, weight);
+
+      cnt = _mm256_castsi256_si128(_mm256_permute4x64_epi64(
+          _mm256_packus_epi32(modifier, modifier), 0x08));
+      _mm_storeu_si128(
+          (__m128i *)(count + k),
+          _mm_add_epi16(_mm_loadu_si128((const __m128i *)(count + k)), cnt));
+      _mm256_storeu_si256(
+          (__m256i *)(accumulator + k),
+          _mm256_add_epi32(
+              _mm256_loadu_si256((const __m256i *)(accumulator + k)),
+              _mm256_mullo_epi32(modifier, pixel)));
+    }
+  }
+}
+
+void av1_temporal_filter_apply_avx2(uint8_t *frame1, unsigned int stride,
+                                    uint8_t *frame2, unsigned int block_width,
+                                    unsigned int block_height, int strength,
+                                    int filter_weight,
+                                    unsigned int *accumulator,
+                                    uint16_t *count) {
+  if (!TF_SIMD_BLOCK_OK(block_width, block_height, 8)) {
+    av1_temporal_filter_apply_c(frame1, stride, frame2, block_width,
+                                block_height, strength, filter_weight,
+                                accumulator, count);
+    return;
+  }
+  temporal_filter_apply(frame1, stride, frame2, 0, block_width, block_height,
+                        strength, filter_weight, accumulator, count);
+}
+
+#if CONFIG_HIGHBITDEPTH
+void av1_highbd_temporal_filter_apply_avx2(
+    uint8_t *frame1, unsigned int stride, uint8_t *frame2,
+    unsigned int block_width, unsigned int block_height, int strength,
+    int filter_weight, unsigned int *accumulator, uint16_t *count) {
+  if (!TF_SIMD_BLOCK_OK(block_width, block_height, 8)) {
+    av1_highbd_temporal_filter_apply_c(frame1, stride, frame2, block_width,
+                                       block_height, strength, filter_weight,
+                                       accumulator, count);
+    return;
+  }
+  temporal_filter_apply(frame1, stride, frame2, 1, block_width, block_height,
+                        strength, filter_weight, accumulator, count);
+}
+#endif  // CONFIG_HIGHBITDEPTH
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AV1_ENCODER_X86_TEMPORAL_FILTER_SIMD_H_
+#define AV1_ENCODER_X86_TEMPORAL_FILTER_SIMD_H_
+
+// Largest block handled by the SIMD temporal filters. The encoder filters
+// 16x16 luma blocks, and chroma blocks of at most that size.
+#define TF_MAX_BLOCK 16
+
+// Whether the SIMD filters, which work on 'n' pixels at a time, can handle
+// a block. Anything else goes to the C version.
+#define TF_SIMD_BLOCK_OK(w, h, n)                                   \
+  ((w) % (n) == 0 && (w) <= TF_MAX_BLOCK && (h) >= 2 &&             \
+   (h) <= TF_MAX_BLOCK)
+
+// The modifier is 3 times the sum of the squared differences around a pixel,
+// divided by the 4, 6 or 9 pixels summed. With 12-bit input, that is below
+// 2^29. (x * TF_DIV_MAGIC_d) >> TF_DIV_SHIFT is exactly x / d for any
+// x < 2^31.
+#define TF_DIV_SHIFT 33
+#define TF_DIV_MAGIC_4 ((int)0x80000000)
+#define TF_DIV_MAGIC_6 0x55555556
+#define TF_DIV_MAGIC_9 0x38e38e39
+
+#endif  // AV1_ENCODER_X86_TEMPORAL_FILTER_SIMD_H_
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <smmintrin.h>
+#include <string.h>
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_ports/mem.h"
+#include "av1/encoder/x86/temporal_filter_simd.h"
+
+/* Same as the AVX2 version, four pixels at a time. */
+
+// Load 4 pixels, zero-extended to 32 bits.
+static INLINE __m128i load_pixels_32(const uint8_t *src, int highbd) {
+#if CONFIG_HIGHBITDEPTH
+  if (highbd) return _mm_cvtepu16_epi32(xx_loadl_64(CONVERT_TO_SHORTPTR(src)));
+#else
+  (void)highbd;
+#endif
+  return _mm_cvtepu8_epi32(xx_loadl_32(src));
+}
+
+static INLINE const uint8_t *offset_pixels(const uint8_t *src, int highbd,
+                                           int offset) {
+#if CONFIG_HIGHBITDEPTH
+  if (highbd) return CONVERT_TO_BYTEPTR(CONVERT_TO_SHORTPTR(src) + offset);
+#else
+  (void)highbd;
+#endif
+  return src + offset;
+}
+
+// Exact x / d for the per-lane divisors d encoded in 'magic', see
+// TF_DIV_MAGIC_*.
+static INLINE __m128i div_by_magic(__m128i x, __m128i magic) {
+  const __m128i even = _mm_mul_epu32(x, magic);
+  const __m128i odd =
+      _mm_mul_epu32(_mm_srli_epi64(x, 32), _mm_srli_epi64(magic, 32));
+  return _mm_blend_epi16(_mm_srli_epi64(even, TF_DIV_SHIFT),
+                         _mm_srli_epi64(odd, TF_DIV_SHIFT - 32), 0xcc);
+}
+
+static INLINE void temporal_filter_apply(const uint8_t *frame1,
+                                         unsigned int stride,
+                                         const uint8_t *frame2, int highbd,
+                                         unsigned int block_width,
+                                         unsigned int block_height,
+                                         int strength, int filter_weight,
+                                         unsigned int *accumulator,
+                                         uint16_t *count) {
+  // Horizontal sums of the squared differences, with a zero row above and
+  // below the block
+  DECLARE_ALIGNED(16, uint32_t, hsum[(TF_MAX_BLOCK + 2) * TF_MAX_BLOCK]);
+  // Squared differences of one row, with a zero column on either side
+  DECLARE_ALIGNED(16, uint32_t, sq[TF_MAX_BLOCK + 4]);
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+  const __m128i rounding =
+      _mm_set1_epi32(strength > 0 ? 1 << (strength - 1) : 0);
+  const __m128i sixteen = _mm_set1_epi32(16);
+  const __m128i weight = _mm_set1_epi32(filter_weight);
+  const __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+  __m128i magic[2][TF_MAX_BLOCK / 4];
+  unsigned int i, j;
+
+  // The divisor of each pixel is the number of its neighbours within the
+  // block: 3 x 3 in the interior, down to 2 x 2 in the corners.
+  for (j = 0; j < block_width; j += 4) {
+    const __m128i col = _mm_add_epi32(lane, _mm_set1_epi32(j));
+    const __m128i col_edge =
+        _mm_or_si128(_mm_cmpeq_epi32(col, _mm_setzero_si128()),
+                     _mm_cmpeq_epi32(col, _mm_set1_epi32(block_width - 1)));
+    magic[0][j / 4] = _mm_blendv_epi8(_mm_set1_epi32(TF_DIV_MAGIC_9),
+                                      _mm_set1_epi32(TF_DIV_MAGIC_6), col_edge);
+    magic[1][j / 4] = _mm_blendv_epi8(_mm_set1_epi32(TF_DIV_MAGIC_6),
+                                      _mm_set1_epi32(TF_DIV_MAGIC_4), col_edge);
+  }
+
+  memset(sq, 0, sizeof(sq));
+  memset(hsum, 0, TF_MAX_BLOCK * sizeof(*hsum));
+  memset(hsum + (block_height + 1) * TF_MAX_BLOCK, 0,
+         TF_MAX_BLOCK * sizeof(*hsum));
+  for (i = 0; i < block_height; ++i) {
+    for (j = 0; j < block_width; j += 4) {
+      const __m128i diff = _mm_sub_epi32(
+          load_pixels_32(offset_pixels(frame1, highbd, i * stride + j), highbd),
+          load_pixels_32(offset_pixels(frame2, highbd, i * block_width + j),
+                         highbd));
+      xx_storeu_128(sq + 1 + j, _mm_mullo_epi32(diff, diff));
+    }
+    for (j = 0; j < block_width; j += 4) {
+      const __m128i s =
+          _mm_add_epi32(_mm_add_epi32(xx_loadu_128(sq + j),
+                                      xx_loadu_128(sq + j + 1)),
+                        xx_loadu_128(sq + j + 2));
+      xx_store_128(hsum + (i + 1) * TF_MAX_BLOCK + j, s);
+    }
+  }
+
+  for (i = 0; i < block_height; ++i) {
+    const int row_edge = i == 0 || i == block_height - 1;
+    const uint32_t *const h = hsum + i * TF_MAX_BLOCK;
+    for (j = 0; j < block_width; j += 4) {
+      const int k = i * block_width + j;
+      const __m128i sum = _mm_add_epi32(
+          _mm_add_epi32(xx_load_128(h + j), xx_load_128(h + TF_MAX_BLOCK + j)),
+          xx_load_128(h + 2 * TF_MAX_BLOCK + j));
+      const __m128i pixel =
+          load_pixels_32(offset_pixels(frame2, highbd, k), highbd);
+      __m128i modifier = div_by_magic(
+          _mm_add_epi32(sum, _mm_slli_epi32(sum, 1)), magic[row_edge][j / 4]);
+      modifier = _mm_srl_epi32(_mm_add_epi32(modifier, rounding), shift);
+      modifier = _mm_sub_epi32(sixteen, _mm_min_epi32(modifier, sixteen));
+      modifier = _mm_mullo_epi32(modifier, weight);
+
+      xx_storel_64(count + k,
+                   _mm_add_epi16(xx_loadl_64(count + k),
+                                 _mm_packus_epi32(modifier, modifier)));
+      xx_storeu_128(accumulator + k,
+                    _mm_add_epi32(xx_loadu_128(accumulator + k),
+                                  _mm_mullo_epi32(modifier, pixel)));
+    }
+  }
+}
+
+void av1_temporal_filter_apply_sse4_1(uint8_t *frame1, unsigned int stride,
+                                      uint8_t *frame2,
+                                      unsigned int block_width,
+                                      unsigned int block_height, int strength,
+                                      int filter_weight,
+                                      unsigned int *accumulator,
+                                      uint16_t *count) {
+  if (!TF_SIMD_BLOCK_OK(block_width, block_height, 4)) {
+    av1_temporal_filter_apply_c(frame1, stride, frame2, block_width,
+                                block_height, strength, filter_weight,
+                                accumulator, count);
+    return;
+  }
+  temporal_filter_apply(frame1, stride, frame2, 0, block_width, block_height,
+                        strength, filter_weight, accumulator, count);
+}
+
+#if CONFIG_HIGHBITDEPTH
+void av1_highbd_temporal_filter_apply_sse4_1(
+    uint8_t *frame1, unsigned int stride, uint8_t *frame2,
+    unsigned int block_width, unsigned int block_height, int strength,
+    int filter_weight, unsigned int *accumulator, uint16_t *count) {
+  if (!TF_SIMD_BLOCK_OK(block_width, block_height, 4)) {
+    av1_highbd_temporal_filter_apply_c(frame1, stride, frame2, block_width,
+                                       block_height, strength, filter_weight,
+                                       accumulator, count);
+    return;
+  }
+  temporal_filter_apply(frame1, stride, frame2, 1, block_width, block_height,
+                        strength, filter_weight, accumulator, count);
+}
+#endif  // CONFIG_HIGHBITDEPTH
@@ -19,6 +19,7 @@
 #include "test/util.h"
 #include "test/webm_video_source.h"
 #include "aom_ports/aom_timer.h"
+#include "aom_util/aom_thread.h"
 #include "./ivfenc.h"
 #include "./aom_version.h"
 
@@ -184,35 +185,16 @@ const EncodePerfTestVideo kAV1EncodePerfTestVectors[] = {
   EncodePerfTestVideo("niklas_1280_720_30.yuv", 1280, 720, 600, 470),
 };
 
-TEST_P(AV1NewEncodeDecodePerfTest, PerfTest) {
-  SetUp();
-
-  // TODO(JBB): Make this work by going through the set of given files.
-  const int i = 0;
-  const aom_rational timebase = { 33333333, 1000000000 };
-  cfg_.g_timebase = timebase;
-  cfg_.rc_target_bitrate = kAV1EncodePerfTestVectors[i].bitrate;
-
-  init_flags_ = AOM_CODEC_USE_PSNR;
-
-  const char *video_name = kAV1EncodePerfTestVectors[i].name;
-  libaom_test::I420VideoSource video(
-      video_name, kAV1EncodePerfTestVectors[i].width,
-      kAV1EncodePerfTestVectors[i].height, timebase.den, timebase.num, 0,
-      kAV1EncodePerfTestVectors[i].frames);
-  set_speed(2);
-
-  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
-
-  const uint32_t threads = 4;
-
+// Decodes kNewEncodeOutputFile and prints the decoding speed.
+void DecodePerf(int threads, aom_codec_flags_t flags, int row_mt) {
   libaom_test::IVFVideoSource decode_video(kNewEncodeOutputFile);
   decode_video.Init();
 
   aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
   cfg.threads = threads;
   cfg.allow_lowbitdepth = CONFIG_LOWBITDEPTH;
-  libaom_test::AV1Decoder decoder(cfg, 0);
+  libaom_test::AV1Decoder decoder(cfg, flags);
+  decoder.Control(AV1D_SET_ROW_MT, row_mt);
 
   aom_usec_timer t;
   aom_usec_timer_start(&t);
@@ -232,13 +214,50 @@ TEST_P(AV1NewEncodeDecodePerfTest, PerfTest) {
   printf("\t\"type\" : \"decode_perf_test\",\n");
   printf("\t\"version\" : \"%s\",\n", VERSION_STRING_NOSP);
   printf("\t\"videoName\" : \"%s\",\n", kNewEncodeOutputFile);
-  printf("\t\"threadCount\" : %u,\n", threads);
+  printf("\t\"threadCount\" : %d,\n", threads);
+  printf("\t\"frameParallel\" : %d,\n",
+         (flags & AOM_CODEC_USE_FRAME_THREADING) != 0);
+  printf("\t\"rowMt\" : %d,\n", row_mt);
   printf("\t\"decodeTimeSecs\" : %f,\n", elapsed_secs);
   printf("\t\"totalFrames\" : %u,\n", decode_frames);
   printf("\t\"framesPerSecond\" : %f\n", fps);
   printf("}\n");
 }
 
+TEST_P(AV1NewEncodeDecodePerfTest, PerfTest) {
+  SetUp();
+
+  // TODO(JBB): Make this work by going through the set of given files.
+  const int i = 0;
+  const aom_rational timebase = { 33333333, 1000000000 };
+  cfg_.g_timebase = timebase;
+  cfg_.rc_target_bitrate = kAV1EncodePerfTestVectors[i].bitrate;
+
+  init_flags_ = AOM_CODEC_USE_PSNR;
+
+  const char *video_name = kAV1EncodePerfTestVectors[i].name;
+  libaom_test::I420VideoSource video(
+      video_name, kAV1EncodePerfTestVectors[i].width,
+      kAV1EncodePerfTestVectors[i].height, timebase.den, timebase.num, 0,
+      kAV1EncodePerfTestVectors[i].frames);
+  set_speed(2);
+
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+  // Decode with the blocks parsed and reconstructed one by one, and in two
+  // stages, by superblock row.
+  const int kDecodeThreads[] = { 1, 4 };
+  for (size_t j = 0; j < sizeof(kDecodeThreads) / sizeof(*kDecodeThreads);
+       ++j) {
+    for (int row_mt = 0; row_mt <= 1; ++row_mt)
+      DecodePerf(kDecodeThreads[j], 0, row_mt);
+  }
+
+  // Frame parallel decoding, over the range of frame worker counts.
+  for (int threads = 2; threads <= MAX_DECODE_THREADS; threads *= 2)
+    DecodePerf(threads, AOM_CODEC_USE_FRAME_THREADING, 0);
+}
+
 AV1_INSTANTIATE_TEST_CASE(AV1NewEncodeDecodePerfTest,
                           ::testing::Values(::libaom_test::kTwoPassGood));
 }  // namespace
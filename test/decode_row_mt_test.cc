@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string>
+#include <vector>
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+
+namespace {
+
+const int kThreads[] = { 1, 2, 4 };
+const int kNumThreads = sizeof(kThreads) / sizeof(kThreads[0]);
+
+// Decodes the stream being encoded with 1, 2 and 4 threads, each with row
+// based multi-threading off and on, and checks that the decoded frames are
+// the same for all of them.
+class AV1DecodeRowMTTest
+    : public ::libaom_test::CodecTestWithParam<int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecodeRowMTTest()
+      : EncoderTest(GET_PARAM(0)), n_tile_cols_(GET_PARAM(1)) {}
+
+  virtual ~AV1DecodeRowMTTest() {
+    for (size_t i = 0; i < decoders_.size(); ++i) delete decoders_[i];
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+
+    for (int i = 0; i < kNumThreads; ++i) {
+      for (int row_mt = 0; row_mt <= 1; ++row_mt) {
+        aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+        cfg.threads = kThreads[i];
+        cfg.allow_lowbitdepth = CONFIG_LOWBITDEPTH;
+        ::libaom_test::Decoder *const decoder = codec_->CreateDecoder(cfg, 0);
+        decoder->Control(AV1D_SET_ROW_MT, row_mt);
+#if CONFIG_AV1 && CONFIG_EXT_TILE
+        decoder->Control(AV1_SET_DECODE_TILE_ROW, -1);
+        decoder->Control(AV1_SET_DECODE_TILE_COL, -1);
+#endif
+        decoders_.push_back(decoder);
+        md5_.push_back(std::vector<std::string>());
+      }
+    }
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AV1E_SET_TILE_COLUMNS, n_tile_cols_);
+#if CONFIG_EXT_TILE
+      encoder->Control(AV1E_SET_TILE_ENCODING_MODE, 0);  // TILE_NORMAL
+#endif                                                   // CONFIG_EXT_TILE
+      encoder->Control(AOME_SET_CPUUSED, 8);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    for (size_t i = 0; i < decoders_.size(); ++i) {
+      const aom_codec_err_t res = decoders_[i]->DecodeFrame(
+          reinterpret_cast<uint8_t *>(pkt->data.frame.buf),
+          pkt->data.frame.sz);
+      if (res != AOM_CODEC_OK) {
+        abort_ = true;
+        ASSERT_EQ(AOM_CODEC_OK, res) << decoders_[i]->DecodeError();
+      }
+      ::libaom_test::DxDataIterator dec_iter = decoders_[i]->GetDxData();
+      const aom_image_t *img;
+      while ((img = dec_iter.Next()) != NULL) {
+        ::libaom_test::MD5 md5_res;
+        md5_res.Add(img);
+        md5_[i].push_back(md5_res.Get());
+      }
+    }
+  }
+
+  void DoTest() {
+    // Noise frames of 4 superblock rows.
+    ::libaom_test::RandomVideoSource video;
+    video.SetSize(512, 256);
+    video.set_limit(10);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_target_bitrate = 1000;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+    ASSERT_FALSE(md5_[0].empty());
+    for (size_t i = 1; i < md5_.size(); ++i) {
+      ASSERT_EQ(md5_[0], md5_[i]) << "threads " << kThreads[i / 2]
+                                  << ", row-mt " << i % 2;
+    }
+  }
+
+  int n_tile_cols_;
+  std::vector< ::libaom_test::Decoder *> decoders_;
+  std::vector<std::vector<std::string> > md5_;
+};
+
+TEST_P(AV1DecodeRowMTTest, MD5Match) { DoTest(); }
+
+// One tile column, or two.
+AV1_INSTANTIATE_TEST_CASE(AV1DecodeRowMTTest, ::testing::Values(0, 1));
+
+}  // namespace
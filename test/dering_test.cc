@@ -323,6 +323,15 @@ INSTANTIATE_TEST_CASE_P(SSE4_1, CDEFDeringFindDirTest,
                                                      &od_dir_find8_c)));
 #endif
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, CDEFDeringDirTest,
+    ::testing::Values(make_tuple(&od_filter_dering_direction_4x4_avx2,
+                                 &od_filter_dering_direction_4x4_c, 4),
+                      make_tuple(&od_filter_dering_direction_8x8_avx2,
+                                 &od_filter_dering_direction_8x8_c, 8)));
+#endif
+
 #if HAVE_NEON
 INSTANTIATE_TEST_CASE_P(
     NEON, CDEFDeringDirTest,
@@ -372,6 +381,15 @@ INSTANTIATE_TEST_CASE_P(SSE4_1, CDEFDeringFindDirSpeedTest,
                                                      &od_dir_find8_c)));
 #endif
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, CDEFDeringSpeedTest,
+    ::testing::Values(make_tuple(&od_filter_dering_direction_4x4_avx2,
+                                 &od_filter_dering_direction_4x4_c, 4),
+                      make_tuple(&od_filter_dering_direction_8x8_avx2,
+                                 &od_filter_dering_direction_8x8_c, 8)));
+#endif
+
 #if HAVE_NEON
 INSTANTIATE_TEST_CASE_P(
     NEON, CDEFDeringSpeedTest,
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "./aom_config.h"
+#include "aom/aomcx.h"
+#include "aom/aom_encoder.h"
+#include "av1/encoder/firstpass.h"
+#include "test/acm_random.h"
+
+namespace {
+
+const int kWidth = 176;
+const int kHeight = 144;
+const int kFrames = 36;
+const int kChunkFrames = 12;
+const int kWarmup = 8;
+
+// The chunk statistics of the frames after a warm-up may differ from those of
+// a first pass of the whole sequence: the warm-up starts from an intra frame,
+// and the small differences in the reconstructed references persist. On this
+// clip the errors differ by less than 1%, and are checked against 3%. The
+// choice of the second reference is close to a tie on a pan, so up to 7 of
+// the 99 macroblocks of a frame change it, checked against 10.
+const double kErrorTolerance = 0.03;
+const double kPcntTolerance = 0.1;
+
+// Fills img with frame n of a noisy texture panning right and down.
+void FillFrame(aom_image_t *img, int n, libaom_test::ACMRandom *rnd) {
+  for (int plane = 0; plane < 3; ++plane) {
+    const int w = plane ? (kWidth + 1) / 2 : kWidth;
+    const int h = plane ? (kHeight + 1) / 2 : kHeight;
+    const int scale = plane ? 2 : 1;
+    for (int r = 0; r < h; ++r) {
+      uint8_t *const row = img->planes[plane] + r * img->stride[plane];
+      for (int c = 0; c < w; ++c) {
+        const double x = c * scale + 1.5 * n;
+        const double y = r * scale + 0.5 * n;
+        const double v = 128 + 60 * sin(x * 0.07) * cos(y * 0.05) +
+                         30 * sin((x + y) * 0.21) + rnd->Rand8() % 5 - 2;
+        row[c] = plane ? (uint8_t)(128 + (v - 128) / 4) : (uint8_t)v;
+      }
+    }
+  }
+}
+
+// Runs a first pass over the frames [first, end) and returns the statistics
+// packets, the total last.
+std::vector<FIRSTPASS_STATS> RunFirstPass(int first, int end, int chunk_start) {
+  std::vector<FIRSTPASS_STATS> stats;
+  aom_codec_enc_cfg_t cfg;
+  aom_codec_ctx_t enc;
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_enc_config_default(aom_codec_av1_cx(), &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_timebase.num = 1;
+  cfg.g_timebase.den = 30;
+  cfg.g_pass = AOM_RC_FIRST_PASS;
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_enc_init(&enc, aom_codec_av1_cx(), &cfg, 0));
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&enc, AV1E_SET_FIRST_PASS_CHUNK_START,
+                              chunk_start));
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&enc, AV1E_SET_FIRST_PASS_CHUNK_WARMUP, kWarmup));
+
+  aom_image_t *const img =
+      aom_img_alloc(NULL, AOM_IMG_FMT_I420, kWidth, kHeight, 32);
+  bool flushed = false;
+  for (int n = first; !flushed; ++n) {
+    // The noise of a frame only depends on its index.
+    libaom_test::ACMRandom rnd(n + 1);
+    if (n < end) FillFrame(img, n, &rnd);
+    EXPECT_EQ(AOM_CODEC_OK, aom_codec_encode(&enc, n < end ? img : NULL, n, 1,
+                                             0, AOM_DL_GOOD_QUALITY));
+    flushed = n >= end;
+    aom_codec_iter_t iter = NULL;
+    const aom_codec_cx_pkt_t *pkt;
+    while ((pkt = aom_codec_get_cx_data(&enc, &iter)) != NULL) {
+      flushed = false;
+      if (pkt->kind != AOM_CODEC_STATS_PKT) continue;
+      EXPECT_EQ(sizeof(FIRSTPASS_STATS), pkt->data.twopass_stats.sz);
+      FIRSTPASS_STATS fps;
+      memcpy(&fps, pkt->data.twopass_stats.buf, sizeof(fps));
+      stats.push_back(fps);
+    }
+  }
+  aom_img_free(img);
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&enc));
+  return stats;
+}
+
+void ExpectNear(double expected, double actual, double tolerance,
+                const char *name) {
+  EXPECT_LE(fabs(actual - expected), tolerance * fabs(expected))
+      << name << ": " << expected << " vs " << actual;
+}
+
+// Checks that a first pass split in chunks, each with its warm-up frames,
+// gives the statistics of a first pass of the whole sequence: exactly for the
+// first chunk, and within the tolerances for the others.
+TEST(FirstPassChunkTest, MatchesSerialFirstPass) {
+  const std::vector<FIRSTPASS_STATS> serial = RunFirstPass(0, kFrames, 0);
+  ASSERT_EQ(static_cast<size_t>(kFrames + 1), serial.size());
+
+  FIRSTPASS_STATS total;
+  memset(&total, 0, sizeof(total));
+  for (int start = 0; start < kFrames; start += kChunkFrames) {
+    SCOPED_TRACE(start);
+    const int first = start > kWarmup ? start - kWarmup : 0;
+    const std::vector<FIRSTPASS_STATS> chunk =
+        RunFirstPass(first, start + kChunkFrames, start);
+    ASSERT_EQ(static_cast<size_t>(kChunkFrames + 1), chunk.size());
+    total.count += chunk.back().count;
+    total.coded_error += chunk.back().coded_error;
+
+    for (int i = 0; i < kChunkFrames; ++i) {
+      const FIRSTPASS_STATS &expected = serial[start + i];
+      const FIRSTPASS_STATS &actual = chunk[i];
+      SCOPED_TRACE(start + i);
+      ASSERT_EQ(expected.frame, actual.frame);
+      if (first == 0) {
+        EXPECT_EQ(0, memcmp(&expected, &actual, sizeof(expected)));
+        continue;
+      }
+      ExpectNear(expected.intra_error, actual.intra_error, kErrorTolerance,
+                 "intra_error");
+      ExpectNear(expected.coded_error, actual.coded_error, kErrorTolerance,
+                 "coded_error");
+      ExpectNear(expected.sr_coded_error, actual.sr_coded_error,
+                 kErrorTolerance, "sr_coded_error");
+      EXPECT_NEAR(expected.pcnt_inter, actual.pcnt_inter, kPcntTolerance);
+      EXPECT_NEAR(expected.pcnt_second_ref, actual.pcnt_second_ref,
+                  kPcntTolerance);
+    }
+  }
+  EXPECT_EQ(serial.back().count, total.count);
+  ExpectNear(serial.back().coded_error, total.coded_error, kErrorTolerance,
+             "total coded_error");
+}
+
+}  // namespace
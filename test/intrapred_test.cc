@@ -29,27 +29,36 @@ using libaom_test::ACMRandom;
 
 const int count_test_block = 100000;
 
-typedef void (*IntraPred)(uint16_t *dst, ptrdiff_t stride,
-                          const uint16_t *above, const uint16_t *left, int bps);
+typedef void (*HighbdIntraPred)(uint16_t *dst, ptrdiff_t stride,
+                                const uint16_t *above, const uint16_t *left,
+                                int bps);
+typedef void (*IntraPred)(uint8_t *dst, ptrdiff_t stride, const uint8_t *above,
+                          const uint8_t *left);
 
+template <typename FuncType>
 struct IntraPredFunc {
-  IntraPredFunc(IntraPred pred = NULL, IntraPred ref = NULL,
-                int block_size_value = 0, int bit_depth_value = 0)
-      : pred_fn(pred), ref_fn(ref), block_size(block_size_value),
-        bit_depth(bit_depth_value) {}
-
-  IntraPred pred_fn;
-  IntraPred ref_fn;
-  int block_size;
+  IntraPredFunc(FuncType pred = NULL, FuncType ref = NULL,
+                int block_width_value = 0, int block_height_value = 0,
+                int bit_depth_value = 0)
+      : pred_fn(pred), ref_fn(ref), block_width(block_width_value),
+        block_height(block_height_value), bit_depth(bit_depth_value) {}
+
+  FuncType pred_fn;
+  FuncType ref_fn;
+  int block_width;
+  int block_height;
   int bit_depth;
 };
 
-class AV1IntraPredTest : public ::testing::TestWithParam<IntraPredFunc> {
+template <typename FuncType, typename Pixel>
+class AV1IntraPredTest
+    : public ::testing::TestWithParam<IntraPredFunc<FuncType> > {
  public:
-  void RunTest(uint16_t *left_col, uint16_t *above_data, uint16_t *dst,
-               uint16_t *ref_dst) {
+  void RunTest(Pixel *left_col, Pixel *above_data, Pixel *dst,
+               Pixel *ref_dst) {
     ACMRandom rnd(ACMRandom::DeterministicSeed());
-    const int block_size = params_.block_size;
+    const int block_width = params_.block_width;
+    const int block_height = params_.block_height;
     above_row_ = above_data + 16;
     left_col_ = left_col;
     dst_ = dst;
@@ -57,14 +66,14 @@ class AV1IntraPredTest : public ::testing::TestWithParam<IntraPredFunc> {
     int error_count = 0;
     for (int i = 0; i < count_test_block; ++i) {
       // Fill edges with random data, try first with saturated values.
-      for (int x = -1; x <= block_size * 2; x++) {
+      for (int x = -1; x <= block_width * 2; x++) {
         if (i == 0) {
           above_row_[x] = mask_;
         } else {
           above_row_[x] = rnd.Rand16() & mask_;
         }
       }
-      for (int y = 0; y < block_size; y++) {
+      for (int y = 0; y < block_height; y++) {
         if (i == 0) {
           left_col_[y] = mask_;
         } else {
@@ -79,23 +88,19 @@ class AV1IntraPredTest : public ::testing::TestWithParam<IntraPredFunc> {
 
  protected:
   virtual void SetUp() {
-    params_ = GetParam();
-    stride_ = params_.block_size * 3;
+    params_ = this->GetParam();
+    stride_ = params_.block_width * 3;
     mask_ = (1 << params_.bit_depth) - 1;
   }
 
-  void Predict() {
-    const int bit_depth = params_.bit_depth;
-    params_.ref_fn(ref_dst_, stride_, above_row_, left_col_, bit_depth);
-    ASM_REGISTER_STATE_CHECK(
-        params_.pred_fn(dst_, stride_, above_row_, left_col_, bit_depth));
-  }
+  virtual void Predict() = 0;
 
   void CheckPrediction(int test_case_number, int *error_count) const {
     // For each pixel ensure that the calculated value is the same as reference.
-    const int block_size = params_.block_size;
-    for (int y = 0; y < block_size; y++) {
-      for (int x = 0; x < block_size; x++) {
+    const int block_width = params_.block_width;
+    const int block_height = params_.block_height;
+    for (int y = 0; y < block_height; y++) {
+      for (int x = 0; x < block_width; x++) {
         *error_count += ref_dst_[x + y * stride_] != dst_[x + y * stride_];
         if (*error_count == 1) {
           ASSERT_EQ(ref_dst_[x + y * stride_], dst_[x + y * stride_])
@@ -105,17 +110,37 @@ class AV1IntraPredTest : public ::testing::TestWithParam<IntraPredFunc> {
     }
   }
 
-  uint16_t *above_row_;
-  uint16_t *left_col_;
-  uint16_t *dst_;
-  uint16_t *ref_dst_;
+  Pixel *above_row_;
+  Pixel *left_col_;
+  Pixel *dst_;
+  Pixel *ref_dst_;
   ptrdiff_t stride_;
   int mask_;
 
-  IntraPredFunc params_;
+  IntraPredFunc<FuncType> params_;
 };
 
-TEST_P(AV1IntraPredTest, IntraPredTests) {
+class HighbdIntraPredTest
+    : public AV1IntraPredTest<HighbdIntraPred, uint16_t> {
+ protected:
+  void Predict() {
+    const int bit_depth = params_.bit_depth;
+    params_.ref_fn(ref_dst_, stride_, above_row_, left_col_, bit_depth);
+    ASM_REGISTER_STATE_CHECK(
+        params_.pred_fn(dst_, stride_, above_row_, left_col_, bit_depth));
+  }
+};
+
+class LowbdIntraPredTest : public AV1IntraPredTest<IntraPred, uint8_t> {
+ protected:
+  void Predict() {
+    params_.ref_fn(ref_dst_, stride_, above_row_, left_col_);
+    ASM_REGISTER_STATE_CHECK(
+        params_.pred_fn(dst_, stride_, above_row_, left_col_));
+  }
+};
+
+TEST_P(HighbdIntraPredTest, IntraPredTests) {
   // max block size is 32
   DECLARE_ALIGNED(16, uint16_t, left_col[2 * 32]);
   DECLARE_ALIGNED(16, uint16_t, above_data[2 * 32 + 32]);
@@ -124,114 +149,209 @@ TEST_P(AV1IntraPredTest, IntraPredTests) {
   RunTest(left_col, above_data, dst, ref_dst);
 }
 
+TEST_P(LowbdIntraPredTest, IntraPredTests) {
+  // max block size is 32
+  DECLARE_ALIGNED(16, uint8_t, left_col[2 * 32]);
+  DECLARE_ALIGNED(16, uint8_t, above_data[2 * 32 + 32]);
+  DECLARE_ALIGNED(16, uint8_t, dst[3 * 32 * 32]);
+  DECLARE_ALIGNED(16, uint8_t, ref_dst[3 * 32 * 32]);
+  RunTest(left_col, above_data, dst, ref_dst);
+}
+
+typedef IntraPredFunc<HighbdIntraPred> HighbdIntraPredFunc;
+typedef IntraPredFunc<IntraPred> LowbdIntraPredFunc;
+
 #if HAVE_SSE2
 #if CONFIG_HIGHBITDEPTH
-const IntraPredFunc IntraPredTestVector8[] = {
-  IntraPredFunc(&aom_highbd_dc_predictor_32x32_sse2,
-                &aom_highbd_dc_predictor_32x32_c, 32, 8),
+const HighbdIntraPredFunc IntraPredTestVector8[] = {
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_32x32_sse2,
+                      &aom_highbd_dc_predictor_32x32_c, 32, 32, 8),
 #if !CONFIG_ALT_INTRA
-  IntraPredFunc(&aom_highbd_tm_predictor_16x16_sse2,
-                &aom_highbd_tm_predictor_16x16_c, 16, 8),
-  IntraPredFunc(&aom_highbd_tm_predictor_32x32_sse2,
-                &aom_highbd_tm_predictor_32x32_c, 32, 8),
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_16x16_sse2,
+                      &aom_highbd_tm_predictor_16x16_c, 16, 16, 8),
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_32x32_sse2,
+                      &aom_highbd_tm_predictor_32x32_c, 32, 32, 8),
 #endif  // !CONFIG_ALT_INTRA
 
-  IntraPredFunc(&aom_highbd_dc_predictor_4x4_sse2,
-                &aom_highbd_dc_predictor_4x4_c, 4, 8),
-  IntraPredFunc(&aom_highbd_dc_predictor_8x8_sse2,
-                &aom_highbd_dc_predictor_8x8_c, 8, 8),
-  IntraPredFunc(&aom_highbd_dc_predictor_16x16_sse2,
-                &aom_highbd_dc_predictor_16x16_c, 16, 8),
-  IntraPredFunc(&aom_highbd_v_predictor_4x4_sse2, &aom_highbd_v_predictor_4x4_c,
-                4, 8),
-  IntraPredFunc(&aom_highbd_v_predictor_8x8_sse2, &aom_highbd_v_predictor_8x8_c,
-                8, 8),
-  IntraPredFunc(&aom_highbd_v_predictor_16x16_sse2,
-                &aom_highbd_v_predictor_16x16_c, 16, 8),
-  IntraPredFunc(&aom_highbd_v_predictor_32x32_sse2,
-                &aom_highbd_v_predictor_32x32_c, 32, 8)
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_4x4_sse2,
+                      &aom_highbd_dc_predictor_4x4_c, 4, 4, 8),
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_8x8_sse2,
+                      &aom_highbd_dc_predictor_8x8_c, 8, 8, 8),
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_16x16_sse2,
+                      &aom_highbd_dc_predictor_16x16_c, 16, 16, 8),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_4x4_sse2,
+                      &aom_highbd_v_predictor_4x4_c, 4, 4, 8),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_8x8_sse2,
+                      &aom_highbd_v_predictor_8x8_c, 8, 8, 8),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_16x16_sse2,
+                      &aom_highbd_v_predictor_16x16_c, 16, 16, 8),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_32x32_sse2,
+                      &aom_highbd_v_predictor_32x32_c, 32, 32, 8)
 #if !CONFIG_ALT_INTRA
       ,
-  IntraPredFunc(&aom_highbd_tm_predictor_4x4_sse2,
-                &aom_highbd_tm_predictor_4x4_c, 4, 8),
-  IntraPredFunc(&aom_highbd_tm_predictor_8x8_sse2,
-                &aom_highbd_tm_predictor_8x8_c, 8, 8)
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_4x4_sse2,
+                      &aom_highbd_tm_predictor_4x4_c, 4, 4, 8),
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_8x8_sse2,
+                      &aom_highbd_tm_predictor_8x8_c, 8, 8, 8)
 #endif  // !CONFIG_ALT_INTRA
 };
 
-INSTANTIATE_TEST_CASE_P(SSE2_TO_C_8, AV1IntraPredTest,
+INSTANTIATE_TEST_CASE_P(SSE2_TO_C_8, HighbdIntraPredTest,
                         ::testing::ValuesIn(IntraPredTestVector8));
 
-const IntraPredFunc IntraPredTestVector10[] = {
-  IntraPredFunc(&aom_highbd_dc_predictor_32x32_sse2,
-                &aom_highbd_dc_predictor_32x32_c, 32, 10),
+const HighbdIntraPredFunc IntraPredTestVector10[] = {
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_32x32_sse2,
+                      &aom_highbd_dc_predictor_32x32_c, 32, 32, 10),
 #if !CONFIG_ALT_INTRA
-  IntraPredFunc(&aom_highbd_tm_predictor_16x16_sse2,
-                &aom_highbd_tm_predictor_16x16_c, 16, 10),
-  IntraPredFunc(&aom_highbd_tm_predictor_32x32_sse2,
-                &aom_highbd_tm_predictor_32x32_c, 32, 10),
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_16x16_sse2,
+                      &aom_highbd_tm_predictor_16x16_c, 16, 16, 10),
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_32x32_sse2,
+                      &aom_highbd_tm_predictor_32x32_c, 32, 32, 10),
 #endif  // !CONFIG_ALT_INTRA
-  IntraPredFunc(&aom_highbd_dc_predictor_4x4_sse2,
-                &aom_highbd_dc_predictor_4x4_c, 4, 10),
-  IntraPredFunc(&aom_highbd_dc_predictor_8x8_sse2,
-                &aom_highbd_dc_predictor_8x8_c, 8, 10),
-  IntraPredFunc(&aom_highbd_dc_predictor_16x16_sse2,
-                &aom_highbd_dc_predictor_16x16_c, 16, 10),
-  IntraPredFunc(&aom_highbd_v_predictor_4x4_sse2, &aom_highbd_v_predictor_4x4_c,
-                4, 10),
-  IntraPredFunc(&aom_highbd_v_predictor_8x8_sse2, &aom_highbd_v_predictor_8x8_c,
-                8, 10),
-  IntraPredFunc(&aom_highbd_v_predictor_16x16_sse2,
-                &aom_highbd_v_predictor_16x16_c, 16, 10),
-  IntraPredFunc(&aom_highbd_v_predictor_32x32_sse2,
-                &aom_highbd_v_predictor_32x32_c, 32, 10)
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_4x4_sse2,
+                      &aom_highbd_dc_predictor_4x4_c, 4, 4, 10),
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_8x8_sse2,
+                      &aom_highbd_dc_predictor_8x8_c, 8, 8, 10),
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_16x16_sse2,
+                      &aom_highbd_dc_predictor_16x16_c, 16, 16, 10),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_4x4_sse2,
+                      &aom_highbd_v_predictor_4x4_c, 4, 4, 10),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_8x8_sse2,
+                      &aom_highbd_v_predictor_8x8_c, 8, 8, 10),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_16x16_sse2,
+                      &aom_highbd_v_predictor_16x16_c, 16, 16, 10),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_32x32_sse2,
+                      &aom_highbd_v_predictor_32x32_c, 32, 32, 10)
 #if !CONFIG_ALT_INTRA
       ,
-  IntraPredFunc(&aom_highbd_tm_predictor_4x4_sse2,
-                &aom_highbd_tm_predictor_4x4_c, 4, 10),
-  IntraPredFunc(&aom_highbd_tm_predictor_8x8_sse2,
-                &aom_highbd_tm_predictor_8x8_c, 8, 10)
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_4x4_sse2,
+                      &aom_highbd_tm_predictor_4x4_c, 4, 4, 10),
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_8x8_sse2,
+                      &aom_highbd_tm_predictor_8x8_c, 8, 8, 10)
 #endif  // !CONFIG_ALT_INTRA
 };
 
-INSTANTIATE_TEST_CASE_P(SSE2_TO_C_10, AV1IntraPredTest,
+INSTANTIATE_TEST_CASE_P(SSE2_TO_C_10, HighbdIntraPredTest,
                         ::testing::ValuesIn(IntraPredTestVector10));
 
-const IntraPredFunc IntraPredTestVector12[] = {
-  IntraPredFunc(&aom_highbd_dc_predictor_32x32_sse2,
-                &aom_highbd_dc_predictor_32x32_c, 32, 12),
+const HighbdIntraPredFunc IntraPredTestVector12[] = {
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_32x32_sse2,
+                      &aom_highbd_dc_predictor_32x32_c, 32, 32, 12),
 #if !CONFIG_ALT_INTRA
-  IntraPredFunc(&aom_highbd_tm_predictor_16x16_sse2,
-                &aom_highbd_tm_predictor_16x16_c, 16, 12),
-  IntraPredFunc(&aom_highbd_tm_predictor_32x32_sse2,
-                &aom_highbd_tm_predictor_32x32_c, 32, 12),
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_16x16_sse2,
+                      &aom_highbd_tm_predictor_16x16_c, 16, 16, 12),
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_32x32_sse2,
+                      &aom_highbd_tm_predictor_32x32_c, 32, 32, 12),
 #endif  // !CONFIG_ALT_INTRA
-  IntraPredFunc(&aom_highbd_dc_predictor_4x4_sse2,
-                &aom_highbd_dc_predictor_4x4_c, 4, 12),
-  IntraPredFunc(&aom_highbd_dc_predictor_8x8_sse2,
-                &aom_highbd_dc_predictor_8x8_c, 8, 12),
-  IntraPredFunc(&aom_highbd_dc_predictor_16x16_sse2,
-                &aom_highbd_dc_predictor_16x16_c, 16, 12),
-  IntraPredFunc(&aom_highbd_v_predictor_4x4_sse2, &aom_highbd_v_predictor_4x4_c,
-                4, 12),
-  IntraPredFunc(&aom_highbd_v_predictor_8x8_sse2, &aom_highbd_v_predictor_8x8_c,
-                8, 12),
-  IntraPredFunc(&aom_highbd_v_predictor_16x16_sse2,
-                &aom_highbd_v_predictor_16x16_c, 16, 12),
-  IntraPredFunc(&aom_highbd_v_predictor_32x32_sse2,
-                &aom_highbd_v_predictor_32x32_c, 32, 12)
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_4x4_sse2,
+                      &aom_highbd_dc_predictor_4x4_c, 4, 4, 12),
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_8x8_sse2,
+                      &aom_highbd_dc_predictor_8x8_c, 8, 8, 12),
+  HighbdIntraPredFunc(&aom_highbd_dc_predictor_16x16_sse2,
+                      &aom_highbd_dc_predictor_16x16_c, 16, 16, 12),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_4x4_sse2,
+                      &aom_highbd_v_predictor_4x4_c, 4, 4, 12),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_8x8_sse2,
+                      &aom_highbd_v_predictor_8x8_c, 8, 8, 12),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_16x16_sse2,
+                      &aom_highbd_v_predictor_16x16_c, 16, 16, 12),
+  HighbdIntraPredFunc(&aom_highbd_v_predictor_32x32_sse2,
+                      &aom_highbd_v_predictor_32x32_c, 32, 32, 12)
 #if !CONFIG_ALT_INTRA
       ,
-  IntraPredFunc(&aom_highbd_tm_predictor_4x4_sse2,
-                &aom_highbd_tm_predictor_4x4_c, 4, 12),
-  IntraPredFunc(&aom_highbd_tm_predictor_8x8_sse2,
-                &aom_highbd_tm_predictor_8x8_c, 8, 12)
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_4x4_sse2,
+                      &aom_highbd_tm_predictor_4x4_c, 4, 4, 12),
+  HighbdIntraPredFunc(&aom_highbd_tm_predictor_8x8_sse2,
+                      &aom_highbd_tm_predictor_8x8_c, 8, 8, 12)
 #endif  // !CONFIG_ALT_INTRA
 };
 
-INSTANTIATE_TEST_CASE_P(SSE2_TO_C_12, AV1IntraPredTest,
+INSTANTIATE_TEST_CASE_P(SSE2_TO_C_12, HighbdIntraPredTest,
                         ::testing::ValuesIn(IntraPredTestVector12));
 
 #endif  // CONFIG_HIGHBITDEPTH
 #endif  // HAVE_SSE2
+
+#if CONFIG_ALT_INTRA
+#if CONFIG_SMOOTH_HV
+#define ALT_INTRA_FUNCS(func, opt, w, h, bd) \
+  func(paeth, opt, w, h, bd),                \
+      func(smooth, opt, w, h, bd),           \
+      func(smooth_v, opt, w, h, bd),         \
+      func(smooth_h, opt, w, h, bd)
+#else
+#define ALT_INTRA_FUNCS(func, opt, w, h, bd) \
+  func(paeth, opt, w, h, bd), func(smooth, opt, w, h, bd)
+#endif  // CONFIG_SMOOTH_HV
+
+// Every block size with an SSE4.1 version; the AVX2 versions cover those at
+// least 16 pixels wide.
+#define ALT_INTRA_SSE4_1_SIZES(func, bd)         \
+  ALT_INTRA_FUNCS(func, sse4_1, 4, 4, bd),       \
+      ALT_INTRA_FUNCS(func, sse4_1, 4, 8, bd),   \
+      ALT_INTRA_FUNCS(func, sse4_1, 8, 4, bd),   \
+      ALT_INTRA_FUNCS(func, sse4_1, 8, 8, bd),   \
+      ALT_INTRA_FUNCS(func, sse4_1, 8, 16, bd),  \
+      ALT_INTRA_FUNCS(func, sse4_1, 16, 8, bd),  \
+      ALT_INTRA_FUNCS(func, sse4_1, 16, 16, bd), \
+      ALT_INTRA_FUNCS(func, sse4_1, 16, 32, bd), \
+      ALT_INTRA_FUNCS(func, sse4_1, 32, 16, bd), \
+      ALT_INTRA_FUNCS(func, sse4_1, 32, 32, bd)
+#define ALT_INTRA_AVX2_SIZES(func, bd)         \
+  ALT_INTRA_FUNCS(func, avx2, 16, 8, bd),      \
+      ALT_INTRA_FUNCS(func, avx2, 16, 16, bd), \
+      ALT_INTRA_FUNCS(func, avx2, 16, 32, bd), \
+      ALT_INTRA_FUNCS(func, avx2, 32, 16, bd), \
+      ALT_INTRA_FUNCS(func, avx2, 32, 32, bd)
+
+#define LOWBD_ALT_INTRA_FUNC(type, opt, w, h, bd)               \
+  LowbdIntraPredFunc(&aom_##type##_predictor_##w##x##h##_##opt, \
+                     &aom_##type##_predictor_##w##x##h##_c, w, h, bd)
+
+#if HAVE_SSE4_1
+const LowbdIntraPredFunc LowbdIntraPredTestVectorSSE4_1[] = {
+  ALT_INTRA_SSE4_1_SIZES(LOWBD_ALT_INTRA_FUNC, 8)
+};
+
+INSTANTIATE_TEST_CASE_P(SSE4_1_TO_C, LowbdIntraPredTest,
+                        ::testing::ValuesIn(LowbdIntraPredTestVectorSSE4_1));
+#endif  // HAVE_SSE4_1
+
+#if HAVE_AVX2
+const LowbdIntraPredFunc LowbdIntraPredTestVectorAVX2[] = {
+  ALT_INTRA_AVX2_SIZES(LOWBD_ALT_INTRA_FUNC, 8)
+};
+
+INSTANTIATE_TEST_CASE_P(AVX2_TO_C, LowbdIntraPredTest,
+                        ::testing::ValuesIn(LowbdIntraPredTestVectorAVX2));
+#endif  // HAVE_AVX2
+
+#if CONFIG_HIGHBITDEPTH
+#define HIGHBD_ALT_INTRA_FUNC(type, opt, w, h, bd)                      \
+  HighbdIntraPredFunc(&aom_highbd_##type##_predictor_##w##x##h##_##opt, \
+                      &aom_highbd_##type##_predictor_##w##x##h##_c, w, h, bd)
+
+#if HAVE_SSE4_1
+const HighbdIntraPredFunc HighbdIntraPredTestVectorSSE4_1[] = {
+  ALT_INTRA_SSE4_1_SIZES(HIGHBD_ALT_INTRA_FUNC, 8),
+  ALT_INTRA_SSE4_1_SIZES(HIGHBD_ALT_INTRA_FUNC, 10),
+  ALT_INTRA_SSE4_1_SIZES(HIGHBD_ALT_INTRA_FUNC, 12)
+};
+
+INSTANTIATE_TEST_CASE_P(SSE4_1_TO_C, HighbdIntraPredTest,
+                        ::testing::ValuesIn(HighbdIntraPredTestVectorSSE4_1));
+#endif  // HAVE_SSE4_1
+
+#if HAVE_AVX2
+const HighbdIntraPredFunc HighbdIntraPredTestVectorAVX2[] = {
+  ALT_INTRA_AVX2_SIZES(HIGHBD_ALT_INTRA_FUNC, 8),
+  ALT_INTRA_AVX2_SIZES(HIGHBD_ALT_INTRA_FUNC, 10),
+  ALT_INTRA_AVX2_SIZES(HIGHBD_ALT_INTRA_FUNC, 12)
+};
+
+INSTANTIATE_TEST_CASE_P(AVX2_TO_C, HighbdIntraPredTest,
+                        ::testing::ValuesIn(HighbdIntraPredTestVectorAVX2));
+#endif  // HAVE_AVX2
+#endif  // CONFIG_HIGHBITDEPTH
+#endif  // CONFIG_ALT_INTRA
 }  // namespace
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "./aom_config.h"
+#include "aom_util/aom_thread.h"
+
+namespace {
+
+const int kNumWorkers = 4;
+
+struct JobWorkerData {
+  AVxJobQueue *queue;
+  int worker;
+  std::vector<int> *runs;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *mutex;
+  pthread_cond_t *cond;
+#endif
+};
+
+// Runs jobs as a wavefront: job j may only finish after job j - 1.
+int WavefrontHook(void *arg1, void *arg2) {
+  JobWorkerData *const data = reinterpret_cast<JobWorkerData *>(arg1);
+  int job;
+  (void)arg2;
+  while (aom_job_queue_pop(data->queue, data->worker, &job)) {
+#if CONFIG_MULTITHREAD
+    pthread_mutex_lock(data->mutex);
+    while (job > 0 && (*data->runs)[job - 1] == 0) {
+      pthread_cond_wait(data->cond, data->mutex);
+    }
+    ++(*data->runs)[job];
+    pthread_cond_broadcast(data->cond);
+    pthread_mutex_unlock(data->mutex);
+#else
+    ++(*data->runs)[job];
+#endif
+  }
+  return 1;
+}
+
+TEST(JobQueueTest, StealsFromMostLoadedWorker) {
+  AVxJobQueue queue;
+  ASSERT_TRUE(aom_job_queue_alloc(&queue, 3));
+  aom_job_queue_reset(&queue, 3, 8);
+
+  // Worker 0 owns jobs 0, 3 and 6, then steals from the back of the others.
+  const int kExpected[] = { 0, 3, 6, 7, 4, 5, 1, 2 };
+  for (int i = 0; i < 8; ++i) {
+    int job = -1;
+    ASSERT_TRUE(aom_job_queue_pop(&queue, 0, &job));
+    EXPECT_EQ(kExpected[i], job);
+  }
+  int job;
+  EXPECT_FALSE(aom_job_queue_pop(&queue, 0, &job));
+  EXPECT_FALSE(aom_job_queue_pop(&queue, 1, &job));
+  EXPECT_FALSE(aom_job_queue_pop(&queue, 2, &job));
+  aom_job_queue_finish(&queue);
+
+  EXPECT_EQ(8, queue.stats[0].jobs);
+  EXPECT_EQ(5, queue.stats[0].steals);
+  EXPECT_EQ(0, queue.stats[1].jobs);
+  EXPECT_EQ(0, queue.stats[2].jobs);
+
+  aom_job_queue_clear_stats(&queue);
+  EXPECT_EQ(0, queue.stats[0].jobs);
+  aom_job_queue_free(&queue);
+}
+
+TEST(JobQueueTest, WavefrontRunsEveryJobOnce) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  AVxWorker workers[kNumWorkers];
+  JobWorkerData data[kNumWorkers];
+  AVxJobQueue queue;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&cond, NULL);
+#endif
+
+  ASSERT_TRUE(aom_job_queue_alloc(&queue, kNumWorkers));
+  for (int i = 0; i < kNumWorkers; ++i) {
+    winterface->init(&workers[i]);
+    ASSERT_TRUE(winterface->reset(&workers[i]));
+  }
+
+  for (int num_jobs = 0; num_jobs < 50; num_jobs += 7) {
+    for (int num_workers = 1; num_workers <= kNumWorkers; ++num_workers) {
+      std::vector<int> runs(num_jobs, 0);
+      aom_job_queue_reset(&queue, num_workers, num_jobs);
+      for (int i = 0; i < num_workers; ++i) {
+        data[i].queue = &queue;
+        data[i].worker = i;
+        data[i].runs = &runs;
+#if CONFIG_MULTITHREAD
+        data[i].mutex = &mutex;
+        data[i].cond = &cond;
+#endif
+        workers[i].hook = WavefrontHook;
+        workers[i].data1 = &data[i];
+        workers[i].data2 = NULL;
+        if (i == num_workers - 1)
+          winterface->execute(&workers[i]);
+        else
+          winterface->launch(&workers[i]);
+      }
+      for (int i = 0; i < num_workers; ++i) {
+        EXPECT_TRUE(winterface->sync(&workers[i]));
+      }
+      aom_job_queue_finish(&queue);
+
+      for (int j = 0; j < num_jobs; ++j) EXPECT_EQ(1, runs[j]) << "job " << j;
+    }
+  }
+
+  int total_jobs = 0;
+  for (int i = 0; i < kNumWorkers; ++i) {
+    total_jobs += queue.stats[i].jobs;
+    EXPECT_GE(queue.stats[i].busy_us, 0);
+    EXPECT_GE(queue.stats[i].idle_us, 0);
+  }
+  EXPECT_EQ((0 + 7 + 14 + 21 + 28 + 35 + 42 + 49) * kNumWorkers, total_jobs);
+
+  for (int i = 0; i < kNumWorkers; ++i) winterface->end(&workers[i]);
+  aom_job_queue_free(&queue);
+#if CONFIG_MULTITHREAD
+  pthread_mutex_destroy(&mutex);
+  pthread_cond_destroy(&cond);
+#endif
+}
+
+}  // namespace
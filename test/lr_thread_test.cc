@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+
+namespace {
+
+// A smooth texture panning right, with a little noise, on which the encoder
+// chooses loop restoration for the key frame.
+class TextureVideoSource : public ::libaom_test::DummyVideoSource {
+ public:
+  TextureVideoSource() : rnd_(::libaom_test::ACMRandom::DeterministicSeed()) {}
+
+ protected:
+  virtual void Begin() {
+    rnd_.Reset(::libaom_test::ACMRandom::DeterministicSeed());
+    DummyVideoSource::Begin();
+  }
+
+  virtual void FillFrame() {
+    if (!img_) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (img_->d_w + 1) / 2 : img_->d_w;
+      const int h = plane ? (img_->d_h + 1) / 2 : img_->d_h;
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img_->planes[plane] + r * img_->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          const double x = (c << (plane > 0)) + 2.0 * frame_;
+          const double y = r << (plane > 0);
+          const double v = 60 * sin(x * 0.05) * cos(y * 0.04) +
+                           20 * sin((x + y) * 0.13) + rnd_.Rand8() % 9 - 4;
+          row[c] = static_cast<uint8_t>(128 + (plane ? v / 4 : v));
+        }
+      }
+    }
+  }
+
+  ::libaom_test::ACMRandom rnd_;
+};
+
+// Encodes with 1 thread and with the given number of threads, where the
+// encoder runs loop restoration on its workers. The test driver checks every
+// frame of the encoder against a single threaded decoder, and a second
+// decoder with the same number of threads as the encoder decodes the stream
+// as well. Both encodes must give the same stream and decoded frames.
+class AV1LrThreadTest : public ::libaom_test::CodecTestWithParam<int>,
+                        public ::libaom_test::EncoderTest {
+ protected:
+  AV1LrThreadTest() : EncoderTest(GET_PARAM(0)), decoder_(NULL) {}
+
+  virtual ~AV1LrThreadTest() { delete decoder_; }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = AOM_Q;
+  }
+
+  virtual void BeginPassHook(unsigned int /*pass*/) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = cfg_.g_threads;
+    cfg.allow_lowbitdepth = CONFIG_LOWBITDEPTH;
+    delete decoder_;
+    decoder_ = codec_->CreateDecoder(cfg, 0);
+#if CONFIG_AV1 && CONFIG_EXT_TILE
+    decoder_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+    decoder_->Control(AV1_SET_DECODE_TILE_COL, -1);
+#endif
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      // Two tile columns, so that the encoder starts its workers.
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+#if CONFIG_EXT_TILE
+      encoder->Control(AV1E_SET_TILE_ENCODING_MODE, 0);  // TILE_NORMAL
+#endif                                                   // CONFIG_EXT_TILE
+      encoder->Control(AOME_SET_CPUUSED, 4);
+      encoder->Control(AOME_SET_CQ_LEVEL, 40);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    ::libaom_test::MD5 md5_enc;
+    md5_enc.Add(reinterpret_cast<uint8_t *>(pkt->data.frame.buf),
+                pkt->data.frame.sz);
+    md5_enc_.push_back(md5_enc.Get());
+
+    const aom_codec_err_t res = decoder_->DecodeFrame(
+        reinterpret_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res) << decoder_->DecodeError();
+    }
+    ::libaom_test::DxDataIterator dec_iter = decoder_->GetDxData();
+    const aom_image_t *img;
+    while ((img = dec_iter.Next()) != NULL) {
+      ::libaom_test::MD5 md5_res;
+      md5_res.Add(img);
+      md5_dec_.push_back(md5_res.Get());
+    }
+  }
+
+  void DoTest() {
+    TextureVideoSource video;
+    video.SetSize(512, 256);
+    video.set_limit(6);
+
+    cfg_.g_threads = 1;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    const std::vector<std::string> single_thr_md5_enc = md5_enc_;
+    const std::vector<std::string> single_thr_md5_dec = md5_dec_;
+    md5_enc_.clear();
+    md5_dec_.clear();
+
+    cfg_.g_threads = GET_PARAM(1);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+    ASSERT_EQ(static_cast<size_t>(video.limit()), single_thr_md5_dec.size());
+    ASSERT_EQ(single_thr_md5_enc, md5_enc_);
+    ASSERT_EQ(single_thr_md5_dec, md5_dec_);
+  }
+
+  ::libaom_test::Decoder *decoder_;
+  std::vector<std::string> md5_enc_;
+  std::vector<std::string> md5_dec_;
+};
+
+TEST_P(AV1LrThreadTest, MatchesSingleThread) { DoTest(); }
+
+AV1_INSTANTIATE_TEST_CASE(AV1LrThreadTest, ::testing::Values(2, 4));
+
+}  // namespace
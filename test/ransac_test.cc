@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <ctime>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "./av1_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+
+namespace {
+
+using libaom_test::ACMRandom;
+
+// Enough correspondences for a full frame of corners.
+const int kMaxPoints = 1024;
+
+typedef int (*RansacInliersFunc)(const double *mat, const double *points1,
+                                 const double *points2, int npoints,
+                                 int min_inliers, int *inlier_indices,
+                                 double *distances);
+
+class AV1RansacInliersTest
+    : public ::testing::TestWithParam<RansacInliersFunc> {
+ public:
+  virtual ~AV1RansacInliersTest() {}
+  virtual void SetUp() { tst_fun_ = GetParam(); }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  // Random corners, matched through a random affine 'mat' plus noise, so that
+  // a varying fraction of them are inliers.
+  void FillPoints(ACMRandom *rnd, double *mat, int npoints) {
+    const int noise = 1 + rnd->PseudoUniform(4);
+    int i;
+    mat[0] = rnd->PseudoUniform(65) - 32 + rnd->PseudoUniform(1024) / 1024.0;
+    mat[1] = rnd->PseudoUniform(65) - 32 + rnd->PseudoUniform(1024) / 1024.0;
+    mat[2] = 1.0 + (rnd->PseudoUniform(257) - 128) / 1024.0;
+    mat[3] = (rnd->PseudoUniform(257) - 128) / 1024.0;
+    mat[4] = (rnd->PseudoUniform(257) - 128) / 1024.0;
+    mat[5] = 1.0 + (rnd->PseudoUniform(257) - 128) / 1024.0;
+    for (i = 0; i < npoints; ++i) {
+      const double x = rnd->PseudoUniform(1920);
+      const double y = rnd->PseudoUniform(1080);
+      points1_[i * 2] = x;
+      points1_[i * 2 + 1] = y;
+      points2_[i * 2] = (int)(mat[2] * x + mat[3] * y + mat[0]) +
+                        rnd->PseudoUniform(2 * noise + 1) - noise;
+      points2_[i * 2 + 1] = (int)(mat[4] * x + mat[5] * y + mat[1]) +
+                            rnd->PseudoUniform(2 * noise + 1) - noise;
+    }
+  }
+
+  void RunCorrectnessTest() {
+    const int NUM_ITERS = 1000;
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    int i, j;
+
+    for (i = 0; i < NUM_ITERS; ++i) {
+      const int npoints = 1 + rnd.PseudoUniform(kMaxPoints);
+      // Half of the time, no early exit.
+      const int min_inliers = (i & 1) ? rnd.PseudoUniform(npoints + 1) : 0;
+      double mat[6];
+      FillPoints(&rnd, mat, npoints);
+
+      const int ref = av1_ransac_affine_inliers_c(
+          mat, points1_, points2_, npoints, min_inliers, ref_indices_,
+          ref_distances_);
+      int tst;
+      ASM_REGISTER_STATE_CHECK(tst = tst_fun_(mat, points1_, points2_, npoints,
+                                              min_inliers, tst_indices_,
+                                              tst_distances_));
+      // Both versions may stop at different points once the count cannot
+      // reach 'min_inliers'.
+      if (ref < min_inliers) {
+        ASSERT_LT(tst, min_inliers) << "npoints " << npoints;
+        continue;
+      }
+      ASSERT_EQ(ref, tst) << "npoints " << npoints;
+      for (j = 0; j < ref; ++j) {
+        ASSERT_EQ(ref_indices_[j], tst_indices_[j]) << "inlier " << j;
+        ASSERT_EQ(ref_distances_[j], tst_distances_[j]) << "inlier " << j;
+      }
+    }
+  }
+
+  void RunSpeedTest() {
+    const int NUM_ITERS = 10000;
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    double mat[6];
+    int i;
+
+    FillPoints(&rnd, mat, kMaxPoints);
+
+    std::clock_t start = std::clock();
+    for (i = 0; i < NUM_ITERS; ++i)
+      av1_ransac_affine_inliers_c(mat, points1_, points2_, kMaxPoints, 0,
+                                  ref_indices_, ref_distances_);
+    const double ref_time =
+        (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+
+    start = std::clock();
+    for (i = 0; i < NUM_ITERS; ++i)
+      tst_fun_(mat, points1_, points2_, kMaxPoints, 0, tst_indices_,
+               tst_distances_);
+    const double tst_time =
+        (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+
+    printf("%d points: C time: %.1f us, SIMD time: %.1f us (x%.1f)\n",
+           kMaxPoints, 1e6 * ref_time / NUM_ITERS, 1e6 * tst_time / NUM_ITERS,
+           ref_time / tst_time);
+  }
+
+  RansacInliersFunc tst_fun_;
+  double points1_[kMaxPoints * 2];
+  double points2_[kMaxPoints * 2];
+  int ref_indices_[kMaxPoints];
+  int tst_indices_[kMaxPoints];
+  double ref_distances_[kMaxPoints];
+  double tst_distances_[kMaxPoints];
+};
+
+TEST_P(AV1RansacInliersTest, CorrectnessTest) { RunCorrectnessTest(); }
+TEST_P(AV1RansacInliersTest, DISABLED_SpeedTest) { RunSpeedTest(); }
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(SSE2, AV1RansacInliersTest,
+                        ::testing::Values(av1_ransac_affine_inliers_sse2));
+#endif
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, AV1RansacInliersTest,
+                        ::testing::Values(av1_ransac_affine_inliers_avx2));
+#endif
+
+}  // namespace
@@ -9,8 +9,14 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+
 #include "av1/common/common_data.h"
 #include "av1/common/scan.h"
+#include "test/acm_random.h"
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 
 namespace {
@@ -55,6 +61,55 @@ TEST(ScanTest, av1_update_sort_order) {
   for (int i = 0; i < 16; ++i) EXPECT_EQ(ref_sort_order[i], sort_order[i]);
 }
 
+TEST(ScanTest, av1_update_sort_order_from) {
+  const TX_SIZE tx_size = TX_32X32;
+  const TX_TYPE tx_type = DCT_DCT;
+  const int tx2d_size = tx_size_2d[tx_size];
+  const SCAN_ORDER *sc = get_default_scan(tx_size, tx_type, 0);
+  const uint32_t mask = (1 << 16) - 1;
+  libaom_test::ACMRandom rnd(libaom_test::ACMRandom::DeterministicSeed());
+  uint32_t prob[1024];
+  uint32_t augmented[1024];
+  int16_t ref_sort_order[1024];
+  int16_t prev_order[1024];
+  int16_t sort_order[1024];
+
+  for (int iter = 0; iter < 20; ++iter) {
+    // Few distinct probabilities, to exercise the tie breaking.
+    for (int i = 0; i < tx2d_size; ++i) prob[i] = rnd(iter < 10 ? 16 : 65536);
+    memcpy(augmented, prob, sizeof(augmented));
+    av1_augment_prob(tx_size, tx_type, augmented);
+    std::sort(augmented, augmented + tx2d_size, std::greater<uint32_t>());
+    for (int i = 0; i < tx2d_size; ++i)
+      ref_sort_order[i] = sc->scan[mask ^ (augmented[i] & mask)];
+    av1_update_sort_order(tx_size, tx_type, prob, sort_order);
+    for (int i = 0; i < tx2d_size; ++i)
+      ASSERT_EQ(ref_sort_order[i], sort_order[i]) << "iter " << iter;
+
+    // Already sorted.
+    EXPECT_EQ(0, av1_update_sort_order_from(tx_size, tx_type, prob,
+                                            ref_sort_order, sort_order));
+    for (int i = 0; i < tx2d_size; ++i)
+      EXPECT_EQ(ref_sort_order[i], sort_order[i]);
+
+    // Nearly sorted, then far from sorted.
+    memcpy(prev_order, ref_sort_order, sizeof(prev_order));
+    for (int n = 0; n < 2; ++n) {
+      const int swaps = n == 0 ? 8 : tx2d_size;
+      for (int k = 0; k < swaps; ++k) {
+        const int a = rnd(tx2d_size);
+        const int b = n == 0 ? AOMMIN(a + 1 + rnd(4), tx2d_size - 1)
+                             : rnd(tx2d_size);
+        std::swap(prev_order[a], prev_order[b]);
+      }
+      av1_update_sort_order_from(tx_size, tx_type, prob, prev_order,
+                                 sort_order);
+      for (int i = 0; i < tx2d_size; ++i)
+        ASSERT_EQ(ref_sort_order[i], sort_order[i]) << "iter " << iter;
+    }
+  }
+}
+
 TEST(ScanTest, av1_update_scan_order) {
   TX_SIZE tx_size = TX_4X4;
   const TX_TYPE tx_type = DCT_DCT;
@@ -28,13 +28,24 @@ using std::tr1::tuple;
 using std::tr1::make_tuple;
 using libaom_test::ACMRandom;
 
-typedef tuple<> FilterTestParam;
+typedef void (*SgrFunc)(uint8_t *dat, int width, int height, int stride,
+                        int eps, int *xqd, uint8_t *dst, int dst_stride,
+                        int32_t *tmpbuf);
+typedef void (*SelfguidedFunc)(uint8_t *dgd, int width, int height, int stride,
+                               int32_t *dst, int dst_stride, int r, int eps,
+                               int32_t *tmpbuf);
+
+// Function pointers to the whole filter, and to one pass of it
+typedef tuple<SgrFunc, SelfguidedFunc> FilterTestParam;
 
 class AV1SelfguidedFilterTest
     : public ::testing::TestWithParam<FilterTestParam> {
  public:
   virtual ~AV1SelfguidedFilterTest() {}
-  virtual void SetUp() {}
+  virtual void SetUp() {
+    tst_fun_ = GET_PARAM(0);
+    tst_pass_ = GET_PARAM(1);
+  }
 
   virtual void TearDown() { libaom_test::ClearSystemState(); }
 
@@ -68,7 +79,7 @@ class AV1SelfguidedFilterTest
 
     std::clock_t start = std::clock();
     for (i = 0; i < NUM_ITERS; ++i) {
-      apply_selfguided_restoration(input, w, h, w, eps, xqd, output, w, tmpbuf);
+      tst_fun_(input, w, h, w, eps, xqd, output, w, tmpbuf);
     }
     std::clock_t end = std::clock();
     double elapsed = ((end - start) / (double)CLOCKS_PER_SEC);
@@ -118,8 +129,8 @@ class AV1SelfguidedFilterTest
       int test_w = max_w - (i / 9);
       int test_h = max_h - (i % 9);
 
-      apply_selfguided_restoration(input, test_w, test_h, stride, eps, xqd,
-                                   output, out_stride, tmpbuf);
+      tst_fun_(input, test_w, test_h, stride, eps, xqd, output, out_stride,
+               tmpbuf);
       apply_selfguided_restoration_c(input, test_w, test_h, stride, eps, xqd,
                                      output2, out_stride, tmpbuf);
       for (j = 0; j < test_h; ++j)
@@ -132,27 +143,205 @@ class AV1SelfguidedFilterTest
     aom_free(output2);
     aom_free(tmpbuf);
   }
+
+  // Time a single filter pass, for each radius, against the C version.
+  void RunBenchmark() {
+    const int w = 256, h = 256;
+    const int NUM_ITERS = 1000;
+    // eps is fixed, since the speed hardly depends on it
+    const int eps = 30;
+    int i, j, r;
+
+    uint8_t *input = (uint8_t *)aom_memalign(16, w * h * sizeof(uint8_t));
+    int32_t *output = (int32_t *)aom_memalign(16, w * h * sizeof(int32_t));
+    int32_t *tmpbuf = (int32_t *)aom_memalign(16, RESTORATION_TMPBUF_SIZE);
+    memset(tmpbuf, 0, RESTORATION_TMPBUF_SIZE);
+
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+
+    for (i = 0; i < h; ++i)
+      for (j = 0; j < w; ++j) input[i * w + j] = rnd.Rand16() & 0xFF;
+
+    av1_loop_restoration_precal();
+
+    for (r = 1; r <= MAX_RADIUS; ++r) {
+      std::clock_t start = std::clock();
+      for (i = 0; i < NUM_ITERS; ++i)
+        av1_selfguided_restoration_c(input, w, h, w, output, w, r, eps, tmpbuf);
+      const double ref_time =
+          (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+
+      start = std::clock();
+      for (i = 0; i < NUM_ITERS; ++i)
+        tst_pass_(input, w, h, w, output, w, r, eps, tmpbuf);
+      const double tst_time =
+          (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+
+      const double mpix = (double)w * h * NUM_ITERS / 1000000.;
+      printf("r=%d: C %7.1f MPix/s, SIMD %7.1f MPix/s (x%.2f)\n", r,
+             mpix / ref_time, mpix / tst_time, ref_time / tst_time);
+    }
+
+    aom_free(input);
+    aom_free(output);
+    aom_free(tmpbuf);
+  }
+
+  SgrFunc tst_fun_;
+  SelfguidedFunc tst_pass_;
 };
 
 TEST_P(AV1SelfguidedFilterTest, SpeedTest) { RunSpeedTest(); }
 TEST_P(AV1SelfguidedFilterTest, CorrectnessTest) { RunCorrectnessTest(); }
+TEST_P(AV1SelfguidedFilterTest, DISABLED_Benchmark) { RunBenchmark(); }
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_CASE_P(
+    SSE4_1, AV1SelfguidedFilterTest,
+    ::testing::Values(make_tuple(apply_selfguided_restoration_sse4_1,
+                                 av1_selfguided_restoration_sse4_1)));
+#endif
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, AV1SelfguidedFilterTest,
+    ::testing::Values(make_tuple(apply_selfguided_restoration_avx2,
+                                 av1_selfguided_restoration_avx2)));
+#endif
+
+typedef void (*IntegralFunc)(uint8_t *dgd, int width, int height, int stride,
+                             int32_t *ii, int32_t *ii_sq);
+typedef void (*FromIntegralFunc)(uint8_t *dgd, int width, int height,
+                                 int stride, const int32_t *ii,
+                                 const int32_t *ii_sq, int32_t *dst,
+                                 int dst_stride, int r, int eps,
+                                 int32_t *tmpbuf);
 
-const FilterTestParam params[] = { make_tuple() };
+// Function pointers to the integral image builder used by the encoder's
+// parameter search, and to the filter pass which reads from its output
+typedef tuple<IntegralFunc, FromIntegralFunc> IntegralTestParam;
+
+class AV1SelfguidedIntegralTest
+    : public ::testing::TestWithParam<IntegralTestParam> {
+ public:
+  virtual ~AV1SelfguidedIntegralTest() {}
+  virtual void SetUp() {
+    tst_integral_ = GET_PARAM(0);
+    tst_pass_ = GET_PARAM(1);
+  }
+
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RunCorrectnessTest() {
+    const int max_w = 260, max_h = 260, stride = 672;
+    const int NUM_ITERS = 90;
+    int i, j, k, r;
+
+    uint8_t *input =
+        (uint8_t *)aom_memalign(16, stride * max_h * sizeof(uint8_t));
+    int32_t *output =
+        (int32_t *)aom_memalign(16, stride * max_h * sizeof(int32_t));
+    int32_t *output2 =
+        (int32_t *)aom_memalign(16, stride * max_h * sizeof(int32_t));
+    int32_t *tmpbuf = (int32_t *)aom_memalign(16, RESTORATION_TMPBUF_SIZE);
+    int32_t *ii = (int32_t *)aom_memalign(16, RESTORATION_EXTBUF_SIZE);
+    int32_t *ii_sq = ii + SGRPROJ_INTEGRAL_SIZE;
+    memset(tmpbuf, 0, RESTORATION_TMPBUF_SIZE);
+
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+
+    av1_loop_restoration_precal();
+
+    for (i = 0; i < NUM_ITERS; ++i) {
+      for (j = 0; j < max_h; ++j)
+        for (k = 0; k < max_w; ++k) input[j * stride + k] = rnd.Rand16() & 0xFF;
+
+      // Test various tile sizes around 256x256, then a few small tiles
+      // where the windows are clipped on both sides.
+      const int test_w = i < 81 ? max_w - (i / 9) : 3 + (i - 81);
+      const int test_h = i < 81 ? max_h - (i % 9) : 11 - (i - 81);
+
+      tst_integral_(input, test_w, test_h, stride, ii, ii_sq);
+      for (r = 1; r <= MAX_RADIUS; ++r) {
+        const int eps = 1 + rnd.PseudoUniform(MAX_EPS);
+        tst_pass_(input, test_w, test_h, stride, ii, ii_sq, output, stride, r,
+                  eps, tmpbuf);
+        // The C version of the full filter reads outside of tiles which are
+        // smaller than the filter window, so compare against the C version
+        // of this path for those.
+        if (test_w >= 2 * r + 1 && test_h >= 2 * r + 1) {
+          av1_selfguided_restoration_c(input, test_w, test_h, stride, output2,
+                                       stride, r, eps, tmpbuf);
+        } else {
+          av1_selfguided_integral_images_c(input, test_w, test_h, stride, ii,
+                                           ii_sq);
+          av1_selfguided_restoration_from_integral_c(
+              input, test_w, test_h, stride, ii, ii_sq, output2, stride, r,
+              eps, tmpbuf);
+          tst_integral_(input, test_w, test_h, stride, ii, ii_sq);
+        }
+        for (j = 0; j < test_h; ++j)
+          for (k = 0; k < test_w; ++k)
+            ASSERT_EQ(output[j * stride + k], output2[j * stride + k])
+                << "r=" << r << " size " << test_w << "x" << test_h;
+      }
+    }
+
+    aom_free(input);
+    aom_free(output);
+    aom_free(output2);
+    aom_free(tmpbuf);
+    aom_free(ii);
+  }
+
+  IntegralFunc tst_integral_;
+  FromIntegralFunc tst_pass_;
+};
+
+TEST_P(AV1SelfguidedIntegralTest, CorrectnessTest) { RunCorrectnessTest(); }
+
+INSTANTIATE_TEST_CASE_P(
+    C, AV1SelfguidedIntegralTest,
+    ::testing::Values(make_tuple(av1_selfguided_integral_images_c,
+                                 av1_selfguided_restoration_from_integral_c)));
 
 #if HAVE_SSE4_1
-INSTANTIATE_TEST_CASE_P(SSE4_1, AV1SelfguidedFilterTest,
-                        ::testing::ValuesIn(params));
+INSTANTIATE_TEST_CASE_P(
+    SSE4_1, AV1SelfguidedIntegralTest,
+    ::testing::Values(
+        make_tuple(av1_selfguided_integral_images_c,
+                   av1_selfguided_restoration_from_integral_sse4_1)));
+#endif
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, AV1SelfguidedIntegralTest,
+    ::testing::Values(
+        make_tuple(av1_selfguided_integral_images_avx2,
+                   av1_selfguided_restoration_from_integral_avx2)));
 #endif
 
 #if CONFIG_HIGHBITDEPTH
 
-typedef tuple<int> HighbdFilterTestParam;
+typedef void (*SgrFuncHighbd)(uint16_t *dat, int width, int height, int stride,
+                              int bit_depth, int eps, int *xqd, uint16_t *dst,
+                              int dst_stride, int32_t *tmpbuf);
+typedef void (*SelfguidedFuncHighbd)(uint16_t *dgd, int width, int height,
+                                     int stride, int32_t *dst, int dst_stride,
+                                     int bit_depth, int r, int eps,
+                                     int32_t *tmpbuf);
+
+typedef tuple<SgrFuncHighbd, SelfguidedFuncHighbd, int> HighbdFilterTestParam;
 
 class AV1HighbdSelfguidedFilterTest
     : public ::testing::TestWithParam<HighbdFilterTestParam> {
  public:
   virtual ~AV1HighbdSelfguidedFilterTest() {}
-  virtual void SetUp() {}
+  virtual void SetUp() {
+    tst_fun_ = GET_PARAM(0);
+    tst_pass_ = GET_PARAM(1);
+  }
 
   virtual void TearDown() { libaom_test::ClearSystemState(); }
 
@@ -161,7 +350,7 @@ class AV1HighbdSelfguidedFilterTest
     const int w = 256, h = 256;
     const int NUM_ITERS = 2000;
     int i, j;
-    int bit_depth = GET_PARAM(0);
+    int bit_depth = GET_PARAM(2);
     int mask = (1 << bit_depth) - 1;
 
     uint16_t *input = (uint16_t *)aom_memalign(16, w * h * sizeof(uint16_t));
@@ -188,8 +377,7 @@ class AV1HighbdSelfguidedFilterTest
 
     std::clock_t start = std::clock();
     for (i = 0; i < NUM_ITERS; ++i) {
-      apply_selfguided_restoration_highbd(input, w, h, w, bit_depth, eps, xqd,
-                                          output, w, tmpbuf);
+      tst_fun_(input, w, h, w, bit_depth, eps, xqd, output, w, tmpbuf);
     }
     std::clock_t end = std::clock();
     double elapsed = ((end - start) / (double)CLOCKS_PER_SEC);
@@ -209,7 +397,7 @@ class AV1HighbdSelfguidedFilterTest
     const int max_w = 260, max_h = 260, stride = 672, out_stride = 672;
     const int NUM_ITERS = 81;
     int i, j, k;
-    int bit_depth = GET_PARAM(0);
+    int bit_depth = GET_PARAM(2);
     int mask = (1 << bit_depth) - 1;
 
     uint16_t *input =
@@ -241,9 +429,8 @@ class AV1HighbdSelfguidedFilterTest
       int test_w = max_w - (i / 9);
       int test_h = max_h - (i % 9);
 
-      apply_selfguided_restoration_highbd(input, test_w, test_h, stride,
-                                          bit_depth, eps, xqd, output,
-                                          out_stride, tmpbuf);
+      tst_fun_(input, test_w, test_h, stride, bit_depth, eps, xqd, output,
+               out_stride, tmpbuf);
       apply_selfguided_restoration_highbd_c(input, test_w, test_h, stride,
                                             bit_depth, eps, xqd, output2,
                                             out_stride, tmpbuf);
@@ -257,17 +444,193 @@ class AV1HighbdSelfguidedFilterTest
     aom_free(output2);
     aom_free(tmpbuf);
   }
+
+  void RunBenchmark() {
+    const int w = 256, h = 256;
+    const int NUM_ITERS = 1000;
+    const int eps = 30;
+    int i, j, r;
+    int bit_depth = GET_PARAM(2);
+    int mask = (1 << bit_depth) - 1;
+
+    uint16_t *input = (uint16_t *)aom_memalign(16, w * h * sizeof(uint16_t));
+    int32_t *output = (int32_t *)aom_memalign(16, w * h * sizeof(int32_t));
+    int32_t *tmpbuf = (int32_t *)aom_memalign(16, RESTORATION_TMPBUF_SIZE);
+    memset(tmpbuf, 0, RESTORATION_TMPBUF_SIZE);
+
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+
+    for (i = 0; i < h; ++i)
+      for (j = 0; j < w; ++j) input[i * w + j] = rnd.Rand16() & mask;
+
+    av1_loop_restoration_precal();
+
+    for (r = 1; r <= MAX_RADIUS; ++r) {
+      std::clock_t start = std::clock();
+      for (i = 0; i < NUM_ITERS; ++i)
+        av1_selfguided_restoration_highbd_c(input, w, h, w, output, w,
+                                            bit_depth, r, eps, tmpbuf);
+      const double ref_time =
+          (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+
+      start = std::clock();
+      for (i = 0; i < NUM_ITERS; ++i)
+        tst_pass_(input, w, h, w, output, w, bit_depth, r, eps, tmpbuf);
+      const double tst_time =
+          (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+
+      const double mpix = (double)w * h * NUM_ITERS / 1000000.;
+      printf("%d-bit r=%d: C %7.1f MPix/s, SIMD %7.1f MPix/s (x%.2f)\n",
+             bit_depth, r, mpix / ref_time, mpix / tst_time,
+             ref_time / tst_time);
+    }
+
+    aom_free(input);
+    aom_free(output);
+    aom_free(tmpbuf);
+  }
+
+  SgrFuncHighbd tst_fun_;
+  SelfguidedFuncHighbd tst_pass_;
 };
 
 TEST_P(AV1HighbdSelfguidedFilterTest, SpeedTest) { RunSpeedTest(); }
 TEST_P(AV1HighbdSelfguidedFilterTest, CorrectnessTest) { RunCorrectnessTest(); }
+TEST_P(AV1HighbdSelfguidedFilterTest, DISABLED_Benchmark) { RunBenchmark(); }
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_CASE_P(
+    SSE4_1, AV1HighbdSelfguidedFilterTest,
+    ::testing::Combine(
+        ::testing::Values(apply_selfguided_restoration_highbd_sse4_1),
+        ::testing::Values(av1_selfguided_restoration_highbd_sse4_1),
+        ::testing::Values(8, 10, 12)));
+#endif
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, AV1HighbdSelfguidedFilterTest,
+    ::testing::Combine(
+        ::testing::Values(apply_selfguided_restoration_highbd_avx2),
+        ::testing::Values(av1_selfguided_restoration_highbd_avx2),
+        ::testing::Values(8, 10, 12)));
+#endif
+
+typedef void (*IntegralFuncHighbd)(uint16_t *dgd, int width, int height,
+                                   int stride, int32_t *ii, int32_t *ii_sq);
+typedef void (*FromIntegralFuncHighbd)(uint16_t *dgd, int width, int height,
+                                       int stride, const int32_t *ii,
+                                       const int32_t *ii_sq, int32_t *dst,
+                                       int dst_stride, int bit_depth, int r,
+                                       int eps, int32_t *tmpbuf);
 
-const HighbdFilterTestParam highbd_params[] = { make_tuple(8), make_tuple(10),
-                                                make_tuple(12) };
+typedef tuple<IntegralFuncHighbd, FromIntegralFuncHighbd, int>
+    HighbdIntegralTestParam;
+
+class AV1HighbdSelfguidedIntegralTest
+    : public ::testing::TestWithParam<HighbdIntegralTestParam> {
+ public:
+  virtual ~AV1HighbdSelfguidedIntegralTest() {}
+  virtual void SetUp() {
+    tst_integral_ = GET_PARAM(0);
+    tst_pass_ = GET_PARAM(1);
+  }
+
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RunCorrectnessTest() {
+    const int max_w = 260, max_h = 260, stride = 672;
+    const int NUM_ITERS = 90;
+    int i, j, k, r;
+    int bit_depth = GET_PARAM(2);
+    int mask = (1 << bit_depth) - 1;
+
+    uint16_t *input =
+        (uint16_t *)aom_memalign(16, stride * max_h * sizeof(uint16_t));
+    int32_t *output =
+        (int32_t *)aom_memalign(16, stride * max_h * sizeof(int32_t));
+    int32_t *output2 =
+        (int32_t *)aom_memalign(16, stride * max_h * sizeof(int32_t));
+    int32_t *tmpbuf = (int32_t *)aom_memalign(16, RESTORATION_TMPBUF_SIZE);
+    int32_t *ii = (int32_t *)aom_memalign(16, RESTORATION_EXTBUF_SIZE);
+    int32_t *ii_sq = ii + SGRPROJ_INTEGRAL_SIZE;
+    memset(tmpbuf, 0, RESTORATION_TMPBUF_SIZE);
+
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+
+    av1_loop_restoration_precal();
+
+    for (i = 0; i < NUM_ITERS; ++i) {
+      for (j = 0; j < max_h; ++j)
+        for (k = 0; k < max_w; ++k) input[j * stride + k] = rnd.Rand16() & mask;
+
+      const int test_w = i < 81 ? max_w - (i / 9) : 3 + (i - 81);
+      const int test_h = i < 81 ? max_h - (i % 9) : 11 - (i - 81);
+
+      tst_integral_(input, test_w, test_h, stride, ii, ii_sq);
+      for (r = 1; r <= MAX_RADIUS; ++r) {
+        const int eps = 1 + rnd.PseudoUniform(MAX_EPS);
+        tst_pass_(input, test_w, test_h, stride, ii, ii_sq, output, stride,
+                  bit_depth, r, eps, tmpbuf);
+        if (test_w >= 2 * r + 1 && test_h >= 2 * r + 1) {
+          av1_selfguided_restoration_highbd_c(input, test_w, test_h, stride,
+                                              output2, stride, bit_depth, r,
+                                              eps, tmpbuf);
+        } else {
+          av1_selfguided_integral_images_highbd_c(input, test_w, test_h,
+                                                  stride, ii, ii_sq);
+          av1_selfguided_restoration_from_integral_highbd_c(
+              input, test_w, test_h, stride, ii, ii_sq, output2, stride,
+              bit_depth, r, eps, tmpbuf);
+          tst_integral_(input, test_w, test_h, stride, ii, ii_sq);
+        }
+        for (j = 0; j < test_h; ++j)
+          for (k = 0; k < test_w; ++k)
+            ASSERT_EQ(output[j * stride + k], output2[j * stride + k])
+                << "r=" << r << " size " << test_w << "x" << test_h;
+      }
+    }
+
+    aom_free(input);
+    aom_free(output);
+    aom_free(output2);
+    aom_free(tmpbuf);
+    aom_free(ii);
+  }
+
+  IntegralFuncHighbd tst_integral_;
+  FromIntegralFuncHighbd tst_pass_;
+};
+
+TEST_P(AV1HighbdSelfguidedIntegralTest, CorrectnessTest) {
+  RunCorrectnessTest();
+}
+
+INSTANTIATE_TEST_CASE_P(
+    C, AV1HighbdSelfguidedIntegralTest,
+    ::testing::Combine(
+        ::testing::Values(av1_selfguided_integral_images_highbd_c),
+        ::testing::Values(av1_selfguided_restoration_from_integral_highbd_c),
+        ::testing::Values(8, 10, 12)));
 
 #if HAVE_SSE4_1
-INSTANTIATE_TEST_CASE_P(SSE4_1, AV1HighbdSelfguidedFilterTest,
-                        ::testing::ValuesIn(highbd_params));
+INSTANTIATE_TEST_CASE_P(
+    SSE4_1, AV1HighbdSelfguidedIntegralTest,
+    ::testing::Combine(
+        ::testing::Values(av1_selfguided_integral_images_highbd_c),
+        ::testing::Values(
+            av1_selfguided_restoration_from_integral_highbd_sse4_1),
+        ::testing::Values(8, 10, 12)));
+#endif
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, AV1HighbdSelfguidedIntegralTest,
+    ::testing::Combine(
+        ::testing::Values(av1_selfguided_integral_images_highbd_avx2),
+        ::testing::Values(av1_selfguided_restoration_from_integral_highbd_avx2),
+        ::testing::Values(8, 10, 12)));
 #endif
 #endif
 
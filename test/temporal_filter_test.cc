@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <ctime>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "./av1_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_mem/aom_mem.h"
+#include "aom_ports/mem.h"
+
+namespace {
+
+using std::tr1::tuple;
+using std::tr1::make_tuple;
+using libaom_test::ACMRandom;
+
+// The encoder filters 16x16 luma blocks and chroma blocks of up to that size.
+// The source frame has a border of 16 pixels around the block.
+const int kMaxBlock = 16;
+const int kStride = kMaxBlock * 3;
+const int kBufSize = kStride * kMaxBlock * 3;
+const int kBlockSizes[][2] = { { 16, 16 }, { 8, 8 },  { 16, 8 },
+                               { 8, 16 },  { 4, 4 },  { 4, 16 },
+                               { 16, 4 },  { 12, 8 }, { 3, 5 } };
+
+typedef void (*TemporalFilterFunc)(uint8_t *frame1, unsigned int stride,
+                                   uint8_t *frame2, unsigned int block_width,
+                                   unsigned int block_height, int strength,
+                                   int filter_weight,
+                                   unsigned int *accumulator, uint16_t *count);
+
+// Function under test, and the bit depth. The 8-bit function takes 8-bit
+// pixels; the others take CONVERT_TO_BYTEPTR() pointers to 16-bit ones.
+typedef tuple<TemporalFilterFunc, int> TemporalFilterParam;
+
+class AV1TemporalFilterTest
+    : public ::testing::TestWithParam<TemporalFilterParam> {
+ public:
+  virtual ~AV1TemporalFilterTest() {}
+  virtual void SetUp() {
+    tst_fun_ = GET_PARAM(0);
+    bit_depth_ = GET_PARAM(1);
+#if CONFIG_HIGHBITDEPTH
+    ref_fun_ = bit_depth_ == 8 ? av1_temporal_filter_apply_c
+                               : av1_highbd_temporal_filter_apply_c;
+#else
+    ref_fun_ = av1_temporal_filter_apply_c;
+#endif
+    frame1_ = (uint16_t *)aom_memalign(16, kBufSize * sizeof(*frame1_));
+    frame2_ = (uint16_t *)aom_memalign(16, kBufSize * sizeof(*frame2_));
+  }
+
+  virtual void TearDown() {
+    aom_free(frame1_);
+    aom_free(frame2_);
+    libaom_test::ClearSystemState();
+  }
+
+ protected:
+  // Fill both frames with base + noise, clipped to the pixel range.
+  void FillFrames(ACMRandom *rnd, int base, int noise) {
+    const int max_val = (1 << bit_depth_) - 1;
+    uint8_t *const f1 = (uint8_t *)frame1_;
+    uint8_t *const f2 = (uint8_t *)frame2_;
+    int i;
+    for (i = 0; i < kBufSize; ++i) {
+      const int a = clamp(base + rnd->PseudoUniform(noise + 1) - noise / 2, 0,
+                          max_val);
+      const int b = clamp(base + rnd->PseudoUniform(noise + 1) - noise / 2, 0,
+                          max_val);
+      if (bit_depth_ == 8) {
+        f1[i] = a;
+        f2[i] = b;
+      } else {
+        frame1_[i] = a;
+        frame2_[i] = b;
+      }
+    }
+  }
+
+  // The block of the source frame, away from the top-left corner of the
+  // buffer, and the predictor, which is packed.
+  uint8_t *Frame1() {
+    if (bit_depth_ == 8) return (uint8_t *)frame1_ + kMaxBlock * kStride + 16;
+    return CONVERT_TO_BYTEPTR(frame1_ + kMaxBlock * kStride + 16);
+  }
+  uint8_t *Frame2() {
+    if (bit_depth_ == 8) return (uint8_t *)frame2_;
+    return CONVERT_TO_BYTEPTR(frame2_);
+  }
+
+  void RunCorrectnessTest() {
+    const int NUM_ITERS = 2000;
+    const int max_val = (1 << bit_depth_) - 1;
+    const int num_sizes = sizeof(kBlockSizes) / sizeof(kBlockSizes[0]);
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    int i, j;
+
+    for (i = 0; i < NUM_ITERS; ++i) {
+      const int w = kBlockSizes[i % num_sizes][0];
+      const int h = kBlockSizes[i % num_sizes][1];
+      // The encoder raises the strength by 2 for each extra bit of depth.
+      const int strength = rnd(7) + 2 * (bit_depth_ - 8);
+      const int filter_weight = rnd(3);
+      // Either full-range noise, which saturates the modifier, or small
+      // differences which give every modifier value.
+      const int noise = (i & 1) ? max_val : rnd((16 << (bit_depth_ - 8)) + 1);
+      DECLARE_ALIGNED(16, unsigned int, acc_ref[kMaxBlock * kMaxBlock]);
+      DECLARE_ALIGNED(16, unsigned int, acc_tst[kMaxBlock * kMaxBlock]);
+      DECLARE_ALIGNED(16, uint16_t, count_ref[kMaxBlock * kMaxBlock]);
+      DECLARE_ALIGNED(16, uint16_t, count_tst[kMaxBlock * kMaxBlock]);
+
+      FillFrames(&rnd, rnd(max_val + 1), noise);
+      for (j = 0; j < kMaxBlock * kMaxBlock; ++j) {
+        acc_ref[j] = acc_tst[j] = rnd.Rand16();
+        count_ref[j] = count_tst[j] = rnd(256);
+      }
+
+      ref_fun_(Frame1(), kStride, Frame2(), w, h, strength, filter_weight,
+               acc_ref, count_ref);
+      ASM_REGISTER_STATE_CHECK(tst_fun_(Frame1(), kStride, Frame2(), w, h,
+                                        strength, filter_weight, acc_tst,
+                                        count_tst));
+      for (j = 0; j < kMaxBlock * kMaxBlock; ++j) {
+        ASSERT_EQ(acc_ref[j], acc_tst[j]) << "accumulator[" << j << "] size "
+                                          << w << "x" << h;
+        ASSERT_EQ(count_ref[j], count_tst[j]) << "count[" << j << "] size "
+                                              << w << "x" << h;
+      }
+    }
+  }
+
+  void RunSpeedTest() {
+    const int NUM_ITERS = 100000;
+    const int max_val = (1 << bit_depth_) - 1;
+    const int strength = 6 + 2 * (bit_depth_ - 8);
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    DECLARE_ALIGNED(16, unsigned int, acc[kMaxBlock * kMaxBlock]);
+    DECLARE_ALIGNED(16, uint16_t, count[kMaxBlock * kMaxBlock]);
+    int i;
+
+    FillFrames(&rnd, max_val / 2, max_val >> 3);
+    memset(acc, 0, sizeof(acc));
+    memset(count, 0, sizeof(count));
+
+    std::clock_t start = std::clock();
+    for (i = 0; i < NUM_ITERS; ++i)
+      ref_fun_(Frame1(), kStride, Frame2(), kMaxBlock, kMaxBlock, strength, 2,
+               acc, count);
+    const double ref_time =
+        (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+
+    start = std::clock();
+    for (i = 0; i < NUM_ITERS; ++i)
+      tst_fun_(Frame1(), kStride, Frame2(), kMaxBlock, kMaxBlock, strength, 2,
+               acc, count);
+    const double tst_time =
+        (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+
+    printf("%d-bit 16x16: C time: %.1f ns, SIMD time: %.1f ns (x%.1f)\n",
+           bit_depth_, 1e9 * ref_time / NUM_ITERS, 1e9 * tst_time / NUM_ITERS,
+           ref_time / tst_time);
+  }
+
+  TemporalFilterFunc tst_fun_;
+  TemporalFilterFunc ref_fun_;
+  int bit_depth_;
+  uint16_t *frame1_;
+  uint16_t *frame2_;
+};
+
+TEST_P(AV1TemporalFilterTest, CorrectnessTest) { RunCorrectnessTest(); }
+TEST_P(AV1TemporalFilterTest, DISABLED_SpeedTest) { RunSpeedTest(); }
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_CASE_P(
+    SSE4_1, AV1TemporalFilterTest,
+    ::testing::Values(make_tuple(av1_temporal_filter_apply_sse4_1, 8)));
+#endif
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, AV1TemporalFilterTest,
+    ::testing::Values(make_tuple(av1_temporal_filter_apply_avx2, 8)));
+#endif
+
+#if CONFIG_HIGHBITDEPTH
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_CASE_P(
+    SSE4_1_HBD, AV1TemporalFilterTest,
+    ::testing::Combine(
+        ::testing::Values(av1_highbd_temporal_filter_apply_sse4_1),
+        ::testing::Values(10, 12)));
+#endif
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2_HBD, AV1TemporalFilterTest,
+    ::testing::Combine(::testing::Values(av1_highbd_temporal_filter_apply_avx2),
+                       ::testing::Values(10, 12)));
+#endif
+#endif  // CONFIG_HIGHBITDEPTH
+
+}  // namespace
@@ -76,6 +76,7 @@ set(AOM_UNIT_TEST_ENCODER_SOURCES
     "${AOM_ROOT}/test/encode_test_driver.cc"
     "${AOM_ROOT}/test/encode_test_driver.h"
     "${AOM_ROOT}/test/error_resilience_test.cc"
+    "${AOM_ROOT}/test/first_pass_chunk_test.cc"
     "${AOM_ROOT}/test/i420_video_source.h"
     "${AOM_ROOT}/test/y4m_test.cc"
     "${AOM_ROOT}/test/y4m_video_source.h"
@@ -197,6 +198,7 @@ if (CONFIG_AV1_ENCODER)
         "${AOM_ROOT}/test/quantize_func_test.cc"
         "${AOM_ROOT}/test/subtract_test.cc"
         "${AOM_ROOT}/test/sum_squares_test.cc"
+        "${AOM_ROOT}/test/temporal_filter_test.cc"
         "${AOM_ROOT}/test/variance_test.cc")
 
     if (CONFIG_CONVOLVE_ROUND)
@@ -228,11 +230,21 @@ if (CONFIG_AV1_ENCODER)
     endif ()
 
     if (CONFIG_GLOBAL_MOTION)
+      set(AOM_UNIT_TEST_ENCODER_SOURCES
+          ${AOM_UNIT_TEST_ENCODER_SOURCES}
+          "${AOM_ROOT}/test/ransac_test.cc")
+
       set(AOM_UNIT_TEST_ENCODER_INTRIN_SSE4_1
           ${AOM_UNIT_TEST_ENCODER_INTRIN_SSE4_1}
           "${AOM_ROOT}/test/corner_match_test.cc")
     endif ()
 
+    if (CONFIG_LOOP_RESTORATION)
+      set(AOM_UNIT_TEST_ENCODER_SOURCES
+          ${AOM_UNIT_TEST_ENCODER_SOURCES}
+          "${AOM_ROOT}/test/wiener_stats_test.cc")
+    endif ()
+
     if (CONFIG_MOTION_VAR)
       set(AOM_UNIT_TEST_ENCODER_SOURCES
           ${AOM_UNIT_TEST_ENCODER_SOURCES}
@@ -253,9 +265,11 @@ if (NOT BUILD_SHARED_LIBS)
     set(AOM_UNIT_TEST_COMMON_SOURCES
         ${AOM_UNIT_TEST_COMMON_SOURCES}
         "${AOM_ROOT}/test/binary_codes_test.cc"
+        "${AOM_ROOT}/test/decode_row_mt_test.cc"
         "${AOM_ROOT}/test/divu_small_test.cc"
         "${AOM_ROOT}/test/ethread_test.cc"
         "${AOM_ROOT}/test/idct8x8_test.cc"
+        "${AOM_ROOT}/test/job_queue_test.cc"
         "${AOM_ROOT}/test/partial_idct_test.cc"
         "${AOM_ROOT}/test/superframe_test.cc"
         "${AOM_ROOT}/test/tile_independence_test.cc")
@@ -276,6 +290,12 @@ if (NOT BUILD_SHARED_LIBS)
           ${AOM_UNIT_TEST_COMMON_SOURCES}
           "${AOM_ROOT}/test/av1_ext_tile_test.cc")
     endif ()
+
+    if (CONFIG_LOOP_RESTORATION)
+      set(AOM_UNIT_TEST_COMMON_SOURCES
+          ${AOM_UNIT_TEST_COMMON_SOURCES}
+          "${AOM_ROOT}/test/lr_thread_test.cc")
+    endif ()
   endif ()
 endif ()
 
@@ -203,6 +203,186 @@ void TestIntraPred32(AvxPredFunc const *pred_funcs) {
                 kSignatures, 32, 32 * 32 * kNumAv1IntraFuncs);
 }
 
+void TestIntraPred4x8(AvxPredFunc const *pred_funcs) {
+  static const char *const kSignatures[kNumAv1IntraFuncs] = {
+    "28913acf84b678b4624008557b2f0b8e",
+    "01ae9af256b049074f65eb9e02f504c2",
+    "133e0a78416707d19e346f64950d1f37",
+    "6707db65df7cddefe9ad2df13ce783dd",
+    "1bf2eea90612816f3cb5fc8befb2a769",
+    "7369d1415582f97b91f93363bea165cf",
+    "0eab6e6b320c872b67c6bca33c87639f",
+    "df509a3e3e08fd4e1f79cd9afc2bfa0d",
+    "985a45cc0ac0ad949eacb483d7afe2b7",
+    "91cc657d3d8d527c04e66c4d47d890ac",
+    "8b559762c9acdc4e1f2dfb01c7dbef8f",
+    "b16a873cb41f75c385ef5b385b274df7",
+#if CONFIG_ALT_INTRA
+    "7cdd839dd668915b86e405406ee85933",
+    "7036c074f46d60538cec41f469c95de1",
+#if CONFIG_SMOOTH_HV
+    "b0b563f14bf1a445fbe4c419df6f48e1",
+    "284971e35a5c01dcb40b5d33838d718b",
+#endif  // CONFIG_SMOOTH_HV
+#else
+    "284c2ddab83e7440f63705dedc35faad",
+#endif  // CONFIG_ALT_INTRA
+  };
+  TestIntraPred("Intra4x8", pred_funcs, kAv1IntraPredNames,
+                kNumAv1IntraFuncs, kSignatures, 8,
+                4 * 8 * kNumAv1IntraFuncs);
+}
+
+void TestIntraPred8x4(AvxPredFunc const *pred_funcs) {
+  static const char *const kSignatures[kNumAv1IntraFuncs] = {
+    "d3839e9bb624daf626900936e9c778f8",
+    "b4b2a196fd1f065621ea6acec7d51142",
+    "a90793190eaa995ad94d35f7e6e2b026",
+    "5995aceefefbed4478ddc7e581d3ab8e",
+    "fa37474eeecae2d1799b4fda190a42e7",
+    "0574d80009af0472653169855f8b2132",
+    "4c5c564750345282e5e904a7807b78db",
+    "862ebdb69c9d63d33f2cd105ca9977c1",
+    "bb58261fb39dcbdfcfb0008d8b6586a1",
+    "13a8ca586779c290838a86e5839cf06a",
+    "c46c1648c9873c83e44666b644befc90",
+    "ec7254bd60f085548aaebb348ca38602",
+#if CONFIG_ALT_INTRA
+    "6d40622514db79a1c5f73c22384f311f",
+    "c8cda112a72a301f3928ed84b4d84c53",
+#if CONFIG_SMOOTH_HV
+    "1e7ad1407febddc9cccd2e5394dfc01d",
+    "abb94cc6798cac1917781e979644cebd",
+#endif  // CONFIG_SMOOTH_HV
+#else
+    "0a80c8cb7c13ed528d768bf192059fa5",
+#endif  // CONFIG_ALT_INTRA
+  };
+  TestIntraPred("Intra8x4", pred_funcs, kAv1IntraPredNames,
+                kNumAv1IntraFuncs, kSignatures, 8,
+                8 * 4 * kNumAv1IntraFuncs);
+}
+
+void TestIntraPred8x16(AvxPredFunc const *pred_funcs) {
+  static const char *const kSignatures[kNumAv1IntraFuncs] = {
+    "bc895b84c648b44286930d6a4d963674",
+    "092d2100a44b50d45b75f97d4733f604",
+    "644ae6a3c46a28c7e22ee16588236baf",
+    "6fab2e3468bf2332a3d4eada4a6a91ca",
+    "31d18c8c1558b8376a19b022b2fe2734",
+    "c6dd675824fb38a0361e483c520e6ff4",
+    "0601a8a8b02177b776f09b4382cc5703",
+    "97ac4a84c6d25f05444eb8e2457af425",
+    "35407096d724fc39d3b4757ca5ebf3ca",
+    "37688f4ec7a64abcd435f98b39b1b581",
+    "c3913f82b1a9141c182160e9f4b12da4",
+    "231c1a6d7f9607e082d29407e04ce016",
+#if CONFIG_ALT_INTRA
+    "56172ec3cdb17cb40495df4e676680bf",
+    "44789645626f7605408726a24bfb72ce",
+#if CONFIG_SMOOTH_HV
+    "852089eaa57c1e1aa35573828ca86ac6",
+    "bb8f3851bb599ea4abb4e2c406829dde",
+#endif  // CONFIG_SMOOTH_HV
+#else
+    "9d114aff0fd173b739b747add588d17b",
+#endif  // CONFIG_ALT_INTRA
+  };
+  TestIntraPred("Intra8x16", pred_funcs, kAv1IntraPredNames,
+                kNumAv1IntraFuncs, kSignatures, 16,
+                8 * 16 * kNumAv1IntraFuncs);
+}
+
+void TestIntraPred16x8(AvxPredFunc const *pred_funcs) {
+  static const char *const kSignatures[kNumAv1IntraFuncs] = {
+    "0f31ca0a65f263422405b3472c662dc3",
+    "ca27417460be3e79612c76623f66b442",
+    "d4775c7b8d6c58478843e57948e8cd4b",
+    "e7e35c89cdedb314f8f55c4c4fed02fa",
+    "a0ac2b2c6bba162340e48569677c9ac2",
+    "d8a95bcfb9cf209feb95b7df0c3f9458",
+    "19b6329edfd6e897e6a6c8dcc6adfe17",
+    "9296bb2235a7885c18384acb51a2e8b0",
+    "88ac9d9f8838e4d56ebc55da37308400",
+    "bd23d7748ae0ebff91f0c07c7cf25881",
+    "e6e04673c98ea019db3c76180b55c469",
+    "bbcb76d668102a7c3f4c02990f466f17",
+#if CONFIG_ALT_INTRA
+    "fed1fe56f3e9eba162942eb8c04edec4",
+    "cb5048aef8d41530e44e9fd3adfc6eb1",
+#if CONFIG_SMOOTH_HV
+    "353752cabbee9e93fa64cff52f735227",
+    "e28c601f4071ba3e8c6ffaca686d7ed1",
+#endif  // CONFIG_SMOOTH_HV
+#else
+    "f7cc129d009534a7e1f83f67429975f7",
+#endif  // CONFIG_ALT_INTRA
+  };
+  TestIntraPred("Intra16x8", pred_funcs, kAv1IntraPredNames,
+                kNumAv1IntraFuncs, kSignatures, 16,
+                16 * 8 * kNumAv1IntraFuncs);
+}
+
+void TestIntraPred16x32(AvxPredFunc const *pred_funcs) {
+  static const char *const kSignatures[kNumAv1IntraFuncs] = {
+    "2ab060c8bccf3e125133e93417cbf1e8",
+    "f54941be3eb21902c39e4044004d728e",
+    "cb134265dd116386c1363352cf9dbe19",
+    "2ab060c8bccf3e125133e93417cbf1e8",
+    "73aad38c49741604f05fd7b0e7d330a1",
+    "c6e2652159face031ebadb5a5da0c224",
+    "201578c6d781782ce8fce0b27f54b152",
+    "3474921f7dcc92c13470bdfb79ce5e80",
+    "411ee8c2addf2714f595e04e058bc66e",
+    "d23b02f5271f62048a1e2e63d4ee4eff",
+    "43c79cd3f851ac2c170d6a30f44e1f35",
+    "878d3d80db1be410f4d2955da3121bf7",
+#if CONFIG_ALT_INTRA
+    "e2e66d571867c754beaca50a30824f73",
+    "1fbe3b286b674fb31a9410acda5269d3",
+#if CONFIG_SMOOTH_HV
+    "f99a9af1abc4ca9c52d4921f08e06820",
+    "bef6b40259025bcb1a356aa10352e51c",
+#endif  // CONFIG_SMOOTH_HV
+#else
+    "6ccc6ff64da3e8469f042e27b95d4960",
+#endif  // CONFIG_ALT_INTRA
+  };
+  TestIntraPred("Intra16x32", pred_funcs, kAv1IntraPredNames,
+                kNumAv1IntraFuncs, kSignatures, 32,
+                16 * 32 * kNumAv1IntraFuncs);
+}
+
+void TestIntraPred32x16(AvxPredFunc const *pred_funcs) {
+  static const char *const kSignatures[kNumAv1IntraFuncs] = {
+    "edddaa3ea8509db9641d2fa2d19f9faf",
+    "a67468b3ecb87b663f659057af9cc7e6",
+    "e7613805fc557d315fef041911ec2d8f",
+    "4e05ccca79c83953c9fba61a32f1160a",
+    "1d0c222ab2a88a1376f9c05f175bde6d",
+    "97af6a6ffd61f5e284d8881f6c3c1183",
+    "a3dd8d39a085bfce61b9fc4405c25d11",
+    "41c36fcf12b523d6045b54452f942593",
+    "6b173a9fae72c943c78d0ea67c12b885",
+    "f23282dcc55ce78c15b1e7ceb7603aed",
+    "063d65f2fdc4e59e651e5885ab75c4ce",
+    "95f212dce9c016268e4fedbbd04df168",
+#if CONFIG_ALT_INTRA
+    "a72fc633c8517854001185710832c866",
+    "b0709c1e791559afeb0f6a0caf8f8fb3",
+#if CONFIG_SMOOTH_HV
+    "9f97c8c262d2e2f92b31c093bbef8ee8",
+    "b8248f60068b6d9a1c5b8e30e10070fa",
+#endif  // CONFIG_SMOOTH_HV
+#else
+    "c831e9ebf00d05791255a07cdd43bb2d",
+#endif  // CONFIG_ALT_INTRA
+  };
+  TestIntraPred("Intra32x16", pred_funcs, kAv1IntraPredNames,
+                kNumAv1IntraFuncs, kSignatures, 32,
+                32 * 16 * kNumAv1IntraFuncs);
+}
+
 }  // namespace
 
 // Defines a test case for |arch| (e.g., C, SSE2, ...) passing the predictors
@@ -218,6 +398,26 @@ void TestIntraPred32(AvxPredFunc const *pred_funcs) {
     test_func(aom_intra_pred);                                              \
   }
 
+#if CONFIG_ALT_INTRA
+// Defines a test case for |arch| that only has the PAETH and SMOOTH predictors
+// of a |width|x|height| block, whose names end in |opt| (e.g., sse4_1).
+#if CONFIG_SMOOTH_HV
+#define ALT_INTRA_PRED_TEST(arch, test_func, opt, width, height)            \
+  INTRA_PRED_TEST(arch, test_func, NULL, NULL, NULL, NULL, NULL, NULL, NULL, \
+                  NULL, NULL, NULL, NULL, NULL,                              \
+                  aom_paeth_predictor_##width##x##height##_##opt,            \
+                  aom_smooth_predictor_##width##x##height##_##opt,           \
+                  aom_smooth_v_predictor_##width##x##height##_##opt,         \
+                  aom_smooth_h_predictor_##width##x##height##_##opt)
+#else
+#define ALT_INTRA_PRED_TEST(arch, test_func, opt, width, height)            \
+  INTRA_PRED_TEST(arch, test_func, NULL, NULL, NULL, NULL, NULL, NULL, NULL, \
+                  NULL, NULL, NULL, NULL, NULL,                              \
+                  aom_paeth_predictor_##width##x##height##_##opt,            \
+                  aom_smooth_predictor_##width##x##height##_##opt, NULL, NULL)
+#endif  // CONFIG_SMOOTH_HV
+#endif  // CONFIG_ALT_INTRA
+
 // -----------------------------------------------------------------------------
 // 4x4
 
@@ -274,6 +474,10 @@ INTRA_PRED_TEST(SSSE3, TestIntraPred4, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
                 aom_d63e_predictor_4x4_ssse3, NULL, NULL, NULL, NULL)
 #endif  // HAVE_SSSE3
 
+#if HAVE_SSE4_1 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(SSE4_1, TestIntraPred4, sse4_1, 4, 4)
+#endif  // HAVE_SSE4_1 && CONFIG_ALT_INTRA
+
 #if HAVE_DSPR2
 #if CONFIG_ALT_INTRA
 #define tm_pred_func NULL
@@ -366,6 +570,10 @@ INTRA_PRED_TEST(SSSE3, TestIntraPred8, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
                 NULL, NULL, NULL)
 #endif  // HAVE_SSSE3
 
+#if HAVE_SSE4_1 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(SSE4_1, TestIntraPred8, sse4_1, 8, 8)
+#endif  // HAVE_SSE4_1 && CONFIG_ALT_INTRA
+
 #if HAVE_DSPR2
 #if CONFIG_ALT_INTRA
 #define tm_pred_func NULL
@@ -459,6 +667,14 @@ INTRA_PRED_TEST(SSSE3, TestIntraPred16, NULL, NULL, NULL, NULL, NULL, NULL,
                 NULL, NULL, NULL, NULL)
 #endif  // HAVE_SSSE3
 
+#if HAVE_SSE4_1 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(SSE4_1, TestIntraPred16, sse4_1, 16, 16)
+#endif  // HAVE_SSE4_1 && CONFIG_ALT_INTRA
+
+#if HAVE_AVX2 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(AVX2, TestIntraPred16, avx2, 16, 16)
+#endif  // HAVE_AVX2 && CONFIG_ALT_INTRA
+
 #if HAVE_DSPR2
 INTRA_PRED_TEST(DSPR2, TestIntraPred16, aom_dc_predictor_16x16_dspr2, NULL,
                 NULL, NULL, NULL, aom_h_predictor_16x16_dspr2, NULL, NULL, NULL,
@@ -547,6 +763,14 @@ INTRA_PRED_TEST(SSSE3, TestIntraPred32, NULL, NULL, NULL, NULL, NULL, NULL,
                 NULL, NULL, NULL, NULL)
 #endif  // HAVE_SSSE3
 
+#if HAVE_SSE4_1 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(SSE4_1, TestIntraPred32, sse4_1, 32, 32)
+#endif  // HAVE_SSE4_1 && CONFIG_ALT_INTRA
+
+#if HAVE_AVX2 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(AVX2, TestIntraPred32, avx2, 32, 32)
+#endif  // HAVE_AVX2 && CONFIG_ALT_INTRA
+
 #if HAVE_NEON
 #if CONFIG_ALT_INTRA
 #define tm_pred_func NULL
@@ -576,4 +800,232 @@ INTRA_PRED_TEST(MSA, TestIntraPred32, aom_dc_predictor_32x32_msa,
 #undef tm_pred_func
 #endif  // HAVE_MSA
 
+// -----------------------------------------------------------------------------
+// 4x8
+
+#if CONFIG_ALT_INTRA
+#define tm_pred_func aom_paeth_predictor_4x8_c
+#define smooth_pred_func aom_smooth_predictor_4x8_c
+#if CONFIG_SMOOTH_HV
+#define smooth_v_pred_func aom_smooth_v_predictor_4x8_c
+#define smooth_h_pred_func aom_smooth_h_predictor_4x8_c
+#else
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_SMOOTH_HV
+#else
+#define tm_pred_func aom_tm_predictor_4x8_c
+#define smooth_pred_func NULL
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_ALT_INTRA
+INTRA_PRED_TEST(C, TestIntraPred4x8, aom_dc_predictor_4x8_c,
+                aom_dc_left_predictor_4x8_c, aom_dc_top_predictor_4x8_c,
+                aom_dc_128_predictor_4x8_c, aom_v_predictor_4x8_c,
+                aom_h_predictor_4x8_c, aom_d45e_predictor_4x8_c,
+                aom_d135_predictor_4x8_c, aom_d117_predictor_4x8_c,
+                aom_d153_predictor_4x8_c, aom_d207e_predictor_4x8_c,
+                aom_d63e_predictor_4x8_c, tm_pred_func, smooth_pred_func,
+                smooth_v_pred_func, smooth_h_pred_func)
+#undef tm_pred_func
+#undef smooth_pred_func
+#undef smooth_v_pred_func
+#undef smooth_h_pred_func
+
+#if HAVE_SSE4_1 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(SSE4_1, TestIntraPred4x8, sse4_1, 4, 8)
+#endif  // HAVE_SSE4_1 && CONFIG_ALT_INTRA
+
+// -----------------------------------------------------------------------------
+// 8x4
+
+#if CONFIG_ALT_INTRA
+#define tm_pred_func aom_paeth_predictor_8x4_c
+#define smooth_pred_func aom_smooth_predictor_8x4_c
+#if CONFIG_SMOOTH_HV
+#define smooth_v_pred_func aom_smooth_v_predictor_8x4_c
+#define smooth_h_pred_func aom_smooth_h_predictor_8x4_c
+#else
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_SMOOTH_HV
+#else
+#define tm_pred_func aom_tm_predictor_8x4_c
+#define smooth_pred_func NULL
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_ALT_INTRA
+INTRA_PRED_TEST(C, TestIntraPred8x4, aom_dc_predictor_8x4_c,
+                aom_dc_left_predictor_8x4_c, aom_dc_top_predictor_8x4_c,
+                aom_dc_128_predictor_8x4_c, aom_v_predictor_8x4_c,
+                aom_h_predictor_8x4_c, aom_d45e_predictor_8x4_c,
+                aom_d135_predictor_8x4_c, aom_d117_predictor_8x4_c,
+                aom_d153_predictor_8x4_c, aom_d207e_predictor_8x4_c,
+                aom_d63e_predictor_8x4_c, tm_pred_func, smooth_pred_func,
+                smooth_v_pred_func, smooth_h_pred_func)
+#undef tm_pred_func
+#undef smooth_pred_func
+#undef smooth_v_pred_func
+#undef smooth_h_pred_func
+
+#if HAVE_SSE4_1 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(SSE4_1, TestIntraPred8x4, sse4_1, 8, 4)
+#endif  // HAVE_SSE4_1 && CONFIG_ALT_INTRA
+
+// -----------------------------------------------------------------------------
+// 8x16
+
+#if CONFIG_ALT_INTRA
+#define tm_pred_func aom_paeth_predictor_8x16_c
+#define smooth_pred_func aom_smooth_predictor_8x16_c
+#if CONFIG_SMOOTH_HV
+#define smooth_v_pred_func aom_smooth_v_predictor_8x16_c
+#define smooth_h_pred_func aom_smooth_h_predictor_8x16_c
+#else
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_SMOOTH_HV
+#else
+#define tm_pred_func aom_tm_predictor_8x16_c
+#define smooth_pred_func NULL
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_ALT_INTRA
+INTRA_PRED_TEST(C, TestIntraPred8x16, aom_dc_predictor_8x16_c,
+                aom_dc_left_predictor_8x16_c, aom_dc_top_predictor_8x16_c,
+                aom_dc_128_predictor_8x16_c, aom_v_predictor_8x16_c,
+                aom_h_predictor_8x16_c, aom_d45e_predictor_8x16_c,
+                aom_d135_predictor_8x16_c, aom_d117_predictor_8x16_c,
+                aom_d153_predictor_8x16_c, aom_d207e_predictor_8x16_c,
+                aom_d63e_predictor_8x16_c, tm_pred_func, smooth_pred_func,
+                smooth_v_pred_func, smooth_h_pred_func)
+#undef tm_pred_func
+#undef smooth_pred_func
+#undef smooth_v_pred_func
+#undef smooth_h_pred_func
+
+#if HAVE_SSE4_1 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(SSE4_1, TestIntraPred8x16, sse4_1, 8, 16)
+#endif  // HAVE_SSE4_1 && CONFIG_ALT_INTRA
+
+// -----------------------------------------------------------------------------
+// 16x8
+
+#if CONFIG_ALT_INTRA
+#define tm_pred_func aom_paeth_predictor_16x8_c
+#define smooth_pred_func aom_smooth_predictor_16x8_c
+#if CONFIG_SMOOTH_HV
+#define smooth_v_pred_func aom_smooth_v_predictor_16x8_c
+#define smooth_h_pred_func aom_smooth_h_predictor_16x8_c
+#else
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_SMOOTH_HV
+#else
+#define tm_pred_func aom_tm_predictor_16x8_c
+#define smooth_pred_func NULL
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_ALT_INTRA
+INTRA_PRED_TEST(C, TestIntraPred16x8, aom_dc_predictor_16x8_c,
+                aom_dc_left_predictor_16x8_c, aom_dc_top_predictor_16x8_c,
+                aom_dc_128_predictor_16x8_c, aom_v_predictor_16x8_c,
+                aom_h_predictor_16x8_c, aom_d45e_predictor_16x8_c,
+                aom_d135_predictor_16x8_c, aom_d117_predictor_16x8_c,
+                aom_d153_predictor_16x8_c, aom_d207e_predictor_16x8_c,
+                aom_d63e_predictor_16x8_c, tm_pred_func, smooth_pred_func,
+                smooth_v_pred_func, smooth_h_pred_func)
+#undef tm_pred_func
+#undef smooth_pred_func
+#undef smooth_v_pred_func
+#undef smooth_h_pred_func
+
+#if HAVE_SSE4_1 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(SSE4_1, TestIntraPred16x8, sse4_1, 16, 8)
+#endif  // HAVE_SSE4_1 && CONFIG_ALT_INTRA
+
+#if HAVE_AVX2 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(AVX2, TestIntraPred16x8, avx2, 16, 8)
+#endif  // HAVE_AVX2 && CONFIG_ALT_INTRA
+
+// -----------------------------------------------------------------------------
+// 16x32
+
+#if CONFIG_ALT_INTRA
+#define tm_pred_func aom_paeth_predictor_16x32_c
+#define smooth_pred_func aom_smooth_predictor_16x32_c
+#if CONFIG_SMOOTH_HV
+#define smooth_v_pred_func aom_smooth_v_predictor_16x32_c
+#define smooth_h_pred_func aom_smooth_h_predictor_16x32_c
+#else
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_SMOOTH_HV
+#else
+#define tm_pred_func aom_tm_predictor_16x32_c
+#define smooth_pred_func NULL
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_ALT_INTRA
+INTRA_PRED_TEST(C, TestIntraPred16x32, aom_dc_predictor_16x32_c,
+                aom_dc_left_predictor_16x32_c, aom_dc_top_predictor_16x32_c,
+                aom_dc_128_predictor_16x32_c, aom_v_predictor_16x32_c,
+                aom_h_predictor_16x32_c, aom_d45e_predictor_16x32_c,
+                aom_d135_predictor_16x32_c, aom_d117_predictor_16x32_c,
+                aom_d153_predictor_16x32_c, aom_d207e_predictor_16x32_c,
+                aom_d63e_predictor_16x32_c, tm_pred_func, smooth_pred_func,
+                smooth_v_pred_func, smooth_h_pred_func)
+#undef tm_pred_func
+#undef smooth_pred_func
+#undef smooth_v_pred_func
+#undef smooth_h_pred_func
+
+#if HAVE_SSE4_1 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(SSE4_1, TestIntraPred16x32, sse4_1, 16, 32)
+#endif  // HAVE_SSE4_1 && CONFIG_ALT_INTRA
+
+#if HAVE_AVX2 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(AVX2, TestIntraPred16x32, avx2, 16, 32)
+#endif  // HAVE_AVX2 && CONFIG_ALT_INTRA
+
+// -----------------------------------------------------------------------------
+// 32x16
+
+#if CONFIG_ALT_INTRA
+#define tm_pred_func aom_paeth_predictor_32x16_c
+#define smooth_pred_func aom_smooth_predictor_32x16_c
+#if CONFIG_SMOOTH_HV
+#define smooth_v_pred_func aom_smooth_v_predictor_32x16_c
+#define smooth_h_pred_func aom_smooth_h_predictor_32x16_c
+#else
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_SMOOTH_HV
+#else
+#define tm_pred_func aom_tm_predictor_32x16_c
+#define smooth_pred_func NULL
+#define smooth_v_pred_func NULL
+#define smooth_h_pred_func NULL
+#endif  // CONFIG_ALT_INTRA
+INTRA_PRED_TEST(C, TestIntraPred32x16, aom_dc_predictor_32x16_c,
+                aom_dc_left_predictor_32x16_c, aom_dc_top_predictor_32x16_c,
+                aom_dc_128_predictor_32x16_c, aom_v_predictor_32x16_c,
+                aom_h_predictor_32x16_c, aom_d45e_predictor_32x16_c,
+                aom_d135_predictor_32x16_c, aom_d117_predictor_32x16_c,
+                aom_d153_predictor_32x16_c, aom_d207e_predictor_32x16_c,
+                aom_d63e_predictor_32x16_c, tm_pred_func, smooth_pred_func,
+                smooth_v_pred_func, smooth_h_pred_func)
+#undef tm_pred_func
+#undef smooth_pred_func
+#undef smooth_v_pred_func
+#undef smooth_h_pred_func
+
+#if HAVE_SSE4_1 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(SSE4_1, TestIntraPred32x16, sse4_1, 32, 16)
+#endif  // HAVE_SSE4_1 && CONFIG_ALT_INTRA
+
+#if HAVE_AVX2 && CONFIG_ALT_INTRA
+ALT_INTRA_PRED_TEST(AVX2, TestIntraPred32x16, avx2, 32, 16)
+#endif  // HAVE_AVX2 && CONFIG_ALT_INTRA
+
 #include "test/test_libaom.cc"
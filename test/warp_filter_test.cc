@@ -16,13 +16,20 @@ using std::tr1::tuple;
 using std::tr1::make_tuple;
 using libaom_test::ACMRandom;
 using libaom_test::AV1WarpFilter::AV1WarpFilterTest;
+#if CONFIG_CONVOLVE_ROUND
+using libaom_test::AV1WarpFilter::AV1WarpFilterPostRoundTest;
+#endif
 #if CONFIG_HIGHBITDEPTH
 using libaom_test::AV1HighbdWarpFilter::AV1HighbdWarpFilterTest;
+#if CONFIG_CONVOLVE_ROUND
+using libaom_test::AV1HighbdWarpFilter::AV1HighbdWarpFilterPostRoundTest;
+#endif
 #endif
 
 namespace {
 
 TEST_P(AV1WarpFilterTest, CheckOutput) { RunCheckOutput(GET_PARAM(3)); }
+TEST_P(AV1WarpFilterTest, DISABLED_Speed) { RunSpeedTest(GET_PARAM(3)); }
 
 INSTANTIATE_TEST_CASE_P(
     SSE2, AV1WarpFilterTest,
@@ -34,13 +41,57 @@ INSTANTIATE_TEST_CASE_P(
     libaom_test::AV1WarpFilter::BuildParams(av1_warp_affine_ssse3));
 #endif
 
-#if CONFIG_HIGHBITDEPTH && HAVE_SSSE3
-TEST_P(AV1HighbdWarpFilterTest, CheckOutput) {
-  RunCheckOutput(av1_highbd_warp_affine_ssse3);
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, AV1WarpFilterTest,
+    libaom_test::AV1WarpFilter::BuildParams(av1_warp_affine_avx2));
+#endif
+
+#if CONFIG_CONVOLVE_ROUND
+TEST_P(AV1WarpFilterPostRoundTest, CheckOutput) {
+  RunCheckOutputPostRound(GET_PARAM(3));
+}
+TEST_P(AV1WarpFilterPostRoundTest, DISABLED_Speed) {
+  RunSpeedTest(GET_PARAM(3));
 }
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, AV1WarpFilterPostRoundTest,
+    libaom_test::AV1WarpFilter::BuildParams(av1_warp_affine_post_round_avx2));
+#endif
+#endif  // CONFIG_CONVOLVE_ROUND
+
+#if CONFIG_HIGHBITDEPTH
+TEST_P(AV1HighbdWarpFilterTest, CheckOutput) { RunCheckOutput(GET_PARAM(4)); }
+TEST_P(AV1HighbdWarpFilterTest, DISABLED_Speed) { RunSpeedTest(GET_PARAM(4)); }
+
+#if HAVE_SSSE3
 INSTANTIATE_TEST_CASE_P(SSSE3, AV1HighbdWarpFilterTest,
-                        libaom_test::AV1HighbdWarpFilter::GetDefaultParams());
+                        libaom_test::AV1HighbdWarpFilter::BuildParams(
+                            av1_highbd_warp_affine_ssse3));
+#endif
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, AV1HighbdWarpFilterTest,
+                        libaom_test::AV1HighbdWarpFilter::BuildParams(
+                            av1_highbd_warp_affine_avx2));
+#endif
+
+#if CONFIG_CONVOLVE_ROUND
+TEST_P(AV1HighbdWarpFilterPostRoundTest, CheckOutput) {
+  RunCheckOutputPostRound(GET_PARAM(4));
+}
+TEST_P(AV1HighbdWarpFilterPostRoundTest, DISABLED_Speed) {
+  RunSpeedTest(GET_PARAM(4));
+}
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, AV1HighbdWarpFilterPostRoundTest,
+                        libaom_test::AV1HighbdWarpFilter::BuildParams(
+                            av1_highbd_warp_affine_post_round_avx2));
 #endif
+#endif  // CONFIG_CONVOLVE_ROUND
+#endif  // CONFIG_HIGHBITDEPTH
 
 }  // namespace
@@ -9,6 +9,7 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include "aom_ports/aom_timer.h"
 #include "test/warp_filter_test_util.h"
 
 using std::tr1::tuple;
@@ -142,23 +143,126 @@ void AV1WarpFilterTest::RunCheckOutput(warp_affine_func test_impl) {
   delete[] output;
   delete[] output2;
 }
+
+#if CONFIG_CONVOLVE_ROUND
+void AV1WarpFilterTest::RunCheckOutputPostRound(warp_affine_func test_impl) {
+  const int w = 128, h = 128;
+  const int border = 16;
+  const int stride = w + 2 * border;
+  const int out_w = GET_PARAM(0), out_h = GET_PARAM(1);
+  const int num_iters = GET_PARAM(2);
+  int i, j, sub_x, sub_y;
+
+  uint8_t *input_ = new uint8_t[h * stride];
+  uint8_t *input = input_ + border;
+
+  int output_n = ((out_w + 7) & ~7) * out_h;
+  int32_t *output = new int32_t[output_n];
+  int32_t *output2 = new int32_t[output_n];
+  int32_t mat[8];
+  int16_t alpha, beta, gamma, delta;
+  ConvolveParams conv_params =
+      get_conv_params_no_round(0, 0, 0, output, out_w);
+  ConvolveParams conv_params2 =
+      get_conv_params_no_round(0, 0, 0, output2, out_w);
+
+  // Generate an input block and extend its borders horizontally
+  for (i = 0; i < h; ++i)
+    for (j = 0; j < w; ++j) input[i * stride + j] = rnd_.Rand8();
+  for (i = 0; i < h; ++i) {
+    memset(input + i * stride - border, input[i * stride], border);
+    memset(input + i * stride + w, input[i * stride + (w - 1)], border);
+  }
+
+  for (i = 0; i < num_iters; ++i) {
+    for (sub_x = 0; sub_x < 2; ++sub_x)
+      for (sub_y = 0; sub_y < 2; ++sub_y) {
+        generate_model(mat, &alpha, &beta, &gamma, &delta);
+        // The post-round filters accumulate into the output buffer
+        for (j = 0; j < output_n; ++j) output[j] = output2[j] = rnd_.Rand16();
+        av1_warp_affine_post_round_c(mat, input, w, h, stride, NULL, 32, 32,
+                                     out_w, out_h, out_w, sub_x, sub_y,
+                                     &conv_params, alpha, beta, gamma, delta);
+        test_impl(mat, input, w, h, stride, NULL, 32, 32, out_w, out_h, out_w,
+                  sub_x, sub_y, &conv_params2, alpha, beta, gamma, delta);
+
+        for (j = 0; j < output_n; ++j)
+          ASSERT_EQ(output[j], output2[j])
+              << "Pixel mismatch at index " << j << " = (" << (j % out_w)
+              << ", " << (j / out_w) << ") on iteration " << i;
+      }
+  }
+  delete[] input_;
+  delete[] output;
+  delete[] output2;
+}
+#endif  // CONFIG_CONVOLVE_ROUND
+
+void AV1WarpFilterTest::RunSpeedTest(warp_affine_func test_impl) {
+  const int w = 128, h = 128;
+  const int border = 16;
+  const int stride = w + 2 * border;
+  const int out_w = GET_PARAM(0), out_h = GET_PARAM(1);
+  const int num_loops = 1000000 * 16 / (out_w * out_h);
+  int i, j;
+
+  uint8_t *input_ = new uint8_t[h * stride];
+  uint8_t *input = input_ + border;
+
+  int output_n = ((out_w + 7) & ~7) * out_h;
+  uint8_t *output = new uint8_t[output_n];
+  int32_t *dst = new int32_t[output_n];
+  int32_t mat[8];
+  int16_t alpha, beta, gamma, delta;
+#if CONFIG_CONVOLVE_ROUND
+  // Suitable for both the regular and the post-round filters
+  ConvolveParams conv_params = get_conv_params_no_round(0, 0, 0, dst, out_w);
+#else
+  ConvolveParams conv_params = get_conv_params(0, 0, 0);
+#endif
+
+  for (i = 0; i < h; ++i)
+    for (j = 0; j < w; ++j) input[i * stride + j] = rnd_.Rand8();
+  for (i = 0; i < h; ++i) {
+    memset(input + i * stride - border, input[i * stride], border);
+    memset(input + i * stride + w, input[i * stride + (w - 1)], border);
+  }
+  memset(dst, 0, output_n * sizeof(*dst));
+  generate_model(mat, &alpha, &beta, &gamma, &delta);
+
+  aom_usec_timer timer;
+  aom_usec_timer_start(&timer);
+  for (i = 0; i < num_loops; ++i)
+    test_impl(mat, input, w, h, stride, output, 32, 32, out_w, out_h, out_w, 0,
+              0, &conv_params, alpha, beta, gamma, delta);
+  aom_usec_timer_mark(&timer);
+
+  const int elapsed_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+  printf("warp %3dx%-3d: %7.2f ns\n", out_w, out_h,
+         1000.0 * elapsed_time / num_loops);
+
+  delete[] input_;
+  delete[] output;
+  delete[] dst;
+}
 }  // namespace AV1WarpFilter
 
 #if CONFIG_HIGHBITDEPTH
 namespace AV1HighbdWarpFilter {
 
-::testing::internal::ParamGenerator<HighbdWarpTestParam> GetDefaultParams() {
-  const HighbdWarpTestParam defaultParams[] = {
-    make_tuple(4, 4, 50000, 8),   make_tuple(8, 8, 50000, 8),
-    make_tuple(64, 64, 1000, 8),  make_tuple(4, 16, 20000, 8),
-    make_tuple(32, 8, 10000, 8),  make_tuple(4, 4, 50000, 10),
-    make_tuple(8, 8, 50000, 10),  make_tuple(64, 64, 1000, 10),
-    make_tuple(4, 16, 20000, 10), make_tuple(32, 8, 10000, 10),
-    make_tuple(4, 4, 50000, 12),  make_tuple(8, 8, 50000, 12),
-    make_tuple(64, 64, 1000, 12), make_tuple(4, 16, 20000, 12),
-    make_tuple(32, 8, 10000, 12),
+::testing::internal::ParamGenerator<HighbdWarpTestParam> BuildParams(
+    highbd_warp_affine_func filter) {
+  const HighbdWarpTestParam params[] = {
+    make_tuple(4, 4, 50000, 8, filter),   make_tuple(8, 8, 50000, 8, filter),
+    make_tuple(64, 64, 1000, 8, filter),  make_tuple(4, 16, 20000, 8, filter),
+    make_tuple(32, 8, 10000, 8, filter),  make_tuple(4, 4, 50000, 10, filter),
+    make_tuple(8, 8, 50000, 10, filter),  make_tuple(64, 64, 1000, 10, filter),
+    make_tuple(4, 16, 20000, 10, filter), make_tuple(32, 8, 10000, 10, filter),
+    make_tuple(4, 4, 50000, 12, filter),  make_tuple(8, 8, 50000, 12, filter),
+    make_tuple(64, 64, 1000, 12, filter), make_tuple(4, 16, 20000, 12, filter),
+    make_tuple(32, 8, 10000, 12, filter),
   };
-  return ::testing::ValuesIn(defaultParams);
+  return ::testing::ValuesIn(params);
 }
 
 AV1HighbdWarpFilterTest::~AV1HighbdWarpFilterTest() {}
@@ -284,6 +388,116 @@ void AV1HighbdWarpFilterTest::RunCheckOutput(
   delete[] output;
   delete[] output2;
 }
+
+#if CONFIG_CONVOLVE_ROUND
+void AV1HighbdWarpFilterTest::RunCheckOutputPostRound(
+    highbd_warp_affine_func test_impl) {
+  const int w = 128, h = 128;
+  const int border = 16;
+  const int stride = w + 2 * border;
+  const int out_w = GET_PARAM(0), out_h = GET_PARAM(1);
+  const int num_iters = GET_PARAM(2);
+  const int bd = GET_PARAM(3);
+  const int mask = (1 << bd) - 1;
+  int i, j, sub_x, sub_y;
+
+  int output_n = ((out_w + 7) & ~7) * out_h;
+  uint16_t *input_ = new uint16_t[h * stride];
+  uint16_t *input = input_ + border;
+  int32_t *output = new int32_t[output_n];
+  int32_t *output2 = new int32_t[output_n];
+  int32_t mat[8];
+  int16_t alpha, beta, gamma, delta;
+  ConvolveParams conv_params =
+      get_conv_params_no_round(0, 0, 0, output, out_w);
+  ConvolveParams conv_params2 =
+      get_conv_params_no_round(0, 0, 0, output2, out_w);
+
+  // Generate an input block and extend its borders horizontally
+  for (i = 0; i < h; ++i)
+    for (j = 0; j < w; ++j) input[i * stride + j] = rnd_.Rand16() & mask;
+  for (i = 0; i < h; ++i) {
+    for (j = 0; j < border; ++j) {
+      input[i * stride - border + j] = input[i * stride];
+      input[i * stride + w + j] = input[i * stride + (w - 1)];
+    }
+  }
+
+  for (i = 0; i < num_iters; ++i) {
+    for (sub_x = 0; sub_x < 2; ++sub_x)
+      for (sub_y = 0; sub_y < 2; ++sub_y) {
+        generate_model(mat, &alpha, &beta, &gamma, &delta);
+        // The post-round filters accumulate into the output buffer
+        for (j = 0; j < output_n; ++j) output[j] = output2[j] = rnd_.Rand16();
+        av1_highbd_warp_affine_post_round_c(
+            mat, input, w, h, stride, NULL, 32, 32, out_w, out_h, out_w, sub_x,
+            sub_y, bd, &conv_params, alpha, beta, gamma, delta);
+        test_impl(mat, input, w, h, stride, NULL, 32, 32, out_w, out_h, out_w,
+                  sub_x, sub_y, bd, &conv_params2, alpha, beta, gamma, delta);
+
+        for (j = 0; j < output_n; ++j)
+          ASSERT_EQ(output[j], output2[j])
+              << "Pixel mismatch at index " << j << " = (" << (j % out_w)
+              << ", " << (j / out_w) << ") on iteration " << i;
+      }
+  }
+
+  delete[] input_;
+  delete[] output;
+  delete[] output2;
+}
+#endif  // CONFIG_CONVOLVE_ROUND
+
+void AV1HighbdWarpFilterTest::RunSpeedTest(highbd_warp_affine_func test_impl) {
+  const int w = 128, h = 128;
+  const int border = 16;
+  const int stride = w + 2 * border;
+  const int out_w = GET_PARAM(0), out_h = GET_PARAM(1);
+  const int bd = GET_PARAM(3);
+  const int mask = (1 << bd) - 1;
+  const int num_loops = 1000000 * 16 / (out_w * out_h);
+  int i, j;
+
+  int output_n = ((out_w + 7) & ~7) * out_h;
+  uint16_t *input_ = new uint16_t[h * stride];
+  uint16_t *input = input_ + border;
+  uint16_t *output = new uint16_t[output_n];
+  int32_t *dst = new int32_t[output_n];
+  int32_t mat[8];
+  int16_t alpha, beta, gamma, delta;
+#if CONFIG_CONVOLVE_ROUND
+  // Suitable for both the regular and the post-round filters
+  ConvolveParams conv_params = get_conv_params_no_round(0, 0, 0, dst, out_w);
+#else
+  ConvolveParams conv_params = get_conv_params(0, 0, 0);
+#endif
+
+  for (i = 0; i < h; ++i)
+    for (j = 0; j < w; ++j) input[i * stride + j] = rnd_.Rand16() & mask;
+  for (i = 0; i < h; ++i) {
+    for (j = 0; j < border; ++j) {
+      input[i * stride - border + j] = input[i * stride];
+      input[i * stride + w + j] = input[i * stride + (w - 1)];
+    }
+  }
+  memset(dst, 0, output_n * sizeof(*dst));
+  generate_model(mat, &alpha, &beta, &gamma, &delta);
+
+  aom_usec_timer timer;
+  aom_usec_timer_start(&timer);
+  for (i = 0; i < num_loops; ++i)
+    test_impl(mat, input, w, h, stride, output, 32, 32, out_w, out_h, out_w, 0,
+              0, bd, &conv_params, alpha, beta, gamma, delta);
+  aom_usec_timer_mark(&timer);
+
+  const int elapsed_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+  printf("highbd warp %3dx%-3d (bd %d): %7.2f ns\n", out_w, out_h, bd,
+         1000.0 * elapsed_time / num_loops);
+
+  delete[] input_;
+  delete[] output;
+  delete[] dst;
+}
 }  // namespace AV1HighbdWarpFilter
 #endif  // CONFIG_HIGHBITDEPTH
 }  // namespace libaom_test
@@ -52,10 +52,18 @@ class AV1WarpFilterTest : public ::testing::TestWithParam<WarpTestParam> {
                       int16_t *gamma, int16_t *delta);
 
   void RunCheckOutput(warp_affine_func test_impl);
+#if CONFIG_CONVOLVE_ROUND
+  void RunCheckOutputPostRound(warp_affine_func test_impl);
+#endif
+  void RunSpeedTest(warp_affine_func test_impl);
 
   libaom_test::ACMRandom rnd_;
 };
 
+#if CONFIG_CONVOLVE_ROUND
+class AV1WarpFilterPostRoundTest : public AV1WarpFilterTest {};
+#endif
+
 }  // namespace AV1WarpFilter
 
 #if CONFIG_HIGHBITDEPTH
@@ -69,9 +77,11 @@ typedef void (*highbd_warp_affine_func)(const int32_t *mat, const uint16_t *ref,
                                         int16_t alpha, int16_t beta,
                                         int16_t gamma, int16_t delta);
 
-typedef std::tr1::tuple<int, int, int, int> HighbdWarpTestParam;
+typedef std::tr1::tuple<int, int, int, int, highbd_warp_affine_func>
+    HighbdWarpTestParam;
 
-::testing::internal::ParamGenerator<HighbdWarpTestParam> GetDefaultParams();
+::testing::internal::ParamGenerator<HighbdWarpTestParam> BuildParams(
+    highbd_warp_affine_func filter);
 
 class AV1HighbdWarpFilterTest
     : public ::testing::TestWithParam<HighbdWarpTestParam> {
@@ -87,10 +97,18 @@ class AV1HighbdWarpFilterTest
                       int16_t *gamma, int16_t *delta);
 
   void RunCheckOutput(highbd_warp_affine_func test_impl);
+#if CONFIG_CONVOLVE_ROUND
+  void RunCheckOutputPostRound(highbd_warp_affine_func test_impl);
+#endif
+  void RunSpeedTest(highbd_warp_affine_func test_impl);
 
   libaom_test::ACMRandom rnd_;
 };
 
+#if CONFIG_CONVOLVE_ROUND
+class AV1HighbdWarpFilterPostRoundTest : public AV1HighbdWarpFilterTest {};
+#endif
+
 }  // namespace AV1HighbdWarpFilter
 #endif  // CONFIG_HIGHBITDEPTH
 
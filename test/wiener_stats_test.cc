@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <ctime>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "./av1_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/util.h"
+
+#include "aom_mem/aom_mem.h"
+#include "av1/common/restoration.h"
+
+namespace {
+
+using std::tr1::tuple;
+using std::tr1::make_tuple;
+using libaom_test::ACMRandom;
+
+// The statistics are gathered over a tile of the frame, and read up to
+// WIENER_HALFWIN pixels beyond it on each side.
+const int kBorder = WIENER_HALFWIN;
+const int kMaxSize = RESTORATION_TILESIZE_MAX * 3 / 2;
+const int kStride = kMaxSize + 2 * kBorder + 13;
+const int kBufSize = kStride * (kMaxSize + 2 * kBorder);
+
+typedef void (*ComputeStatsFunc)(const uint8_t *dgd, const uint8_t *src,
+                                 int avg, int h_start, int h_end, int v_start,
+                                 int v_end, int dgd_stride, int src_stride,
+                                 int64_t *M, int64_t *H);
+
+typedef tuple<ComputeStatsFunc> WienerStatsParam;
+
+class AV1WienerStatsTest : public ::testing::TestWithParam<WienerStatsParam> {
+ public:
+  virtual ~AV1WienerStatsTest() {}
+  virtual void SetUp() { tst_fun_ = GET_PARAM(0); }
+
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RunCorrectnessTest() {
+    const int NUM_ITERS = 40;
+    int i, j;
+
+    uint8_t *dgd = (uint8_t *)aom_memalign(16, kBufSize);
+    uint8_t *src = (uint8_t *)aom_memalign(16, kBufSize);
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+
+    for (i = 0; i < NUM_ITERS; ++i) {
+      // Mostly random sizes, including the extremes, and either smooth or
+      // noisy content.
+      const int w = i == 0 ? kMaxSize : (i == 1 ? 1 : 1 + rnd(kMaxSize));
+      const int h = i == 0 ? kMaxSize : (i == 1 ? 1 : 1 + rnd(kMaxSize));
+      const int noise = (i & 1) ? 255 : 15;
+      const int base = rnd(256 - noise);
+      for (j = 0; j < kBufSize; ++j) {
+        dgd[j] = base + rnd(noise + 1);
+        src[j] = base + rnd(noise + 1);
+      }
+      // Any offset gives exact statistics, so don't bother with the average
+      const int avg = base + noise / 2;
+
+      int64_t M_ref[WIENER_WIN2], M_tst[WIENER_WIN2];
+      int64_t H_ref[WIENER_WIN2 * WIENER_WIN2];
+      int64_t H_tst[WIENER_WIN2 * WIENER_WIN2];
+      av1_compute_stats_c(dgd, src, avg, kBorder, kBorder + w, kBorder,
+                          kBorder + h, kStride, kStride, M_ref, H_ref);
+      tst_fun_(dgd, src, avg, kBorder, kBorder + w, kBorder, kBorder + h,
+               kStride, kStride, M_tst, H_tst);
+      for (j = 0; j < WIENER_WIN2; ++j)
+        ASSERT_EQ(M_ref[j], M_tst[j]) << "M[" << j << "] size " << w << "x"
+                                      << h;
+      for (j = 0; j < WIENER_WIN2 * WIENER_WIN2; ++j)
+        ASSERT_EQ(H_ref[j], H_tst[j]) << "H[" << j << "] size " << w << "x"
+                                      << h;
+    }
+
+    aom_free(dgd);
+    aom_free(src);
+  }
+
+  void RunSpeedTest() {
+    const int w = RESTORATION_TILESIZE_MAX, h = RESTORATION_TILESIZE_MAX;
+    const int NUM_ITERS = 10;
+    int i;
+
+    uint8_t *dgd = (uint8_t *)aom_memalign(16, kBufSize);
+    uint8_t *src = (uint8_t *)aom_memalign(16, kBufSize);
+    int64_t M[WIENER_WIN2], H[WIENER_WIN2 * WIENER_WIN2];
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    for (i = 0; i < kBufSize; ++i) {
+      dgd[i] = rnd.Rand8();
+      src[i] = rnd.Rand8();
+    }
+
+    std::clock_t start = std::clock();
+    for (i = 0; i < NUM_ITERS; ++i)
+      av1_compute_stats_c(dgd, src, 128, kBorder, kBorder + w, kBorder,
+                          kBorder + h, kStride, kStride, M, H);
+    const double ref_time =
+        (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+
+    start = std::clock();
+    for (i = 0; i < NUM_ITERS; ++i)
+      tst_fun_(dgd, src, 128, kBorder, kBorder + w, kBorder, kBorder + h,
+               kStride, kStride, M, H);
+    const double tst_time =
+        (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+
+    printf("C time: %.3f ms, SIMD time: %.3f ms (x%.1f)\n",
+           1000 * ref_time / NUM_ITERS, 1000 * tst_time / NUM_ITERS,
+           ref_time / tst_time);
+
+    aom_free(dgd);
+    aom_free(src);
+  }
+
+  ComputeStatsFunc tst_fun_;
+};
+
+TEST_P(AV1WienerStatsTest, CorrectnessTest) { RunCorrectnessTest(); }
+TEST_P(AV1WienerStatsTest, DISABLED_SpeedTest) { RunSpeedTest(); }
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, AV1WienerStatsTest,
+                        ::testing::Values(make_tuple(av1_compute_stats_avx2)));
+#endif
+
+#if CONFIG_HIGHBITDEPTH
+
+typedef void (*ComputeStatsHighbdFunc)(const uint16_t *dgd, const uint16_t *src,
+                                       int avg, int h_start, int h_end,
+                                       int v_start, int v_end, int dgd_stride,
+                                       int src_stride, int64_t *M, int64_t *H);
+
+typedef tuple<ComputeStatsHighbdFunc, int> HighbdWienerStatsParam;
+
+class AV1HighbdWienerStatsTest
+    : public ::testing::TestWithParam<HighbdWienerStatsParam> {
+ public:
+  virtual ~AV1HighbdWienerStatsTest() {}
+  virtual void SetUp() { tst_fun_ = GET_PARAM(0); }
+
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RunCorrectnessTest() {
+    const int NUM_ITERS = 40;
+    const int bit_depth = GET_PARAM(1);
+    const int max_val = (1 << bit_depth) - 1;
+    int i, j;
+
+    uint16_t *dgd = (uint16_t *)aom_memalign(16, kBufSize * sizeof(*dgd));
+    uint16_t *src = (uint16_t *)aom_memalign(16, kBufSize * sizeof(*src));
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+
+    for (i = 0; i < NUM_ITERS; ++i) {
+      const int w = i == 0 ? kMaxSize : (i == 1 ? 1 : 1 + rnd(kMaxSize));
+      const int h = i == 0 ? kMaxSize : (i == 1 ? 1 : 1 + rnd(kMaxSize));
+      // Alternate between full-range noise, which gives the largest
+      // products, and smooth content.
+      const int noise = (i & 1) ? max_val : (max_val >> 4);
+      const int base = rnd.PseudoUniform(max_val + 1 - noise);
+      for (j = 0; j < kBufSize; ++j) {
+        dgd[j] = base + rnd.PseudoUniform(noise + 1);
+        src[j] = base + rnd.PseudoUniform(noise + 1);
+      }
+      const int avg = base + noise / 2;
+
+      int64_t M_ref[WIENER_WIN2], M_tst[WIENER_WIN2];
+      int64_t H_ref[WIENER_WIN2 * WIENER_WIN2];
+      int64_t H_tst[WIENER_WIN2 * WIENER_WIN2];
+      av1_compute_stats_highbd_c(dgd, src, avg, kBorder, kBorder + w, kBorder,
+                                 kBorder + h, kStride, kStride, M_ref, H_ref);
+      tst_fun_(dgd, src, avg, kBorder, kBorder + w, kBorder, kBorder + h,
+               kStride, kStride, M_tst, H_tst);
+      for (j = 0; j < WIENER_WIN2; ++j)
+        ASSERT_EQ(M_ref[j], M_tst[j]) << "M[" << j << "] size " << w << "x"
+                                      << h;
+      for (j = 0; j < WIENER_WIN2 * WIENER_WIN2; ++j)
+        ASSERT_EQ(H_ref[j], H_tst[j]) << "H[" << j << "] size " << w << "x"
+                                      << h;
+    }
+
+    aom_free(dgd);
+    aom_free(src);
+  }
+
+  ComputeStatsHighbdFunc tst_fun_;
+};
+
+TEST_P(AV1HighbdWienerStatsTest, CorrectnessTest) { RunCorrectnessTest(); }
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, AV1HighbdWienerStatsTest,
+    ::testing::Combine(::testing::Values(av1_compute_stats_highbd_avx2),
+                       ::testing::Values(8, 10, 12)));
+#endif
+
+#endif  // CONFIG_HIGHBITDEPTH
+
+}  // namespace